@@ -53,43 +53,45 @@ namespace Skylicht
 			CGroup *parentGroup = subGroup->getParentGroup();
 
 			CParticle *baseParticles = parentGroup->getParticlePointer();
-			CParticle *p;
 
-#pragma omp parallel for private(p)
-			for (int i = 0; i < num; i++)
-			{
-				p = particles + i;
+			SkylichtSystem::CJobSystem::runParallelFor(num, PARTICLE_GRAIN_SIZE, [&](int begin, int end) {
+				CParticle *p;
 
-				if (p->ParentIndex >= 0)
+				for (int i = begin; i < end; i++)
 				{
-					CParticle &parent = baseParticles[p->ParentIndex];
+					p = particles + i;
 
-					p->Position = (p->Position - p->LastPosition) + parent.Position;
-
-					if (m_syncLife == true)
-					{
-						p->Age = parent.Age;
-						p->Life = parent.Life;
-						p->LifeTime = parent.LifeTime;
-					}
-
-					if (m_syncColor == true)
+					if (p->ParentIndex >= 0)
 					{
-						p->Params[ColorR] = parent.Params[ColorR];
-						p->Params[ColorG] = parent.Params[ColorG];
-						p->Params[ColorB] = parent.Params[ColorB];
-						p->Params[ColorA] = parent.Params[ColorA];
+						CParticle &parent = baseParticles[p->ParentIndex];
+
+						p->Position = (p->Position - p->LastPosition) + parent.Position;
+
+						if (m_syncLife == true)
+						{
+							p->Age = parent.Age;
+							p->Life = parent.Life;
+							p->LifeTime = parent.LifeTime;
+						}
+
+						if (m_syncColor == true)
+						{
+							p->Params[ColorR] = parent.Params[ColorR];
+							p->Params[ColorG] = parent.Params[ColorG];
+							p->Params[ColorB] = parent.Params[ColorB];
+							p->Params[ColorA] = parent.Params[ColorA];
+						}
 					}
-				}
-				else
-				{
-					// sync dead
-					if (m_syncLife == true)
+					else
 					{
-						p->Life = -1.0f;
+						// sync dead
+						if (m_syncLife == true)
+						{
+							p->Life = -1.0f;
+						}
 					}
 				}
-			}
+				});
 		}
 	}
 }
\ No newline at end of file
@@ -55,10 +55,6 @@ namespace Skylicht
 
 			SParticleInstance *vtx = (SParticleInstance*)buffer->getVertices();
 
-			CParticle *p;
-			float *params;
-			SParticleInstance *data;
-
 			u32 frameX = 1;
 			u32 frameY = 1;
 
@@ -84,42 +80,47 @@ namespace Skylicht
 			u32 totalFrames = frameX * frameY;
 			float frameW = 1.0f / frameX;
 			float frameH = 1.0f / frameY;
-			u32 frame, row, col;
 
-#pragma omp parallel for private(p, params, data, frame, row, col)
-			for (int i = 0; i < num; i++)
-			{
-				p = particles + i;
-				params = p->Params;
-				data = vtx + i;
-
-				data->Pos = p->Position;
-
-				data->Color.set(
-					(u32)(params[ColorA] * 255.0f),
-					(u32)(params[ColorR] * 255.0f),
-					(u32)(params[ColorG] * 255.0f),
-					(u32)(params[ColorB] * 255.0f)
-				);
-
-				data->Size.set(
-					sx * params[ScaleX],
-					sy * params[ScaleY],
-					sz * params[ScaleZ]
-				);
-				data->Rotation = p->Rotation;
-				data->Velocity = p->Velocity;
-
-				frame = (u32)params[FrameIndex];
-				frame = frame < 0 ? 0 : frame;
-				frame = frame >= totalFrames ? totalFrames - 1 : frame;
-
-				row = frame / frameX;
-				col = frame - (row * frameX);
-
-				data->UVScale.set(frameW, frameH);
-				data->UVOffset.set(col * frameW, row * frameH);
-			}
+			SkylichtSystem::CJobSystem::runParallelFor(num, PARTICLE_GRAIN_SIZE, [&](int begin, int end) {
+				CParticle *p;
+				float *params;
+				SParticleInstance *data;
+				u32 frame, row, col;
+
+				for (int i = begin; i < end; i++)
+				{
+					p = particles + i;
+					params = p->Params;
+					data = vtx + i;
+
+					data->Pos = p->Position;
+
+					data->Color.set(
+						(u32)(params[ColorA] * 255.0f),
+						(u32)(params[ColorR] * 255.0f),
+						(u32)(params[ColorG] * 255.0f),
+						(u32)(params[ColorB] * 255.0f)
+					);
+
+					data->Size.set(
+						sx * params[ScaleX],
+						sy * params[ScaleY],
+						sz * params[ScaleZ]
+					);
+					data->Rotation = p->Rotation;
+					data->Velocity = p->Velocity;
+
+					frame = (u32)params[FrameIndex];
+					frame = frame < 0 ? 0 : frame;
+					frame = frame >= totalFrames ? totalFrames - 1 : frame;
+
+					row = frame / frameX;
+					col = frame - (row * frameX);
+
+					data->UVScale.set(frameW, frameH);
+					data->UVOffset.set(col * frameW, row * frameH);
+				}
+				});
 
 			buffer->setDirty();
 		}
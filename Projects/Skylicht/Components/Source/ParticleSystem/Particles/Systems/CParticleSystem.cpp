@@ -46,19 +46,20 @@ namespace Skylicht
 		{
 			dt = dt * 0.001f;
 
-			CParticle *p;
+			SkylichtSystem::CJobSystem::runParallelFor(num, PARTICLE_GRAIN_SIZE, [&](int begin, int end) {
+				CParticle *p;
 
-#pragma omp parallel for private(p)
-			for (int i = 0; i < num; i++)
-			{
-				p = particles + i;
+				for (int i = begin; i < end; i++)
+				{
+					p = particles + i;
 
-				// update life time
-				p->Age = p->Age + dt;
+					// update life time
+					p->Age = p->Age + dt;
 
-				if (!p->Immortal)
-					p->Life -= dt;
-			}
+					if (!p->Immortal)
+						p->Life -= dt;
+				}
+				});
 		}
 
 		void CParticleSystem::update(CParticle *particles, int num, CGroup *group, float dt)
@@ -70,9 +71,6 @@ namespace Skylicht
 
 			float friction = group->Friction * dt;
 
-			CParticle *p;
-			float *params;
-
 			// model
 			std::vector<CModel*>& listModel = group->getModels();
 
@@ -91,75 +89,78 @@ namespace Skylicht
 			EParticleParams* paramTypes = listParams.data();
 			CInterpolator** modelInterpolators = listModelInterpolators.data();
 
-			float f, y;
-
-#pragma omp parallel for private(p, params, f, y)
-			for (int i = 0; i < num; i++)
-			{
-				p = particles + i;
-				params = p->Params;
-
-				// update life time
-				p->Age = p->Age + dt;
-
-				if (!p->Immortal)
-					p->Life -= dt;
-
-				p->LastPosition = p->Position;
-
-				p->Position += p->Velocity * dt;
+			SkylichtSystem::CJobSystem::runParallelFor(num, PARTICLE_GRAIN_SIZE, [&](int begin, int end) {
+				CParticle *p;
+				float *params;
+				float f, y;
 
-				// update gravity
-				p->Velocity += gravity;
-
-				// update rotation
-				if (p->HaveRotate == true)
+				for (int i = begin; i < end; i++)
 				{
-					p->Rotation.X = p->Rotation.X + params[RotateSpeedX] * dt;
-					p->Rotation.Y = p->Rotation.Y + params[RotateSpeedY] * dt;
-					p->Rotation.Z = p->Rotation.Z + params[RotateSpeedZ] * dt;
+					p = particles + i;
+					params = p->Params;
 
-					p->Rotation.X = fmod(p->Rotation.X, pi2);
-					p->Rotation.Y = fmod(p->Rotation.Y, pi2);
-					p->Rotation.Z = fmod(p->Rotation.Z, pi2);
-				}
+					// update life time
+					p->Age = p->Age + dt;
 
-				// update friction
-				if (group->Friction > 0.0f)
-				{
-					f = 1.0f - core::min_(1.0f, friction / params[Mass]);
-					p->Velocity *= f;
-				}
+					if (!p->Immortal)
+						p->Life -= dt;
 
-				// update interpolate parameters
-				float x = core::clamp(p->Age / p->LifeTime, 0.0f, 1.0f);
+					p->LastPosition = p->Position;
 
-				for (u32 j = 0; j < numModels; j++)
-				{
-					// linear
-					y = x;
-					EParticleParams t = paramTypes[j];
+					p->Position += p->Velocity * dt;
 
-					if (modelInterpolators[j] != NULL)
+					// update gravity
+					p->Velocity += gravity;
+
+					// update rotation
+					if (p->HaveRotate == true)
 					{
-						// interpolate
-						y = modelInterpolators[j]->interpolate(x);
-						params[t] = y;
+						p->Rotation.X = p->Rotation.X + params[RotateSpeedX] * dt;
+						p->Rotation.Y = p->Rotation.Y + params[RotateSpeedY] * dt;
+						p->Rotation.Z = p->Rotation.Z + params[RotateSpeedZ] * dt;
+
+						p->Rotation.X = fmod(p->Rotation.X, pi2);
+						p->Rotation.Y = fmod(p->Rotation.Y, pi2);
+						p->Rotation.Z = fmod(p->Rotation.Z, pi2);
 					}
-					else
+
+					// update friction
+					if (group->Friction > 0.0f)
 					{
-						// update param value
-						params[t] = p->StartValue[t] + (p->EndValue[t] - p->StartValue[t]) * y;
+						f = 1.0f - core::min_(1.0f, friction / params[Mass]);
+						p->Velocity *= f;
 					}
 
-					if (t == Scale)
+					// update interpolate parameters
+					float x = core::clamp(p->Age / p->LifeTime, 0.0f, 1.0f);
+
+					for (u32 j = 0; j < numModels; j++)
 					{
-						params[ScaleX] = params[Scale];
-						params[ScaleY] = params[Scale];
-						params[ScaleZ] = params[Scale];
+						// linear
+						y = x;
+						EParticleParams t = paramTypes[j];
+
+						if (modelInterpolators[j] != NULL)
+						{
+							// interpolate
+							y = modelInterpolators[j]->interpolate(x);
+							params[t] = y;
+						}
+						else
+						{
+							// update param value
+							params[t] = p->StartValue[t] + (p->EndValue[t] - p->StartValue[t]) * y;
+						}
+
+						if (t == Scale)
+						{
+							params[ScaleX] = params[Scale];
+							params[ScaleY] = params[Scale];
+							params[ScaleZ] = params[Scale];
+						}
 					}
 				}
-			}
+				});
 		}
 	}
 }
\ No newline at end of file
@@ -58,58 +58,59 @@ namespace Skylicht
 
 			float deltaTime = dt * 0.001f;
 
-			CParticle *p;
-			float dist, angle, endRadius;
-			core::vector3df rotationCenter, normal, tangent, attraction;
+			SkylichtSystem::CJobSystem::runParallelFor(num, PARTICLE_GRAIN_SIZE, [&](int begin, int end) {
+				CParticle *p;
+				float dist, angle, endRadius;
+				core::vector3df rotationCenter, normal, tangent, attraction;
 
-#pragma omp parallel for private(p, dist, angle, endRadius, rotationCenter, normal, tangent, attraction)
-			for (int i = 0; i < num; i++)
-			{
-				p = particles + i;
+				for (int i = begin; i < end; i++)
+				{
+					p = particles + i;
 
-				// Distance of the projection point from the position of the vortex
-				dist = direction.dotProduct(p->Position - position);
+					// Distance of the projection point from the position of the vortex
+					dist = direction.dotProduct(p->Position - position);
 
-				// Position of the rotation center (orthogonal projection of the particle)
-				rotationCenter = direction;
-				rotationCenter *= dist;
+					// Position of the rotation center (orthogonal projection of the particle)
+					rotationCenter = direction;
+					rotationCenter *= dist;
 
-				attraction = -rotationCenter;
+					attraction = -rotationCenter;
 
-				rotationCenter += position;
+					rotationCenter += position;
 
-				// Distance of the particle from the eye of the vortex
-				dist = rotationCenter.getDistanceFrom(p->Position);
+					// Distance of the particle from the eye of the vortex
+					dist = rotationCenter.getDistanceFrom(p->Position);
 
-				if (dist <= m_eyeRadius)
-				{
-					if (m_killingParticleEnabled)
-						p->Life = -1.0f;
-					continue;
-				}
+					if (dist <= m_eyeRadius)
+					{
+						if (m_killingParticleEnabled)
+							p->Life = -1.0f;
+						continue;
+					}
 
-				angle = m_rotationSpeed * deltaTime / dist;
+					angle = m_rotationSpeed * deltaTime / dist;
 
-				// Distance attraction
-				attraction.normalize();
-				attraction *= m_eyeAttractionSpeed * deltaTime / dist;
+					// Distance attraction
+					attraction.normalize();
+					attraction *= m_eyeAttractionSpeed * deltaTime / dist;
 
-				// Computes ortho base
-				normal = (p->Position - rotationCenter) / dist;
-				tangent = direction.crossProduct(normal);
+					// Computes ortho base
+					normal = (p->Position - rotationCenter) / dist;
+					tangent = direction.crossProduct(normal);
 
-				endRadius = dist - m_attractionSpeed * deltaTime;
-				if (endRadius <= m_eyeRadius)
-				{
-					endRadius = m_eyeRadius;
-					if (m_killingParticleEnabled)
-						p->Life = -1.0f;
-				}
+					endRadius = dist - m_attractionSpeed * deltaTime;
+					if (endRadius <= m_eyeRadius)
+					{
+						endRadius = m_eyeRadius;
+						if (m_killingParticleEnabled)
+							p->Life = -1.0f;
+					}
 
-				p->Position = rotationCenter + normal * endRadius * cosf(angle) + tangent * endRadius * sinf(angle);
+					p->Position = rotationCenter + normal * endRadius * cosf(angle) + tangent * endRadius * sinf(angle);
 
-				p->Position += attraction;
-			}
+					p->Position += attraction;
+				}
+				});
 		}
 	}
 }
\ No newline at end of file
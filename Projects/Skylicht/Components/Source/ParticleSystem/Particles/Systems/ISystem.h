@@ -24,6 +24,11 @@ https://github.com/skylicht-lab/skylicht-engine
 
 #pragma once
 
+#include "Job/CJobSystem.h"
+
+// number of particles per job on the parallel update
+#define PARTICLE_GRAIN_SIZE 256
+
 namespace Skylicht
 {
 	namespace Particle
@@ -34,6 +34,7 @@ https://github.com/skylicht-lab/skylicht-engine
 #include "Culling/CCullingData.h"
 #include "Culling/CCullingBBoxData.h"
 #include "IndirectLighting/CIndirectLightingData.h"
+#include "ReflectionProbe/CIndirectReflectionData.h"
 #include "Material/CMaterialManager.h"
 
 namespace Skylicht
@@ -195,6 +196,7 @@ namespace Skylicht
 		entity->addData<CWorldInverseTransformData>();
 		entity->addData<CCullingData>();
 		entity->addData<CIndirectLightingData>();
+		entity->addData<CIndirectReflectionData>();
 
 		CCullingBBoxData* cullingBBox = entity->addData<CCullingBBoxData>();
 
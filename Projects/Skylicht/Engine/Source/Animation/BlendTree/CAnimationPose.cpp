@@ -0,0 +1,229 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2023 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#include "pch.h"
+#include "CAnimationPose.h"
+#include "Utils/CSIMD.h"
+
+namespace Skylicht
+{
+	CAnimationPose::CAnimationPose() :
+		m_numBone(0),
+		m_stride(0)
+	{
+
+	}
+
+	CAnimationPose::~CAnimationPose()
+	{
+
+	}
+
+	void CAnimationPose::init(u32 numBone)
+	{
+		m_numBone = numBone;
+		m_stride = (numBone + 3) & ~3;
+
+		m_data.set_used(CPoseSampler::StreamCount * m_stride);
+		memset(m_data.pointer(), 0, m_data.size() * sizeof(f32));
+
+		for (u32 i = 0; i < m_stride; i++)
+		{
+			getStream(CPoseSampler::ScaleX)[i] = 1.0f;
+			getStream(CPoseSampler::ScaleY)[i] = 1.0f;
+			getStream(CPoseSampler::ScaleZ)[i] = 1.0f;
+			getStream(CPoseSampler::RotationW)[i] = 1.0f;
+		}
+	}
+
+	void CAnimationPose::copy(const CAnimationPose& pose)
+	{
+		if (m_stride != pose.m_stride)
+		{
+			m_numBone = pose.m_numBone;
+			m_stride = pose.m_stride;
+			m_data.set_used(pose.m_data.size());
+		}
+
+		memcpy(m_data.pointer(), pose.m_data.const_pointer(), m_data.size() * sizeof(f32));
+	}
+
+	void CAnimationPose::blend(const CAnimationPose& pose, f32 weight, const f32* mask)
+	{
+		f32* a = m_data.pointer();
+		const f32* b = pose.m_data.const_pointer();
+
+		u32 rx = CPoseSampler::RotationX * m_stride;
+		u32 ry = CPoseSampler::RotationY * m_stride;
+		u32 rz = CPoseSampler::RotationZ * m_stride;
+		u32 rw = CPoseSampler::RotationW * m_stride;
+
+#if defined(USE_SIMD)
+		SIMDVec vweight = simdSet(weight);
+		SIMDVec zero = simdSet(0.0f);
+		SIMDVec one = simdSet(1.0f);
+		SIMDVec two = simdSet(2.0f);
+
+		for (u32 i = 0; i < m_stride; i += 4)
+		{
+			SIMDVec vt = mask != NULL ? simdMul(simdLoad(mask + i), vweight) : vweight;
+
+			// position & scale: lerp
+			for (u32 s = 0; s < rx; s += m_stride)
+			{
+				SIMDVec va = simdLoad(a + s + i);
+				SIMDVec vb = simdLoad(b + s + i);
+				simdStore(a + s + i, simdAdd(va, simdMul(simdSub(vb, va), vt)));
+			}
+
+			// rotation: nlerp on the same hemisphere
+			SIMDVec ax = simdLoad(a + rx + i);
+			SIMDVec ay = simdLoad(a + ry + i);
+			SIMDVec az = simdLoad(a + rz + i);
+			SIMDVec aw = simdLoad(a + rw + i);
+
+			SIMDVec bx = simdLoad(b + rx + i);
+			SIMDVec by = simdLoad(b + ry + i);
+			SIMDVec bz = simdLoad(b + rz + i);
+			SIMDVec bw = simdLoad(b + rw + i);
+
+			SIMDVec dot = simdAdd(simdAdd(simdMul(ax, bx), simdMul(ay, by)), simdAdd(simdMul(az, bz), simdMul(aw, bw)));
+
+			// the weight of b is -t if dot < 0
+			SIMDVec sign = simdSub(one, simdAnd(simdLess(dot, zero), two));
+			SIMDVec wa = simdSub(one, vt);
+			SIMDVec wb = simdMul(vt, sign);
+
+			SIMDVec x = simdAdd(simdMul(ax, wa), simdMul(bx, wb));
+			SIMDVec y = simdAdd(simdMul(ay, wa), simdMul(by, wb));
+			SIMDVec z = simdAdd(simdMul(az, wa), simdMul(bz, wb));
+			SIMDVec w = simdAdd(simdMul(aw, wa), simdMul(bw, wb));
+
+			SIMDVec len = simdAdd(simdAdd(simdMul(x, x), simdMul(y, y)), simdAdd(simdMul(z, z), simdMul(w, w)));
+			len = simdSqrt(len);
+
+			simdStore(a + rx + i, simdDiv(x, len));
+			simdStore(a + ry + i, simdDiv(y, len));
+			simdStore(a + rz + i, simdDiv(z, len));
+			simdStore(a + rw + i, simdDiv(w, len));
+		}
+#else
+		for (u32 i = 0; i < m_stride; i++)
+		{
+			f32 t = mask != NULL ? mask[i] * weight : weight;
+
+			for (u32 s = 0; s < rx; s += m_stride)
+				a[s + i] = a[s + i] + (b[s + i] - a[s + i]) * t;
+
+			f32 dot = a[rx + i] * b[rx + i] + a[ry + i] * b[ry + i] + a[rz + i] * b[rz + i] + a[rw + i] * b[rw + i];
+
+			f32 wa = 1.0f - t;
+			f32 wb = dot < 0.0f ? -t : t;
+
+			f32 x = a[rx + i] * wa + b[rx + i] * wb;
+			f32 y = a[ry + i] * wa + b[ry + i] * wb;
+			f32 z = a[rz + i] * wa + b[rz + i] * wb;
+			f32 w = a[rw + i] * wa + b[rw + i] * wb;
+
+			f32 invLen = core::reciprocal_squareroot(x * x + y * y + z * z + w * w);
+
+			a[rx + i] = x * invLen;
+			a[ry + i] = y * invLen;
+			a[rz + i] = z * invLen;
+			a[rw + i] = w * invLen;
+		}
+#endif
+	}
+
+	void CAnimationPose::additive(const CAnimationPose& pose, const CAnimationPose& reference, f32 weight, const f32* mask)
+	{
+		core::vector3df position, scale, addPosition, addScale, refPosition, refScale;
+		core::quaternion rotation, addRotation, refRotation, delta;
+
+		for (u32 i = 0; i < m_numBone; i++)
+		{
+			f32 t = mask != NULL ? mask[i] * weight : weight;
+			if (t <= 0.0f)
+				continue;
+
+			getBone(i, position, scale, rotation);
+			pose.getBone(i, addPosition, addScale, addRotation);
+			reference.getBone(i, refPosition, refScale, refRotation);
+
+			position += (addPosition - refPosition) * t;
+
+			if (refScale.X != 0.0f)
+				scale.X *= 1.0f + (addScale.X / refScale.X - 1.0f) * t;
+			if (refScale.Y != 0.0f)
+				scale.Y *= 1.0f + (addScale.Y / refScale.Y - 1.0f) * t;
+			if (refScale.Z != 0.0f)
+				scale.Z *= 1.0f + (addScale.Z / refScale.Z - 1.0f) * t;
+
+			// delta = inverse(ref) * add, so base = ref gives the add rotation
+			refRotation.makeInverse();
+			delta = refRotation * addRotation;
+
+			if (delta.W < 0.0f)
+				delta *= -1.0f;
+
+			if (t < 1.0f)
+			{
+				delta.set(
+					delta.X * t,
+					delta.Y * t,
+					delta.Z * t,
+					1.0f + (delta.W - 1.0f) * t);
+				delta.normalize();
+			}
+
+			rotation = rotation * delta;
+			rotation.normalize();
+
+			setBone(i, position, scale, rotation);
+		}
+	}
+
+	void CAnimationPose::setBone(u32 bone, const core::vector3df& position, const core::vector3df& scale, const core::quaternion& rotation)
+	{
+		f32* p = m_data.pointer() + bone;
+		p[CPoseSampler::PositionX * m_stride] = position.X;
+		p[CPoseSampler::PositionY * m_stride] = position.Y;
+		p[CPoseSampler::PositionZ * m_stride] = position.Z;
+		p[CPoseSampler::ScaleX * m_stride] = scale.X;
+		p[CPoseSampler::ScaleY * m_stride] = scale.Y;
+		p[CPoseSampler::ScaleZ * m_stride] = scale.Z;
+		p[CPoseSampler::RotationX * m_stride] = rotation.X;
+		p[CPoseSampler::RotationY * m_stride] = rotation.Y;
+		p[CPoseSampler::RotationZ * m_stride] = rotation.Z;
+		p[CPoseSampler::RotationW * m_stride] = rotation.W;
+	}
+
+	void CAnimationPose::getBone(u32 bone, core::vector3df& position, core::vector3df& scale, core::quaternion& rotation) const
+	{
+		const f32* p = m_data.const_pointer() + bone;
+		position.set(p[CPoseSampler::PositionX * m_stride], p[CPoseSampler::PositionY * m_stride], p[CPoseSampler::PositionZ * m_stride]);
+		scale.set(p[CPoseSampler::ScaleX * m_stride], p[CPoseSampler::ScaleY * m_stride], p[CPoseSampler::ScaleZ * m_stride]);
+		rotation.set(p[CPoseSampler::RotationX * m_stride], p[CPoseSampler::RotationY * m_stride], p[CPoseSampler::RotationZ * m_stride], p[CPoseSampler::RotationW * m_stride]);
+	}
+}
@@ -0,0 +1,84 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2023 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#pragma once
+
+#include "Animation/CPoseSampler.h"
+
+namespace Skylicht
+{
+	/// The local transform of all bones in the SoA layout of CPoseSampler (the track is the bone of skeleton),
+	/// the blend functions run on all bones in one pass.
+	class CAnimationPose
+	{
+	protected:
+		u32 m_numBone;
+
+		// number of bones that is aligned to 4
+		u32 m_stride;
+
+		// stream s, bone b: m_data[s * m_stride + b]
+		core::array<f32> m_data;
+
+	public:
+		CAnimationPose();
+
+		virtual ~CAnimationPose();
+
+		// identity transform
+		void init(u32 numBone);
+
+		void copy(const CAnimationPose& pose);
+
+		// lerp position, scale & nlerp rotation to the pose, the weight of bone b is weight * mask[b]
+		void blend(const CAnimationPose& pose, f32 weight, const f32* mask = NULL);
+
+		// add the difference of the pose from the reference pose
+		void additive(const CAnimationPose& pose, const CAnimationPose& reference, f32 weight, const f32* mask = NULL);
+
+		void setBone(u32 bone, const core::vector3df& position, const core::vector3df& scale, const core::quaternion& rotation);
+
+		void getBone(u32 bone, core::vector3df& position, core::vector3df& scale, core::quaternion& rotation) const;
+
+		inline f32* getStream(u32 stream)
+		{
+			return m_data.pointer() + stream * m_stride;
+		}
+
+		inline const f32* getStream(u32 stream) const
+		{
+			return m_data.const_pointer() + stream * m_stride;
+		}
+
+		inline u32 getNumBone() const
+		{
+			return m_numBone;
+		}
+
+		inline u32 getStride() const
+		{
+			return m_stride;
+		}
+	};
+}
@@ -0,0 +1,152 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2023 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#include "pch.h"
+#include "CBlendClipNode.h"
+#include "CBlendTree.h"
+#include "Animation/Skeleton/CSkeleton.h"
+
+namespace Skylicht
+{
+	CBlendClipNode::CBlendClipNode(CAnimationClip* clip, bool loop) :
+		m_clip(clip),
+		m_sharePose(false)
+	{
+		m_timeline.Loop = loop;
+	}
+
+	CBlendClipNode::~CBlendClipNode()
+	{
+
+	}
+
+	void CBlendClipNode::init(CBlendTree* tree)
+	{
+		IBlendNode::init(tree);
+
+		std::map<SEntityAnim*, int> trackIndex;
+		for (u32 i = 0, n = (u32)m_clip->AnimInfo.size(); i < n; i++)
+			trackIndex[m_clip->AnimInfo[i]] = (int)i;
+
+		float duration = 0.0f;
+
+		m_trackIndex.set_used(0);
+		for (u32 i = 0, n = tree->getNumBone(); i < n; i++)
+		{
+			SEntityAnim* anim = m_clip->getAnimOfEntity(tree->getBoneName(i));
+			m_trackIndex.push_back(anim != NULL ? trackIndex[anim] : -1);
+
+			if (anim != NULL)
+				duration = core::max_(duration, anim->Data.getLastFrame());
+		}
+
+		m_timeline.From = 0.0f;
+		m_timeline.Duration = duration;
+		m_timeline.To = duration;
+		m_timeline.Frame = 0.0f;
+	}
+
+	void CBlendClipNode::updateTime()
+	{
+		m_timeline.update();
+	}
+
+	void CBlendClipNode::evaluate()
+	{
+		sample(m_timeline.Frame, m_pose);
+	}
+
+	f32 CBlendClipNode::getPhase()
+	{
+		f32 length = m_timeline.To - m_timeline.From;
+		if (length <= 0.0f)
+			return 0.0f;
+
+		return (m_timeline.Frame - m_timeline.From) / length;
+	}
+
+	void CBlendClipNode::setPhase(f32 phase)
+	{
+		phase = core::clamp(phase, 0.0f, 1.0f);
+		m_timeline.Frame = m_timeline.From + phase * (m_timeline.To - m_timeline.From);
+	}
+
+	void CBlendClipNode::sample(f32 frame, CAnimationPose& pose)
+	{
+		pose.copy(m_tree->getDefaultPose());
+
+		int* trackIndex = m_trackIndex.pointer();
+		u32 numBone = m_trackIndex.size();
+
+		CPoseSampler* sampler = CSkeleton::isEnablePoseSampler() ? m_clip->getPoseSampler() : NULL;
+		if (sampler != NULL)
+		{
+			u32 stride = sampler->getStride();
+
+			const f32* clipPose;
+			f32 frameStep = getTimeStep() * m_timeline.Speed / 1000.0f;
+
+			if (m_sharePose && CPoseCache::canShare(frameStep))
+			{
+				clipPose = m_clip->getPoseCache()->getPose(frame);
+			}
+			else
+			{
+				m_clipPose.set_used(CPoseSampler::StreamCount * stride);
+				sampler->sample(frame, m_clipPose.pointer());
+				clipPose = m_clipPose.pointer();
+			}
+
+			// gather the clip tracks to the bones
+			for (u32 s = 0; s < CPoseSampler::StreamCount; s++)
+			{
+				const f32* src = clipPose + s * stride;
+				f32* dst = pose.getStream(s);
+
+				for (u32 i = 0; i < numBone; i++)
+				{
+					if (trackIndex[i] >= 0)
+						dst[i] = src[trackIndex[i]];
+				}
+			}
+		}
+		else
+		{
+			core::vector3df position, scale;
+			core::quaternion rotation;
+
+			for (u32 i = 0; i < numBone; i++)
+			{
+				if (trackIndex[i] < 0)
+					continue;
+
+				m_track.setAnimationData(&m_clip->AnimInfo[trackIndex[i]]->Data);
+				m_track.getFrameData(frame, position, scale, rotation);
+				rotation.normalize();
+
+				pose.setBone(i, position, scale, rotation);
+			}
+		}
+	}
+}
@@ -0,0 +1,89 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2023 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#pragma once
+
+#include "IBlendNode.h"
+#include "Animation/CAnimationClip.h"
+#include "Animation/Skeleton/CAnimationTimeline.h"
+
+namespace Skylicht
+{
+	class CBlendClipNode : public IBlendNode
+	{
+	protected:
+		CAnimationClip* m_clip;
+
+		CAnimationTimeline m_timeline;
+
+		// the track index on the clip of each bone, -1 if the bone has no animation
+		core::array<int> m_trackIndex;
+
+		// the clip pose that is sampled by CPoseSampler
+		core::array<f32> m_clipPose;
+
+		CAnimationTrack m_track;
+
+		bool m_sharePose;
+
+	public:
+		CBlendClipNode(CAnimationClip* clip, bool loop = true);
+
+		virtual ~CBlendClipNode();
+
+		virtual void init(CBlendTree* tree);
+
+		virtual void updateTime();
+
+		virtual void evaluate();
+
+		virtual f32 getPhase();
+
+		virtual void setPhase(f32 phase);
+
+		// sample the clip at the frame to the pose
+		void sample(f32 frame, CAnimationPose& pose);
+
+		inline CAnimationClip* getClip()
+		{
+			return m_clip;
+		}
+
+		inline CAnimationTimeline& getTimeline()
+		{
+			return m_timeline;
+		}
+
+		// share the sampled pose by the quantized time (see CPoseCache)
+		inline void setSharePose(bool b)
+		{
+			m_sharePose = b;
+		}
+
+		inline bool isSharePose()
+		{
+			return m_sharePose;
+		}
+	};
+}
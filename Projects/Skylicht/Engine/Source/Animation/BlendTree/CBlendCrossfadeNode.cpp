@@ -0,0 +1,119 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2023 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#include "pch.h"
+#include "CBlendCrossfadeNode.h"
+
+namespace Skylicht
+{
+	CBlendCrossfadeNode::CBlendCrossfadeNode() :
+		m_current(-1),
+		m_previous(-1),
+		m_fadeTime(0.0f),
+		m_fade(0.0f)
+	{
+
+	}
+
+	CBlendCrossfadeNode::~CBlendCrossfadeNode()
+	{
+
+	}
+
+	int CBlendCrossfadeNode::addChild(IBlendNode* node)
+	{
+		m_childs.push_back(node);
+
+		if (m_current < 0)
+			m_current = 0;
+
+		return (int)m_childs.size() - 1;
+	}
+
+	void CBlendCrossfadeNode::play(int child, f32 fadeTime, bool restart)
+	{
+		if (child < 0 || child >= (int)m_childs.size())
+			return;
+
+		if (restart)
+			m_childs[child]->setPhase(0.0f);
+
+		if (child == m_current)
+			return;
+
+		m_previous = fadeTime > 0.0f ? m_current : -1;
+		m_current = child;
+		m_fadeTime = fadeTime;
+		m_fade = 0.0f;
+	}
+
+	void CBlendCrossfadeNode::updateTime()
+	{
+		if (m_current < 0)
+			return;
+
+		m_childs[m_current]->updateTime();
+
+		if (m_previous >= 0)
+		{
+			m_childs[m_previous]->updateTime();
+
+			m_fade += getTimeStep() / 1000.0f;
+			if (m_fade >= m_fadeTime)
+				m_previous = -1;
+		}
+	}
+
+	void CBlendCrossfadeNode::evaluate()
+	{
+		if (m_current < 0)
+			return;
+
+		IBlendNode* current = m_childs[m_current];
+		current->evaluate();
+
+		if (m_previous < 0)
+		{
+			m_pose.copy(current->getPose());
+			return;
+		}
+
+		IBlendNode* previous = m_childs[m_previous];
+		previous->evaluate();
+
+		m_pose.copy(previous->getPose());
+		m_pose.blend(current->getPose(), m_fade / m_fadeTime);
+	}
+
+	f32 CBlendCrossfadeNode::getPhase()
+	{
+		return m_current >= 0 ? m_childs[m_current]->getPhase() : 0.0f;
+	}
+
+	void CBlendCrossfadeNode::setPhase(f32 phase)
+	{
+		if (m_current >= 0)
+			m_childs[m_current]->setPhase(phase);
+	}
+}
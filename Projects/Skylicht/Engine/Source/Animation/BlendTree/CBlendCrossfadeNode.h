@@ -0,0 +1,74 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2023 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#pragma once
+
+#include "IBlendNode.h"
+
+namespace Skylicht
+{
+	/// Play one of the childs, the new child is faded in from the last pose.
+	class CBlendCrossfadeNode : public IBlendNode
+	{
+	protected:
+		core::array<IBlendNode*> m_childs;
+
+		int m_current;
+
+		// the child that is faded out, -1 if no fading
+		int m_previous;
+
+		// second
+		f32 m_fadeTime;
+		f32 m_fade;
+
+	public:
+		CBlendCrossfadeNode();
+
+		virtual ~CBlendCrossfadeNode();
+
+		virtual void updateTime();
+
+		virtual void evaluate();
+
+		virtual f32 getPhase();
+
+		virtual void setPhase(f32 phase);
+
+		// return the child index
+		int addChild(IBlendNode* node);
+
+		void play(int child, f32 fadeTime, bool restart = true);
+
+		inline int getCurrent()
+		{
+			return m_current;
+		}
+
+		inline bool isFading()
+		{
+			return m_previous >= 0;
+		}
+	};
+}
@@ -0,0 +1,126 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2023 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#include "pch.h"
+#include "CBlendLayerNode.h"
+#include "CBlendClipNode.h"
+#include "CBlendTree.h"
+
+namespace Skylicht
+{
+	CBlendLayerNode::CBlendLayerNode(IBlendNode* base, IBlendNode* layer, ELayerBlend blend) :
+		m_base(base),
+		m_layer(layer),
+		m_blend(blend),
+		m_weight(1.0f),
+		m_weightParameter(-1)
+	{
+
+	}
+
+	CBlendLayerNode::~CBlendLayerNode()
+	{
+
+	}
+
+	void CBlendLayerNode::init(CBlendTree* tree)
+	{
+		IBlendNode::init(tree);
+
+		m_reference.copy(tree->getDefaultPose());
+
+		if (!m_weightName.empty())
+			m_weightParameter = tree->getParameterID(m_weightName.c_str());
+
+		m_mask.set_used(0);
+		for (SMaskBone& bone : m_maskBones)
+			tree->setMask(m_mask, bone.Name.c_str(), bone.Weight, bone.Recursive);
+	}
+
+	void CBlendLayerNode::setWeightParameter(const char* name)
+	{
+		m_weightName = name;
+
+		if (m_tree != NULL)
+			m_weightParameter = m_tree->getParameterID(name);
+	}
+
+	void CBlendLayerNode::setMask(const char* boneName, f32 weight, bool recursive)
+	{
+		SMaskBone bone;
+		bone.Name = boneName;
+		bone.Weight = weight;
+		bone.Recursive = recursive;
+		m_maskBones.push_back(bone);
+
+		if (m_tree != NULL)
+			m_tree->setMask(m_mask, boneName, weight, recursive);
+	}
+
+	void CBlendLayerNode::clearMask()
+	{
+		m_maskBones.clear();
+		m_mask.set_used(0);
+	}
+
+	void CBlendLayerNode::setReference(CBlendClipNode* clip, f32 frame)
+	{
+		clip->sample(frame, m_reference);
+	}
+
+	void CBlendLayerNode::updateTime()
+	{
+		m_base->updateTime();
+		m_layer->updateTime();
+	}
+
+	void CBlendLayerNode::evaluate()
+	{
+		m_base->evaluate();
+		m_pose.copy(m_base->getPose());
+
+		f32 weight = m_weightParameter >= 0 ? m_tree->getParameter(m_weightParameter) : m_weight;
+		if (weight <= 0.0f)
+			return;
+
+		m_layer->evaluate();
+
+		const f32* mask = m_mask.size() > 0 ? m_mask.const_pointer() : NULL;
+
+		if (m_blend == Additive)
+			m_pose.additive(m_layer->getPose(), m_reference, weight, mask);
+		else
+			m_pose.blend(m_layer->getPose(), weight, mask);
+	}
+
+	f32 CBlendLayerNode::getPhase()
+	{
+		return m_base->getPhase();
+	}
+
+	void CBlendLayerNode::setPhase(f32 phase)
+	{
+		m_base->setPhase(phase);
+	}
+}
@@ -0,0 +1,101 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2023 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#pragma once
+
+#include "IBlendNode.h"
+
+namespace Skylicht
+{
+	class CBlendClipNode;
+
+	/// Blend the layer on the base pose: override (lerp) or additive, the weight of bone is scaled by the mask.
+	class CBlendLayerNode : public IBlendNode
+	{
+	public:
+		enum ELayerBlend
+		{
+			Override = 0,
+			Additive
+		};
+
+	protected:
+		IBlendNode* m_base;
+		IBlendNode* m_layer;
+
+		ELayerBlend m_blend;
+
+		f32 m_weight;
+
+		std::string m_weightName;
+		int m_weightParameter;
+
+		struct SMaskBone
+		{
+			std::string Name;
+			f32 Weight;
+			bool Recursive;
+		};
+
+		// the mask is built when the node is added to the tree
+		std::vector<SMaskBone> m_maskBones;
+
+		// the weight of bones, empty is all bones
+		core::array<f32> m_mask;
+
+		// the additive layer is the difference from this pose (default: the bone transform that has no animation)
+		CAnimationPose m_reference;
+
+	public:
+		CBlendLayerNode(IBlendNode* base, IBlendNode* layer, ELayerBlend blend = Override);
+
+		virtual ~CBlendLayerNode();
+
+		virtual void init(CBlendTree* tree);
+
+		virtual void updateTime();
+
+		virtual void evaluate();
+
+		virtual f32 getPhase();
+
+		virtual void setPhase(f32 phase);
+
+		inline void setWeight(f32 weight)
+		{
+			m_weight = weight;
+		}
+
+		// the weight is read from the tree parameter
+		void setWeightParameter(const char* name);
+
+		// the bone (and its childs) is blended by the weight
+		void setMask(const char* boneName, f32 weight = 1.0f, bool recursive = true);
+
+		void clearMask();
+
+		// the reference pose of additive layer is the clip at frame
+		void setReference(CBlendClipNode* clip, f32 frame);
+	};
+}
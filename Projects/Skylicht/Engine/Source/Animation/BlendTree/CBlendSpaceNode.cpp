@@ -0,0 +1,206 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2023 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#include "pch.h"
+#include "CBlendSpaceNode.h"
+#include "CBlendTree.h"
+
+namespace Skylicht
+{
+	CBlendSpaceNode::CBlendSpaceNode(const char* parameterX, const char* parameterY) :
+		m_dimension(parameterY != NULL ? 2 : 1),
+		m_sync(true)
+	{
+		m_parameterName[0] = parameterX;
+		if (parameterY != NULL)
+			m_parameterName[1] = parameterY;
+
+		m_parameter[0] = -1;
+		m_parameter[1] = -1;
+	}
+
+	CBlendSpaceNode::~CBlendSpaceNode()
+	{
+
+	}
+
+	void CBlendSpaceNode::init(CBlendTree* tree)
+	{
+		IBlendNode::init(tree);
+
+		for (u32 i = 0; i < m_dimension; i++)
+			m_parameter[i] = tree->getParameterID(m_parameterName[i].c_str());
+	}
+
+	void CBlendSpaceNode::addChild(IBlendNode* node, f32 x, f32 y)
+	{
+		SBlendChild child;
+		child.Node = node;
+		child.Position.set(x, m_dimension == 2 ? y : 0.0f);
+		child.Weight = 0.0f;
+
+		// the 1D childs are sorted by position
+		u32 i = 0;
+		if (m_dimension == 1)
+		{
+			while (i < m_childs.size() && m_childs[i].Position.X < x)
+				i++;
+		}
+		else
+		{
+			i = m_childs.size();
+		}
+
+		m_childs.insert(child, i);
+	}
+
+	void CBlendSpaceNode::updateWeights()
+	{
+		u32 numChild = m_childs.size();
+		if (numChild == 0)
+			return;
+
+		for (u32 i = 0; i < numChild; i++)
+			m_childs[i].Weight = 0.0f;
+
+		if (m_dimension == 1)
+		{
+			f32 x = m_tree->getParameter(m_parameter[0]);
+
+			if (x <= m_childs[0].Position.X)
+			{
+				m_childs[0].Weight = 1.0f;
+				return;
+			}
+
+			for (u32 i = 1; i < numChild; i++)
+			{
+				f32 x0 = m_childs[i - 1].Position.X;
+				f32 x1 = m_childs[i].Position.X;
+
+				if (x <= x1)
+				{
+					f32 t = x1 > x0 ? (x - x0) / (x1 - x0) : 1.0f;
+					m_childs[i - 1].Weight = 1.0f - t;
+					m_childs[i].Weight = t;
+					return;
+				}
+			}
+
+			m_childs[numChild - 1].Weight = 1.0f;
+		}
+		else
+		{
+			core::vector2df p(m_tree->getParameter(m_parameter[0]), m_tree->getParameter(m_parameter[1]));
+
+			f32 sum = 0.0f;
+			for (u32 i = 0; i < numChild; i++)
+			{
+				f32 d = m_childs[i].Position.getDistanceFromSQ(p);
+
+				// on the child position
+				if (d < 0.000001f)
+				{
+					for (u32 j = 0; j < numChild; j++)
+						m_childs[j].Weight = 0.0f;
+					m_childs[i].Weight = 1.0f;
+					return;
+				}
+
+				m_childs[i].Weight = 1.0f / d;
+				sum += m_childs[i].Weight;
+			}
+
+			for (u32 i = 0; i < numChild; i++)
+				m_childs[i].Weight /= sum;
+		}
+	}
+
+	IBlendNode* CBlendSpaceNode::getHeaviestChild()
+	{
+		IBlendNode* node = NULL;
+		f32 maxWeight = -1.0f;
+
+		for (u32 i = 0, n = m_childs.size(); i < n; i++)
+		{
+			if (m_childs[i].Weight > maxWeight)
+			{
+				maxWeight = m_childs[i].Weight;
+				node = m_childs[i].Node;
+			}
+		}
+
+		return node;
+	}
+
+	void CBlendSpaceNode::updateTime()
+	{
+		updateWeights();
+
+		for (u32 i = 0, n = m_childs.size(); i < n; i++)
+			m_childs[i].Node->updateTime();
+
+		if (m_sync)
+		{
+			IBlendNode* base = getHeaviestChild();
+			if (base != NULL)
+				setPhase(base->getPhase());
+		}
+	}
+
+	void CBlendSpaceNode::evaluate()
+	{
+		f32 sum = 0.0f;
+
+		for (u32 i = 0, n = m_childs.size(); i < n; i++)
+		{
+			SBlendChild& child = m_childs[i];
+
+			// skip the child that has no weight
+			if (child.Weight < 0.001f)
+				continue;
+
+			child.Node->evaluate();
+
+			// the weighted average by the chain of lerp
+			sum += child.Weight;
+			if (sum == child.Weight)
+				m_pose.copy(child.Node->getPose());
+			else
+				m_pose.blend(child.Node->getPose(), child.Weight / sum);
+		}
+	}
+
+	f32 CBlendSpaceNode::getPhase()
+	{
+		IBlendNode* base = getHeaviestChild();
+		return base != NULL ? base->getPhase() : 0.0f;
+	}
+
+	void CBlendSpaceNode::setPhase(f32 phase)
+	{
+		for (u32 i = 0, n = m_childs.size(); i < n; i++)
+			m_childs[i].Node->setPhase(phase);
+	}
+}
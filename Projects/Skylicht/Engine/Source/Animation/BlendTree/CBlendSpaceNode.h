@@ -0,0 +1,92 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2023 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#pragma once
+
+#include "IBlendNode.h"
+
+namespace Skylicht
+{
+	/// Blend the childs by the distance of the parameters (x) or (x, y) to the child positions,
+	/// 1D: lerp the 2 nearest childs, 2D: inverse distance weights.
+	class CBlendSpaceNode : public IBlendNode
+	{
+	protected:
+		struct SBlendChild
+		{
+			IBlendNode* Node;
+			core::vector2df Position;
+			f32 Weight;
+		};
+
+		core::array<SBlendChild> m_childs;
+
+		std::string m_parameterName[2];
+		int m_parameter[2];
+
+		u32 m_dimension;
+
+		// sync the normalized time of the childs to the heaviest child
+		bool m_sync;
+
+	public:
+		// the 1D blend space if parameterY is NULL
+		CBlendSpaceNode(const char* parameterX, const char* parameterY = NULL);
+
+		virtual ~CBlendSpaceNode();
+
+		virtual void init(CBlendTree* tree);
+
+		virtual void updateTime();
+
+		virtual void evaluate();
+
+		virtual f32 getPhase();
+
+		virtual void setPhase(f32 phase);
+
+		void addChild(IBlendNode* node, f32 x, f32 y = 0.0f);
+
+		inline void setSync(bool b)
+		{
+			m_sync = b;
+		}
+
+		inline u32 getNumChild()
+		{
+			return m_childs.size();
+		}
+
+		inline f32 getWeight(u32 child)
+		{
+			return m_childs[child].Weight;
+		}
+
+	protected:
+
+		void updateWeights();
+
+		IBlendNode* getHeaviestChild();
+	};
+}
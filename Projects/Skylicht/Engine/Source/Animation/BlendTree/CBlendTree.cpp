@@ -0,0 +1,136 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2023 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#include "pch.h"
+#include "CBlendTree.h"
+#include "Animation/Skeleton/CSkeleton.h"
+
+namespace Skylicht
+{
+	CBlendTree::CBlendTree(CSkeleton* skeleton) :
+		m_root(NULL)
+	{
+		std::vector<CAnimationTransformData*>& bones = skeleton->getEntitiesData();
+		u32 numBone = (u32)bones.size();
+
+		m_defaultPose.init(numBone);
+
+		std::map<int, int> entityToBone;
+		for (u32 i = 0; i < numBone; i++)
+			entityToBone[bones[i]->EntityIndex] = (int)i;
+
+		for (u32 i = 0; i < numBone; i++)
+		{
+			CAnimationTransformData* bone = bones[i];
+			m_boneNames.push_back(bone->Name);
+
+			std::map<int, int>::iterator parent = entityToBone.find(bone->ParentID);
+			m_boneParents.push_back(parent != entityToBone.end() ? parent->second : -1);
+
+			m_defaultPose.setBone(i, bone->DefaultPosition, bone->DefaultScale, bone->DefaultRotation);
+		}
+	}
+
+	CBlendTree::~CBlendTree()
+	{
+		for (u32 i = 0, n = m_nodes.size(); i < n; i++)
+			delete m_nodes[i];
+		m_nodes.clear();
+	}
+
+	int CBlendTree::getParameterID(const char* name)
+	{
+		for (u32 i = 0, n = (u32)m_parameterNames.size(); i < n; i++)
+		{
+			if (m_parameterNames[i] == name)
+				return (int)i;
+		}
+
+		m_parameterNames.push_back(name);
+		m_parameters.push_back(0.0f);
+		return (int)m_parameters.size() - 1;
+	}
+
+	void CBlendTree::setParameter(const char* name, f32 value)
+	{
+		setParameter(getParameterID(name), value);
+	}
+
+	int CBlendTree::getBoneID(const char* name)
+	{
+		for (u32 i = 0, n = (u32)m_boneNames.size(); i < n; i++)
+		{
+			if (m_boneNames[i] == name)
+				return (int)i;
+		}
+		return -1;
+	}
+
+	void CBlendTree::setMask(core::array<f32>& mask, const char* boneName, f32 weight, bool recursive)
+	{
+		u32 stride = m_defaultPose.getStride();
+		if (mask.size() != stride)
+		{
+			mask.set_used(stride);
+			memset(mask.pointer(), 0, stride * sizeof(f32));
+		}
+
+		int root = getBoneID(boneName);
+		if (root < 0)
+			return;
+
+		mask[root] = weight;
+
+		if (!recursive)
+			return;
+
+		// the parent bone is created before its childs (see CSkeleton::initSkeleton)
+		core::array<bool> inside;
+		inside.set_used(m_boneParents.size());
+
+		for (u32 i = 0, n = m_boneParents.size(); i < n; i++)
+		{
+			int parent = m_boneParents[i];
+			inside[i] = (int)i == root || (parent >= 0 && parent < (int)i && inside[parent]);
+
+			if (inside[i])
+				mask[i] = weight;
+		}
+	}
+
+	void CBlendTree::updateTime()
+	{
+		if (m_root != NULL)
+			m_root->updateTime();
+	}
+
+	CAnimationPose* CBlendTree::evaluate()
+	{
+		if (m_root == NULL)
+			return NULL;
+
+		m_root->evaluate();
+		return &m_root->getPose();
+	}
+}
@@ -0,0 +1,118 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2023 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#pragma once
+
+#include "IBlendNode.h"
+
+namespace Skylicht
+{
+	class CSkeleton;
+
+	/// The blend tree of a skeleton: the nodes (clips, blend spaces, layers, crossfades) blend the SoA poses of all bones,
+	/// so the blend targets do not need their own skeleton & entities.
+	class CBlendTree
+	{
+	protected:
+		std::vector<std::string> m_boneNames;
+
+		// the parent bone index, -1 is the root
+		core::array<int> m_boneParents;
+
+		CAnimationPose m_defaultPose;
+
+		std::vector<std::string> m_parameterNames;
+		core::array<f32> m_parameters;
+
+		core::array<IBlendNode*> m_nodes;
+
+		IBlendNode* m_root;
+
+	public:
+		CBlendTree(CSkeleton* skeleton);
+
+		virtual ~CBlendTree();
+
+		// the tree owns the node
+		template<class T>
+		T* addNode(T* node)
+		{
+			m_nodes.push_back(node);
+			node->init(this);
+			return node;
+		}
+
+		inline void setRoot(IBlendNode* node)
+		{
+			m_root = node;
+		}
+
+		inline IBlendNode* getRoot()
+		{
+			return m_root;
+		}
+
+		// the id of parameter, it is added if not exists
+		int getParameterID(const char* name);
+
+		void setParameter(const char* name, f32 value);
+
+		inline void setParameter(int id, f32 value)
+		{
+			m_parameters[id] = value;
+		}
+
+		inline f32 getParameter(int id)
+		{
+			return m_parameters[id];
+		}
+
+		inline u32 getNumBone()
+		{
+			return (u32)m_boneNames.size();
+		}
+
+		inline const std::string& getBoneName(u32 bone)
+		{
+			return m_boneNames[bone];
+		}
+
+		// -1 if not found
+		int getBoneID(const char* name);
+
+		// the bone transform that has no animation
+		inline CAnimationPose& getDefaultPose()
+		{
+			return m_defaultPose;
+		}
+
+		// set the weight of the bone (and its childs) on the mask, the mask has getStride() floats
+		void setMask(core::array<f32>& mask, const char* boneName, f32 weight, bool recursive = true);
+
+		void updateTime();
+
+		// NULL if there is no root node
+		CAnimationPose* evaluate();
+	};
+}
@@ -26,6 +26,8 @@ https://github.com/skylicht-lab/skylicht-engine
 
 #include "pch.h"
 #include "CAnimationTrack.h"
+#include "CPoseSampler.h"
+#include "CPoseCache.h"
 
 namespace Skylicht
 {
@@ -45,11 +47,24 @@ namespace Skylicht
 		std::vector<SEntityAnim*> AnimInfo;
 		std::map<std::string, SEntityAnim*> AnimNameToInfo;
 
+	protected:
+		// the uniform pose cache, that is shared by all skeletons play this clip
+		CPoseSampler* m_poseSampler;
+		CPoseCache* m_poseCache;
+		bool m_buildPoseSampler;
+		bool m_usePoseSampler;
+
+	public:
 		CAnimationClip()
 		{
 			AnimName = "";
 			Duration = 0.0f;
 			Loop = true;
+
+			m_poseSampler = NULL;
+			m_poseCache = NULL;
+			m_buildPoseSampler = true;
+			m_usePoseSampler = false;
 		}
 
 		virtual ~CAnimationClip()
@@ -65,10 +80,70 @@ namespace Skylicht
 			}
 			AnimInfo.clear();
 			AnimNameToInfo.clear();
+
+			releasePoseSampler();
+		}
+
+		void releasePoseSampler()
+		{
+			if (m_poseCache != NULL)
+				delete m_poseCache;
+
+			if (m_poseSampler != NULL)
+				delete m_poseSampler;
+
+			m_poseCache = NULL;
+			m_poseSampler = NULL;
+			m_buildPoseSampler = true;
+		}
+
+		// the clip that is played by many skeletons (crowd) should use the pose sampler
+		// note: the sampled table is numFrame * 10 * stride * 4 bytes (~720KB for 300 frames & 60 bones)
+		void enablePoseSampler(bool b)
+		{
+			m_usePoseSampler = b;
+			if (!b)
+				releasePoseSampler();
+		}
+
+		bool isEnablePoseSampler()
+		{
+			return m_usePoseSampler;
+		}
+
+		// NULL if the pose sampler is not enabled or the keys are not on the integer frames
+		CPoseSampler* getPoseSampler()
+		{
+			if (!m_usePoseSampler)
+				return NULL;
+
+			if (m_buildPoseSampler)
+			{
+				m_buildPoseSampler = false;
+
+				CPoseSampler* sampler = new CPoseSampler();
+				if (sampler->build(this))
+					m_poseSampler = sampler;
+				else
+					delete sampler;
+			}
+
+			return m_poseSampler;
+		}
+
+		// the poses that are shared by the skeletons, NULL if the clip has no pose sampler
+		CPoseCache* getPoseCache()
+		{
+			if (m_poseCache == NULL && getPoseSampler() != NULL)
+				m_poseCache = new CPoseCache(m_poseSampler);
+
+			return m_poseCache;
 		}
 
 		void addAnim(SEntityAnim* anim)
 		{
+			releasePoseSampler();
+
 			for (SEntityAnim *&i : AnimInfo)
 			{
 				if (i->Name == anim->Name)
@@ -0,0 +1,319 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2023 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#include "pch.h"
+#include "CAnimationCompressor.h"
+#include "CAnimationTrack.h"
+
+namespace Skylicht
+{
+	CAnimationCompressor::CAnimationCompressor() :
+		m_positionError(0.001f),
+		m_rotationError(0.001f),
+		m_scaleError(0.001f)
+	{
+
+	}
+
+	CAnimationCompressor::~CAnimationCompressor()
+	{
+
+	}
+
+	void CAnimationCompressor::compressClip(CAnimationClip* clip)
+	{
+		for (SEntityAnim* anim : clip->AnimInfo)
+			compressData(&anim->Data);
+	}
+
+	void CAnimationCompressor::compressData(CAnimationData* data)
+	{
+		if (data->Compressed)
+			return;
+
+		compressVectorKeys(data->Positions, data->QuantizedPositions, m_positionError);
+		compressVectorKeys(data->Scales, data->QuantizedScales, m_scaleError);
+		compressQuaternionKeys(data->Rotations, data->QuantizedRotations, m_rotationError);
+
+		// just keep the default value
+		data->Positions.Data.clear();
+		data->Rotations.Data.clear();
+		data->Scales.Data.clear();
+
+		data->Compressed = true;
+	}
+
+	u32 CAnimationCompressor::getKeyMemory(CAnimationClip* clip)
+	{
+		u32 bytes = 0;
+
+		for (SEntityAnim* anim : clip->AnimInfo)
+		{
+			CAnimationData& data = anim->Data;
+
+			bytes += data.Positions.size() * sizeof(CPositionKey);
+			bytes += data.Rotations.size() * sizeof(CRotationKey);
+			bytes += data.Scales.size() * sizeof(CScaleKey);
+
+			bytes += data.QuantizedPositions.size() * sizeof(SQuantizedKey);
+			bytes += data.QuantizedRotations.size() * sizeof(SQuantizedKey);
+			bytes += data.QuantizedScales.size() * sizeof(SQuantizedKey);
+		}
+
+		return bytes;
+	}
+
+	void CAnimationCompressor::compressVectorKeys(CArrayKeyFrame<core::vector3df>& keys, CQuantizedKeyFrame& out, f32 error)
+	{
+		out.Data.clear();
+		out.clearHint();
+
+		u32 numKey = keys.size();
+		if (numKey == 0)
+			return;
+
+		CKeyFrameData<core::vector3df>* k = keys.pointer();
+
+		// the max speed of track, the frame quantization moves the key in time
+		core::aabbox3df range(k[0].Value);
+		f32 speed = 0.0f;
+
+		for (u32 i = 1; i < numKey; i++)
+		{
+			range.addInternalPoint(k[i].Value);
+
+			f32 d = k[i].Frame - k[i - 1].Frame;
+			if (d > 0.0f)
+				speed = core::max_(speed, k[i].Value.getDistanceFrom(k[i - 1].Value) / d);
+		}
+
+		f32 frameStep = (k[numKey - 1].Frame - k[0].Frame) / 65535.0f;
+
+		// the rounding of the values & the frames is in the error, the key reduction uses the rest
+		f32 quantizeError = 0.5f * range.getExtent().getLength() / 65535.0f + 0.5f * speed * frameStep;
+		f32 keyError = core::max_(error - quantizeError, 0.0f);
+
+		core::array<u32> keep;
+
+		// constant track, the value of 1 key is exact
+		bool constant = true;
+		for (u32 i = 1; i < numKey && constant; i++)
+			constant = k[i].Value.getDistanceFrom(k[0].Value) <= error;
+
+		if (constant)
+			keep.push_back(0);
+		else
+		{
+			// greedy: extend the segment from the last kept key while the removed keys are in the error
+			u32 last = 0;
+			keep.push_back(0);
+
+			for (u32 j = 2; j < numKey; j++)
+			{
+				bool valid = true;
+
+				for (u32 i = last + 1; i < j && valid; i++)
+				{
+					f32 d = k[j].Frame - k[last].Frame;
+					f32 t = d > 0.0f ? (k[i].Frame - k[last].Frame) / d : 0.0f;
+					core::vector3df v = k[last].Value + (k[j].Value - k[last].Value) * t;
+					valid = v.getDistanceFrom(k[i].Value) <= keyError;
+				}
+
+				if (!valid)
+				{
+					last = j - 1;
+					keep.push_back(last);
+				}
+			}
+
+			if (numKey > 1)
+				keep.push_back(numKey - 1);
+		}
+
+		// range of value
+		core::aabbox3df box(k[keep[0]].Value);
+		for (u32 i = 1, n = keep.size(); i < n; i++)
+			box.addInternalPoint(k[keep[i]].Value);
+
+		out.Min = box.MinEdge;
+		out.Extent = box.MaxEdge - box.MinEdge;
+
+		core::array<f32> frames;
+		for (u32 i = 0, n = keep.size(); i < n; i++)
+			frames.push_back(k[keep[i]].Frame);
+
+		// the constant track keeps the duration
+		if (constant)
+			frames[0] = k[numKey - 1].Frame;
+
+		quantizeFrames(frames, out);
+
+		for (u32 i = 0, n = keep.size(); i < n; i++)
+		{
+			const core::vector3df& v = k[keep[i]].Value;
+			u16* q = out.Data[i].Value;
+
+			q[0] = out.Extent.X > 0.0f ? (u16)core::round32((v.X - out.Min.X) / out.Extent.X * 65535.0f) : 0;
+			q[1] = out.Extent.Y > 0.0f ? (u16)core::round32((v.Y - out.Min.Y) / out.Extent.Y * 65535.0f) : 0;
+			q[2] = out.Extent.Z > 0.0f ? (u16)core::round32((v.Z - out.Min.Z) / out.Extent.Z * 65535.0f) : 0;
+		}
+	}
+
+	void CAnimationCompressor::compressQuaternionKeys(CArrayKeyFrame<core::quaternion>& keys, CQuantizedKeyFrame& out, f32 error)
+	{
+		out.Data.clear();
+		out.clearHint();
+
+		u32 numKey = keys.size();
+		if (numKey == 0)
+			return;
+
+		CKeyFrameData<core::quaternion>* k = keys.pointer();
+
+		// the max angular speed of track, the frame quantization moves the key in time
+		f32 speed = 0.0f;
+
+		for (u32 i = 1; i < numKey; i++)
+		{
+			f32 d = k[i].Frame - k[i - 1].Frame;
+			if (d > 0.0f)
+			{
+				f32 dot = core::clamp(fabsf(k[i].Value.dotProduct(k[i - 1].Value)), 0.0f, 1.0f);
+				speed = core::max_(speed, 2.0f * acosf(dot) / d);
+			}
+		}
+
+		f32 frameStep = (k[numKey - 1].Frame - k[0].Frame) / 65535.0f;
+
+		// the smallest three rounds 3 components to the half of 15 bits step, the rebuilt largest component
+		// doubles it at most, so the angle is in 4 steps
+		f32 quantizeError = 4.0f * 1.41421356f / 32767.0f + 0.5f * speed * frameStep;
+		f32 keyError = core::max_(error - quantizeError, 0.0f);
+
+		// the angle between 2 rotations is in the error
+		f32 minDot = cosf(keyError * 0.5f);
+
+		core::array<u32> keep;
+
+		bool constant = true;
+		for (u32 i = 1; i < numKey && constant; i++)
+			constant = fabsf(k[i].Value.dotProduct(k[0].Value)) >= minDot;
+
+		if (constant)
+			keep.push_back(0);
+		else
+		{
+			u32 last = 0;
+			keep.push_back(0);
+
+			for (u32 j = 2; j < numKey; j++)
+			{
+				bool valid = true;
+
+				for (u32 i = last + 1; i < j && valid; i++)
+				{
+					f32 d = k[j].Frame - k[last].Frame;
+					f32 t = d > 0.0f ? (k[i].Frame - k[last].Frame) / d : 0.0f;
+
+					core::quaternion q;
+					CAnimationTrack::quaternionSlerp(q, k[last].Value, k[j].Value, t);
+					q.normalize();
+
+					valid = fabsf(q.dotProduct(k[i].Value)) >= minDot;
+				}
+
+				if (!valid)
+				{
+					last = j - 1;
+					keep.push_back(last);
+				}
+			}
+
+			if (numKey > 1)
+				keep.push_back(numKey - 1);
+		}
+
+		core::array<f32> frames;
+		for (u32 i = 0, n = keep.size(); i < n; i++)
+			frames.push_back(k[keep[i]].Frame);
+
+		if (constant)
+			frames[0] = k[numKey - 1].Frame;
+
+		quantizeFrames(frames, out);
+
+		for (u32 i = 0, n = keep.size(); i < n; i++)
+			quantizeQuaternion(k[keep[i]].Value, out.Data[i].Value);
+	}
+
+	void CAnimationCompressor::quantizeFrames(core::array<f32>& frames, CQuantizedKeyFrame& out)
+	{
+		u32 numKey = frames.size();
+
+		out.FrameStart = frames[0];
+		out.FrameStep = 1.0f;
+
+		f32 range = frames[numKey - 1] - frames[0];
+		if (range > 0.0f)
+			out.FrameStep = range / 65535.0f;
+
+		out.Data.set_used(numKey);
+		for (u32 i = 0; i < numKey; i++)
+			out.Data[i].Frame = (u16)core::round32((frames[i] - out.FrameStart) / out.FrameStep);
+	}
+
+	void CAnimationCompressor::quantizeQuaternion(const core::quaternion& rotation, u16* out)
+	{
+		core::quaternion r = rotation;
+		r.normalize();
+
+		f32 c[4] = { r.X, r.Y, r.Z, r.W };
+
+		int largest = 0;
+		for (int i = 1; i < 4; i++)
+		{
+			if (fabsf(c[i]) > fabsf(c[largest]))
+				largest = i;
+		}
+
+		// q & -q are the same rotation, the largest component is rebuilt as positive
+		f32 sign = c[largest] < 0.0f ? -1.0f : 1.0f;
+
+		int j = 0;
+		for (int i = 0; i < 4; i++)
+		{
+			if (i == largest)
+				continue;
+
+			// [-1/sqrt(2), 1/sqrt(2)] to [0, 32767]
+			f32 v = (c[i] * sign + 0.70710678f) / 1.41421356f;
+			v = core::clamp(v, 0.0f, 1.0f);
+			out[j++] = (u16)core::round32(v * 32767.0f);
+		}
+
+		out[0] |= (u16)((largest & 1) << 15);
+		out[1] |= (u16)((largest >> 1) << 15);
+	}
+}
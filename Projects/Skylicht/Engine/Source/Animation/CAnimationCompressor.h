@@ -0,0 +1,97 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2023 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#pragma once
+
+#include "CAnimationClip.h"
+
+namespace Skylicht
+{
+	/// Convert the float keys of clip to the quantized keys:
+	/// the keys that the linear interpolation can rebuild (in the error) are removed,
+	/// the constant track keeps 1 key, the rotation is packed by smallest three and the position & scale are range quantized.
+	/// The error includes the u16 quantization of the values & frames, if it is smaller than the quantization no key is removed
+	class CAnimationCompressor
+	{
+	protected:
+		f32 m_positionError;
+		f32 m_rotationError;
+		f32 m_scaleError;
+
+	public:
+		CAnimationCompressor();
+
+		virtual ~CAnimationCompressor();
+
+		// the max distance of the compressed position to the source
+		inline void setPositionError(f32 e)
+		{
+			m_positionError = e;
+		}
+
+		inline f32 getPositionError()
+		{
+			return m_positionError;
+		}
+
+		// the max angle (radian) of the compressed rotation to the source
+		inline void setRotationError(f32 e)
+		{
+			m_rotationError = e;
+		}
+
+		inline f32 getRotationError()
+		{
+			return m_rotationError;
+		}
+
+		inline void setScaleError(f32 e)
+		{
+			m_scaleError = e;
+		}
+
+		inline f32 getScaleError()
+		{
+			return m_scaleError;
+		}
+
+		// compress all tracks of the clip, the float keys are released
+		void compressClip(CAnimationClip* clip);
+
+		void compressData(CAnimationData* data);
+
+		// the memory of keys in bytes
+		static u32 getKeyMemory(CAnimationClip* clip);
+
+		static void quantizeQuaternion(const core::quaternion& q, u16* out);
+
+	protected:
+
+		void compressVectorKeys(CArrayKeyFrame<core::vector3df>& keys, CQuantizedKeyFrame& out, f32 error);
+
+		void compressQuaternionKeys(CArrayKeyFrame<core::quaternion>& keys, CQuantizedKeyFrame& out, f32 error);
+
+		void quantizeFrames(core::array<f32>& frames, CQuantizedKeyFrame& out);
+	};
+}
@@ -25,15 +25,25 @@ https://github.com/skylicht-lab/skylicht-engine
 #include "pch.h"
 #include "GameObject/CGameObject.h"
 #include "CAnimationController.h"
+#include "Animation/BlendTree/CBlendTree.h"
 
 #include "RenderMesh/CRenderMesh.h"
+#include "Camera/CCamera.h"
+#include "Entity/CEntityManager.h"
 
 namespace Skylicht
 {
+	bool CAnimationController::s_enableLOD = false;
+	u32 CAnimationController::s_lodPhase = 0;
+
 	CAnimationController::CAnimationController() :
-		m_output(NULL)
+		m_output(NULL),
+		m_cullingChangedID(0xFFFFFFFF),
+		m_lod(-1),
+		m_culled(false)
 	{
-
+		// spread the updates of the crowd on the frames
+		m_frameCount = s_lodPhase++;
 	}
 
 	CAnimationController::~CAnimationController()
@@ -54,22 +64,177 @@ namespace Skylicht
 				skeleton->getTimeline().update();
 		}
 
+		for (CSkeleton *&skeleton : m_skeletons)
+		{
+			if (skeleton->isEnable() == true && skeleton->getAnimationType() == CSkeleton::BlendTree && skeleton->getBlendTree() != NULL)
+				skeleton->getBlendTree()->updateTime();
+		}
+
 		for (CSkeleton *&skeleton : m_skeletons)
 		{
 			if (skeleton->isEnable() == true && skeleton->getAnimationType() == CSkeleton::Blending)
 				skeleton->syncAnimationByTimeScale();
 		}
 
+		int maxDepth = -1;
+		u32 updateFrames = 1;
+		bool interpolate = false;
+		bool rootMotion = false;
+
+		if (s_enableLOD)
+		{
+			updateCullingData();
+			updateLOD();
+
+			if (m_culled)
+			{
+				// keep the root motion
+				rootMotion = true;
+			}
+			else if (m_lod >= 0)
+			{
+				SAnimationLOD& lod = m_lods[m_lod];
+				updateFrames = core::max_(lod.UpdateFrames, 1u);
+				maxDepth = lod.MaxDepth;
+				interpolate = lod.Interpolate && updateFrames > 1;
+			}
+		}
+		else
+		{
+			m_lod = -1;
+			m_culled = false;
+		}
+
+		u32 frame = m_frameCount++ % updateFrames;
+		bool evaluate = frame == 0;
+
+		// the bones keep the last pose
+		if (!evaluate && !interpolate)
+			return;
+
 		for (CSkeleton *&skeleton : m_skeletons)
 		{
-			if (skeleton->isEnable() == true)
+			skeleton->setLODDepth(maxDepth);
+			skeleton->setLODRootMotion(rootMotion);
+		}
+
+		if (evaluate)
+		{
+			if (interpolate && m_output != NULL)
+				m_output->storeLastPose();
+
+			for (CSkeleton *&skeleton : m_skeletons)
 			{
-				skeleton->update();
+				if (skeleton->isEnable() == true)
+				{
+					skeleton->update();
+				}
 			}
 		}
 
 		if (m_output != NULL)
-			m_output->applyTransform();
+		{
+			if (interpolate)
+				m_output->applyTransform((frame + 1) / (float)updateFrames);
+			else
+				m_output->applyTransform();
+		}
+	}
+
+	void CAnimationController::addLOD(float screenSize, u32 updateFrames, int maxDepth, bool interpolate)
+	{
+		SAnimationLOD lod;
+		lod.ScreenSize = screenSize;
+		lod.UpdateFrames = updateFrames;
+		lod.MaxDepth = maxDepth;
+		lod.Interpolate = interpolate;
+
+		u32 i = 0;
+		while (i < m_lods.size() && m_lods[i].ScreenSize > screenSize)
+			i++;
+
+		m_lods.insert(lod, i);
+	}
+
+	void CAnimationController::clearLOD()
+	{
+		m_lods.set_used(0);
+		m_lod = -1;
+	}
+
+	void CAnimationController::initCullingData(CRenderMesh* renderMesh)
+	{
+		core::array<CEntity*>& entities = renderMesh->getEntities();
+
+		m_cullings.set_used(0);
+		for (u32 i = 0, n = entities.size(); i < n; i++)
+		{
+			CCullingData* culling = GET_ENTITY_DATA(entities[i], CCullingData);
+			if (culling != NULL)
+				m_cullings.push_back(culling);
+		}
+
+		m_cullingChangedID = renderMesh->getEntitiesChangedID();
+	}
+
+	void CAnimationController::updateCullingData()
+	{
+		// the render mesh is reloaded, the culling data is released with its entities
+		CRenderMesh* renderMesh = m_gameObject->getComponent<CRenderMesh>();
+		if (renderMesh != NULL && renderMesh->getEntitiesChangedID() != m_cullingChangedID)
+			initCullingData(renderMesh);
+	}
+
+	void CAnimationController::updateLOD()
+	{
+		m_lod = -1;
+		m_culled = false;
+
+		if (m_cullings.size() == 0)
+			return;
+
+		// the result of the culling on the last frame
+		bool visible = false;
+		core::aabbox3df box;
+
+		for (u32 i = 0, n = m_cullings.size(); i < n; i++)
+		{
+			CCullingData* culling = m_cullings[i];
+			if (culling->Visible || culling->ViewMask != 0)
+				visible = true;
+
+			if (i == 0)
+				box = culling->BBox;
+			else
+				box.addInternalBox(culling->BBox);
+		}
+
+		if (!visible)
+		{
+			m_culled = true;
+			return;
+		}
+
+		if (m_lods.size() == 0)
+			return;
+
+		CCamera* camera = m_gameObject->getEntityManager()->getCamera();
+		if (camera == NULL || camera->getProjectionType() != CCamera::Perspective)
+			return;
+
+		float radius = box.getExtent().getLength() * 0.5f;
+		float distance = camera->getGameObject()->getPosition().getDistanceFrom(box.getCenter());
+		if (radius <= 0.0f || distance <= radius)
+			return;
+
+		// the height of bounding sphere on screen
+		float screenSize = radius / (distance * tanf(camera->getFOV() * 0.5f * core::DEGTORAD));
+
+		for (u32 i = 0, n = m_lods.size(); i < n; i++)
+		{
+			if (screenSize < m_lods[i].ScreenSize)
+				m_lod = (int)i;
+		}
 	}
 
 	CSkeleton* CAnimationController::createSkeleton()
@@ -80,7 +245,10 @@ namespace Skylicht
 
 		CRenderMesh *renderMesh = m_gameObject->getComponent<CRenderMesh>();
 		if (renderMesh != NULL)
+		{
 			skeleton->initSkeleton(renderMesh->getEntities());
+			initCullingData(renderMesh);
+		}
 
 		m_skeletons.push_back(skeleton);
 
@@ -97,6 +265,8 @@ namespace Skylicht
 			delete skeleton;
 		}
 		m_skeletons.clear();
+		m_cullings.set_used(0);
+		m_cullingChangedID = 0xFFFFFFFF;
 		m_output = NULL;
 	}
 }
\ No newline at end of file
@@ -26,9 +26,27 @@ https://github.com/skylicht-lab/skylicht-engine
 
 #include "Skeleton/CSkeleton.h"
 #include "Components/CComponentSystem.h"
+#include "Culling/CCullingData.h"
 
 namespace Skylicht
 {
+	class CRenderMesh;
+
+	struct SAnimationLOD
+	{
+		// use this LOD if the height of object on screen (0 - 1) is smaller
+		float ScreenSize;
+
+		// evaluate the animation once per frames
+		u32 UpdateFrames;
+
+		// the bones deeper than this depth keep the last pose, -1 is all bones
+		int MaxDepth;
+
+		// interpolate the pose on the frames between the updates
+		bool Interpolate;
+	};
+
 	class CAnimationController : public CComponentSystem
 	{
 	protected:
@@ -36,6 +54,20 @@ namespace Skylicht
 
 		CSkeleton* m_output;
 
+		// sorted by the descending screen size
+		core::array<SAnimationLOD> m_lods;
+
+		// the culling of render mesh, to check visible & screen size
+		core::array<CCullingData*> m_cullings;
+		u32 m_cullingChangedID;
+
+		int m_lod;
+		bool m_culled;
+		u32 m_frameCount;
+
+		static bool s_enableLOD;
+		static u32 s_lodPhase;
+
 	public:
 		CAnimationController();
 
@@ -65,5 +97,40 @@ namespace Skylicht
 		{
 			m_output = skeleton;
 		}
+
+		void addLOD(float screenSize, u32 updateFrames, int maxDepth = -1, bool interpolate = true);
+
+		void clearLOD();
+
+		// the current LOD, -1 is full animation
+		inline int getLOD()
+		{
+			return m_lod;
+		}
+
+		// the object is culled on all views, just the root motion bone is updated
+		inline bool isCulled()
+		{
+			return m_culled;
+		}
+
+		// off by default: the culled object just updates the root motion bone, and the LOD bands skip the frames & bones
+		static void enableLOD(bool b)
+		{
+			s_enableLOD = b;
+		}
+
+		static bool isEnableLOD()
+		{
+			return s_enableLOD;
+		}
+
+	protected:
+
+		void initCullingData(CRenderMesh* renderMesh);
+
+		void updateCullingData();
+
+		void updateLOD();
 	};
 }
\ No newline at end of file
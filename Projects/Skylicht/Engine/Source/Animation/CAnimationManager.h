@@ -50,6 +50,9 @@ namespace Skylicht
 
 		CAnimationClip* loadAnimation(const char *resource);
 
+		// export the compressed clip (.sanim)
+		bool exportAnimation(CAnimationClip* clip, const char* output);
+
 		void releaseAllClips();
 
 		void releaseAllAnimations();
@@ -27,6 +27,68 @@ https://github.com/skylicht-lab/skylicht-engine
 
 namespace Skylicht
 {
+	int CQuantizedKeyFrame::getIndex(f32 frame)
+	{
+		int foundPositionIndex = -1;
+
+		int numKey = (int)Data.size();
+		SQuantizedKey* pData = Data.pointer();
+
+		// compare on the quantized frame
+		f32 q = (frame - FrameStart) / FrameStep;
+
+		// Test the Hints...
+		if (Hint >= 0 && Hint < numKey)
+		{
+			if (Hint > 0 && (f32)pData[Hint].Frame >= q && (f32)pData[Hint - 1].Frame < q)
+				foundPositionIndex = Hint;
+			else if (Hint + 1 < numKey)
+			{
+				if ((f32)pData[Hint + 1].Frame >= q && (f32)pData[Hint + 0].Frame < q)
+				{
+					Hint++;
+					foundPositionIndex = Hint;
+				}
+			}
+		}
+
+		// The Hint test failed, do a full scan...
+		if (foundPositionIndex == -1)
+		{
+			for (s32 i = 0; i < numKey; ++i)
+			{
+				if ((f32)pData[i].Frame >= q)
+				{
+					foundPositionIndex = i;
+					Hint = i;
+					break;
+				}
+			}
+		}
+
+		return foundPositionIndex;
+	}
+
+	f32 CAnimationData::getLastFrame()
+	{
+		f32 totalFrame;
+
+		if (Compressed)
+		{
+			totalFrame = QuantizedPositions.getLastFrame();
+			totalFrame = core::max_(totalFrame, QuantizedRotations.getLastFrame());
+			totalFrame = core::max_(totalFrame, QuantizedScales.getLastFrame());
+		}
+		else
+		{
+			totalFrame = Positions.getLastFrame();
+			totalFrame = core::max_(totalFrame, Rotations.getLastFrame());
+			totalFrame = core::max_(totalFrame, Scales.getLastFrame());
+		}
+
+		return totalFrame;
+	}
+
 	CAnimationTrack::CAnimationTrack() :
 		m_data(NULL),
 		HaveAnimation(false)
@@ -54,6 +116,12 @@ namespace Skylicht
 			return;
 		}
 
+		if (data->Compressed)
+		{
+			getCompressedFrameData(frame, position, scale, rotation);
+			return;
+		}
+
 		s32 foundPositionIndex = -1;
 		s32 foundScaleIndex = -1;
 		s32 foundRotationIndex = -1;
@@ -197,6 +265,78 @@ namespace Skylicht
 #pragma endregion
 	}
 
+	void CAnimationTrack::getCompressedFrameData(f32 frame,
+		core::vector3df& position,
+		core::vector3df& scale,
+		core::quaternion& rotation)
+	{
+		CAnimationData* data = getAnimData();
+
+		CQuantizedKeyFrame* vectorKeys[2] = { &data->QuantizedPositions, &data->QuantizedScales };
+		core::vector3df* vectorResult[2] = { &position, &scale };
+		core::vector3df* vectorDefault[2] = { &data->Positions.Default, &data->Scales.Default };
+
+		// position & scale
+		for (int i = 0; i < 2; i++)
+		{
+			CQuantizedKeyFrame* keys = vectorKeys[i];
+			core::vector3df& result = *vectorResult[i];
+
+			u32 numKey = keys->size();
+			if (numKey == 0)
+			{
+				result = *vectorDefault[i];
+				continue;
+			}
+
+			s32 found = keys->getIndex(frame);
+			if (found == 0)
+				keys->getVector(0, result);
+			else if (found == -1)
+				keys->getVector(numKey - 1, result);
+			else
+			{
+				core::vector3df a, b;
+				keys->getVector(found, a);
+				keys->getVector(found - 1, b);
+
+				const f32 fd1 = frame - keys->getFrame(found);
+				const f32 fd2 = keys->getFrame(found - 1) - frame;
+				const f32 t = fd1 / (fd1 + fd2);
+
+				result = a + (b - a) * t;
+			}
+		}
+
+		// rotation
+		CQuantizedKeyFrame* keys = &data->QuantizedRotations;
+
+		u32 numKey = keys->size();
+		if (numKey == 0)
+		{
+			rotation = data->Rotations.Default;
+			return;
+		}
+
+		s32 found = keys->getIndex(frame);
+		if (found == 0)
+			keys->getQuaternion(0, rotation);
+		else if (found == -1)
+			keys->getQuaternion(numKey - 1, rotation);
+		else
+		{
+			core::quaternion a, b;
+			keys->getQuaternion(found, a);
+			keys->getQuaternion(found - 1, b);
+
+			const f32 fd1 = frame - keys->getFrame(found);
+			const f32 fd2 = keys->getFrame(found - 1) - frame;
+			const f32 t = fd1 / (fd1 + fd2);
+
+			quaternionSlerp(rotation, a, b, t);
+		}
+	}
+
 	void CAnimationTrack::quaternionSlerp(core::quaternion& result, core::quaternion q1, core::quaternion q2, float time)
 	{
 		f32 angle = (q1.X * q2.X) + (q1.Y * q2.Y) + (q1.Z * q2.Z) + (q1.W * q2.W);
@@ -119,6 +119,98 @@ namespace Skylicht
 		return foundPositionIndex;
 	}
 
+	// the key of compressed clip: frame & value are quantized to u16
+	struct SQuantizedKey
+	{
+		u16 Frame;
+		u16 Value[3];
+	};
+
+	// the compressed keys, the frame & vector are range quantized on the track
+	// and the quaternion is packed by smallest three (2 bits of the largest component index)
+	class CQuantizedKeyFrame
+	{
+	public:
+		core::array<SQuantizedKey> Data;
+
+		f32 FrameStart;
+		f32 FrameStep;
+
+		core::vector3df Min;
+		core::vector3df Extent;
+
+		int Hint;
+
+		CQuantizedKeyFrame() :
+			FrameStart(0.0f),
+			FrameStep(1.0f),
+			Hint(0)
+		{
+		}
+
+		inline void clearHint()
+		{
+			Hint = 0;
+		}
+
+		int getIndex(f32 frame);
+
+		inline u32 size()
+		{
+			return Data.size();
+		}
+
+		inline f32 getFrame(u32 i)
+		{
+			return FrameStart + (f32)Data[i].Frame * FrameStep;
+		}
+
+		inline f32 getLastFrame()
+		{
+			if (Data.size() == 0)
+				return 0.0f;
+
+			return getFrame(Data.size() - 1);
+		}
+
+		inline void getVector(u32 i, core::vector3df& v)
+		{
+			const u16* q = Data[i].Value;
+			v.X = Min.X + Extent.X * (f32)q[0] * (1.0f / 65535.0f);
+			v.Y = Min.Y + Extent.Y * (f32)q[1] * (1.0f / 65535.0f);
+			v.Z = Min.Z + Extent.Z * (f32)q[2] * (1.0f / 65535.0f);
+		}
+
+		inline void getQuaternion(u32 i, core::quaternion& r)
+		{
+			const u16* q = Data[i].Value;
+
+			// [0, 32767] to [-1/sqrt(2), 1/sqrt(2)]
+			const f32 s = 1.41421356f / 32767.0f;
+			f32 a = (f32)(q[0] & 0x7fff) * s - 0.70710678f;
+			f32 b = (f32)(q[1] & 0x7fff) * s - 0.70710678f;
+			f32 c = (f32)(q[2] & 0x7fff) * s - 0.70710678f;
+			f32 d = sqrtf(core::max_(0.0f, 1.0f - a * a - b * b - c * c));
+
+			int largest = (q[0] >> 15) | ((q[1] >> 15) << 1);
+			switch (largest)
+			{
+			case 0:
+				r.set(d, a, b, c);
+				break;
+			case 1:
+				r.set(a, d, b, c);
+				break;
+			case 2:
+				r.set(a, b, d, c);
+				break;
+			default:
+				r.set(a, b, c, d);
+				break;
+			}
+		}
+	};
+
 	class CAnimationData
 	{
 	public:
@@ -126,9 +218,19 @@ namespace Skylicht
 		CArrayKeyFrame<core::quaternion> Rotations;
 		CArrayKeyFrame<core::vector3df> Scales;
 
-		CAnimationData()
+		// the keys of compressed clip (see CAnimationCompressor), the arrays above just keep the Default value
+		CQuantizedKeyFrame QuantizedPositions;
+		CQuantizedKeyFrame QuantizedRotations;
+		CQuantizedKeyFrame QuantizedScales;
+
+		bool Compressed;
+
+		CAnimationData() :
+			Compressed(false)
 		{
 		}
+
+		f32 getLastFrame();
 	};
 
 	class CAnimationTrack
@@ -149,6 +251,11 @@ namespace Skylicht
 
 		static void quaternionSlerp(core::quaternion& result, core::quaternion q1, core::quaternion q2, float t);
 
+		void getCompressedFrameData(f32 frame,
+			core::vector3df& position,
+			core::vector3df& scale,
+			core::quaternion& rotation);
+
 		void getFrameData(f32 frame,
 			core::vector3df& position,
 			core::vector3df& scale,
@@ -163,6 +270,10 @@ namespace Skylicht
 				m_data->Positions.clearHint();
 				m_data->Rotations.clearHint();
 				m_data->Scales.clearHint();
+
+				m_data->QuantizedPositions.clearHint();
+				m_data->QuantizedRotations.clearHint();
+				m_data->QuantizedScales.clearHint();
 			}
 
 			m_data = NULL;
@@ -0,0 +1,77 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2023 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#include "pch.h"
+#include "CPoseCache.h"
+
+namespace Skylicht
+{
+	u32 CPoseCache::s_subFrames = 4;
+	u32 CPoseCache::s_capacity = 64;
+
+	CPoseCache::CPoseCache(CPoseSampler* sampler) :
+		m_sampler(sampler),
+		m_capacity(s_capacity),
+		m_subFrames(s_subFrames),
+		m_hit(0),
+		m_miss(0)
+	{
+		m_poseSize = CPoseSampler::StreamCount * sampler->getStride();
+
+		m_poses.set_used(m_capacity * m_poseSize);
+
+		m_keys.set_used(m_capacity);
+		for (u32 i = 0; i < m_capacity; i++)
+			m_keys[i] = -1;
+	}
+
+	CPoseCache::~CPoseCache()
+	{
+
+	}
+
+	const f32* CPoseCache::getPose(f32 frame)
+	{
+		if (frame < 0.0f)
+			frame = 0.0f;
+
+		s32 key = (s32)(frame * (f32)m_subFrames + 0.5f);
+		u32 slot = (u32)key % m_capacity;
+
+		f32* pose = &m_poses[slot * m_poseSize];
+
+		if (m_keys[slot] != key)
+		{
+			m_sampler->sample((f32)key / (f32)m_subFrames, pose);
+			m_keys[slot] = key;
+			m_miss++;
+		}
+		else
+		{
+			m_hit++;
+		}
+
+		return pose;
+	}
+}
@@ -0,0 +1,106 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2023 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#pragma once
+
+#include "CPoseSampler.h"
+
+namespace Skylicht
+{
+	/// The sampled poses of a clip keyed by the quantized time,
+	/// the skeletons that play the clip at the same time (crowd) share the pose and do not sample again.
+	/// The cache is direct mapped with a fixed capacity, so the memory is bounded.
+	class CPoseCache
+	{
+	protected:
+		CPoseSampler* m_sampler;
+
+		u32 m_poseSize;
+		u32 m_capacity;
+		u32 m_subFrames;
+
+		// m_capacity poses
+		core::array<f32> m_poses;
+
+		// the quantized time of pose slot, -1 is empty
+		core::array<s32> m_keys;
+
+		u32 m_hit;
+		u32 m_miss;
+
+		static u32 s_subFrames;
+		static u32 s_capacity;
+
+	public:
+		CPoseCache(CPoseSampler* sampler);
+
+		virtual ~CPoseCache();
+
+		// the pose at the quantized frame, the layout is the output of CPoseSampler::sample
+		const f32* getPose(f32 frame);
+
+		inline u32 getHit()
+		{
+			return m_hit;
+		}
+
+		inline u32 getMiss()
+		{
+			return m_miss;
+		}
+
+		inline void resetStats()
+		{
+			m_hit = 0;
+			m_miss = 0;
+		}
+
+		// the time steps in a frame, the cache that is created after just uses the new value
+		static void setSubFrames(u32 n)
+		{
+			s_subFrames = core::max_(n, 1u);
+		}
+
+		static u32 getSubFrames()
+		{
+			return s_subFrames;
+		}
+
+		// the time step of a render frame is less than the quantized step, the pose would hold then jump
+		static bool canShare(f32 frameStep)
+		{
+			return fabsf(frameStep) * (f32)s_subFrames >= 1.0f;
+		}
+
+		static void setCapacity(u32 n)
+		{
+			s_capacity = core::max_(n, 1u);
+		}
+
+		static u32 getCapacity()
+		{
+			return s_capacity;
+		}
+	};
+}
@@ -0,0 +1,231 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2023 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#include "pch.h"
+#include "CPoseSampler.h"
+#include "CAnimationClip.h"
+#include "Utils/CSIMD.h"
+
+namespace Skylicht
+{
+	CPoseSampler::CPoseSampler() :
+		m_numTrack(0),
+		m_stride(0),
+		m_numFrame(0)
+	{
+
+	}
+
+	CPoseSampler::~CPoseSampler()
+	{
+
+	}
+
+	static bool isIntegerFrame(f32 frame)
+	{
+		return fabsf(frame - floorf(frame + 0.5f)) < 0.01f;
+	}
+
+	bool CPoseSampler::canSample(CAnimationClip* clip)
+	{
+		if (clip->AnimInfo.size() == 0)
+			return false;
+
+		for (SEntityAnim* anim : clip->AnimInfo)
+		{
+			CAnimationData& data = anim->Data;
+
+			// the dense table would undo the compression
+			if (data.Compressed)
+				return false;
+
+			for (u32 i = 0, n = data.Positions.size(); i < n; i++)
+			{
+				if (!isIntegerFrame(data.Positions.Data[i].Frame))
+					return false;
+			}
+
+			for (u32 i = 0, n = data.Rotations.size(); i < n; i++)
+			{
+				if (!isIntegerFrame(data.Rotations.Data[i].Frame))
+					return false;
+			}
+
+			for (u32 i = 0, n = data.Scales.size(); i < n; i++)
+			{
+				if (!isIntegerFrame(data.Scales.Data[i].Frame))
+					return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool CPoseSampler::build(CAnimationClip* clip)
+	{
+		m_data.clear();
+		m_numTrack = 0;
+		m_stride = 0;
+		m_numFrame = 0;
+
+		if (!canSample(clip))
+			return false;
+
+		f32 lastFrame = 0.0f;
+		for (SEntityAnim* anim : clip->AnimInfo)
+			lastFrame = core::max_(lastFrame, anim->Data.getLastFrame());
+
+		m_numTrack = (u32)clip->AnimInfo.size();
+		m_stride = (m_numTrack + 3) & ~3;
+		m_numFrame = (u32)floorf(lastFrame + 0.5f) + 1;
+
+		m_data.set_used(m_numFrame * StreamCount * m_stride);
+		memset(m_data.pointer(), 0, m_data.size() * sizeof(f32));
+
+		CAnimationTrack track;
+
+		for (u32 t = 0; t < m_numTrack; t++)
+		{
+			track.clearAllKeyFrame();
+			track.setAnimationData(&clip->AnimInfo[t]->Data);
+
+			core::quaternion last;
+
+			for (u32 f = 0; f < m_numFrame; f++)
+			{
+				core::vector3df position, scale;
+				core::quaternion rotation;
+
+				track.getFrameData((f32)f, position, scale, rotation);
+				rotation.normalize();
+
+				// keep the same hemisphere with the last frame, the nlerp does not need to check the sign
+				if (f > 0 && last.dotProduct(rotation) < 0.0f)
+					rotation *= -1.0f;
+				last = rotation;
+
+				f32* p = &m_data[f * StreamCount * m_stride + t];
+				p[PositionX * m_stride] = position.X;
+				p[PositionY * m_stride] = position.Y;
+				p[PositionZ * m_stride] = position.Z;
+				p[ScaleX * m_stride] = scale.X;
+				p[ScaleY * m_stride] = scale.Y;
+				p[ScaleZ * m_stride] = scale.Z;
+				p[RotationX * m_stride] = rotation.X;
+				p[RotationY * m_stride] = rotation.Y;
+				p[RotationZ * m_stride] = rotation.Z;
+				p[RotationW * m_stride] = rotation.W;
+			}
+		}
+
+		// the padding tracks are identity rotation, it is safe to normalize
+		for (u32 f = 0; f < m_numFrame; f++)
+		{
+			for (u32 t = m_numTrack; t < m_stride; t++)
+				m_data[(f * StreamCount + RotationW) * m_stride + t] = 1.0f;
+		}
+
+		return true;
+	}
+
+	void CPoseSampler::sample(f32 frame, f32* out)
+	{
+		if (m_numFrame == 0)
+			return;
+
+		// O(1) key lookup on the uniform frames
+		f32 lastFrame = (f32)(m_numFrame - 1);
+		frame = core::clamp(frame, 0.0f, lastFrame);
+
+		u32 f0 = (u32)frame;
+		u32 f1 = core::min_(f0 + 1, m_numFrame - 1);
+		f32 t = frame - (f32)f0;
+
+		u32 frameSize = StreamCount * m_stride;
+		const f32* a = &m_data[f0 * frameSize];
+		const f32* b = &m_data[f1 * frameSize];
+
+#if defined(USE_SIMD)
+		SIMDVec vt = simdSet(t);
+
+		// position & scale: lerp
+		for (u32 i = 0, n = RotationX * m_stride; i < n; i += 4)
+		{
+			SIMDVec va = simdLoad(a + i);
+			SIMDVec vb = simdLoad(b + i);
+			simdStore(out + i, simdAdd(va, simdMul(simdSub(vb, va), vt)));
+		}
+
+		// rotation: nlerp
+		u32 rx = RotationX * m_stride;
+		u32 ry = RotationY * m_stride;
+		u32 rz = RotationZ * m_stride;
+		u32 rw = RotationW * m_stride;
+
+		for (u32 i = 0; i < m_stride; i += 4)
+		{
+			SIMDVec x = simdLoad(a + rx + i);
+			SIMDVec y = simdLoad(a + ry + i);
+			SIMDVec z = simdLoad(a + rz + i);
+			SIMDVec w = simdLoad(a + rw + i);
+
+			x = simdAdd(x, simdMul(simdSub(simdLoad(b + rx + i), x), vt));
+			y = simdAdd(y, simdMul(simdSub(simdLoad(b + ry + i), y), vt));
+			z = simdAdd(z, simdMul(simdSub(simdLoad(b + rz + i), z), vt));
+			w = simdAdd(w, simdMul(simdSub(simdLoad(b + rw + i), w), vt));
+
+			SIMDVec len = simdAdd(simdAdd(simdMul(x, x), simdMul(y, y)), simdAdd(simdMul(z, z), simdMul(w, w)));
+			len = simdSqrt(len);
+
+			simdStore(out + rx + i, simdDiv(x, len));
+			simdStore(out + ry + i, simdDiv(y, len));
+			simdStore(out + rz + i, simdDiv(z, len));
+			simdStore(out + rw + i, simdDiv(w, len));
+		}
+#else
+		for (u32 i = 0, n = RotationX * m_stride; i < n; i++)
+			out[i] = a[i] + (b[i] - a[i]) * t;
+
+		u32 rx = RotationX * m_stride;
+		u32 ry = RotationY * m_stride;
+		u32 rz = RotationZ * m_stride;
+		u32 rw = RotationW * m_stride;
+
+		for (u32 i = 0; i < m_stride; i++)
+		{
+			f32 x = a[rx + i] + (b[rx + i] - a[rx + i]) * t;
+			f32 y = a[ry + i] + (b[ry + i] - a[ry + i]) * t;
+			f32 z = a[rz + i] + (b[rz + i] - a[rz + i]) * t;
+			f32 w = a[rw + i] + (b[rw + i] - a[rw + i]) * t;
+
+			f32 invLen = core::reciprocal_squareroot(x * x + y * y + z * z + w * w);
+
+			out[rx + i] = x * invLen;
+			out[ry + i] = y * invLen;
+			out[rz + i] = z * invLen;
+			out[rw + i] = w * invLen;
+		}
+#endif
+	}
+}
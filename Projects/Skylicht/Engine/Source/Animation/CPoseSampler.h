@@ -0,0 +1,92 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2023 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#pragma once
+
+namespace Skylicht
+{
+	class CAnimationClip;
+
+	/// The clip is resampled on the integer frames to a frame major SoA layout:
+	/// the pose of all tracks at one time is sampled in one pass by SIMD lerp (position, scale) & nlerp (rotation),
+	/// the key lookup is O(1). It is built only for the clip that all keys are on the integer frames.
+	/// The table costs numFrame * StreamCount * stride * 4 bytes (~720KB for 300 frames & 60 bones),
+	/// so it is opt-in per clip (see CAnimationClip::enablePoseSampler) and the compressed clip is not sampled.
+	class CPoseSampler
+	{
+	public:
+		enum EPoseStream
+		{
+			PositionX = 0,
+			PositionY,
+			PositionZ,
+			ScaleX,
+			ScaleY,
+			ScaleZ,
+			RotationX,
+			RotationY,
+			RotationZ,
+			RotationW,
+			StreamCount
+		};
+
+	protected:
+		u32 m_numTrack;
+
+		// number of tracks that is aligned to 4
+		u32 m_stride;
+
+		u32 m_numFrame;
+
+		// frame f, stream s, track t: m_data[(f * StreamCount + s) * m_stride + t]
+		core::array<f32> m_data;
+
+	public:
+		CPoseSampler();
+
+		virtual ~CPoseSampler();
+
+		static bool canSample(CAnimationClip* clip);
+
+		bool build(CAnimationClip* clip);
+
+		// out: StreamCount * getStride() floats, the value of track t on stream s is out[s * getStride() + t]
+		void sample(f32 frame, f32* out);
+
+		inline u32 getNumTrack()
+		{
+			return m_numTrack;
+		}
+
+		inline u32 getStride()
+		{
+			return m_stride;
+		}
+
+		inline u32 getNumFrame()
+		{
+			return m_numFrame;
+		}
+	};
+}
@@ -39,6 +39,9 @@ namespace Skylicht
 		int ParentID;
 		int Depth;
 
+		// the root motion bone or its parents, they are updated when the object is culled
+		bool RootMotion;
+
 		// transform if the entity dont have animation
 		core::vector3df DefaultPosition;
 		core::vector3df DefaultScale;
@@ -49,6 +52,11 @@ namespace Skylicht
 		core::vector3df AnimScale;
 		core::quaternion AnimRotation;
 
+		// the last evaluated transform, that is interpolated to the Anim transform (see CSkeleton::applyTransform)
+		core::vector3df LastPosition;
+		core::vector3df LastScale;
+		core::quaternion LastRotation;
+
 		// handle of world transform
 		CWorldTransformData* WorldTransform;
 
@@ -24,17 +24,24 @@ https://github.com/skylicht-lab/skylicht-engine
 
 #include "pch.h"
 #include "CSkeleton.h"
+#include "Animation/BlendTree/CBlendTree.h"
 
 #define COPY_VECTOR3DF(dest, src)	dest.X = src.X; dest.Y = src.Y; dest.Z = src.Z
 #define COPY_QUATERNION(dest, src)	dest.X = src.X; dest.Y = src.Y; dest.Z = src.Z; dest.W = src.W
 
 namespace Skylicht
 {
+	bool CSkeleton::s_usePoseSampler = true;
+
 	CSkeleton::CSkeleton(int id) :
 		m_id(id),
 		m_enable(true),
 		m_animationType(KeyFrame),
 		m_clip(NULL),
+		m_lodDepth(-1),
+		m_lodRootMotion(false),
+		m_blendTree(NULL),
+		m_sharePose(false),
 		m_target(NULL)
 	{
 
@@ -97,13 +104,68 @@ namespace Skylicht
 			COPY_VECTOR3DF(animationData->AnimPosition, animationData->DefaultPosition);
 			COPY_VECTOR3DF(animationData->AnimScale, animationData->DefaultScale);
 			COPY_QUATERNION(animationData->AnimRotation, animationData->DefaultRotation);
+
+			COPY_VECTOR3DF(animationData->LastPosition, animationData->DefaultPosition);
+			COPY_VECTOR3DF(animationData->LastScale, animationData->DefaultScale);
+			COPY_QUATERNION(animationData->LastRotation, animationData->DefaultRotation);
+		}
+
+		updateRootMotion();
+	}
+
+	void CSkeleton::setRootMotionBone(const char* name)
+	{
+		m_rootMotionBone = name != NULL ? name : "";
+		updateRootMotion();
+	}
+
+	void CSkeleton::updateRootMotion()
+	{
+		CAnimationTransformData* bone = NULL;
+
+		for (CAnimationTransformData*& entity : m_entitiesData)
+		{
+			entity->RootMotion = false;
+
+			if (bone != NULL)
+				continue;
+
+			if (!m_rootMotionBone.empty())
+			{
+				if (entity->Name == m_rootMotionBone)
+					bone = entity;
+			}
+			else if (entity->AnimationTrack.HaveAnimation)
+			{
+				bone = entity;
+			}
+		}
+
+		if (bone == NULL)
+		{
+			// no animated bone, keep the root bones
+			for (CAnimationTransformData*& entity : m_entitiesData)
+				entity->RootMotion = entity->Depth == 0;
+			return;
+		}
+
+		// the bone & its parents
+		while (bone != NULL)
+		{
+			bone->RootMotion = true;
+
+			CEntity* parent = bone->ParentID >= 0 ? m_entities.getEntity(bone->ParentID) : NULL;
+			bone = parent != NULL ? GET_ENTITY_DATA(parent, CAnimationTransformData) : NULL;
 		}
 	}
 
 	void CSkeleton::releaseAllEntities()
 	{
+		releaseBlendTree();
+
 		m_entities.releaseAllEntities();
 		m_entitiesData.clear();
+		m_trackIndex.set_used(0);
 	}
 
 	void CSkeleton::setAnimation(CAnimationClip* clip, bool loop, float from, float duration, bool pause)
@@ -151,12 +213,20 @@ namespace Skylicht
 
 	void CSkeleton::setAnimationData()
 	{
+		std::map<SEntityAnim*, int> trackIndex;
+		for (u32 i = 0, n = (u32)m_clip->AnimInfo.size(); i < n; i++)
+			trackIndex[m_clip->AnimInfo[i]] = (int)i;
+
+		m_trackIndex.set_used(0);
+
 		for (CAnimationTransformData*& entity : m_entitiesData)
 		{
 			CAnimationTrack& track = entity->AnimationTrack;
 			track.clearAllKeyFrame();
 
 			SEntityAnim* anim = m_clip->getAnimOfEntity(entity->Name);
+			m_trackIndex.push_back(anim != NULL ? trackIndex[anim] : -1);
+
 			if (anim != NULL)
 			{
 				// apply new frame data
@@ -164,9 +234,7 @@ namespace Skylicht
 				track.setAnimationData(&anim->Data);
 
 				// get anim duration
-				float totalFrame = anim->Data.Positions.getLastFrame();
-				totalFrame = core::max_(totalFrame, anim->Data.Rotations.getLastFrame());
-				totalFrame = core::max_(totalFrame, anim->Data.Scales.getLastFrame());
+				float totalFrame = anim->Data.getLastFrame();
 
 				if (m_timeline.Duration < totalFrame)
 					m_timeline.Duration = totalFrame;
@@ -175,59 +243,165 @@ namespace Skylicht
 				track.HaveAnimation = true;
 			}
 		}
+
+		updateRootMotion();
+	}
+
+	CBlendTree* CSkeleton::createBlendTree()
+	{
+		releaseBlendTree();
+
+		m_blendTree = new CBlendTree(this);
+		m_animationType = BlendTree;
+		return m_blendTree;
+	}
+
+	void CSkeleton::releaseBlendTree()
+	{
+		if (m_blendTree != NULL)
+		{
+			delete m_blendTree;
+			m_blendTree = NULL;
+
+			if (m_animationType == BlendTree)
+				m_animationType = KeyFrame;
+		}
 	}
 
 	void CSkeleton::update()
 	{
 		if (m_animationType == KeyFrame)
 			updateTrackKeyFrame();
+		else if (m_animationType == BlendTree)
+			updateBlendTree();
 		else
 			updateBlending();
 	}
 
+	void CSkeleton::updateBlendTree()
+	{
+		if (m_blendTree == NULL)
+			return;
+
+		CAnimationPose* pose = m_blendTree->evaluate();
+		if (pose == NULL)
+			return;
+
+		for (u32 i = 0, n = (u32)m_entitiesData.size(); i < n; i++)
+		{
+			CAnimationTransformData* entity = m_entitiesData[i];
+			if (isSkipLOD(entity))
+				continue;
+
+			pose->getBone(i, entity->AnimPosition, entity->AnimScale, entity->AnimRotation);
+		}
+	}
+
 	void CSkeleton::applyTransform()
 	{
 		for (CAnimationTransformData*& entity : m_entitiesData)
 		{
-			// todo calc relative matrix & position
-			core::matrix4& relativeMatrix = entity->WorldTransform->Relative;
-			relativeMatrix.makeIdentity();
-
-			// rotation
-			entity->AnimRotation.getMatrix(relativeMatrix);
-
-			// position	
-			f32* m1 = relativeMatrix.pointer();
-
-			m1[12] = entity->AnimPosition.X;
-			m1[13] = entity->AnimPosition.Y;
-			m1[14] = entity->AnimPosition.Z;
-
-			// scale
-			m1[0] *= entity->AnimScale.X;
-			m1[1] *= entity->AnimScale.X;
-			m1[2] *= entity->AnimScale.X;
-			m1[3] *= entity->AnimScale.X;
-
-			m1[4] *= entity->AnimScale.Y;
-			m1[5] *= entity->AnimScale.Y;
-			m1[6] *= entity->AnimScale.Y;
-			m1[7] *= entity->AnimScale.Y;
-
-			m1[8] *= entity->AnimScale.Z;
-			m1[9] *= entity->AnimScale.Z;
-			m1[10] *= entity->AnimScale.Z;
-			m1[11] *= entity->AnimScale.Z;
-
-			// notify transform changed for CWorldTransformSystem
-			entity->WorldTransform->HasChanged = true;
+			if (isSkipLOD(entity))
+				continue;
+
+			updateRelativeMatrix(entity, entity->AnimPosition, entity->AnimScale, entity->AnimRotation);
 		}
 	}
 
+	void CSkeleton::applyTransform(float weight)
+	{
+		core::vector3df position;
+		core::vector3df scale;
+		core::quaternion rotation;
+
+		for (CAnimationTransformData*& entity : m_entitiesData)
+		{
+			if (isSkipLOD(entity))
+				continue;
+
+			position = entity->LastPosition + (entity->AnimPosition - entity->LastPosition) * weight;
+			scale = entity->LastScale + (entity->AnimScale - entity->LastScale) * weight;
+
+			// nlerp on the same hemisphere
+			const core::quaternion& q1 = entity->LastRotation;
+			const core::quaternion& q2 = entity->AnimRotation;
+
+			float w2 = q1.dotProduct(q2) < 0.0f ? -weight : weight;
+			float w1 = 1.0f - weight;
+
+			rotation.set(
+				q1.X * w1 + q2.X * w2,
+				q1.Y * w1 + q2.Y * w2,
+				q1.Z * w1 + q2.Z * w2,
+				q1.W * w1 + q2.W * w2);
+			rotation.normalize();
+
+			updateRelativeMatrix(entity, position, scale, rotation);
+		}
+	}
+
+	void CSkeleton::storeLastPose()
+	{
+		for (CAnimationTransformData*& entity : m_entitiesData)
+		{
+			COPY_VECTOR3DF(entity->LastPosition, entity->AnimPosition);
+			COPY_VECTOR3DF(entity->LastScale, entity->AnimScale);
+			COPY_QUATERNION(entity->LastRotation, entity->AnimRotation);
+		}
+	}
+
+	void CSkeleton::updateRelativeMatrix(CAnimationTransformData* entity, const core::vector3df& position, const core::vector3df& scale, const core::quaternion& rotation)
+	{
+		core::matrix4& relativeMatrix = entity->WorldTransform->Relative;
+		relativeMatrix.makeIdentity();
+
+		// rotation
+		rotation.getMatrix(relativeMatrix);
+
+		// position	
+		f32* m1 = relativeMatrix.pointer();
+
+		m1[12] = position.X;
+		m1[13] = position.Y;
+		m1[14] = position.Z;
+
+		// scale
+		m1[0] *= scale.X;
+		m1[1] *= scale.X;
+		m1[2] *= scale.X;
+		m1[3] *= scale.X;
+
+		m1[4] *= scale.Y;
+		m1[5] *= scale.Y;
+		m1[6] *= scale.Y;
+		m1[7] *= scale.Y;
+
+		m1[8] *= scale.Z;
+		m1[9] *= scale.Z;
+		m1[10] *= scale.Z;
+		m1[11] *= scale.Z;
+
+		// notify transform changed for CWorldTransformSystem
+		entity->WorldTransform->HasChanged = true;
+	}
+
 	void CSkeleton::updateTrackKeyFrame()
 	{
+		if (s_usePoseSampler && m_clip != NULL && m_trackIndex.size() == m_entitiesData.size())
+		{
+			CPoseSampler* sampler = m_clip->getPoseSampler();
+			if (sampler != NULL)
+			{
+				updatePoseSampler(sampler);
+				return;
+			}
+		}
+
 		for (CAnimationTransformData*& entity : m_entitiesData)
 		{
+			if (isSkipLOD(entity))
+				continue;
+
 			CAnimationTrack& track = entity->AnimationTrack;
 
 			if (track.HaveAnimation == true)
@@ -244,6 +418,61 @@ namespace Skylicht
 		}
 	}
 
+	void CSkeleton::updatePoseSampler(CPoseSampler* sampler)
+	{
+		u32 stride = sampler->getStride();
+
+		const f32* pose;
+
+		f32 frameStep = getTimeStep() * m_timeline.Speed / 1000.0f;
+
+		if (m_sharePose && CPoseCache::canShare(frameStep))
+		{
+			// the pose is shared with the skeletons that play this clip at the same time
+			pose = m_clip->getPoseCache()->getPose(m_timeline.Frame);
+		}
+		else
+		{
+			m_pose.set_used(CPoseSampler::StreamCount * stride);
+			sampler->sample(m_timeline.Frame, m_pose.pointer());
+			pose = m_pose.pointer();
+		}
+
+		const f32* px = pose + CPoseSampler::PositionX * stride;
+		const f32* py = pose + CPoseSampler::PositionY * stride;
+		const f32* pz = pose + CPoseSampler::PositionZ * stride;
+		const f32* sx = pose + CPoseSampler::ScaleX * stride;
+		const f32* sy = pose + CPoseSampler::ScaleY * stride;
+		const f32* sz = pose + CPoseSampler::ScaleZ * stride;
+		const f32* rx = pose + CPoseSampler::RotationX * stride;
+		const f32* ry = pose + CPoseSampler::RotationY * stride;
+		const f32* rz = pose + CPoseSampler::RotationZ * stride;
+		const f32* rw = pose + CPoseSampler::RotationW * stride;
+
+		int* trackIndex = m_trackIndex.pointer();
+
+		for (u32 i = 0, n = (u32)m_entitiesData.size(); i < n; i++)
+		{
+			CAnimationTransformData* entity = m_entitiesData[i];
+			if (isSkipLOD(entity))
+				continue;
+
+			int t = trackIndex[i];
+			if (t >= 0)
+			{
+				entity->AnimPosition.set(px[t], py[t], pz[t]);
+				entity->AnimScale.set(sx[t], sy[t], sz[t]);
+				entity->AnimRotation.set(rx[t], ry[t], rz[t], rw[t]);
+			}
+			else
+			{
+				COPY_VECTOR3DF(entity->AnimPosition, entity->DefaultPosition);
+				COPY_VECTOR3DF(entity->AnimScale, entity->DefaultScale);
+				COPY_QUATERNION(entity->AnimRotation, entity->DefaultRotation);
+			}
+		}
+	}
+
 	void CSkeleton::setTarget(CSkeleton* skeleton)
 	{
 		if (m_target != NULL)
@@ -268,10 +497,15 @@ namespace Skylicht
 
 	void CSkeleton::updateBlending()
 	{
-		int id = 0;
+		int id = -1;
 
 		for (CAnimationTransformData*& entity : m_entitiesData)
 		{
+			id++;
+
+			if (isSkipLOD(entity))
+				continue;
+
 			bool first = true;
 
 			for (CSkeleton*& skeleton : m_blending)
@@ -332,8 +566,6 @@ namespace Skylicht
 					entity->AnimRotation.W += Rw * weight;
 				}
 			}
-
-			id++;
 		}
 	}
 
@@ -31,6 +31,8 @@ https://github.com/skylicht-lab/skylicht-engine
 
 namespace Skylicht
 {
+	class CBlendTree;
+
 	class CSkeleton
 	{
 	public:
@@ -38,6 +40,7 @@ namespace Skylicht
 		{
 			KeyFrame = 0,
 			Blending,
+			BlendTree,
 		};
 
 	protected:
@@ -55,6 +58,28 @@ namespace Skylicht
 
 		CAnimationClip* m_clip;
 
+		// the bones deeper than this depth are not evaluated, -1 is all bones
+		int m_lodDepth;
+
+		// just evaluate the root motion bone & its parents
+		bool m_lodRootMotion;
+
+		// the name of root motion bone, empty is the first animated bone of the clip
+		std::string m_rootMotionBone;
+
+		CBlendTree* m_blendTree;
+
+		// the track index on the clip of each entity, -1 if the entity has no animation
+		core::array<int> m_trackIndex;
+
+		// the pose of all tracks that is sampled by CPoseSampler
+		core::array<f32> m_pose;
+
+		// the crowd skeleton shares the sampled pose with the skeletons that play the same clip (see CPoseCache)
+		bool m_sharePose;
+
+		static bool s_usePoseSampler;
+
 	protected:
 
 		CSkeleton* m_target;
@@ -74,6 +99,11 @@ namespace Skylicht
 
 		void applyTransform();
 
+		// apply the transform that is interpolated from the last pose (see storeLastPose)
+		void applyTransform(float weight);
+
+		void storeLastPose();
+
 		void syncAnimationByTimeScale();
 
 		void setAnimation(CAnimationClip* clip, bool loop, bool pause = false);
@@ -105,6 +135,21 @@ namespace Skylicht
 			return m_timeline;
 		}
 
+		inline std::vector<CAnimationTransformData*>& getEntitiesData()
+		{
+			return m_entitiesData;
+		}
+
+		// create the blend tree on the bones of this skeleton, the animation type is changed to BlendTree
+		CBlendTree* createBlendTree();
+
+		void releaseBlendTree();
+
+		inline CBlendTree* getBlendTree()
+		{
+			return m_blendTree;
+		}
+
 		inline void setAnimationType(EAnimationType type)
 		{
 			m_animationType = type;
@@ -117,12 +162,76 @@ namespace Skylicht
 
 		void setTarget(CSkeleton* skeleton);
 
+		inline void setLODDepth(int depth)
+		{
+			m_lodDepth = depth;
+		}
+
+		inline int getLODDepth()
+		{
+			return m_lodDepth;
+		}
+
+		inline void setLODRootMotion(bool b)
+		{
+			m_lodRootMotion = b;
+		}
+
+		inline bool isLODRootMotion()
+		{
+			return m_lodRootMotion;
+		}
+
+		void setRootMotionBone(const char* name);
+
+		inline const std::string& getRootMotionBone()
+		{
+			return m_rootMotionBone;
+		}
+
+		static void enablePoseSampler(bool b)
+		{
+			s_usePoseSampler = b;
+		}
+
+		static bool isEnablePoseSampler()
+		{
+			return s_usePoseSampler;
+		}
+
+		// share the sampled pose by the quantized time, for the crowd that plays the clip with the pose sampler
+		inline void setSharePose(bool b)
+		{
+			m_sharePose = b;
+		}
+
+		inline bool isSharePose()
+		{
+			return m_sharePose;
+		}
+
 	protected:
 
 		void setAnimationData();
 
+		void updateRootMotion();
+
 		void updateTrackKeyFrame();
 
+		void updatePoseSampler(CPoseSampler* sampler);
+
+		void updateBlendTree();
+
+		void updateRelativeMatrix(CAnimationTransformData* entity, const core::vector3df& position, const core::vector3df& scale, const core::quaternion& rotation);
+
+		inline bool isSkipLOD(CAnimationTransformData* entity)
+		{
+			if (m_lodRootMotion)
+				return !entity->RootMotion;
+
+			return m_lodDepth >= 0 && entity->Depth > m_lodDepth;
+		}
+
 		void updateBlending();
 
 		void addBlending(CSkeleton* skeleton);
@@ -0,0 +1,507 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2023 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#include "pch.h"
+#include "CCullingBVH.h"
+
+namespace Skylicht
+{
+	static inline f32 getBoxArea(const core::aabbox3df& box)
+	{
+		core::vector3df e = box.getExtent();
+		return e.X * e.Y + e.Y * e.Z + e.Z * e.X;
+	}
+
+	static inline core::aabbox3df mergeBox(const core::aabbox3df& a, const core::aabbox3df& b)
+	{
+		core::aabbox3df r(a);
+		r.addInternalBox(b);
+		return r;
+	}
+
+	static inline bool containBox(const core::aabbox3df& a, const core::aabbox3df& b)
+	{
+		return a.MinEdge.X <= b.MinEdge.X && a.MinEdge.Y <= b.MinEdge.Y && a.MinEdge.Z <= b.MinEdge.Z &&
+			a.MaxEdge.X >= b.MaxEdge.X && a.MaxEdge.Y >= b.MaxEdge.Y && a.MaxEdge.Z >= b.MaxEdge.Z;
+	}
+
+	static inline core::aabbox3df enlargeBox(const core::aabbox3df& box, f32 ratio)
+	{
+		core::vector3df e = box.getExtent();
+		f32 margin = core::max_(e.X, e.Y, e.Z) * ratio;
+		core::vector3df m(margin, margin, margin);
+		return core::aabbox3df(box.MinEdge - m, box.MaxEdge + m);
+	}
+
+	CCullingBVH::CCullingBVH() :
+		m_root(-1),
+		m_freeList(-1),
+		m_leafCount(0)
+	{
+
+	}
+
+	CCullingBVH::~CCullingBVH()
+	{
+
+	}
+
+	void CCullingBVH::clear()
+	{
+		m_nodes.set_used(0);
+		m_root = -1;
+		m_freeList = -1;
+		m_leafCount = 0;
+	}
+
+	int CCullingBVH::allocateNode()
+	{
+		int id;
+
+		if (m_freeList == -1)
+		{
+			id = (int)m_nodes.size();
+			m_nodes.push_back(SNode());
+		}
+		else
+		{
+			id = m_freeList;
+			m_freeList = m_nodes[id].Parent;
+		}
+
+		SNode& node = m_nodes[id];
+		node.UserData = -1;
+		node.Parent = -1;
+		node.Child1 = -1;
+		node.Child2 = -1;
+		node.Height = 0;
+		return id;
+	}
+
+	void CCullingBVH::freeNode(int node)
+	{
+		m_nodes[node].Parent = m_freeList;
+		m_nodes[node].Height = -1;
+		m_freeList = node;
+	}
+
+	int CCullingBVH::insert(const core::aabbox3df& box, int userData)
+	{
+		int leaf = allocateNode();
+
+		SNode& node = m_nodes[leaf];
+		node.Box = enlargeBox(box, BVH_FAT_RATIO);
+		node.UserData = userData;
+
+		insertLeaf(leaf);
+		m_leafCount++;
+		return leaf;
+	}
+
+	void CCullingBVH::remove(int node)
+	{
+		removeLeaf(node);
+		freeNode(node);
+		m_leafCount--;
+	}
+
+	bool CCullingBVH::move(int node, const core::aabbox3df& box)
+	{
+		const core::aabbox3df& fatBox = m_nodes[node].Box;
+
+		// reinsert if the box move out, or the fat box is too large after scale down
+		if (containBox(fatBox, box) && containBox(enlargeBox(box, 4.0f * BVH_FAT_RATIO), fatBox))
+			return false;
+
+		removeLeaf(node);
+		m_nodes[node].Box = enlargeBox(box, BVH_FAT_RATIO);
+		insertLeaf(node);
+		return true;
+	}
+
+	void CCullingBVH::insertLeaf(int leaf)
+	{
+		if (m_root == -1)
+		{
+			m_root = leaf;
+			m_nodes[leaf].Parent = -1;
+			return;
+		}
+
+		// find the best sibling, by the cost of the surface area
+		core::aabbox3df leafBox = m_nodes[leaf].Box;
+
+		int index = m_root;
+		while (!m_nodes[index].isLeaf())
+		{
+			const SNode& node = m_nodes[index];
+			const SNode& child1 = m_nodes[node.Child1];
+			const SNode& child2 = m_nodes[node.Child2];
+
+			f32 area = getBoxArea(node.Box);
+			f32 combinedArea = getBoxArea(mergeBox(node.Box, leafBox));
+
+			// cost of creating a new parent for this node and the leaf
+			f32 cost = 2.0f * combinedArea;
+
+			// minimum cost of pushing the leaf further down the tree
+			f32 inheritanceCost = 2.0f * (combinedArea - area);
+
+			f32 cost1 = getBoxArea(mergeBox(child1.Box, leafBox)) + inheritanceCost;
+			if (!child1.isLeaf())
+				cost1 -= getBoxArea(child1.Box);
+
+			f32 cost2 = getBoxArea(mergeBox(child2.Box, leafBox)) + inheritanceCost;
+			if (!child2.isLeaf())
+				cost2 -= getBoxArea(child2.Box);
+
+			if (cost < cost1 && cost < cost2)
+				break;
+
+			index = cost1 < cost2 ? node.Child1 : node.Child2;
+		}
+
+		int sibling = index;
+
+		// create a new parent
+		int oldParent = m_nodes[sibling].Parent;
+		int newParent = allocateNode();
+
+		SNode& parent = m_nodes[newParent];
+		parent.Parent = oldParent;
+		parent.Box = mergeBox(leafBox, m_nodes[sibling].Box);
+		parent.Height = m_nodes[sibling].Height + 1;
+		parent.Child1 = sibling;
+		parent.Child2 = leaf;
+
+		if (oldParent != -1)
+		{
+			if (m_nodes[oldParent].Child1 == sibling)
+				m_nodes[oldParent].Child1 = newParent;
+			else
+				m_nodes[oldParent].Child2 = newParent;
+		}
+		else
+		{
+			m_root = newParent;
+		}
+
+		m_nodes[sibling].Parent = newParent;
+		m_nodes[leaf].Parent = newParent;
+
+		refit(newParent);
+	}
+
+	void CCullingBVH::removeLeaf(int leaf)
+	{
+		if (leaf == m_root)
+		{
+			m_root = -1;
+			return;
+		}
+
+		int parent = m_nodes[leaf].Parent;
+		int grandParent = m_nodes[parent].Parent;
+		int sibling = m_nodes[parent].Child1 == leaf ? m_nodes[parent].Child2 : m_nodes[parent].Child1;
+
+		if (grandParent != -1)
+		{
+			// connect the sibling to the grand parent
+			if (m_nodes[grandParent].Child1 == parent)
+				m_nodes[grandParent].Child1 = sibling;
+			else
+				m_nodes[grandParent].Child2 = sibling;
+
+			m_nodes[sibling].Parent = grandParent;
+			freeNode(parent);
+
+			refit(grandParent);
+		}
+		else
+		{
+			m_root = sibling;
+			m_nodes[sibling].Parent = -1;
+			freeNode(parent);
+		}
+	}
+
+	void CCullingBVH::refit(int index)
+	{
+		// walk back up the tree fixing heights and boxes
+		while (index != -1)
+		{
+			index = balance(index);
+
+			SNode& node = m_nodes[index];
+			const SNode& child1 = m_nodes[node.Child1];
+			const SNode& child2 = m_nodes[node.Child2];
+
+			node.Height = 1 + core::max_(child1.Height, child2.Height);
+			node.Box = mergeBox(child1.Box, child2.Box);
+
+			index = node.Parent;
+		}
+	}
+
+	int CCullingBVH::balance(int iA)
+	{
+		SNode* a = &m_nodes[iA];
+		if (a->isLeaf() || a->Height < 2)
+			return iA;
+
+		int iB = a->Child1;
+		int iC = a->Child2;
+		SNode* b = &m_nodes[iB];
+		SNode* c = &m_nodes[iC];
+
+		int diff = c->Height - b->Height;
+
+		// rotate C up
+		if (diff > 1)
+		{
+			int iF = c->Child1;
+			int iG = c->Child2;
+			SNode* f = &m_nodes[iF];
+			SNode* g = &m_nodes[iG];
+
+			c->Child1 = iA;
+			c->Parent = a->Parent;
+			a->Parent = iC;
+
+			if (c->Parent != -1)
+			{
+				if (m_nodes[c->Parent].Child1 == iA)
+					m_nodes[c->Parent].Child1 = iC;
+				else
+					m_nodes[c->Parent].Child2 = iC;
+			}
+			else
+			{
+				m_root = iC;
+			}
+
+			if (f->Height > g->Height)
+			{
+				c->Child2 = iF;
+				a->Child2 = iG;
+				g->Parent = iA;
+				a->Box = mergeBox(b->Box, g->Box);
+				c->Box = mergeBox(a->Box, f->Box);
+				a->Height = 1 + core::max_(b->Height, g->Height);
+				c->Height = 1 + core::max_(a->Height, f->Height);
+			}
+			else
+			{
+				c->Child2 = iG;
+				a->Child2 = iF;
+				f->Parent = iA;
+				a->Box = mergeBox(b->Box, f->Box);
+				c->Box = mergeBox(a->Box, g->Box);
+				a->Height = 1 + core::max_(b->Height, f->Height);
+				c->Height = 1 + core::max_(a->Height, g->Height);
+			}
+
+			return iC;
+		}
+
+		// rotate B up
+		if (diff < -1)
+		{
+			int iD = b->Child1;
+			int iE = b->Child2;
+			SNode* d = &m_nodes[iD];
+			SNode* e = &m_nodes[iE];
+
+			b->Child1 = iA;
+			b->Parent = a->Parent;
+			a->Parent = iB;
+
+			if (b->Parent != -1)
+			{
+				if (m_nodes[b->Parent].Child1 == iA)
+					m_nodes[b->Parent].Child1 = iB;
+				else
+					m_nodes[b->Parent].Child2 = iB;
+			}
+			else
+			{
+				m_root = iB;
+			}
+
+			if (d->Height > e->Height)
+			{
+				b->Child2 = iD;
+				a->Child1 = iE;
+				e->Parent = iA;
+				a->Box = mergeBox(c->Box, e->Box);
+				b->Box = mergeBox(a->Box, d->Box);
+				a->Height = 1 + core::max_(c->Height, e->Height);
+				b->Height = 1 + core::max_(a->Height, d->Height);
+			}
+			else
+			{
+				b->Child2 = iE;
+				a->Child1 = iD;
+				d->Parent = iA;
+				a->Box = mergeBox(c->Box, d->Box);
+				b->Box = mergeBox(a->Box, e->Box);
+				a->Height = 1 + core::max_(c->Height, d->Height);
+				b->Height = 1 + core::max_(a->Height, e->Height);
+			}
+
+			return iB;
+		}
+
+		return iA;
+	}
+
+	void CCullingBVH::query(const core::aabbox3df& box, const core::plane3df* planes, int numPlane, CFastArray<int>& result)
+	{
+		result.reset();
+
+		if (m_root == -1)
+			return;
+
+		m_stack.reset();
+
+		SQueryItem* item = m_stack.getPush();
+		item->Node = m_root;
+		item->PlaneMask = (1 << numPlane) - 1;
+
+		while (m_stack.count() > 0)
+		{
+			SQueryItem current = m_stack.pointer()[m_stack.count() - 1];
+			m_stack.pop();
+
+			const SNode& node = m_nodes[current.Node];
+
+			if (!node.Box.intersectsWithBox(box))
+				continue;
+
+			core::vector3df center = node.Box.getCenter();
+			core::vector3df extent = node.Box.getExtent() * 0.5f;
+
+			// test the planes that the parent intersects
+			u32 planeMask = current.PlaneMask;
+			bool outside = false;
+
+			for (int p = 0; p < numPlane; p++)
+			{
+				u32 bit = 1 << p;
+				if ((planeMask & bit) == 0)
+					continue;
+
+				const core::plane3df& plane = planes[p];
+
+				f32 d = plane.Normal.dotProduct(center) + plane.D;
+				f32 r = fabsf(plane.Normal.X) * extent.X +
+					fabsf(plane.Normal.Y) * extent.Y +
+					fabsf(plane.Normal.Z) * extent.Z;
+
+				// the normal points out of the frustum (see SViewFrustum::setFrom)
+				if (d - r > 0.0f)
+				{
+					outside = true;
+					break;
+				}
+
+				// the node is inside this plane, the children do not need test it
+				if (d + r <= 0.0f)
+					planeMask &= ~bit;
+			}
+
+			if (outside)
+				continue;
+
+			// accept the whole sub tree
+			if (planeMask == 0 && containBox(box, node.Box))
+			{
+				addSubTree(current.Node, result);
+				continue;
+			}
+
+			if (node.isLeaf())
+			{
+				result.push(node.UserData);
+			}
+			else
+			{
+				item = m_stack.getPush();
+				item->Node = node.Child1;
+				item->PlaneMask = planeMask;
+
+				item = m_stack.getPush();
+				item->Node = node.Child2;
+				item->PlaneMask = planeMask;
+			}
+		}
+	}
+
+	void CCullingBVH::addSubTree(int index, CFastArray<int>& result)
+	{
+		const SNode& node = m_nodes[index];
+		if (node.isLeaf())
+		{
+			result.push(node.UserData);
+		}
+		else
+		{
+			addSubTree(node.Child1, result);
+			addSubTree(node.Child2, result);
+		}
+	}
+
+	bool CCullingBVH::validate()
+	{
+		if (m_root == -1)
+			return m_leafCount == 0;
+
+		if (m_nodes[m_root].Parent != -1)
+			return false;
+
+		return validate(m_root, -1);
+	}
+
+	bool CCullingBVH::validate(int index, int parent)
+	{
+		const SNode& node = m_nodes[index];
+
+		if (node.Parent != parent)
+			return false;
+
+		if (node.isLeaf())
+			return node.Height == 0;
+
+		const SNode& child1 = m_nodes[node.Child1];
+		const SNode& child2 = m_nodes[node.Child2];
+
+		if (node.Height != 1 + core::max_(child1.Height, child2.Height))
+			return false;
+
+		if (!containBox(node.Box, child1.Box) || !containBox(node.Box, child2.Box))
+			return false;
+
+		return validate(node.Child1, index) && validate(node.Child2, index);
+	}
+}
@@ -0,0 +1,142 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2023 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#pragma once
+
+#include "Entity/CArrayUtils.h"
+
+// the leaf box is enlarged by this ratio, so a small move do not need update the tree
+#define BVH_FAT_RATIO 0.1f
+
+namespace Skylicht
+{
+	/// Dynamic bounding volume tree of the world bounding boxes, used by CCullingSystem
+	class CCullingBVH
+	{
+	public:
+		struct SNode
+		{
+			core::aabbox3df Box;
+
+			// index of data on the leaf node
+			int UserData;
+
+			// parent node, or next free node
+			int Parent;
+
+			int Child1;
+			int Child2;
+
+			// leaf = 0, free = -1
+			int Height;
+
+			inline bool isLeaf() const
+			{
+				return Child1 == -1;
+			}
+		};
+
+	protected:
+		struct SQueryItem
+		{
+			int Node;
+
+			// bit of the planes that the node still intersects
+			u32 PlaneMask;
+		};
+
+		core::array<SNode> m_nodes;
+
+		int m_root;
+
+		int m_freeList;
+
+		int m_leafCount;
+
+		CFastArray<SQueryItem> m_stack;
+
+	public:
+		CCullingBVH();
+
+		virtual ~CCullingBVH();
+
+		void clear();
+
+		int insert(const core::aabbox3df& box, int userData);
+
+		void remove(int node);
+
+		// return true if the leaf is reinserted
+		bool move(int node, const core::aabbox3df& box);
+
+		// get the user data of leaves that intersect the box and inside all planes
+		void query(const core::aabbox3df& box, const core::plane3df* planes, int numPlane, CFastArray<int>& result);
+
+		inline void setUserData(int node, int userData)
+		{
+			m_nodes[node].UserData = userData;
+		}
+
+		inline int getUserData(int node)
+		{
+			return m_nodes[node].UserData;
+		}
+
+		inline const core::aabbox3df& getFatBox(int node)
+		{
+			return m_nodes[node].Box;
+		}
+
+		inline int getHeight()
+		{
+			return m_root == -1 ? 0 : m_nodes[m_root].Height;
+		}
+
+		inline int getLeafCount()
+		{
+			return m_leafCount;
+		}
+
+		// check the links, heights and boxes of the tree
+		bool validate();
+
+	protected:
+
+		int allocateNode();
+
+		void freeNode(int node);
+
+		void insertLeaf(int leaf);
+
+		void removeLeaf(int leaf);
+
+		int balance(int node);
+
+		void refit(int node);
+
+		void addSubTree(int node, CFastArray<int>& result);
+
+		bool validate(int node, int parent);
+	};
+}
@@ -34,6 +34,7 @@ namespace Skylicht
 	CCullingData::CCullingData() :
 		Type(CCullingData::BoundingBox),
 		Visible(true),
+		ViewMask(0),
 		Occlusion(false)
 	{
 
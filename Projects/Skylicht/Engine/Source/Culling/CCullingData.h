@@ -47,6 +47,9 @@ namespace Skylicht
 
 		u32 CullingLayer;
 
+		// visible bit of the views on CCullingSystem
+		u32 ViewMask;
+
 		bool Occlusion;
 
 		DECLARE_DATA_TYPE_INDEX;
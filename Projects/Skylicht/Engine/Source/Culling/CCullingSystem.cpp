@@ -25,25 +25,35 @@ https://github.com/skylicht-lab/skylicht-engine
 #include "pch.h"
 #include "CCullingSystem.h"
 #include "CCullingBBoxData.h"
+#include "CCullingBVH.h"
+#include "RenderMesh/CSkinnedMesh.h"
+#include "RenderMesh/CJointData.h"
 #include "Entity/CEntityManager.h"
 #include "RenderPipeline/IRenderPipeline.h"
 #include "Camera/CCamera.h"
 
 #include "RenderPipeline/CShadowMapRP.h"
 
+#include "Utils/CSIMD.h"
+
 namespace Skylicht
 {
 	bool CCullingSystem::s_useCacheCulling = false;
 
 	CCullingSystem::CCullingSystem() :
-		m_group(NULL)
+		m_group(NULL),
+		m_queryID(0),
+		m_currentView(-1),
+		m_viewCulled(false),
+		m_viewQueried(false)
 	{
 		m_pipelineType = IRenderPipeline::Mix;
+		m_bvh = new CCullingBVH();
 	}
 
 	CCullingSystem::~CCullingSystem()
 	{
-
+		delete m_bvh;
 	}
 
 	void CCullingSystem::beginQuery(CEntityManager* entityManager)
@@ -63,6 +73,10 @@ namespace Skylicht
 		if (s_useCacheCulling)
 			return;
 
+		// the tree is updated for the views on this frame
+		if (m_currentView >= 0 && m_viewQueried)
+			return;
+
 		entities = m_group->getEntities();
 		numEntity = m_group->getEntityCount();
 
@@ -93,6 +107,10 @@ namespace Skylicht
 					m->Culling = culling;
 					m->BBox = meshObj->getBoundingBoxPtr();
 					m->Materials = &meshObj->Materials;
+
+					culling->CameraCulled = true;
+					culling->Visible = false;
+					culling->ViewMask = 0;
 				}
 				else
 				{
@@ -104,10 +122,143 @@ namespace Skylicht
 						m->Culling = culling;
 						m->BBox = &bbox->BBox;
 						m->Materials = &bbox->Materials;
+
+						culling->CameraCulled = true;
+						culling->Visible = false;
+						culling->ViewMask = 0;
 					}
 				}
 			}
 		}
+
+		updateBVH();
+
+		m_viewQueried = m_views.size() > 0;
+	}
+
+	void CCullingSystem::updateBVH()
+	{
+		m_queryID++;
+		m_changedBoxes.reset();
+
+		int count = m_bboxAndMaterials.count();
+		SBBoxAndMaterial* bboxMats = m_bboxAndMaterials.pointer();
+
+		for (int i = 0; i < count; i++)
+		{
+			SBBoxAndMaterial* bbBoxMat = &bboxMats[i];
+
+			CEntity* entity = bbBoxMat->Entity;
+			CCullingData* culling = bbBoxMat->Culling;
+			CWorldTransformData* transform = GET_ENTITY_DATA(entity, CWorldTransformData);
+
+			u32 entityIndex = (u32)entity->getIndex();
+			while (m_proxies.size() <= entityIndex)
+				m_proxies.push_back(SCullingProxy());
+
+			SCullingProxy& proxy = m_proxies[entityIndex];
+			proxy.QueryID = m_queryID;
+
+			if (proxy.Node == -1)
+			{
+				// new entity on the tree
+				culling->BBox = *bbBoxMat->BBox;
+				transform->World.transformBoxEx(culling->BBox);
+
+				proxy.Node = m_bvh->insert(culling->BBox, i);
+				proxy.LocalBBox = *bbBoxMat->BBox;
+				m_proxyEntities.push(entityIndex);
+
+				m_changedBoxes.push(culling->BBox);
+			}
+			else
+			{
+				m_bvh->setUserData(proxy.Node, i);
+
+				// refit the entity that moved or changed the mesh
+				if (transform->NeedValidate || proxy.LocalBBox != *bbBoxMat->BBox)
+				{
+					m_changedBoxes.push(culling->BBox);
+
+					culling->BBox = *bbBoxMat->BBox;
+					transform->World.transformBoxEx(culling->BBox);
+
+					m_bvh->move(proxy.Node, culling->BBox);
+					proxy.LocalBBox = *bbBoxMat->BBox;
+
+					m_changedBoxes.push(culling->BBox);
+				}
+				else
+				{
+					// the skinned mesh is deformed only by the joints animated on this frame
+					CRenderMeshData* renderMesh = GET_ENTITY_DATA(entity, CRenderMeshData);
+					if (renderMesh != NULL && renderMesh->isSkinnedMesh() && isSkinChanged(renderMesh))
+						m_changedBoxes.push(culling->BBox);
+				}
+			}
+		}
+
+		// remove the entities that are not in the query
+		int i = 0;
+		while (i < m_proxyEntities.count())
+		{
+			u32* proxyEntities = m_proxyEntities.pointer();
+			u32 entityIndex = proxyEntities[i];
+
+			SCullingProxy& proxy = m_proxies[entityIndex];
+			if (proxy.QueryID != m_queryID)
+			{
+				m_changedBoxes.push(m_bvh->getFatBox(proxy.Node));
+				m_bvh->remove(proxy.Node);
+				proxy.Node = -1;
+
+				proxyEntities[i] = proxyEntities[m_proxyEntities.count() - 1];
+				m_proxyEntities.pop();
+			}
+			else
+			{
+				i++;
+			}
+		}
+	}
+
+	bool CCullingSystem::isSkinChanged(CRenderMeshData* renderMesh)
+	{
+		CSkinnedMesh* skinnedMesh = (CSkinnedMesh*)renderMesh->getMesh();
+		if (skinnedMesh == NULL)
+			return false;
+
+		for (u32 i = 0, n = skinnedMesh->Joints.size(); i < n; i++)
+		{
+			CJointData* joint = skinnedMesh->Joints[i].JointData;
+			if (joint == NULL || joint->Changed)
+				return true;
+		}
+
+		return false;
+	}
+
+	bool CCullingSystem::checkRender(IRenderPipeline* rp, u32 cullingMask, SBBoxAndMaterial* bbBoxMat)
+	{
+		// check camera mask culling
+		if ((cullingMask & bbBoxMat->Culling->CullingLayer) == 0)
+			return false;
+
+		// check material
+		if (bbBoxMat->Materials != NULL)
+		{
+			CMaterial** materials = bbBoxMat->Materials->data();
+			int materialCount = (int)bbBoxMat->Materials->size();
+
+			for (int j = 0; j < materialCount; j++)
+			{
+				CMaterial* m = materials[j];
+				if (m != NULL && rp->canRenderMaterial(m) == false)
+					return false;
+			}
+		}
+
+		return true;
 	}
 
 	void CCullingSystem::init(CEntityManager* entityManager)
@@ -121,128 +272,450 @@ namespace Skylicht
 		if (rp == NULL)
 			return;
 
-		core::matrix4 invTrans;
-
 		// camera
 		CCamera* camera = entityManager->getCamera();
 		u32 cameraCullingMask = camera->getCullingMask();
-		const core::aabbox3df& cameraBox = camera->getViewFrustum().getBoundingBox();
 
-		int count = m_bboxAndMaterials.count();
 		SBBoxAndMaterial* bboxMats = m_bboxAndMaterials.pointer();
 
-		for (int i = 0; i < count; i++)
+		if (m_currentView >= 0)
 		{
-			SBBoxAndMaterial* bbBoxMat = &bboxMats[i];
+			// test all views once, then the passes use the view mask
+			if (!m_viewCulled)
+				cullViews();
 
-			CEntity* entity = bbBoxMat->Entity;
+			applyView(rp, cameraCullingMask);
+			return;
+		}
+
+		if (s_useCacheCulling)
+		{
+			// use the last test result, just check the mask & material
+			int* cameraVisible = m_cameraVisible.pointer();
+			for (int i = 0, n = m_cameraVisible.count(); i < n; i++)
+			{
+				SBBoxAndMaterial* bbBoxMat = &bboxMats[cameraVisible[i]];
+				bbBoxMat->Culling->Visible = checkRender(rp, cameraCullingMask, bbBoxMat);
+			}
+			return;
+		}
+
+		// 1. Query the tree, reject the sub trees outside the box or planes
+		const SViewFrustum* frustum = NULL;
+
+		if (rp->getType() == IRenderPipeline::ShadowMap)
+		{
+			CShadowMapRP* shadowMapRP = (CShadowMapRP*)rp;
+			m_bvh->query(shadowMapRP->getFrustumBox(), NULL, 0, m_queryResult);
+		}
+		else
+		{
+			frustum = &camera->getViewFrustum();
+			m_bvh->query(frustum->getBoundingBox(), frustum->planes, scene::SViewFrustum::VF_PLANE_COUNT, m_queryResult);
+		}
+
+		m_testIndex.reset();
+		m_centerX.reset();
+		m_centerY.reset();
+		m_centerZ.reset();
+		m_extentX.reset();
+		m_extentY.reset();
+		m_extentZ.reset();
+
+		int* queryResult = m_queryResult.pointer();
+
+		for (int i = 0, n = m_queryResult.count(); i < n; i++)
+		{
+			CCullingData* culling = bboxMats[queryResult[i]].Culling;
+
+			core::vector3df center = culling->BBox.getCenter();
+			core::vector3df extent = culling->BBox.getExtent() * 0.5f;
+
+			m_testIndex.push(queryResult[i]);
+			m_centerX.push(center.X);
+			m_centerY.push(center.Y);
+			m_centerZ.push(center.Z);
+			m_extentX.push(extent.X);
+			m_extentY.push(extent.Y);
+			m_extentZ.push(extent.Z);
+		}
+
+		// 2. Test the world bbox of the leaves
+		if (frustum)
+		{
+			testBBoxes(frustum->getBoundingBox(), frustum);
+		}
+		else
+		{
+			CShadowMapRP* shadowMapRP = (CShadowMapRP*)rp;
+			testBBoxes(shadowMapRP->getFrustumBox(), NULL);
+		}
+
+		int* testIndex = m_testIndex.pointer();
+		u8* testResult = m_testResult.pointer();
+
+		m_cameraVisible.reset();
+
+		for (int i = 0, n = m_testIndex.count(); i < n; i++)
+		{
+			SBBoxAndMaterial* bbBoxMat = &bboxMats[testIndex[i]];
 			CCullingData* culling = bbBoxMat->Culling;
 
-			if (s_useCacheCulling)
+			u8 result = testResult[i];
+
+			culling->CameraCulled = (result & 1) != 0;
+			if (!culling->CameraCulled && culling->Type == CCullingData::FrustumBox)
+				culling->CameraCulled = (result & 2) != 0;
+
+			if (culling->CameraCulled)
+				continue;
+
+			m_cameraVisible.push(testIndex[i]);
+			culling->Visible = checkRender(rp, cameraCullingMask, bbBoxMat);
+		}
+	}
+
+	void CCullingSystem::clearViews()
+	{
+		m_views.set_used(0);
+		m_viewVisible.reset();
+		m_currentView = -1;
+		m_viewCulled = false;
+		m_viewQueried = false;
+	}
+
+	int CCullingSystem::addView(const core::aabbox3df& box)
+	{
+		if (m_views.size() >= MAX_CULLING_VIEW)
+			return -1;
+
+		m_views.push_back(SCullingView());
+
+		SCullingView& view = m_views.getLast();
+		view.Box = box;
+		view.UseFrustum = false;
+
+		m_viewCulled = false;
+		return (int)m_views.size() - 1;
+	}
+
+	int CCullingSystem::addView(const SViewFrustum& frustum)
+	{
+		if (m_views.size() >= MAX_CULLING_VIEW)
+			return -1;
+
+		m_views.push_back(SCullingView());
+
+		SCullingView& view = m_views.getLast();
+		view.Box = frustum.getBoundingBox();
+		view.Frustum = frustum;
+		view.UseFrustum = true;
+
+		m_viewCulled = false;
+		return (int)m_views.size() - 1;
+	}
+
+	void CCullingSystem::setView(int view, const core::aabbox3df& box)
+	{
+		if (view < 0 || view >= (int)m_views.size())
+			return;
+
+		SCullingView& v = m_views[view];
+		v.Box = box;
+		v.UseFrustum = false;
+
+		m_viewCulled = false;
+	}
+
+	void CCullingSystem::setCurrentView(int view)
+	{
+		if (view >= (int)m_views.size())
+			view = -1;
+
+		m_currentView = view;
+	}
+
+	void CCullingSystem::queryViews(CEntityManager* entityManager)
+	{
+		if (m_views.size() == 0 || m_viewCulled)
+			return;
+
+		if (!m_viewQueried)
+		{
+			beginQuery(entityManager);
+			onQuery(entityManager, NULL, 0);
+		}
+		cullViews();
+	}
+
+	bool CCullingSystem::isChanged(const core::aabbox3df& box)
+	{
+		core::aabbox3df* boxes = m_changedBoxes.pointer();
+		for (int i = 0, n = m_changedBoxes.count(); i < n; i++)
+		{
+			if (boxes[i].intersectsWithBox(box))
+				return true;
+		}
+		return false;
+	}
+
+	bool CCullingSystem::isChanged(const SViewFrustum& frustum)
+	{
+		const core::aabbox3df& frustumBox = frustum.getBoundingBox();
+
+		core::aabbox3df* boxes = m_changedBoxes.pointer();
+		for (int i = 0, n = m_changedBoxes.count(); i < n; i++)
+		{
+			if (!boxes[i].intersectsWithBox(frustumBox))
+				continue;
+
+			core::vector3df center = boxes[i].getCenter();
+			core::vector3df extent = boxes[i].getExtent() * 0.5f;
+
+			// the frustum plane normals point out (see SViewFrustum::setFrom)
+			// the box is outside if the nearest corner is on front of a plane
+			bool outside = false;
+			for (int p = 0; p < scene::SViewFrustum::VF_PLANE_COUNT && !outside; p++)
 			{
-				// if we have the last test result
-				if (culling->CameraCulled == true)
-					continue;
+				const core::plane3df& plane = frustum.planes[p];
+
+				f32 d = center.dotProduct(plane.Normal) + plane.D -
+					extent.X * fabsf(plane.Normal.X) -
+					extent.Y * fabsf(plane.Normal.Y) -
+					extent.Z * fabsf(plane.Normal.Z);
+
+				outside = d > 0.0f;
 			}
-			else
+
+			if (!outside)
+				return true;
+		}
+		return false;
+	}
+
+	void CCullingSystem::cullViews()
+	{
+		int numView = (int)m_views.size();
+
+		// query the tree once by the box of all views
+		core::aabbox3df box = m_views[0].Box;
+		for (int v = 1; v < numView; v++)
+			box.addInternalBox(m_views[v].Box);
+
+		m_bvh->query(box, NULL, 0, m_queryResult);
+
+		m_testIndex.reset();
+		m_centerX.reset();
+		m_centerY.reset();
+		m_centerZ.reset();
+		m_extentX.reset();
+		m_extentY.reset();
+		m_extentZ.reset();
+
+		SBBoxAndMaterial* bboxMats = m_bboxAndMaterials.pointer();
+		int* queryResult = m_queryResult.pointer();
+
+		for (int i = 0, n = m_queryResult.count(); i < n; i++)
+		{
+			CCullingData* culling = bboxMats[queryResult[i]].Culling;
+			culling->ViewMask = 0;
+
+			core::vector3df center = culling->BBox.getCenter();
+			core::vector3df extent = culling->BBox.getExtent() * 0.5f;
+
+			m_testIndex.push(queryResult[i]);
+			m_centerX.push(center.X);
+			m_centerY.push(center.Y);
+			m_centerZ.push(center.Z);
+			m_extentX.push(extent.X);
+			m_extentY.push(extent.Y);
+			m_extentZ.push(extent.Z);
+		}
+
+		int* testIndex = m_testIndex.pointer();
+		int numTest = m_testIndex.count();
+
+		// test the candidates with each view
+		for (int v = 0; v < numView; v++)
+		{
+			SCullingView& view = m_views[v];
+			testBBoxes(view.Box, view.UseFrustum ? &view.Frustum : NULL);
+
+			u8* testResult = m_testResult.pointer();
+			u32 bit = 1 << v;
+
+			for (int i = 0; i < numTest; i++)
 			{
-				culling->CameraCulled = false;
+				CCullingData* culling = bboxMats[testIndex[i]].Culling;
+
+				u8 result = testResult[i];
+
+				bool culled = (result & 1) != 0;
+				if (!culled && culling->Type == CCullingData::FrustumBox)
+					culled = (result & 2) != 0;
+
+				if (!culled)
+					culling->ViewMask |= bit;
 			}
+		}
 
-			culling->Visible = true;
+		m_viewVisible.reset();
+		for (int i = 0; i < numTest; i++)
+		{
+			if (bboxMats[testIndex[i]].Culling->ViewMask != 0)
+				m_viewVisible.push(testIndex[i]);
+		}
 
-			// check camera mask culling
-			u32 test = cameraCullingMask & culling->CullingLayer;
-			if (test == 0)
+		m_viewCulled = true;
+	}
+
+	void CCullingSystem::applyView(IRenderPipeline* rp, u32 cullingMask)
+	{
+		SBBoxAndMaterial* bboxMats = m_bboxAndMaterials.pointer();
+		int* viewVisible = m_viewVisible.pointer();
+		u32 bit = 1 << m_currentView;
+
+		m_cameraVisible.reset();
+
+		for (int i = 0, n = m_viewVisible.count(); i < n; i++)
+		{
+			SBBoxAndMaterial* bbBoxMat = &bboxMats[viewVisible[i]];
+			CCullingData* culling = bbBoxMat->Culling;
+
+			if (culling->ViewMask & bit)
 			{
+				culling->CameraCulled = false;
+				culling->Visible = checkRender(rp, cullingMask, bbBoxMat);
+				m_cameraVisible.push(viewVisible[i]);
+			}
+			else
+			{
+				culling->CameraCulled = true;
 				culling->Visible = false;
-				continue;
 			}
+		}
+	}
 
-			// check material first
-			if (bbBoxMat->Materials != NULL)
-			{
-				CMaterial** materials = bbBoxMat->Materials->data();
-				int materialCount = (int)bbBoxMat->Materials->size();
+	void CCullingSystem::testBBoxes(const core::aabbox3df& box, const SViewFrustum* frustum)
+	{
+		int count = m_testIndex.count();
 
-				for (int j = 0; j < materialCount; j++)
-				{
-					CMaterial* m = materials[j];
-					if (m != NULL && rp->canRenderMaterial(m) == false)
-					{
-						culling->Visible = false;
-						break;
-					}
-				}
-			}
+		m_testResult.reset();
+		for (int i = 0; i < count; i++)
+			m_testResult.push(0);
 
-			if (culling->Visible == false)
-				continue;
+		if (count == 0)
+			return;
 
-			if (s_useCacheCulling)
-				continue;
+		f32* cx = m_centerX.pointer();
+		f32* cy = m_centerY.pointer();
+		f32* cz = m_centerZ.pointer();
+		f32* ex = m_extentX.pointer();
+		f32* ey = m_extentY.pointer();
+		f32* ez = m_extentZ.pointer();
+		u8* result = m_testResult.pointer();
 
-			// transform world bbox
-			culling->BBox = *bbBoxMat->BBox;
+		core::vector3df boxCenter = box.getCenter();
+		core::vector3df boxExtent = box.getExtent() * 0.5f;
 
-			CWorldTransformData* transform = GET_ENTITY_DATA(entity, CWorldTransformData);
-			transform->World.transformBoxEx(culling->BBox);
+		// plane: normal, abs(normal), d
+		f32 planes[scene::SViewFrustum::VF_PLANE_COUNT][7];
+		int numPlane = 0;
 
-			// 1. Detect by bounding box
-			if (rp->getType() == IRenderPipeline::ShadowMap)
+		if (frustum)
+		{
+			numPlane = scene::SViewFrustum::VF_PLANE_COUNT;
+			for (int p = 0; p < numPlane; p++)
 			{
-				CShadowMapRP* shadowMapRP = (CShadowMapRP*)rp;
-
-				const core::aabbox3df& box = shadowMapRP->getFrustumBox();
-				culling->CameraCulled = !culling->BBox.intersectsWithBox(box);
-				culling->Visible = !culling->CameraCulled;
-				continue;
+				const core::plane3df& plane = frustum->planes[p];
+				planes[p][0] = plane.Normal.X;
+				planes[p][1] = plane.Normal.Y;
+				planes[p][2] = plane.Normal.Z;
+				planes[p][3] = fabsf(plane.Normal.X);
+				planes[p][4] = fabsf(plane.Normal.Y);
+				planes[p][5] = fabsf(plane.Normal.Z);
+				planes[p][6] = plane.D;
 			}
-			else
+		}
+
+		int i = 0;
+
+#if defined(USE_SIMD)
+		SIMDVec bcx = simdSet(boxCenter.X);
+		SIMDVec bcy = simdSet(boxCenter.Y);
+		SIMDVec bcz = simdSet(boxCenter.Z);
+		SIMDVec bex = simdSet(boxExtent.X);
+		SIMDVec bey = simdSet(boxExtent.Y);
+		SIMDVec bez = simdSet(boxExtent.Z);
+		SIMDVec zero = simdSet(0.0f);
+
+		for (; i + 4 <= count; i += 4)
+		{
+			SIMDVec x = simdLoad(cx + i);
+			SIMDVec y = simdLoad(cy + i);
+			SIMDVec z = simdLoad(cz + i);
+			SIMDVec sx = simdLoad(ex + i);
+			SIMDVec sy = simdLoad(ey + i);
+			SIMDVec sz = simdLoad(ez + i);
+
+			// the boxes do not intersect if the distance of centers > sum of extents on an axis
+			SIMDVec outBox = simdGreater(simdAbs(simdSub(x, bcx)), simdAdd(sx, bex));
+			outBox = simdOr(outBox, simdGreater(simdAbs(simdSub(y, bcy)), simdAdd(sy, bey)));
+			outBox = simdOr(outBox, simdGreater(simdAbs(simdSub(z, bcz)), simdAdd(sz, bez)));
+
+			// the plane normals point out of the frustum (see SViewFrustum::setFrom)
+			// the box is outside if the nearest corner is on front of a plane
+			SIMDVec outPlane = zero;
+			for (int p = 0; p < numPlane; p++)
 			{
-				culling->CameraCulled = !culling->BBox.intersectsWithBox(cameraBox);
-				culling->Visible = !culling->CameraCulled;
+				const f32* plane = planes[p];
+
+				SIMDVec d = simdAdd(simdMul(x, simdSet(plane[0])), simdSet(plane[6]));
+				d = simdAdd(d, simdMul(y, simdSet(plane[1])));
+				d = simdAdd(d, simdMul(z, simdSet(plane[2])));
+				d = simdSub(d, simdMul(sx, simdSet(plane[3])));
+				d = simdSub(d, simdMul(sy, simdSet(plane[4])));
+				d = simdSub(d, simdMul(sz, simdSet(plane[5])));
+
+				outPlane = simdOr(outPlane, simdGreater(d, zero));
 			}
 
-			// 2. Detect algorithm
-			if (culling->Visible == true)
+			int maskBox = simdMoveMask(outBox);
+			int maskPlane = simdMoveMask(outPlane);
+
+			for (int j = 0; j < 4; j++)
+				result[i + j] = (u8)(((maskBox >> j) & 1) | (((maskPlane >> j) & 1) << 1));
+		}
+#endif
+
+		for (; i < count; i++)
+		{
+			u8 r = 0;
+
+			if (fabsf(cx[i] - boxCenter.X) > ex[i] + boxExtent.X ||
+				fabsf(cy[i] - boxCenter.Y) > ey[i] + boxExtent.Y ||
+				fabsf(cz[i] - boxCenter.Z) > ez[i] + boxExtent.Z)
+				r |= 1;
+
+			for (int p = 0; p < numPlane; p++)
 			{
-				if (culling->Type == CCullingData::FrustumBox)
+				const f32* plane = planes[p];
+
+				f32 d = cx[i] * plane[0] + plane[6] +
+					cy[i] * plane[1] +
+					cz[i] * plane[2] -
+					ex[i] * plane[3] -
+					ey[i] * plane[4] -
+					ez[i] * plane[5];
+
+				if (d > 0.0f)
 				{
-					CWorldInverseTransformData* invTransform = GET_ENTITY_DATA(entity, CWorldInverseTransformData);
-					if (invTransform)
-					{
-						// transform the frustum to the node's current absolute transformation
-						invTrans = invTransform->WorldInverse;
-
-						SViewFrustum frust = camera->getViewFrustum();
-						frust.transform(invTrans);
-
-						core::vector3df edges[8];
-						bbBoxMat->BBox->getEdges(edges);
-
-						for (s32 i = 0; i < scene::SViewFrustum::VF_PLANE_COUNT; ++i)
-						{
-							bool boxInFrustum = false;
-							for (u32 j = 0; j < 8; ++j)
-							{
-								if (frust.planes[i].classifyPointRelation(edges[j]) != core::ISREL3D_FRONT)
-								{
-									boxInFrustum = true;
-									break;
-								}
-							}
-
-							if (!boxInFrustum)
-							{
-								culling->CameraCulled = true;
-								culling->Visible = false;
-								break;
-							}
-						}
-					} // if invTransform
+					r |= 2;
+					break;
 				}
 			}
+
+			result[i] = r;
 		}
 	}
 
@@ -32,6 +32,8 @@ https://github.com/skylicht-lab/skylicht-engine
 #include "Transform/CWorldInverseTransformData.h"
 #include "RenderMesh/CRenderMeshData.h"
 
+#define MAX_CULLING_VIEW 32
+
 namespace Skylicht
 {
 	struct SBBoxAndMaterial
@@ -53,11 +55,77 @@ namespace Skylicht
 		}
 	};
 
+	struct SCullingProxy
+	{
+		// leaf node on the tree
+		int Node;
+
+		// the last query that has this entity
+		u32 QueryID;
+
+		// local bbox used to calculate the leaf, the mesh could update its bbox on the same pointer
+		core::aabbox3df LocalBBox;
+
+		SCullingProxy()
+		{
+			Node = -1;
+			QueryID = 0;
+		}
+	};
+
+	struct SCullingView
+	{
+		core::aabbox3df Box;
+
+		SViewFrustum Frustum;
+
+		bool UseFrustum;
+	};
+
+	class CCullingBVH;
+
 	class CCullingSystem : public IRenderSystem
 	{
 	protected:
 		CFastArray<SBBoxAndMaterial> m_bboxAndMaterials;
 
+		// tree of the world bbox, the leaf data is index of m_bboxAndMaterials
+		CCullingBVH* m_bvh;
+
+		// tree proxy (by entity index)
+		core::array<SCullingProxy> m_proxies;
+		CFastArray<u32> m_proxyEntities;
+		u32 m_queryID;
+
+		// world bbox of the entities that moved, changed or removed on the last query (old & new place)
+		CFastArray<core::aabbox3df> m_changedBoxes;
+
+		CFastArray<int> m_queryResult;
+
+		// the entities that are not culled by the last test
+		CFastArray<int> m_cameraVisible;
+
+		// the views that are culled together, the result is CCullingData::ViewMask
+		core::array<SCullingView> m_views;
+		CFastArray<int> m_viewVisible;
+		int m_currentView;
+		bool m_viewCulled;
+
+		// the tree is updated for the views, the views added later are just culled again
+		bool m_viewQueried;
+
+		// world bbox (center, extent) of the entities need test, SoA layout for SIMD
+		CFastArray<int> m_testIndex;
+		CFastArray<f32> m_centerX;
+		CFastArray<f32> m_centerY;
+		CFastArray<f32> m_centerZ;
+		CFastArray<f32> m_extentX;
+		CFastArray<f32> m_extentY;
+		CFastArray<f32> m_extentZ;
+
+		// bit 0: outside the test box, bit 1: outside the frustum planes
+		CFastArray<u8> m_testResult;
+
 		static bool s_useCacheCulling;
 
 		CEntityGroup* m_group;
@@ -88,5 +156,67 @@ namespace Skylicht
 		{
 			return s_useCacheCulling;
 		}
+
+		// remove all views, cull by the current camera
+		void clearViews();
+
+		// the shadow view: test by the box
+		int addView(const core::aabbox3df& box);
+
+		// the camera view: test by the box & frustum planes
+		int addView(const SViewFrustum& frustum);
+
+		// change the box of a shadow view, it is culled again on the next pass
+		void setView(int view, const core::aabbox3df& box);
+
+		// the view that the next passes use, -1 to cull by the current camera
+		void setCurrentView(int view);
+
+		// query the entities and test all views now, the next passes just apply the view mask
+		void queryViews(CEntityManager* entityManager);
+
+		inline int getCurrentView()
+		{
+			return m_currentView;
+		}
+
+		inline int getNumView()
+		{
+			return (int)m_views.size();
+		}
+
+		inline CFastArray<SBBoxAndMaterial>& getBBoxAndMaterials()
+		{
+			return m_bboxAndMaterials;
+		}
+
+		// index of m_bboxAndMaterials that are not culled by the last test
+		inline CFastArray<int>& getCameraVisible()
+		{
+			return m_cameraVisible;
+		}
+
+		inline CFastArray<core::aabbox3df>& getChangedBoxes()
+		{
+			return m_changedBoxes;
+		}
+
+		bool isChanged(const core::aabbox3df& box);
+
+		bool isChanged(const SViewFrustum& frustum);
+
+	protected:
+
+		void updateBVH();
+
+		void cullViews();
+
+		void applyView(IRenderPipeline* rp, u32 cullingMask);
+
+		bool checkRender(IRenderPipeline* rp, u32 cullingMask, SBBoxAndMaterial* bbBoxMat);
+
+		bool isSkinChanged(CRenderMeshData* renderMesh);
+
+		void testBBoxes(const core::aabbox3df& box, const SViewFrustum* frustum);
 	};
 }
\ No newline at end of file
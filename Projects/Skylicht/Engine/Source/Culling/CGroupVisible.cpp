@@ -35,6 +35,7 @@ namespace Skylicht
 		CEntityGroup(NULL, 0)
 	{
 		m_dataTypes.push_back(CVisibleData::DataTypeIndex);
+		m_incrementalQuery = true;
 	}
 
 	CGroupVisible::~CGroupVisible()
@@ -46,33 +47,72 @@ namespace Skylicht
 	{
 		CEntity** allEntities = entityManager->getEntities();
 
-		m_entities.reset();
+		clearEntities();
 
 		for (int i = 0; i < numEntity; i++)
 		{
 			CEntity* entity = entities[i];
 
-			CVisibleData* visible = GET_ENTITY_DATA(entity, CVisibleData);
-			CWorldTransformData* transform = GET_ENTITY_DATA(entity, CWorldTransformData);
+			// only select visible
+			if (updateVisible(entity, allEntities))
+				addEntity(entity);
+		}
+
+		m_needQuery = false;
+		m_needValidate = true;
+	}
+
+	void CGroupVisible::onQueryChanged(CEntityManager* entityManager, CEntity** entities, int numEntity)
+	{
+		CEntity** allEntities = entityManager->getEntities();
+
+		// the entities are sorted by depth, so the parent visible is updated before
+		for (int i = 0; i < numEntity; i++)
+		{
+			CEntity* entity = entities[i];
+
+			bool select = false;
+			if (entity->isAlive() && GET_ENTITY_DATA(entity, CVisibleData) != NULL)
+				select = updateVisible(entity, allEntities);
 
-			visible->SelfVisible = entities[i]->isVisible();
-			visible->Visible = visible->SelfVisible;
-			visible->Culled = false;
+			bool have = haveEntity(entity);
 
-			if (visible->Visible == true && transform->ParentIndex >= 0)
+			if (select && !have)
 			{
-				// link parent visible
-				CEntity* parentEntity = allEntities[transform->ParentIndex];
-				CVisibleData* parentVisible = GET_ENTITY_DATA(parentEntity, CVisibleData);
-				visible->Visible = parentVisible->Visible;
+				addEntity(entity);
+				m_needValidate = true;
 			}
+			else if (!select && have)
+			{
+				removeEntity(entity);
+				m_needValidate = true;
+			}
+		}
+	}
 
-			// only select visible
-			if (visible->Visible)
-				m_entities.push(entity);
+	u64 CGroupVisible::getDataMask()
+	{
+		// the parent of transform is used to link visible
+		return CEntityGroup::getDataMask() | (1ULL << CWorldTransformData::DataTypeIndex);
+	}
+
+	bool CGroupVisible::updateVisible(CEntity* entity, CEntity** allEntities)
+	{
+		CVisibleData* visible = GET_ENTITY_DATA(entity, CVisibleData);
+		CWorldTransformData* transform = GET_ENTITY_DATA(entity, CWorldTransformData);
+
+		visible->SelfVisible = entity->isVisible();
+		visible->Visible = visible->SelfVisible;
+		visible->Culled = false;
+
+		if (visible->Visible == true && transform != NULL && transform->ParentIndex >= 0)
+		{
+			// link parent visible
+			CEntity* parentEntity = allEntities[transform->ParentIndex];
+			CVisibleData* parentVisible = GET_ENTITY_DATA(parentEntity, CVisibleData);
+			visible->Visible = parentVisible != NULL && parentVisible->Visible;
 		}
 
-		m_needQuery = false;
-		m_needValidate = true;
+		return visible->Visible;
 	}
 }
\ No newline at end of file
@@ -35,5 +35,13 @@ namespace Skylicht
 		virtual ~CGroupVisible();
 
 		virtual void onQuery(CEntityManager* entityManager, CEntity** entities, int numEntity);
+
+		virtual void onQueryChanged(CEntityManager* entityManager, CEntity** entities, int numEntity);
+
+		virtual u64 getDataMask();
+
+	protected:
+
+		bool updateVisible(CEntity* entity, CEntity** allEntities);
 	};
 }
\ No newline at end of file
@@ -0,0 +1,469 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2023 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#include "pch.h"
+#include "COcclusionBuffer.h"
+
+#include "Utils/CSIMD.h"
+
+namespace Skylicht
+{
+	COcclusionBuffer::COcclusionBuffer(int width, int height) :
+		m_needUpdateTile(true)
+	{
+		// the size is multiple of tile size
+		m_numTileX = core::max_((width + OCCLUSION_TILE_SIZE - 1) / OCCLUSION_TILE_SIZE, 1);
+		m_numTileY = core::max_((height + OCCLUSION_TILE_SIZE - 1) / OCCLUSION_TILE_SIZE, 1);
+
+		m_width = m_numTileX * OCCLUSION_TILE_SIZE;
+		m_height = m_numTileY * OCCLUSION_TILE_SIZE;
+
+		m_depth.set_used(m_width * m_height);
+		m_tileDepth.set_used(m_numTileX * m_numTileY);
+
+		clear(core::IdentityMatrix);
+	}
+
+	COcclusionBuffer::~COcclusionBuffer()
+	{
+
+	}
+
+	void COcclusionBuffer::clear(const core::matrix4& viewProjection)
+	{
+		m_viewProjection = viewProjection;
+
+		memset(m_depth.pointer(), 0, m_depth.size() * sizeof(f32));
+		memset(m_tileDepth.pointer(), 0, m_tileDepth.size() * sizeof(f32));
+
+		m_needUpdateTile = false;
+	}
+
+	void COcclusionBuffer::drawMeshBuffer(const core::matrix4& world, IMeshBuffer* mb)
+	{
+		if (mb->getPrimitiveType() != scene::EPT_TRIANGLES)
+			return;
+
+		IVertexBuffer* vb = mb->getVertexBuffer(0);
+		IIndexBuffer* ib = mb->getIndexBuffer();
+		if (vb == NULL || ib == NULL)
+			return;
+
+		// the position is the first attribute of all vertex types
+		transformVertices(world, (const u8*)vb->getVertices(), vb->getVertexSize(), (int)vb->getVertexCount());
+
+		if (ib->getType() == video::EIT_16BIT)
+			drawIndexed((const u16*)ib->getIndices(), (int)ib->getIndexCount());
+		else
+			drawIndexed((const u32*)ib->getIndices(), (int)ib->getIndexCount());
+	}
+
+	void COcclusionBuffer::drawTriangles(const core::matrix4& world, const core::vector3df* positions, int numVertex, const u32* indices, int numIndex)
+	{
+		transformVertices(world, (const u8*)positions, sizeof(core::vector3df), numVertex);
+		drawIndexed(indices, numIndex);
+	}
+
+	void COcclusionBuffer::transformVertices(const core::matrix4& world, const u8* positions, u32 stride, int numVertex)
+	{
+		m_clipX.set_used(numVertex);
+		m_clipY.set_used(numVertex);
+		m_clipW.set_used(numVertex);
+		m_screenX.set_used(numVertex);
+		m_screenY.set_used(numVertex);
+		m_invW.set_used(numVertex);
+
+		core::matrix4 mvp = m_viewProjection * world;
+		const f32* m = mvp.pointer();
+
+		f32 halfW = 0.5f * (f32)m_width;
+		f32 halfH = 0.5f * (f32)m_height;
+
+		f32* clipX = m_clipX.pointer();
+		f32* clipY = m_clipY.pointer();
+		f32* clipW = m_clipW.pointer();
+		f32* screenX = m_screenX.pointer();
+		f32* screenY = m_screenY.pointer();
+		f32* invW = m_invW.pointer();
+
+		int i = 0;
+
+#if defined(USE_SIMD)
+		SIMDVec m0 = simdSet(m[0]), m4 = simdSet(m[4]), m8 = simdSet(m[8]), m12 = simdSet(m[12]);
+		SIMDVec m1 = simdSet(m[1]), m5 = simdSet(m[5]), m9 = simdSet(m[9]), m13 = simdSet(m[13]);
+		SIMDVec m3 = simdSet(m[3]), m7 = simdSet(m[7]), m11 = simdSet(m[11]), m15 = simdSet(m[15]);
+
+		SIMDVec one = simdSet(1.0f);
+		SIMDVec nearW = simdSet(OCCLUSION_NEAR_W);
+		SIMDVec vHalfW = simdSet(halfW);
+		SIMDVec vHalfH = simdSet(halfH);
+
+		f32 px[4], py[4], pz[4];
+
+		for (; i + 4 <= numVertex; i += 4)
+		{
+			for (int j = 0; j < 4; j++)
+			{
+				const f32* p = (const f32*)(positions + (i + j) * stride);
+				px[j] = p[0];
+				py[j] = p[1];
+				pz[j] = p[2];
+			}
+
+			SIMDVec x = simdLoad(px);
+			SIMDVec y = simdLoad(py);
+			SIMDVec z = simdLoad(pz);
+
+			SIMDVec cx = simdAdd(simdAdd(simdMul(x, m0), simdMul(y, m4)), simdAdd(simdMul(z, m8), m12));
+			SIMDVec cy = simdAdd(simdAdd(simdMul(x, m1), simdMul(y, m5)), simdAdd(simdMul(z, m9), m13));
+			SIMDVec cw = simdAdd(simdAdd(simdMul(x, m3), simdMul(y, m7)), simdAdd(simdMul(z, m11), m15));
+
+			simdStore(clipX + i, cx);
+			simdStore(clipY + i, cy);
+			simdStore(clipW + i, cw);
+
+			// the vertices behind near are clipped later, just avoid divide by zero
+			SIMDVec iw = simdDiv(one, simdMax(cw, nearW));
+
+			simdStore(screenX + i, simdMul(simdAdd(simdMul(cx, iw), one), vHalfW));
+			simdStore(screenY + i, simdMul(simdSub(one, simdMul(cy, iw)), vHalfH));
+			simdStore(invW + i, iw);
+		}
+#endif
+
+		for (; i < numVertex; i++)
+		{
+			const f32* p = (const f32*)(positions + i * stride);
+
+			clipX[i] = p[0] * m[0] + p[1] * m[4] + p[2] * m[8] + m[12];
+			clipY[i] = p[0] * m[1] + p[1] * m[5] + p[2] * m[9] + m[13];
+			clipW[i] = p[0] * m[3] + p[1] * m[7] + p[2] * m[11] + m[15];
+
+			f32 iw = 1.0f / core::max_(clipW[i], OCCLUSION_NEAR_W);
+
+			screenX[i] = (clipX[i] * iw + 1.0f) * halfW;
+			screenY[i] = (1.0f - clipY[i] * iw) * halfH;
+			invW[i] = iw;
+		}
+	}
+
+	template<class T>
+	void COcclusionBuffer::drawIndexed(const T* indices, int numIndex)
+	{
+		int numVertex = (int)m_clipW.size();
+
+		for (int i = 0; i + 2 < numIndex; i += 3)
+		{
+			int a = (int)indices[i];
+			int b = (int)indices[i + 1];
+			int c = (int)indices[i + 2];
+
+			if (a >= numVertex || b >= numVertex || c >= numVertex)
+				continue;
+
+			drawClippedTriangle(a, b, c);
+		}
+
+		m_needUpdateTile = true;
+	}
+
+	void COcclusionBuffer::projectVertex(f32 x, f32 y, f32 w, f32* out)
+	{
+		f32 iw = 1.0f / w;
+		out[0] = (x * iw + 1.0f) * 0.5f * (f32)m_width;
+		out[1] = (1.0f - y * iw) * 0.5f * (f32)m_height;
+		out[2] = iw;
+	}
+
+	void COcclusionBuffer::drawClippedTriangle(int a, int b, int c)
+	{
+		const f32* clipW = m_clipW.pointer();
+
+		int id[3] = { a, b, c };
+		int numInside = 0;
+		for (int i = 0; i < 3; i++)
+		{
+			if (clipW[id[i]] >= OCCLUSION_NEAR_W)
+				numInside++;
+		}
+
+		if (numInside == 0)
+			return;
+
+		if (numInside == 3)
+		{
+			f32 v[3][3];
+			for (int i = 0; i < 3; i++)
+			{
+				v[i][0] = m_screenX[id[i]];
+				v[i][1] = m_screenY[id[i]];
+				v[i][2] = m_invW[id[i]];
+			}
+			drawTriangle(v[0], v[1], v[2]);
+			return;
+		}
+
+		// clip the triangle by the near plane, the result has 3 or 4 vertices
+		const f32* clipX = m_clipX.pointer();
+		const f32* clipY = m_clipY.pointer();
+
+		f32 poly[4][3];
+		int numPoly = 0;
+
+		for (int i = 0; i < 3; i++)
+		{
+			int p = id[i];
+			int q = id[(i + 1) % 3];
+
+			f32 wp = clipW[p];
+			f32 wq = clipW[q];
+
+			if (wp >= OCCLUSION_NEAR_W)
+				projectVertex(clipX[p], clipY[p], wp, poly[numPoly++]);
+
+			if ((wp >= OCCLUSION_NEAR_W) != (wq >= OCCLUSION_NEAR_W))
+			{
+				f32 t = (OCCLUSION_NEAR_W - wp) / (wq - wp);
+				f32 x = clipX[p] + (clipX[q] - clipX[p]) * t;
+				f32 y = clipY[p] + (clipY[q] - clipY[p]) * t;
+				projectVertex(x, y, OCCLUSION_NEAR_W, poly[numPoly++]);
+			}
+		}
+
+		for (int i = 1; i + 1 < numPoly; i++)
+			drawTriangle(poly[0], poly[i], poly[i + 1]);
+	}
+
+	void COcclusionBuffer::drawTriangle(const f32* v0, const f32* v1, const f32* v2)
+	{
+		f32 area = (v1[0] - v0[0]) * (v2[1] - v0[1]) - (v2[0] - v0[0]) * (v1[1] - v0[1]);
+		if (fabsf(area) < 1e-6f)
+			return;
+
+		// both faces are rasterized, make the counter clockwise order
+		if (area < 0.0f)
+		{
+			const f32* t = v1;
+			v1 = v2;
+			v2 = t;
+			area = -area;
+		}
+
+		int minX = core::max_((int)floorf(core::min_(v0[0], v1[0], v2[0])), 0);
+		int maxX = core::min_((int)ceilf(core::max_(v0[0], v1[0], v2[0])), m_width - 1);
+		int minY = core::max_((int)floorf(core::min_(v0[1], v1[1], v2[1])), 0);
+		int maxY = core::min_((int)ceilf(core::max_(v0[1], v1[1], v2[1])), m_height - 1);
+
+		if (minX > maxX || minY > maxY)
+			return;
+
+		// edge functions: e = a * x + b * y + c, it is positive inside the triangle
+		const f32* v[3] = { v0, v1, v2 };
+		f32 ea[3], eb[3], ec[3];
+
+		for (int i = 0; i < 3; i++)
+		{
+			const f32* p = v[(i + 1) % 3];
+			const f32* q = v[(i + 2) % 3];
+
+			ea[i] = p[1] - q[1];
+			eb[i] = q[0] - p[0];
+			ec[i] = -(ea[i] * p[0] + eb[i] * p[1]);
+		}
+
+		// interpolate 1/w by the barycentric
+		f32 invArea = 1.0f / area;
+		f32 za = (v0[2] * ea[0] + v1[2] * ea[1] + v2[2] * ea[2]) * invArea;
+		f32 zb = (v0[2] * eb[0] + v1[2] * eb[1] + v2[2] * eb[2]) * invArea;
+		f32 zc = (v0[2] * ec[0] + v1[2] * ec[1] + v2[2] * ec[2]) * invArea;
+
+		f32* depth = m_depth.pointer();
+
+#if defined(USE_SIMD)
+		const f32 offset[4] = { 0.5f, 1.5f, 2.5f, 3.5f };
+
+		SIMDVec zero = simdSet(0.0f);
+		SIMDVec pixelOffset = simdLoad(offset);
+
+		SIMDVec a0 = simdSet(ea[0]), a1 = simdSet(ea[1]), a2 = simdSet(ea[2]);
+		SIMDVec vza = simdSet(za);
+
+		// the width is multiple of 4
+		int startX = minX & ~3;
+
+		for (int y = minY; y <= maxY; y++)
+		{
+			f32 py = (f32)y + 0.5f;
+
+			SIMDVec row0 = simdSet(eb[0] * py + ec[0]);
+			SIMDVec row1 = simdSet(eb[1] * py + ec[1]);
+			SIMDVec row2 = simdSet(eb[2] * py + ec[2]);
+			SIMDVec rowZ = simdSet(zb * py + zc);
+
+			f32* line = depth + y * m_width;
+
+			for (int x = startX; x <= maxX; x += 4)
+			{
+				SIMDVec px = simdAdd(simdSet((f32)x), pixelOffset);
+
+				SIMDVec outside = simdLess(simdAdd(simdMul(a0, px), row0), zero);
+				outside = simdOr(outside, simdLess(simdAdd(simdMul(a1, px), row1), zero));
+				outside = simdOr(outside, simdLess(simdAdd(simdMul(a2, px), row2), zero));
+
+				if (simdMoveMask(outside) == 15)
+					continue;
+
+				SIMDVec z = simdAdd(simdMul(vza, px), rowZ);
+
+				// keep the nearest (max 1/w)
+				SIMDVec d = simdLoad(line + x);
+				simdStore(line + x, simdMax(d, simdAndNot(outside, z)));
+			}
+		}
+#else
+		for (int y = minY; y <= maxY; y++)
+		{
+			f32 py = (f32)y + 0.5f;
+			f32* line = depth + y * m_width;
+
+			for (int x = minX; x <= maxX; x++)
+			{
+				f32 px = (f32)x + 0.5f;
+
+				if (ea[0] * px + eb[0] * py + ec[0] < 0.0f ||
+					ea[1] * px + eb[1] * py + ec[1] < 0.0f ||
+					ea[2] * px + eb[2] * py + ec[2] < 0.0f)
+					continue;
+
+				f32 z = za * px + zb * py + zc;
+				if (z > line[x])
+					line[x] = z;
+			}
+		}
+#endif
+	}
+
+	void COcclusionBuffer::updateTile()
+	{
+		f32* depth = m_depth.pointer();
+		f32* tileDepth = m_tileDepth.pointer();
+
+		for (int ty = 0; ty < m_numTileY; ty++)
+		{
+			for (int tx = 0; tx < m_numTileX; tx++)
+			{
+				f32 minDepth = FLT_MAX;
+
+				for (int y = 0; y < OCCLUSION_TILE_SIZE; y++)
+				{
+					f32* line = depth + (ty * OCCLUSION_TILE_SIZE + y) * m_width + tx * OCCLUSION_TILE_SIZE;
+					for (int x = 0; x < OCCLUSION_TILE_SIZE; x++)
+						minDepth = core::min_(minDepth, line[x]);
+				}
+
+				tileDepth[ty * m_numTileX + tx] = minDepth;
+			}
+		}
+
+		m_needUpdateTile = false;
+	}
+
+	bool COcclusionBuffer::isVisible(const core::aabbox3df& box)
+	{
+		if (m_needUpdateTile)
+			updateTile();
+
+		core::vector3df edges[8];
+		box.getEdges(edges);
+
+		const f32* m = m_viewProjection.pointer();
+
+		f32 minX = FLT_MAX, minY = FLT_MAX;
+		f32 maxX = -FLT_MAX, maxY = -FLT_MAX;
+		f32 maxInvW = 0.0f;
+
+		for (int i = 0; i < 8; i++)
+		{
+			const core::vector3df& p = edges[i];
+
+			f32 w = p.X * m[3] + p.Y * m[7] + p.Z * m[11] + m[15];
+
+			// the box cross the near plane
+			if (w < OCCLUSION_NEAR_W)
+				return true;
+
+			f32 s[3];
+			projectVertex(
+				p.X * m[0] + p.Y * m[4] + p.Z * m[8] + m[12],
+				p.X * m[1] + p.Y * m[5] + p.Z * m[9] + m[13],
+				w,
+				s);
+
+			minX = core::min_(minX, s[0]);
+			maxX = core::max_(maxX, s[0]);
+			minY = core::min_(minY, s[1]);
+			maxY = core::max_(maxY, s[1]);
+			maxInvW = core::max_(maxInvW, s[2]);
+		}
+
+		int x0 = core::max_((int)floorf(minX), 0);
+		int x1 = core::min_((int)floorf(maxX), m_width - 1);
+		int y0 = core::max_((int)floorf(minY), 0);
+		int y1 = core::min_((int)floorf(maxY), m_height - 1);
+
+		// out of screen, the frustum culling will check it
+		if (x0 > x1 || y0 > y1)
+			return true;
+
+		f32* depth = m_depth.pointer();
+		f32* tileDepth = m_tileDepth.pointer();
+
+		for (int ty = y0 / OCCLUSION_TILE_SIZE, ty1 = y1 / OCCLUSION_TILE_SIZE; ty <= ty1; ty++)
+		{
+			for (int tx = x0 / OCCLUSION_TILE_SIZE, tx1 = x1 / OCCLUSION_TILE_SIZE; tx <= tx1; tx++)
+			{
+				// all occluders on the tile are nearer than the box
+				if (tileDepth[ty * m_numTileX + tx] > maxInvW)
+					continue;
+
+				int px0 = core::max_(x0, tx * OCCLUSION_TILE_SIZE);
+				int px1 = core::min_(x1, tx * OCCLUSION_TILE_SIZE + OCCLUSION_TILE_SIZE - 1);
+				int py0 = core::max_(y0, ty * OCCLUSION_TILE_SIZE);
+				int py1 = core::min_(y1, ty * OCCLUSION_TILE_SIZE + OCCLUSION_TILE_SIZE - 1);
+
+				for (int y = py0; y <= py1; y++)
+				{
+					f32* line = depth + y * m_width;
+					for (int x = px0; x <= px1; x++)
+					{
+						if (line[x] <= maxInvW)
+							return true;
+					}
+				}
+			}
+		}
+
+		return false;
+	}
+}
@@ -0,0 +1,106 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2023 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#pragma once
+
+#define OCCLUSION_TILE_SIZE 8
+
+// the vertex behind this w is clipped
+#define OCCLUSION_NEAR_W 0.001f
+
+namespace Skylicht
+{
+	/// Low resolution depth buffer, the occluder meshes are rasterized on CPU to test the bounding boxes
+	class COcclusionBuffer
+	{
+	protected:
+		int m_width;
+		int m_height;
+
+		int m_numTileX;
+		int m_numTileY;
+
+		// 1/w of the nearest occluder, 0 is empty
+		core::array<f32> m_depth;
+
+		// min 1/w of the pixels on the tile (the farthest depth)
+		core::array<f32> m_tileDepth;
+
+		core::matrix4 m_viewProjection;
+
+		// transformed vertices: clip x, y, w and screen x, y, 1/w
+		core::array<f32> m_clipX;
+		core::array<f32> m_clipY;
+		core::array<f32> m_clipW;
+		core::array<f32> m_screenX;
+		core::array<f32> m_screenY;
+		core::array<f32> m_invW;
+
+		bool m_needUpdateTile;
+
+	public:
+		COcclusionBuffer(int width, int height);
+
+		virtual ~COcclusionBuffer();
+
+		void clear(const core::matrix4& viewProjection);
+
+		void drawMeshBuffer(const core::matrix4& world, IMeshBuffer* mb);
+
+		void drawTriangles(const core::matrix4& world, const core::vector3df* positions, int numVertex, const u32* indices, int numIndex);
+
+		// false if the box is behind the occluders on all pixels
+		bool isVisible(const core::aabbox3df& box);
+
+		inline int getWidth()
+		{
+			return m_width;
+		}
+
+		inline int getHeight()
+		{
+			return m_height;
+		}
+
+		inline f32 getDepth(int x, int y)
+		{
+			return m_depth[y * m_width + x];
+		}
+
+	protected:
+
+		void transformVertices(const core::matrix4& world, const u8* positions, u32 stride, int numVertex);
+
+		template<class T>
+		void drawIndexed(const T* indices, int numIndex);
+
+		void drawClippedTriangle(int a, int b, int c);
+
+		void projectVertex(f32 x, f32 y, f32 w, f32* out);
+
+		void drawTriangle(const f32* v0, const f32* v1, const f32* v2);
+
+		void updateTile();
+	};
+}
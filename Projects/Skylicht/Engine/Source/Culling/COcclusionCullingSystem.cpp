@@ -0,0 +1,148 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2023 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#include "pch.h"
+#include "COcclusionCullingSystem.h"
+#include "Entity/CEntityManager.h"
+#include "RenderPipeline/IRenderPipeline.h"
+#include "Camera/CCamera.h"
+
+namespace Skylicht
+{
+	bool COcclusionCullingSystem::s_enableOcclusion = true;
+
+	COcclusionCullingSystem::COcclusionCullingSystem() :
+		m_cullingSystem(NULL)
+	{
+		m_pipelineType = IRenderPipeline::Mix;
+		m_buffer = new COcclusionBuffer(OCCLUSION_BUFFER_WIDTH, OCCLUSION_BUFFER_HEIGHT);
+	}
+
+	COcclusionCullingSystem::~COcclusionCullingSystem()
+	{
+		delete m_buffer;
+	}
+
+	void COcclusionCullingSystem::beginQuery(CEntityManager* entityManager)
+	{
+		if (m_cullingSystem == NULL)
+			m_cullingSystem = entityManager->getSystem<CCullingSystem>();
+	}
+
+	void COcclusionCullingSystem::onQuery(CEntityManager* entityManager, CEntity** entities, int numEntity)
+	{
+
+	}
+
+	void COcclusionCullingSystem::init(CEntityManager* entityManager)
+	{
+
+	}
+
+	void COcclusionCullingSystem::update(CEntityManager* entityManager)
+	{
+		if (!s_enableOcclusion || m_cullingSystem == NULL)
+			return;
+
+		// the occlusion is tested on the camera view only
+		IRenderPipeline* rp = entityManager->getRenderPipeline();
+		if (rp == NULL || rp->getType() == IRenderPipeline::ShadowMap)
+			return;
+
+		CCamera* camera = entityManager->getCamera();
+		if (camera == NULL)
+			return;
+
+		SBBoxAndMaterial* bboxMats = m_cullingSystem->getBBoxAndMaterials().pointer();
+
+		if (CCullingSystem::useCacheCulling())
+		{
+			// apply the last result
+			int* occluded = m_occluded.pointer();
+			for (int i = 0, n = m_occluded.count(); i < n; i++)
+				bboxMats[occluded[i]].Culling->Visible = false;
+			return;
+		}
+
+		m_occluded.reset();
+
+		CFastArray<int>& cameraVisible = m_cullingSystem->getCameraVisible();
+		int* visibles = cameraVisible.pointer();
+		int numVisible = cameraVisible.count();
+
+		// 1. Rasterize the occluders
+		m_buffer->clear(camera->getProjectionMatrix() * camera->getViewMatrix());
+
+		int numOccluder = 0;
+
+		for (int i = 0; i < numVisible; i++)
+		{
+			SBBoxAndMaterial* bbBoxMat = &bboxMats[visibles[i]];
+			CCullingData* culling = bbBoxMat->Culling;
+
+			if (!culling->Occlusion || !culling->Visible)
+				continue;
+
+			CRenderMeshData* renderMesh = GET_ENTITY_DATA(bbBoxMat->Entity, CRenderMeshData);
+			if (renderMesh == NULL || renderMesh->getMesh() == NULL)
+				continue;
+
+			CWorldTransformData* transform = GET_ENTITY_DATA(bbBoxMat->Entity, CWorldTransformData);
+
+			CMesh* mesh = renderMesh->getMesh();
+			for (u32 j = 0, n = mesh->getMeshBufferCount(); j < n; j++)
+				m_buffer->drawMeshBuffer(transform->World, mesh->getMeshBuffer(j));
+
+			numOccluder++;
+		}
+
+		if (numOccluder == 0)
+			return;
+
+		// 2. Test the bounding box of the others
+		for (int i = 0; i < numVisible; i++)
+		{
+			CCullingData* culling = bboxMats[visibles[i]].Culling;
+
+			if (culling->Occlusion || !culling->Visible)
+				continue;
+
+			if (!m_buffer->isVisible(culling->BBox))
+			{
+				culling->Visible = false;
+				m_occluded.push(visibles[i]);
+			}
+		}
+	}
+
+	void COcclusionCullingSystem::render(CEntityManager* entityManager)
+	{
+
+	}
+
+	void COcclusionCullingSystem::postRender(CEntityManager* entityManager)
+	{
+
+	}
+}
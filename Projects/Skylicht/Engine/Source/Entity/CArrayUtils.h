@@ -77,6 +77,12 @@ namespace Skylicht
 			m_ptr[m_count++] = element;
 		}
 
+		inline void pop()
+		{
+			if (m_count > 0)
+				m_count--;
+		}
+
 		T* getPush()
 		{
 			if (m_count + 1 >= m_alloc)
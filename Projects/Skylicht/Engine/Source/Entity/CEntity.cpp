@@ -35,8 +35,10 @@ namespace Skylicht
 {
 	CEntity::CEntity(CEntityManager* mgr) :
 		m_alive(true),
+		m_changed(false),
 		m_visible(true),
-		m_mgr(mgr)
+		m_mgr(mgr),
+		m_storageMask(0)
 	{
 		m_index = mgr->getNumEntities();
 
@@ -46,8 +48,10 @@ namespace Skylicht
 
 	CEntity::CEntity(CEntityPrefab* mgr) :
 		m_alive(true),
+		m_changed(false),
 		m_visible(true),
-		m_mgr(NULL)
+		m_mgr(NULL),
+		m_storageMask(0)
 	{
 		m_index = mgr->getNumEntities();
 
@@ -66,8 +70,7 @@ namespace Skylicht
 		{
 			notifyUpdateGroup(index);
 
-			delete Data[index];
-			Data[index] = NULL;
+			releaseData(index);
 			return true;
 		}
 
@@ -97,7 +100,7 @@ namespace Skylicht
 		int index = CEntityDataTypeManager::getDataIndex(typeid(*data));
 
 		if (Data[index])
-			delete Data[index];
+			releaseData(index);
 
 		// save at index
 		Data[index] = data;
@@ -113,19 +116,56 @@ namespace Skylicht
 		{
 			if (Data[i])
 			{
-				delete Data[i];
-				Data[i] = NULL;
+				releaseData(i);
 
 				notifyUpdateGroup(i);
 			}
 		}
 	}
 
+	void* CEntity::allocData(u32 index, u32 size)
+	{
+		if (m_mgr == NULL || !m_mgr->isUseDataStorage())
+			return NULL;
+
+		CEntityDataStorage* storage = m_mgr->getDataStorage(index, size);
+		if (storage == NULL)
+			return NULL;
+
+		m_storageMask |= (1ULL << index);
+		return storage->allocate();
+	}
+
+	void CEntity::releaseData(u32 index)
+	{
+		IEntityData* data = Data[index];
+		Data[index] = NULL;
+
+		u64 bit = 1ULL << index;
+		if (m_storageMask & bit)
+		{
+			m_storageMask &= ~bit;
+			m_mgr->getDataStorage(index)->release(data);
+		}
+		else
+		{
+			delete data;
+		}
+	}
+
+	void CEntity::releaseDataMemory(u32 index, void* memory)
+	{
+		m_storageMask &= ~(1ULL << index);
+		m_mgr->getDataStorage(index)->releaseSlot(memory);
+	}
+
 	void CEntity::setVisible(bool b)
 	{
 		if (m_visible != b)
 		{
-			notifyUpdateGroup(CVisibleData::DataTypeIndex);
+			// the visible of child entities also change, so the groups need query again
+			if (m_mgr)
+				m_mgr->notifyUpdateGroup(CVisibleData::DataTypeIndex);
 			m_visible = b;
 		}
 	}
@@ -133,6 +173,6 @@ namespace Skylicht
 	void CEntity::notifyUpdateGroup(int type)
 	{
 		if (m_mgr)
-			m_mgr->notifyUpdateGroup(type);
+			m_mgr->notifyUpdateEntity(this, type);
 	}
 }
\ No newline at end of file
@@ -40,6 +40,8 @@ namespace Skylicht
 
 #define MAX_ENTITY_DATA 64
 
+#define MAX_ENTITY_DEPTH 256
+
 	class CEntity
 	{
 		friend class CEntityManager;
@@ -48,10 +50,18 @@ namespace Skylicht
 	protected:
 		bool m_visible;
 		bool m_alive;
+
+		// the entity is on the changed list of entity manager
+		bool m_changed;
+
 		int m_index;
 		std::string m_id;
 
 		CEntityManager* m_mgr;
+
+		// bit mask of the data that allocated on CEntityDataStorage
+		u64 m_storageMask;
+
 	public:
 
 		IEntityData* Data[MAX_ENTITY_DATA];
@@ -121,6 +131,12 @@ namespace Skylicht
 
 	protected:
 
+		void* allocData(u32 index, u32 size);
+
+		void releaseData(u32 index);
+
+		void releaseDataMemory(u32 index, void* memory);
+
 		inline void setAlive(bool b)
 		{
 			m_alive = b;
@@ -131,39 +147,22 @@ namespace Skylicht
 	template<class T>
 	T* CEntity::addData()
 	{
-		T* newData = new T();
-		IEntityData* data = dynamic_cast<IEntityData*>(newData);
-		if (data == NULL)
-		{
-			char exceptionInfo[512];
-			sprintf(exceptionInfo, "CEntity::addData %s must inherit IEntityData", typeid(T).name());
-			os::Printer::log(exceptionInfo);
-
-			delete newData;
-			return NULL;
-		}
-
 		// get index of type
 		u32 index = CEntityDataTypeManager::getDataIndex(typeid(T));
 
-		// also save this entity index
-		data->EntityIndex = m_index;
-
-		if (Data[index])
-			delete Data[index];
-
-		// save at index
-		Data[index] = newData;
-
-		notifyUpdateGroup(index);
-
-		return newData;
+		return addData<T>((int)index);
 	}
 
 	template<class T>
 	T* CEntity::addData(int index)
 	{
-		T* newData = new T();
+		if (Data[index])
+			releaseData(index);
+
+		// alloc on the chunk storage of entity manager
+		void* memory = allocData(index, sizeof(T));
+
+		T* newData = memory ? new (memory) T() : new T();
 		IEntityData* data = dynamic_cast<IEntityData*>(newData);
 		if (data == NULL)
 		{
@@ -171,18 +170,21 @@ namespace Skylicht
 			sprintf(exceptionInfo, "CEntity::addData %s must inherit IEntityData", typeid(T).name());
 			os::Printer::log(exceptionInfo);
 
-			delete newData;
+			if (memory)
+			{
+				newData->~T();
+				releaseDataMemory(index, memory);
+			}
+			else
+				delete newData;
 			return NULL;
 		}
 
 		// also save this entity index
 		data->EntityIndex = m_index;
 
-		if (Data[index])
-			delete Data[index];
-
 		// save at index
-		Data[index] = newData;
+		Data[index] = data;
 
 		notifyUpdateGroup(index);
 
@@ -215,8 +217,7 @@ namespace Skylicht
 
 		if (Data[index])
 		{
-			delete Data[index];
-			Data[index] = NULL;
+			releaseData(index);
 
 			notifyUpdateGroup(index);
 
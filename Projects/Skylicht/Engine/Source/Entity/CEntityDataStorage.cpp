@@ -0,0 +1,108 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2023 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#include "pch.h"
+#include "CEntityDataStorage.h"
+
+#define ENTITY_DATA_ALIGN 16
+
+namespace Skylicht
+{
+	CEntityDataStorage::CEntityDataStorage(u32 dataSize) :
+		m_numUsedInChunk(0),
+		m_numAlloc(0)
+	{
+		// align the data stride
+		m_dataSize = (dataSize + ENTITY_DATA_ALIGN - 1) & ~(ENTITY_DATA_ALIGN - 1);
+
+		m_numDataPerChunk = ENTITY_DATA_CHUNK_SIZE / m_dataSize;
+		if (m_numDataPerChunk == 0)
+			m_numDataPerChunk = 1;
+
+		// force allocate chunk at first allocate
+		m_numUsedInChunk = m_numDataPerChunk;
+	}
+
+	CEntityDataStorage::~CEntityDataStorage()
+	{
+		// all data should be released by CEntity
+		for (u32 i = 0, n = m_buffers.size(); i < n; i++)
+			free(m_buffers[i]);
+		m_buffers.clear();
+		m_chunks.clear();
+		m_free.clear();
+	}
+
+	void CEntityDataStorage::allocChunk()
+	{
+		size_t size = (size_t)m_dataSize * m_numDataPerChunk;
+
+		// malloc is only 8 bytes aligned on 32-bit platforms, so align the chunk by hand
+		u8* buffer = (u8*)malloc(size + ENTITY_DATA_ALIGN - 1);
+		u8* chunk = (u8*)(((size_t)buffer + ENTITY_DATA_ALIGN - 1) & ~(size_t)(ENTITY_DATA_ALIGN - 1));
+
+		m_buffers.push_back(buffer);
+		m_chunks.push_back(chunk);
+		m_numUsedInChunk = 0;
+	}
+
+	void* CEntityDataStorage::allocate()
+	{
+		m_numAlloc++;
+
+		// reuse the released slot
+		u32 numFree = m_free.size();
+		if (numFree > 0)
+		{
+			void* slot = m_free[numFree - 1];
+			m_free.set_used(numFree - 1);
+			return slot;
+		}
+
+		if (m_numUsedInChunk >= m_numDataPerChunk)
+			allocChunk();
+
+		u8* chunk = m_chunks[m_chunks.size() - 1];
+		void* slot = chunk + (size_t)m_numUsedInChunk * m_dataSize;
+		m_numUsedInChunk++;
+		return slot;
+	}
+
+	void CEntityDataStorage::release(IEntityData* data)
+	{
+		// the slot address of most derived object
+		void* slot = dynamic_cast<void*>(data);
+
+		// destroy data but keep memory on chunk
+		data->~IEntityData();
+
+		releaseSlot(slot);
+	}
+
+	void CEntityDataStorage::releaseSlot(void* slot)
+	{
+		m_free.push_back(slot);
+		m_numAlloc--;
+	}
+}
@@ -0,0 +1,91 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2023 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#pragma once
+
+#include "IEntityData.h"
+
+// bytes of a storage chunk
+#define ENTITY_DATA_CHUNK_SIZE 16384
+
+namespace Skylicht
+{
+	/// Pool storage of one IEntityData type.
+	/// The data is allocated in fixed-size chunks, so entities that are created together
+	/// have their data contiguous in memory and the systems iterate them without heap jumping.
+	class CEntityDataStorage
+	{
+	protected:
+		u32 m_dataSize;
+		u32 m_numDataPerChunk;
+		u32 m_numUsedInChunk;
+		u32 m_numAlloc;
+
+		// the malloc buffers, m_chunks is the aligned address in them
+		core::array<u8*> m_buffers;
+		core::array<u8*> m_chunks;
+		core::array<void*> m_free;
+
+	public:
+		CEntityDataStorage(u32 dataSize);
+
+		virtual ~CEntityDataStorage();
+
+		void* allocate();
+
+		void release(IEntityData* data);
+
+		// return the slot memory of allocate, the data is already destroyed
+		void releaseSlot(void* slot);
+
+		inline u32 getDataSize()
+		{
+			return m_dataSize;
+		}
+
+		inline u32 getNumDataPerChunk()
+		{
+			return m_numDataPerChunk;
+		}
+
+		inline u32 getNumChunk()
+		{
+			return m_chunks.size();
+		}
+
+		inline u32 getNumAlloc()
+		{
+			return m_numAlloc;
+		}
+
+		inline u8* getChunk(u32 i)
+		{
+			return m_chunks[i];
+		}
+
+	protected:
+
+		void allocChunk();
+	};
+}
@@ -30,6 +30,7 @@ namespace Skylicht
 	CEntityGroup::CEntityGroup(const u32* dataTypes, int count) :
 		m_needQuery(true),
 		m_needValidate(true),
+		m_incrementalQuery(false),
 		m_parentGroup(NULL)
 	{
 		for (int i = 0; i < count; i++)
@@ -38,6 +39,8 @@ namespace Skylicht
 
 	CEntityGroup::CEntityGroup(const u32* dataTypes, int count, CEntityGroup* parentGroup) :
 		m_needQuery(true),
+		m_needValidate(true),
+		m_incrementalQuery(false),
 		m_parentGroup(parentGroup)
 	{
 		for (int i = 0; i < count; i++)
@@ -51,10 +54,7 @@ namespace Skylicht
 
 	void CEntityGroup::onQuery(CEntityManager* entityManager, CEntity** entities, int numEntity)
 	{
-		u32* types = m_dataTypes.pointer();
-		int count = m_dataTypes.size();
-
-		m_entities.reset();
+		clearEntities();
 
 		if (m_parentGroup)
 		{
@@ -65,25 +65,122 @@ namespace Skylicht
 		for (int i = 0; i < numEntity; i++)
 		{
 			CEntity* entity = entities[i];
-			bool selectEntity = true;
 
-			for (int j = 0; j < count; j++)
+			if (selectEntity(entity))
+				addEntity(entity);
+		}
+
+		m_needQuery = false;
+		m_needValidate = true;
+	}
+
+	void CEntityGroup::onQueryChanged(CEntityManager* entityManager, CEntity** entities, int numEntity)
+	{
+		for (int i = 0; i < numEntity; i++)
+		{
+			CEntity* entity = entities[i];
+
+			bool select = entity->isAlive() && selectEntity(entity);
+			if (select && m_parentGroup)
+				select = m_parentGroup->haveEntity(entity);
+
+			bool have = haveEntity(entity);
+
+			if (select && !have)
 			{
-				if (entity->Data[types[j]] == NULL)
-				{
-					selectEntity = false;
-					break;
-				}
+				addEntity(entity);
+				m_needValidate = true;
 			}
-
-			if (selectEntity)
+			else if (!select && have)
 			{
-				m_entities.push(entity);
+				removeEntity(entity);
+				m_needValidate = true;
 			}
 		}
+	}
 
-		m_needQuery = false;
-		m_needValidate = true;
+	u64 CEntityGroup::getDataMask()
+	{
+		u32* types = m_dataTypes.pointer();
+		int count = m_dataTypes.size();
+
+		u64 mask = 0;
+		for (int i = 0; i < count; i++)
+			mask |= (1ULL << types[i]);
+
+		return mask;
+	}
+
+	bool CEntityGroup::canQueryChanged()
+	{
+		if (!m_incrementalQuery)
+			return false;
+
+		if (m_parentGroup)
+			return m_parentGroup->canQueryChanged();
+
+		return true;
+	}
+
+	bool CEntityGroup::selectEntity(CEntity* entity)
+	{
+		u32* types = m_dataTypes.pointer();
+		int count = m_dataTypes.size();
+
+		for (int j = 0; j < count; j++)
+		{
+			if (entity->Data[types[j]] == NULL)
+				return false;
+		}
+
+		return true;
+	}
+
+	void CEntityGroup::addEntity(CEntity* entity)
+	{
+		u32 index = (u32)entity->getIndex();
+
+		u32 size = m_entityPosition.size();
+		if (index >= size)
+		{
+			u32 newSize = core::max_(index + 1, size * 2);
+			m_entityPosition.set_used(newSize);
+
+			int* position = m_entityPosition.pointer();
+			for (u32 i = size; i < newSize; i++)
+				position[i] = -1;
+		}
+
+		m_entityPosition[index] = m_entities.count();
+		m_entities.push(entity);
+	}
+
+	void CEntityGroup::removeEntity(CEntity* entity)
+	{
+		int index = entity->getIndex();
+		int pos = m_entityPosition[index];
+
+		// swap the last entity to the removed position
+		CEntity** entities = m_entities.pointer();
+		int last = m_entities.count() - 1;
+		if (pos != last)
+		{
+			entities[pos] = entities[last];
+			m_entityPosition[entities[pos]->getIndex()] = pos;
+		}
+
+		m_entityPosition[index] = -1;
+		m_entities.pop();
+	}
+
+	void CEntityGroup::clearEntities()
+	{
+		// the entities on list can be released, so do not read them
+		int* position = m_entityPosition.pointer();
+		for (u32 i = 0, n = m_entityPosition.size(); i < n; i++)
+			position[i] = -1;
+
+		m_entities.reset();
 	}
 
 	bool CEntityGroup::haveDataType(u32 type)
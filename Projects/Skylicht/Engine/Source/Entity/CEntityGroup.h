@@ -42,8 +42,13 @@ namespace Skylicht
 
 		bool m_needValidate;
 
+		bool m_incrementalQuery;
+
 		CFastArray<CEntity*> m_entities;
 
+		// position of entity on m_entities (by entity index), -1 if the entity is not in the group
+		core::array<int> m_entityPosition;
+
 	public:
 		CEntityGroup(const u32* dataTypes, int count);
 
@@ -53,6 +58,31 @@ namespace Skylicht
 
 		virtual void onQuery(CEntityManager* entityManager, CEntity** entities, int numEntity);
 
+		// only check the entities that changed data since last update, instead query all entities
+		virtual void onQueryChanged(CEntityManager* entityManager, CEntity** entities, int numEntity);
+
+		// bit mask of the data types that change the group
+		virtual u64 getDataMask();
+
+		inline bool haveEntity(CEntity* entity)
+		{
+			u32 index = (u32)entity->getIndex();
+			return index < m_entityPosition.size() && m_entityPosition[index] >= 0;
+		}
+
+		inline void setIncrementalQuery(bool b)
+		{
+			m_incrementalQuery = b;
+		}
+
+		inline bool isIncrementalQuery()
+		{
+			return m_incrementalQuery;
+		}
+
+		// the group and its parents can update by the changed entities
+		bool canQueryChanged();
+
 		inline CEntity** getEntities()
 		{
 			return m_entities.pointer();
@@ -89,5 +119,15 @@ namespace Skylicht
 		{
 			return m_parentGroup;
 		}
+
+		void clearEntities();
+
+	protected:
+
+		bool selectEntity(CEntity* entity);
+
+		void addEntity(CEntity* entity);
+
+		void removeEntity(CEntity* entity);
 	};
 }
\ No newline at end of file
@@ -37,20 +37,33 @@ https://github.com/skylicht-lab/skylicht-engine
 #include "RenderMesh/CSoftwareSkinningSystem.h"
 #include "Culling/CVisibleSystem.h"
 #include "Culling/CCullingSystem.h"
+#include "Culling/COcclusionCullingSystem.h"
 #include "LOD/CLODSystem.h"
 #include "Lighting/CLightCullingSystem.h"
 #include "ReflectionProbe/CReflectionProbeSystem.h"
 #include "IndirectLighting/CIndirectLightingSystem.h"
 #include "Debug/CDebugRenderer.h"
+#include "RenderPipeline/CRenderStateCache.h"
+#include "RenderPipeline/CRenderCommandBuffer.h"
+
+#include "Job/CJobSystem.h"
 
 namespace Skylicht
 {
 	CEntityManager::CEntityManager() :
 		m_camera(NULL),
 		m_renderPipeline(NULL),
+		m_changedDataMask(0),
 		m_systemChanged(true),
-		m_needSortEntities(true)
+		m_needSortEntities(true),
+		m_useDataStorage(true),
+		m_needBuildStages(true),
+		m_parallelUpdate(true),
+		m_parallelRender(true)
 	{
+		for (int i = 0; i < MAX_ENTITY_DATA; i++)
+			m_dataStorage[i] = NULL;
+
 		// core engine systems
 		addSystem<CVisibleSystem>();
 		addSystem<CComponentTransformSystem>();
@@ -66,6 +79,7 @@ namespace Skylicht
 		// culling system
 		addRenderSystem<CLODSystem>();
 		addRenderSystem<CCullingSystem>();
+		addRenderSystem<COcclusionCullingSystem>();
 		addRenderSystem<CLightCullingSystem>();
 
 		// systems run after culling
@@ -80,6 +94,11 @@ namespace Skylicht
 		releaseAllEntities();
 		releaseAllSystems();
 		releaseAllGroups();
+		releaseAllDataStorage();
+
+		for (CRenderCommandBuffer* commands : m_renderCommands)
+			delete commands;
+		m_renderCommands.clear();
 	}
 
 	void CEntityManager::releaseAllEntities()
@@ -94,6 +113,14 @@ namespace Skylicht
 		m_entities.set_used(0);
 		m_unused.set_used(0);
 
+		m_changedEntities.reset();
+		m_changedDataMask = 0;
+
+		// the groups must not keep the released entities, the new entities can reuse their index
+		u32 count = m_groups.size();
+		for (u32 i = 0; i < count; i++)
+			m_groups[i]->clearEntities();
+
 		notifyUpdateSortEntities();
 	}
 
@@ -106,6 +133,11 @@ namespace Skylicht
 
 		m_systems.clear();
 		m_renders.clear();
+		m_sortRender.clear();
+		m_updateStages.clear();
+
+		m_systemChanged = true;
+		m_needBuildStages = true;
 	}
 
 	void CEntityManager::releaseAllGroups()
@@ -115,6 +147,35 @@ namespace Skylicht
 		m_groups.clear();
 	}
 
+	void CEntityManager::releaseAllDataStorage()
+	{
+		for (int i = 0; i < MAX_ENTITY_DATA; i++)
+		{
+			if (m_dataStorage[i])
+			{
+				delete m_dataStorage[i];
+				m_dataStorage[i] = NULL;
+			}
+		}
+	}
+
+	CEntityDataStorage* CEntityManager::getDataStorage(u32 dataType, u32 dataSize)
+	{
+		CEntityDataStorage* storage = m_dataStorage[dataType];
+		if (storage == NULL)
+		{
+			storage = new CEntityDataStorage(dataSize);
+			m_dataStorage[dataType] = storage;
+		}
+		else if (storage->getDataSize() < dataSize)
+		{
+			// the data type is not match on this slot, use heap allocate
+			return NULL;
+		}
+
+		return storage;
+	}
+
 	CEntity* CEntityManager::createEntity()
 	{
 		if (m_unused.size() > 0)
@@ -127,7 +188,7 @@ namespace Skylicht
 
 			m_unused.erase(last);
 
-			notifyUpdateSortEntities();
+			m_needSortEntities = true;
 			return entity;
 		}
 
@@ -135,7 +196,7 @@ namespace Skylicht
 		initDefaultData(entity);
 		m_entities.push_back(entity);
 
-		notifyUpdateSortEntities();
+		m_needSortEntities = true;
 		return entity;
 	}
 
@@ -153,7 +214,7 @@ namespace Skylicht
 			entities.push_back(entity);
 		}
 
-		notifyUpdateSortEntities();
+		m_needSortEntities = true;
 		return entities.pointer();
 	}
 
@@ -235,7 +296,7 @@ namespace Skylicht
 		entity->removeAllData();
 		m_unused.push_back(entity);
 
-		notifyUpdateSortEntities();
+		m_needSortEntities = true;
 	}
 
 	void CEntityManager::removeEntity(CEntity* entity)
@@ -244,7 +305,7 @@ namespace Skylicht
 		entity->removeAllData();
 		m_unused.push_back(entity);
 
-		notifyUpdateSortEntities();
+		m_needSortEntities = true;
 	}
 
 	void CEntityManager::sortAliveEntities()
@@ -291,6 +352,107 @@ namespace Skylicht
 		m_needSortEntities = false;
 	}
 
+	void CEntityManager::updateGroups()
+	{
+		CEntity** entities = m_alives.pointer();
+		int numEntity = (int)m_alives.size();
+
+		CEntity** changed = m_changedEntities.pointer();
+		int numChanged = m_changedEntities.count();
+
+		// too many changed entities, query all is faster than check each entity
+		bool queryAll = numChanged * 4 > numEntity;
+
+		if (numChanged > 1 && !queryAll)
+		{
+			// the parent entity must be checked before its childs
+			std::sort(changed, changed + numChanged, [](CEntity* a, CEntity* b)
+				{
+					CWorldTransformData* ta = GET_ENTITY_DATA(a, CWorldTransformData);
+					CWorldTransformData* tb = GET_ENTITY_DATA(b, CWorldTransformData);
+					int depthA = ta ? ta->Depth : 0;
+					int depthB = tb ? tb->Depth : 0;
+					return depthA < depthB;
+				});
+		}
+
+		for (u32 i = 0, n = m_groups.size(); i < n; i++)
+		{
+			CEntityGroup* g = m_groups[i];
+			g->finishValidate();
+
+			if (g->needQuery())
+			{
+				g->onQuery(this, entities, numEntity);
+			}
+			else if (numChanged > 0 && g->canQueryChanged())
+			{
+				CEntityGroup* parent = g->getParent();
+
+				// skip if the changed data and the parent group do not affect this group
+				if ((g->getDataMask() & m_changedDataMask) == 0 &&
+					(parent == NULL || !parent->needValidate()))
+					continue;
+
+				if (queryAll)
+					g->onQuery(this, entities, numEntity);
+				else
+					g->onQueryChanged(this, changed, numChanged);
+			}
+		}
+
+		for (int i = 0; i < numChanged; i++)
+			changed[i]->m_changed = false;
+
+		m_changedEntities.reset();
+		m_changedDataMask = 0;
+	}
+
+	void CEntityManager::buildUpdateStages()
+	{
+		int numSystem = (int)m_systems.size();
+
+		std::vector<int> systemStage;
+		systemStage.resize(numSystem, 0);
+
+		int numStage = 0;
+
+		// the system must run after all the previous systems that conflict data access
+		for (int i = 0; i < numSystem; i++)
+		{
+			int stage = 0;
+			for (int j = 0; j < i; j++)
+			{
+				if (m_systems[i]->isConflict(m_systems[j]))
+					stage = core::max_(stage, systemStage[j] + 1);
+			}
+
+			systemStage[i] = stage;
+			numStage = core::max_(numStage, stage + 1);
+		}
+
+		m_updateStages.clear();
+		m_updateStages.resize(numStage);
+
+		for (int i = 0; i < numSystem; i++)
+			m_updateStages[systemStage[i]].push_back(m_systems[i]);
+
+		m_needBuildStages = false;
+	}
+
+	int CEntityManager::getUpdateStage(IEntitySystem* system)
+	{
+		for (int i = 0, n = (int)m_updateStages.size(); i < n; i++)
+		{
+			for (IEntitySystem* s : m_updateStages[i])
+			{
+				if (s == system)
+					return i;
+			}
+		}
+		return -1;
+	}
+
 	void CEntityManager::update()
 	{
 		for (IEntitySystem*& s : m_systems)
@@ -301,22 +463,40 @@ namespace Skylicht
 		if (m_needSortEntities)
 			sortAliveEntities();
 
+		if (m_needBuildStages)
+			buildUpdateStages();
+
+		updateGroups();
+
 		CEntity** entities = m_alives.pointer();
 		int numEntity = (int)m_alives.size();
 
-		for (u32 i = 0, n = m_groups.size(); i < n; i++)
+		for (std::vector<IEntitySystem*>& stage : m_updateStages)
 		{
-			CEntityGroup* g = m_groups[i];
-			g->finishValidate();
+			int numSystem = (int)stage.size();
+			IEntitySystem** systems = stage.data();
 
-			if (g->needQuery())
-				g->onQuery(this, entities, numEntity);
-		}
+			SkylichtSystem::CJobSystem* jobSystem = SkylichtSystem::CJobSystem::getInstance();
 
-		for (IEntitySystem*& s : m_systems)
-		{
-			s->onQuery(this, entities, numEntity);
-			s->update(this);
+			if (numSystem == 1 || !m_parallelUpdate || jobSystem == NULL)
+			{
+				for (int i = 0; i < numSystem; i++)
+				{
+					systems[i]->onQuery(this, entities, numEntity);
+					systems[i]->update(this);
+				}
+			}
+			else
+			{
+				// the systems on a stage do not conflict data access
+				jobSystem->parallelFor(numSystem, 1, [&](int begin, int end) {
+					for (int i = begin; i < end; i++)
+					{
+						systems[i]->onQuery(this, entities, numEntity);
+						systems[i]->update(this);
+					}
+					});
+			}
 		}
 	}
 
@@ -348,12 +528,53 @@ namespace Skylicht
 			m_systemChanged = false;
 		}
 
-		for (IRenderSystem*& s : m_sortRender)
+		int numRender = (int)m_sortRender.size();
+		IRenderSystem** renders = m_sortRender.data();
+
+		bool recorded = false;
+
+		SkylichtSystem::CJobSystem* jobSystem = SkylichtSystem::CJobSystem::getInstance();
+		if (m_parallelRender && jobSystem != NULL && numRender > 1)
+		{
+			while ((int)m_renderCommands.size() < numRender)
+				m_renderCommands.push_back(new CRenderCommandBuffer());
+
+			m_recorded.set_used(numRender);
+
+			CRenderCommandBuffer** commands = m_renderCommands.data();
+			u8* recordedSystem = m_recorded.pointer();
+			IRenderPipeline::ERenderPipelineType type = m_renderPipeline->getType();
+
+			jobSystem->parallelFor(numRender, 1, [&](int begin, int end) {
+				for (int i = begin; i < end; i++)
+				{
+					IRenderPipeline::ERenderPipelineType t = renders[i]->getPipelineType();
+
+					commands[i]->reset();
+					recordedSystem[i] = 0;
+
+					if (t == IRenderPipeline::Mix || t == type)
+						recordedSystem[i] = renders[i]->recordRender(this, commands[i]) ? 1 : 0;
+				}
+				});
+
+			recorded = true;
+		}
+
+		// the systems can set the driver material directly, so invalidate the render state cache before each system
+		for (int i = 0; i < numRender; i++)
 		{
+			IRenderSystem* s = renders[i];
+
 			IRenderPipeline::ERenderPipelineType t = s->getPipelineType();
 			if (t == IRenderPipeline::Mix || t == m_renderPipeline->getType())
 			{
-				s->render(this);
+				CRenderStateCache::invalidate();
+
+				if (recorded && m_recorded[i])
+					m_renderCommands[i]->replay(this);
+				else
+					s->render(this);
 			}
 		}
 
@@ -363,6 +584,7 @@ namespace Skylicht
 			IRenderPipeline::ERenderPipelineType t = s->getPipelineType();
 			if (t == IRenderPipeline::Mix || t == m_renderPipeline->getType())
 			{
+				CRenderStateCache::invalidate();
 				s->renderTransparent(this);
 			}
 		}
@@ -373,38 +595,25 @@ namespace Skylicht
 			IRenderPipeline::ERenderPipelineType t = s->getPipelineType();
 			if (t == IRenderPipeline::Mix || t == m_renderPipeline->getType())
 			{
+				CRenderStateCache::invalidate();
 				s->postRender(this);
 			}
 		}
+
+		CRenderStateCache::invalidate();
 	}
 
 	void CEntityManager::cullingAndRender()
 	{
-		for (IRenderSystem*& s : m_renders)
-		{
-			s->beginQuery(this);
-		}
-
-		if (m_systemChanged == true)
-		{
-			updateSortRenderer();
-			m_systemChanged = false;
-		}
-
-		CEntity** entities = m_alives.pointer();
-		int numEntity = m_alives.size();
-
-		for (IRenderSystem*& s : m_renders)
-		{
-			s->onQuery(this, entities, numEntity);
-			s->update(this);
-		}
+		cullingQuery();
 
+		// the systems can set the driver material directly, so invalidate the render state cache before each system
 		for (IRenderSystem*& s : m_sortRender)
 		{
 			IRenderPipeline::ERenderPipelineType t = s->getPipelineType();
 			if (t == IRenderPipeline::Mix || t == m_renderPipeline->getType())
 			{
+				CRenderStateCache::invalidate();
 				s->render(this);
 			}
 		}
@@ -414,6 +623,7 @@ namespace Skylicht
 			IRenderPipeline::ERenderPipelineType t = s->getPipelineType();
 			if (t == IRenderPipeline::Mix || t == m_renderPipeline->getType())
 			{
+				CRenderStateCache::invalidate();
 				s->renderTransparent(this);
 			}
 		}
@@ -423,9 +633,35 @@ namespace Skylicht
 			IRenderPipeline::ERenderPipelineType t = s->getPipelineType();
 			if (t == IRenderPipeline::Mix || t == m_renderPipeline->getType())
 			{
+				CRenderStateCache::invalidate();
 				s->postRender(this);
 			}
 		}
+
+		CRenderStateCache::invalidate();
+	}
+
+	void CEntityManager::cullingQuery()
+	{
+		for (IRenderSystem*& s : m_renders)
+		{
+			s->beginQuery(this);
+		}
+
+		if (m_systemChanged == true)
+		{
+			updateSortRenderer();
+			m_systemChanged = false;
+		}
+
+		CEntity** entities = m_alives.pointer();
+		int numEntity = m_alives.size();
+
+		for (IRenderSystem*& s : m_renders)
+		{
+			s->onQuery(this, entities, numEntity);
+			s->update(this);
+		}
 	}
 
 	void CEntityManager::renderEmission()
@@ -466,6 +702,9 @@ namespace Skylicht
 
 		if (release == true)
 		{
+			m_systemChanged = true;
+			m_needBuildStages = true;
+
 			delete system;
 			return true;
 		}
@@ -490,6 +729,7 @@ namespace Skylicht
 	CEntityGroup* CEntityManager::createGroup(const u32* types, int count)
 	{
 		CEntityGroup* group = new CEntityGroup(types, count);
+		group->setIncrementalQuery(true);
 		m_groups.push_back(group);
 		return group;
 	}
@@ -497,6 +737,7 @@ namespace Skylicht
 	CEntityGroup* CEntityManager::createGroup(const u32* types, int count, CEntityGroup* parent)
 	{
 		CEntityGroup* group = new CEntityGroup(types, count, parent);
+		group->setIncrementalQuery(true);
 		m_groups.push_back(group);
 		return group;
 	}
@@ -575,4 +816,30 @@ namespace Skylicht
 				g->notifyNeedQuery();
 		}
 	}
+
+	void CEntityManager::notifyUpdateEntity(CEntity* entity, u32 dataType)
+	{
+		if (!entity->m_changed)
+		{
+			entity->m_changed = true;
+			m_changedEntities.push(entity);
+		}
+
+		m_changedDataMask |= (1ULL << dataType);
+
+		// the custom groups can not update by the changed entities, they must query again
+		u32 count = m_groups.size();
+		for (u32 i = 0; i < count; i++)
+		{
+			CEntityGroup* g = m_groups[i];
+			if (g->canQueryChanged())
+				continue;
+
+			if (g->haveDataType(dataType))
+				g->notifyNeedQuery();
+
+			if (g->getParent() && g->getParent()->needQuery())
+				g->notifyNeedQuery();
+		}
+	}
 }
\ No newline at end of file
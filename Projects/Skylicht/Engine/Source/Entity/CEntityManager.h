@@ -28,12 +28,11 @@ https://github.com/skylicht-lab/skylicht-engine
 #include "IRenderSystem.h"
 #include "CEntity.h"
 #include "CEntityGroup.h"
+#include "CEntityDataStorage.h"
 
 #include "GameObject/CGameObject.h"
 #include "Camera/CCamera.h"
 
-#define MAX_ENTITY_DEPTH 256
-
 namespace Skylicht
 {
 	class CEntityManager
@@ -45,14 +44,32 @@ namespace Skylicht
 
 		core::array<CEntityGroup*> m_groups;
 
+		// the entities that add/remove data since last update
+		CFastArray<CEntity*> m_changedEntities;
+		u64 m_changedDataMask;
+
 		CFastArray<CEntity*> m_sortDepth[MAX_ENTITY_DEPTH];
 
 		std::vector<IEntitySystem*> m_systems;
 		std::vector<IRenderSystem*> m_renders;
 
 		std::vector<IRenderSystem*> m_sortRender;
+
+		// the commands of m_sortRender that are recorded parallel
+		std::vector<CRenderCommandBuffer*> m_renderCommands;
+		core::array<u8> m_recorded;
+
+		// the systems that can update at the same time
+		std::vector<std::vector<IEntitySystem*>> m_updateStages;
+
+		CEntityDataStorage* m_dataStorage[MAX_ENTITY_DATA];
+
 		bool m_systemChanged;
 		bool m_needSortEntities;
+		bool m_useDataStorage;
+		bool m_needBuildStages;
+		bool m_parallelUpdate;
+		bool m_parallelRender;
 
 		CCamera* m_camera;
 
@@ -71,10 +88,17 @@ namespace Skylicht
 
 		void cullingAndRender();
 
+		// query & update the render systems, without render
+		void cullingQuery();
+
 	protected:
 
 		void sortAliveEntities();
 
+		void updateGroups();
+
+		void buildUpdateStages();
+
 	public:
 
 		inline void setCamera(CCamera* camera)
@@ -107,6 +131,51 @@ namespace Skylicht
 
 		void releaseAllGroups();
 
+		inline void setParallelUpdate(bool b)
+		{
+			m_parallelUpdate = b;
+		}
+
+		inline bool isParallelUpdate()
+		{
+			return m_parallelUpdate;
+		}
+
+		// record the render commands of the systems on the job system, the main thread only replays them
+		inline void setParallelRender(bool b)
+		{
+			m_parallelRender = b;
+		}
+
+		inline bool isParallelRender()
+		{
+			return m_parallelRender;
+		}
+
+		inline int getNumUpdateStage()
+		{
+			return (int)m_updateStages.size();
+		}
+
+		int getUpdateStage(IEntitySystem* system);
+
+		inline void setUseDataStorage(bool b)
+		{
+			m_useDataStorage = b;
+		}
+
+		inline bool isUseDataStorage()
+		{
+			return m_useDataStorage;
+		}
+
+		CEntityDataStorage* getDataStorage(u32 dataType, u32 dataSize);
+
+		inline CEntityDataStorage* getDataStorage(u32 dataType)
+		{
+			return m_dataStorage[dataType];
+		}
+
 		inline int getNumEntities()
 		{
 			return (int)m_entities.size();
@@ -161,10 +230,14 @@ namespace Skylicht
 
 		void notifyUpdateGroup(u32 dataType);
 
+		void notifyUpdateEntity(CEntity* entity, u32 dataType);
+
 	protected:
 
 		void initDefaultData(CEntity* entity);
 
+		void releaseAllDataStorage();
+
 		void updateSortRenderer();
 
 	};
@@ -187,6 +260,7 @@ namespace Skylicht
 		system->init(this);
 
 		m_systemChanged = true;
+		m_needBuildStages = true;
 
 		m_systems.push_back(system);
 		return newSystem;
@@ -219,6 +293,7 @@ namespace Skylicht
 		m_renders.push_back(render);
 
 		m_systemChanged = true;
+		m_needBuildStages = true;
 
 		return newSystem;
 	}
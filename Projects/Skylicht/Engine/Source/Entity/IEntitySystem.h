@@ -32,8 +32,16 @@ namespace Skylicht
 
 	class IEntitySystem
 	{
+	protected:
+		u64 m_readData;
+		u64 m_writeData;
+		bool m_declareDataAccess;
+
 	public:
-		IEntitySystem()
+		IEntitySystem() :
+			m_readData(0),
+			m_writeData(0),
+			m_declareDataAccess(false)
 		{
 		}
 
@@ -49,5 +57,52 @@ namespace Skylicht
 		virtual void init(CEntityManager* entityManager) = 0;
 
 		virtual void update(CEntityManager* entityManager) = 0;
+
+		inline bool isDeclareDataAccess()
+		{
+			return m_declareDataAccess;
+		}
+
+		inline u64 getReadData()
+		{
+			return m_readData;
+		}
+
+		inline u64 getWriteData()
+		{
+			return m_writeData;
+		}
+
+		// the system can not run at the same time with the conflict system
+		// the system that do not declare data access is always conflict
+		bool isConflict(IEntitySystem* system)
+		{
+			if (!m_declareDataAccess || !system->isDeclareDataAccess())
+				return true;
+
+			if (m_writeData & (system->getReadData() | system->getWriteData()))
+				return true;
+
+			if (m_readData & system->getWriteData())
+				return true;
+
+			return false;
+		}
+
+	protected:
+
+		// declare the entity data that onQuery & update will read
+		inline void readData(u32 dataType)
+		{
+			m_readData |= (1ULL << dataType);
+			m_declareDataAccess = true;
+		}
+
+		// declare the entity data that onQuery & update will modify
+		inline void writeData(u32 dataType)
+		{
+			m_writeData |= (1ULL << dataType);
+			m_declareDataAccess = true;
+		}
 	};
 }
\ No newline at end of file
@@ -31,6 +31,7 @@ https://github.com/skylicht-lab/skylicht-engine
 namespace Skylicht
 {
 	class CEntityManager;
+	class CRenderCommandBuffer;
 
 	class IRenderSystem : public IEntitySystem
 	{
@@ -68,6 +69,13 @@ namespace Skylicht
 
 		virtual void render(CEntityManager *entityManager) = 0;
 
+		// record the render commands instead of calling the driver, it can run on a worker thread
+		// return false if the system does not support
+		virtual bool recordRender(CEntityManager* entityManager, CRenderCommandBuffer* commands)
+		{
+			return false;
+		}
+
 		virtual void renderTransparent(CEntityManager *entityManager)
 		{
 
@@ -0,0 +1,106 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2023 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#include "pch.h"
+#include "Exporter/ExportResources.h"
+
+#include "CSkylichtAnimExporter.h"
+#include "Utils/CMemoryStream.h"
+
+namespace Skylicht
+{
+	CSkylichtAnimExporter::CSkylichtAnimExporter()
+	{
+
+	}
+
+	CSkylichtAnimExporter::~CSkylichtAnimExporter()
+	{
+
+	}
+
+	bool CSkylichtAnimExporter::exportAnimation(CAnimationClip* clip, const char* output)
+	{
+		IrrlichtDevice* device = getIrrlichtDevice();
+		io::IFileSystem* fs = device->getFileSystem();
+
+		io::IWriteFile* writeFile = fs->createAndWriteFile(output);
+		if (writeFile == NULL)
+			return false;
+
+		// write header
+		SAssetHeader assetHeader;
+		strcpy(assetHeader.Sign, "SLT");
+		assetHeader.AssetType = (u32)AssetAnimation;
+		assetHeader.AssetVersion = 1;
+		writeFile->write(&assetHeader, sizeof(SAssetHeader));
+
+		CMemoryStream memory(4096);
+
+		memory.writeString(clip->AnimName);
+		memory.writeFloat(clip->Duration);
+		memory.writeChar(clip->Loop ? 1 : 0);
+
+		u32 numTrack = (u32)clip->AnimInfo.size();
+		memory.writeUInt(numTrack);
+
+		for (u32 i = 0; i < numTrack; i++)
+		{
+			SEntityAnim* anim = clip->AnimInfo[i];
+
+			// the clip in memory is not changed
+			CAnimationData data = anim->Data;
+			m_compressor.compressData(&data);
+
+			memory.writeString(anim->Name);
+
+			memory.writeFloatArray(&data.Positions.Default.X, 3);
+			memory.writeFloatArray(&data.Rotations.Default.X, 4);
+			memory.writeFloatArray(&data.Scales.Default.X, 3);
+
+			writeKeys(&memory, data.QuantizedPositions);
+			writeKeys(&memory, data.QuantizedRotations);
+			writeKeys(&memory, data.QuantizedScales);
+		}
+
+		writeFile->write(memory.getData(), memory.getSize());
+		writeFile->drop();
+		return true;
+	}
+
+	void CSkylichtAnimExporter::writeKeys(CMemoryStream* stream, CQuantizedKeyFrame& keys)
+	{
+		u32 numKey = keys.size();
+		stream->writeUInt(numKey);
+
+		if (numKey == 0)
+			return;
+
+		stream->writeFloat(keys.FrameStart);
+		stream->writeFloat(keys.FrameStep);
+		stream->writeFloatArray(&keys.Min.X, 3);
+		stream->writeFloatArray(&keys.Extent.X, 3);
+		stream->writeData(keys.Data.pointer(), numKey * sizeof(SQuantizedKey));
+	}
+}
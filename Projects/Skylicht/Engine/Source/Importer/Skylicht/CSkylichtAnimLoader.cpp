@@ -0,0 +1,120 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2023 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#include "pch.h"
+#include "CSkylichtAnimLoader.h"
+
+#include "Animation/CAnimationClip.h"
+#include "Exporter/ExportResources.h"
+#include "Utils/CMemoryStream.h"
+
+namespace Skylicht
+{
+	CSkylichtAnimLoader::CSkylichtAnimLoader()
+	{
+
+	}
+
+	CSkylichtAnimLoader::~CSkylichtAnimLoader()
+	{
+
+	}
+
+	bool CSkylichtAnimLoader::loadAnimation(const char* resource, CAnimationClip* output)
+	{
+		IrrlichtDevice* device = getIrrlichtDevice();
+		io::IFileSystem* fs = device->getFileSystem();
+
+		io::IReadFile* readFile = fs->createAndOpenFile(resource);
+		if (readFile == NULL)
+			return false;
+
+		u32 size = readFile->getSize();
+
+		unsigned char* data = new unsigned char[size];
+		readFile->read(data, size);
+		readFile->drop();
+
+		CMemoryStream stream(data, size);
+
+		// read header
+		SAssetHeader assetHeader;
+		stream.readData(&assetHeader, sizeof(SAssetHeader));
+
+		if (strcmp(assetHeader.Sign, "SLT") != 0 ||
+			assetHeader.AssetType != (u32)AssetAnimation ||
+			assetHeader.AssetVersion != 1)
+		{
+			delete[] data;
+			return false;
+		}
+
+		loadVersion1(&stream, output);
+
+		delete[] data;
+		return true;
+	}
+
+	void CSkylichtAnimLoader::loadVersion1(CMemoryStream* stream, CAnimationClip* output)
+	{
+		output->AnimName = stream->readString();
+		output->Duration = stream->readFloat();
+		output->Loop = stream->readChar() == 1 ? true : false;
+
+		u32 numTrack = stream->readUInt();
+		for (u32 i = 0; i < numTrack; i++)
+		{
+			SEntityAnim* anim = new SEntityAnim();
+			anim->Name = stream->readString();
+
+			CAnimationData& data = anim->Data;
+			stream->readFloatArray(&data.Positions.Default.X, 3);
+			stream->readFloatArray(&data.Rotations.Default.X, 4);
+			stream->readFloatArray(&data.Scales.Default.X, 3);
+
+			readKeys(stream, data.QuantizedPositions);
+			readKeys(stream, data.QuantizedRotations);
+			readKeys(stream, data.QuantizedScales);
+
+			data.Compressed = true;
+
+			output->addAnim(anim);
+		}
+	}
+
+	void CSkylichtAnimLoader::readKeys(CMemoryStream* stream, CQuantizedKeyFrame& keys)
+	{
+		u32 numKey = stream->readUInt();
+		if (numKey == 0)
+			return;
+
+		keys.FrameStart = stream->readFloat();
+		keys.FrameStep = stream->readFloat();
+		stream->readFloatArray(&keys.Min.X, 3);
+		stream->readFloatArray(&keys.Extent.X, 3);
+
+		keys.Data.set_used(numKey);
+		stream->readData(keys.Data.pointer(), numKey * sizeof(SQuantizedKey));
+	}
+}
@@ -30,6 +30,7 @@ https://github.com/skylicht-lab/skylicht-engine
 #include "GameObject/CGameObject.h"
 #include "RenderMesh/CRenderMesh.h"
 #include "Entity/CEntityManager.h"
+#include "ReflectionProbe/CIndirectReflectionData.h"
 
 namespace Skylicht
 {
@@ -102,6 +103,9 @@ namespace Skylicht
 		data->SH = m_sh;
 		data->AutoSH = &m_autoSH;
 
+		// the reflection texture from the nearest probe
+		entity->addData<CIndirectReflectionData>();
+
 		m_data.push_back(data);
 	}
 
@@ -169,6 +173,9 @@ namespace Skylicht
 		m_autoSH = false;
 		for (int i = 0; i < 9; i++)
 			m_sh[i] = sh[i];
+
+		for (CIndirectLightingData* data : m_data)
+			data->ChangedID++;
 	}
 
 	void CIndirectLighting::setAmbientColor(const SColor& color)
@@ -177,6 +184,7 @@ namespace Skylicht
 		for (CIndirectLightingData* data : m_data)
 		{
 			data->Color = color;
+			data->ChangedID++;
 		}
 	}
 
@@ -235,6 +243,8 @@ namespace Skylicht
 			{
 				data->Type = CIndirectLightingData::VertexColor;
 			}
+
+			data->ChangedID++;
 		}
 	}
 }
\ No newline at end of file
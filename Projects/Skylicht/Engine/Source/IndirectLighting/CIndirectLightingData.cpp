@@ -33,11 +33,11 @@ namespace Skylicht
 		Type(LightmapArray),
 		IndirectTexture(NULL),
 		LightTexture(NULL),
-		ReflectionTexture(NULL),
 		SH(NULL),
 		AutoSH(NULL),
 		Init(true),
-		ReleaseSH(false)
+		ReleaseSH(false),
+		ChangedID(0)
 	{
 
 	}
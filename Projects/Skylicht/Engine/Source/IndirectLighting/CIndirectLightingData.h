@@ -49,12 +49,14 @@ namespace Skylicht
 
 		ITexture* IndirectTexture;
 		ITexture* LightTexture;
-		ITexture* ReflectionTexture;
 
 		bool Init;
 
 		bool ReleaseSH;
 
+		// increase when the lighting data is changed
+		u32 ChangedID;
+
 		DECLARE_DATA_TYPE_INDEX;
 
 	public:
@@ -33,6 +33,11 @@ namespace Skylicht
 		m_groupLighting(NULL),
 		m_groupProbes(NULL)
 	{
+		// CReflectionProbeSystem writes CIndirectReflectionData, so they can run at same time
+		readData(CWorldTransformData::DataTypeIndex);
+		writeData(CLightProbeData::DataTypeIndex);
+		writeData(CIndirectLightingData::DataTypeIndex);
+
 		m_kdtree = kd_create(3);
 	}
 
@@ -165,6 +170,7 @@ namespace Skylicht
 						}
 
 						indirectData->Init = false;
+						indirectData->ChangedID++;
 					}
 
 					// kd_res_next(res);
@@ -0,0 +1,420 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2023 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#include "pch.h"
+#include "CLightCluster.h"
+#include "CLight.h"
+#include "CSpotLight.h"
+#include "GameObject/CGameObject.h"
+#include "Utils/CSIMD.h"
+
+namespace Skylicht
+{
+	void SClusterLight::init(CLight* light)
+	{
+		Position = light->getGameObject()->getPosition();
+		Direction = light->getDirection();
+		Radius = light->getRadius();
+
+		CSpotLight* spotLight = dynamic_cast<CSpotLight*>(light);
+		if (spotLight)
+		{
+			f32 angle = spotLight->getSplotCutoff() * core::DEGTORAD * 0.5f;
+			Spot = true;
+			CosAngle = cosf(angle);
+			SinAngle = sinf(angle);
+		}
+		else
+		{
+			Spot = false;
+			CosAngle = -1.0f;
+			SinAngle = 0.0f;
+		}
+	}
+
+	CLightCluster::CLightCluster() :
+		m_tileX(16),
+		m_tileY(9),
+		m_sliceZ(24),
+		m_near(0.1f),
+		m_far(1000.0f),
+		m_sliceScale(1.0f),
+		m_needBuildClusters(true)
+	{
+
+	}
+
+	CLightCluster::~CLightCluster()
+	{
+
+	}
+
+	void CLightCluster::setGridSize(u32 tileX, u32 tileY, u32 sliceZ)
+	{
+		m_tileX = core::max_(tileX, 1u);
+		m_tileY = core::max_(tileY, 1u);
+		m_sliceZ = core::max_(sliceZ, 1u);
+
+		// the cluster id is packed in 16 bits
+		while (getNumCluster() > 0xffff && m_sliceZ > 1)
+			m_sliceZ--;
+
+		m_needBuildClusters = true;
+	}
+
+	void CLightCluster::update(const core::matrix4& projection, f32 nearValue, f32 farValue)
+	{
+		nearValue = core::max_(nearValue, 0.001f);
+		farValue = core::max_(farValue, nearValue + 0.001f);
+
+		if (m_needBuildClusters ||
+			m_near != nearValue ||
+			m_far != farValue ||
+			m_projection != projection)
+		{
+			m_near = nearValue;
+			m_far = farValue;
+			m_projection = projection;
+			buildClusters();
+		}
+	}
+
+	static core::vector3df unprojectNDC(const core::matrix4& invProjection, f32 x, f32 y, f32 z)
+	{
+		f32 out[4];
+		invProjection.transformVect(out, core::vector3df(x, y, z));
+
+		f32 invW = out[3] != 0.0f ? 1.0f / out[3] : 1.0f;
+		return core::vector3df(out[0] * invW, out[1] * invW, out[2] * invW);
+	}
+
+	void CLightCluster::buildClusters()
+	{
+		m_needBuildClusters = false;
+
+		m_sliceScale = (f32)m_sliceZ / logf(m_far / m_near);
+
+		u32 numCluster = getNumCluster();
+		m_minX.set_used(numCluster);
+		m_minY.set_used(numCluster);
+		m_minZ.set_used(numCluster);
+		m_maxX.set_used(numCluster);
+		m_maxY.set_used(numCluster);
+		m_maxZ.set_used(numCluster);
+		m_offset.set_used(numCluster);
+		m_count.set_used(numCluster);
+
+		core::matrix4 invProjection;
+		m_projection.getInverse(invProjection);
+
+		// depth of the slice planes
+		core::array<f32> depth;
+		depth.set_used(m_sliceZ + 1);
+		for (u32 z = 0; z <= m_sliceZ; z++)
+			depth[z] = m_near * powf(m_far / m_near, (f32)z / (f32)m_sliceZ);
+
+		for (u32 y = 0; y < m_tileY; y++)
+		{
+			// tile y is from the top of screen
+			f32 ndcY[2] = {
+				1.0f - 2.0f * (f32)y / (f32)m_tileY,
+				1.0f - 2.0f * (f32)(y + 1) / (f32)m_tileY
+			};
+
+			for (u32 x = 0; x < m_tileX; x++)
+			{
+				f32 ndcX[2] = {
+					-1.0f + 2.0f * (f32)x / (f32)m_tileX,
+					-1.0f + 2.0f * (f32)(x + 1) / (f32)m_tileX
+				};
+
+				// the 4 corner lines of the tile in view space
+				core::vector3df a[4], b[4];
+				for (int c = 0; c < 4; c++)
+				{
+					a[c] = unprojectNDC(invProjection, ndcX[c & 1], ndcY[c >> 1], 0.0f);
+					b[c] = unprojectNDC(invProjection, ndcX[c & 1], ndcY[c >> 1], 0.5f);
+				}
+
+				for (u32 z = 0; z < m_sliceZ; z++)
+				{
+					core::aabbox3df box;
+					bool first = true;
+
+					for (int c = 0; c < 4; c++)
+					{
+						f32 dz = b[c].Z - a[c].Z;
+
+						for (int s = 0; s < 2; s++)
+						{
+							f32 t = dz != 0.0f ? (depth[z + s] - a[c].Z) / dz : 0.0f;
+							core::vector3df p = a[c] + (b[c] - a[c]) * t;
+
+							if (first)
+								box.reset(p);
+							else
+								box.addInternalPoint(p);
+							first = false;
+						}
+					}
+
+					u32 id = getClusterID(x, y, z);
+					m_minX[id] = box.MinEdge.X;
+					m_minY[id] = box.MinEdge.Y;
+					m_minZ[id] = box.MinEdge.Z;
+					m_maxX[id] = box.MaxEdge.X;
+					m_maxY[id] = box.MaxEdge.Y;
+					m_maxZ[id] = box.MaxEdge.Z;
+				}
+			}
+		}
+	}
+
+	u32 CLightCluster::getSlice(f32 z)
+	{
+		if (z <= m_near)
+			return 0;
+
+		s32 slice = (s32)(logf(z / m_near) * m_sliceScale);
+		return (u32)core::clamp<s32>(slice, 0, (s32)m_sliceZ - 1);
+	}
+
+	void CLightCluster::assignLights(const core::matrix4& view, const SClusterLight* lights, u32 numLight)
+	{
+		if (m_needBuildClusters)
+			buildClusters();
+
+		u32 numCluster = getNumCluster();
+
+		// the light index is packed in 16 bits
+		numLight = core::min_(numLight, 0xffffu);
+
+		m_pairs.reset();
+		m_lightTiles.set_used(numLight);
+
+		for (u32 i = 0; i < numLight; i++)
+		{
+			core::vector3df center = lights[i].Position;
+			view.transformVect(center);
+
+			core::vector3df direction = lights[i].Direction;
+			view.rotateVect(direction);
+			direction.normalize();
+
+			addLight(i, lights[i], center, direction);
+		}
+
+		// count the lights per cluster
+		u32* count = m_count.pointer();
+		u32* offset = m_offset.pointer();
+		memset(count, 0, numCluster * sizeof(u32));
+
+		u32* pairs = m_pairs.pointer();
+		u32 numPair = (u32)m_pairs.count();
+
+		for (u32 i = 0; i < numPair; i++)
+			count[pairs[i] >> 16]++;
+
+		u32 sum = 0;
+		for (u32 i = 0; i < numCluster; i++)
+		{
+			offset[i] = sum;
+			sum += count[i];
+			count[i] = 0;
+		}
+
+		// compact light lists, the pairs are sorted by light
+		m_lightIndex.reset();
+		for (u32 i = 0; i < numPair; i++)
+			m_lightIndex.push(0);
+
+		u16* lightIndex = m_lightIndex.pointer();
+		for (u32 i = 0; i < numPair; i++)
+		{
+			u32 cluster = pairs[i] >> 16;
+			lightIndex[offset[cluster] + count[cluster]++] = (u16)(pairs[i] & 0xffff);
+		}
+	}
+
+	void CLightCluster::addLight(u32 lightID, const SClusterLight& light, const core::vector3df& center, const core::vector3df& direction)
+	{
+		core::recti& tiles = m_lightTiles[lightID];
+		tiles = core::recti(0, 0, 0, 0);
+
+		// bounding sphere, the cone of spot light has a smaller sphere if the angle < 60
+		core::vector3df sphereCenter = center;
+		f32 sphereRadius = light.Radius;
+
+		if (light.Spot && light.CosAngle > 0.5f)
+		{
+			sphereRadius = light.Radius / (2.0f * light.CosAngle);
+			sphereCenter = center + direction * sphereRadius;
+		}
+
+		if (sphereCenter.Z + sphereRadius < m_near || sphereCenter.Z - sphereRadius > m_far)
+			return;
+
+		u32 z0 = getSlice(sphereCenter.Z - sphereRadius);
+		u32 z1 = getSlice(sphereCenter.Z + sphereRadius);
+
+		const f32* minX = m_minX.const_pointer();
+		const f32* minY = m_minY.const_pointer();
+		const f32* minZ = m_minZ.const_pointer();
+		const f32* maxX = m_maxX.const_pointer();
+		const f32* maxY = m_maxY.const_pointer();
+		const f32* maxZ = m_maxZ.const_pointer();
+
+		f32 r2 = sphereRadius * sphereRadius;
+		u32 sliceSize = m_tileX * m_tileY;
+
+		bool hasCluster = false;
+		u32 tileMinX = 0, tileMinY = 0, tileMaxX = 0, tileMaxY = 0;
+
+		for (u32 z = z0; z <= z1; z++)
+		{
+			u32 begin = z * sliceSize;
+			u32 end = begin + sliceSize;
+			u32 i = begin;
+
+			// the clusters that the bounding sphere touches
+			u32 touch[4];
+			u32 numTouch = 0;
+
+			while (i < end)
+			{
+				numTouch = 0;
+
+#if defined(USE_SIMD)
+				if (i + 4 <= end)
+				{
+					SIMDVec zero = simdSet(0.0f);
+					SIMDVec cx = simdSet(sphereCenter.X);
+					SIMDVec cy = simdSet(sphereCenter.Y);
+					SIMDVec cz = simdSet(sphereCenter.Z);
+
+					// squared distance from the sphere center to the boxes
+					SIMDVec dx = simdAdd(simdMax(simdSub(simdLoad(minX + i), cx), zero), simdMax(simdSub(cx, simdLoad(maxX + i)), zero));
+					SIMDVec dy = simdAdd(simdMax(simdSub(simdLoad(minY + i), cy), zero), simdMax(simdSub(cy, simdLoad(maxY + i)), zero));
+					SIMDVec dz = simdAdd(simdMax(simdSub(simdLoad(minZ + i), cz), zero), simdMax(simdSub(cz, simdLoad(maxZ + i)), zero));
+					SIMDVec d2 = simdAdd(simdAdd(simdMul(dx, dx), simdMul(dy, dy)), simdMul(dz, dz));
+
+					int mask = simdMoveMask(simdGreater(d2, simdSet(r2)));
+					for (u32 j = 0; j < 4; j++)
+					{
+						if (((mask >> j) & 1) == 0)
+							touch[numTouch++] = i + j;
+					}
+					i += 4;
+				}
+				else
+#endif
+				{
+					f32 dx = core::max_(minX[i] - sphereCenter.X, 0.0f) + core::max_(sphereCenter.X - maxX[i], 0.0f);
+					f32 dy = core::max_(minY[i] - sphereCenter.Y, 0.0f) + core::max_(sphereCenter.Y - maxY[i], 0.0f);
+					f32 dz = core::max_(minZ[i] - sphereCenter.Z, 0.0f) + core::max_(sphereCenter.Z - maxZ[i], 0.0f);
+
+					if (dx * dx + dy * dy + dz * dz <= r2)
+						touch[numTouch++] = i;
+					i++;
+				}
+
+				for (u32 t = 0; t < numTouch; t++)
+				{
+					u32 cluster = touch[t];
+
+					if (light.Spot)
+					{
+						// cone vs the bounding sphere of cluster
+						core::vector3df boxMin(minX[cluster], minY[cluster], minZ[cluster]);
+						core::vector3df boxMax(maxX[cluster], maxY[cluster], maxZ[cluster]);
+						core::vector3df boxCenter = (boxMin + boxMax) * 0.5f;
+						f32 boxRadius = (boxMax - boxMin).getLength() * 0.5f;
+
+						core::vector3df v = boxCenter - center;
+						f32 lenSq = v.getLengthSQ();
+						f32 v1Len = v.dotProduct(direction);
+						f32 distClosest = light.CosAngle * sqrtf(core::max_(lenSq - v1Len * v1Len, 0.0f)) - v1Len * light.SinAngle;
+
+						if (distClosest > boxRadius ||
+							v1Len > boxRadius + light.Radius ||
+							v1Len < -boxRadius)
+							continue;
+					}
+
+					m_pairs.push((cluster << 16) | lightID);
+
+					u32 tile = cluster - begin;
+					u32 tx = tile % m_tileX;
+					u32 ty = tile / m_tileX;
+
+					if (!hasCluster)
+					{
+						tileMinX = tileMaxX = tx;
+						tileMinY = tileMaxY = ty;
+						hasCluster = true;
+					}
+					else
+					{
+						tileMinX = core::min_(tileMinX, tx);
+						tileMinY = core::min_(tileMinY, ty);
+						tileMaxX = core::max_(tileMaxX, tx);
+						tileMaxY = core::max_(tileMaxY, ty);
+					}
+				}
+			}
+		}
+
+		if (hasCluster)
+			tiles = core::recti(tileMinX, tileMinY, tileMaxX + 1, tileMaxY + 1);
+	}
+
+	const u16* CLightCluster::getClusterLights(u32 cluster, u32& count)
+	{
+		if (cluster >= m_count.size())
+		{
+			count = 0;
+			return NULL;
+		}
+
+		count = m_count[cluster];
+		return m_lightIndex.pointer() + m_offset[cluster];
+	}
+
+	bool CLightCluster::getLightScreenRect(u32 light, f32 screenW, f32 screenH, core::rectf& rect)
+	{
+		if (light >= m_lightTiles.size())
+			return false;
+
+		const core::recti& tiles = m_lightTiles[light];
+		if (tiles.getArea() == 0)
+			return false;
+
+		f32 tileW = screenW / (f32)m_tileX;
+		f32 tileH = screenH / (f32)m_tileY;
+
+		rect.UpperLeftCorner.set(tiles.UpperLeftCorner.X * tileW, tiles.UpperLeftCorner.Y * tileH);
+		rect.LowerRightCorner.set(tiles.LowerRightCorner.X * tileW, tiles.LowerRightCorner.Y * tileH);
+		return true;
+	}
+}
@@ -0,0 +1,149 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2023 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#pragma once
+
+#include "Entity/CArrayUtils.h"
+
+namespace Skylicht
+{
+	class CLight;
+
+	// the light in world space that is binned to the clusters
+	struct SClusterLight
+	{
+		core::vector3df Position;
+		core::vector3df Direction;
+		f32 Radius;
+
+		// spot light: cos & sin of the half cone angle
+		bool Spot;
+		f32 CosAngle;
+		f32 SinAngle;
+
+		SClusterLight()
+		{
+			Radius = 0.0f;
+			Spot = false;
+			CosAngle = -1.0f;
+			SinAngle = 0.0f;
+		}
+
+		void init(CLight* light);
+	};
+
+	/// CPU clustered light assignment: the view frustum is split to a 3D grid (screen tiles x exponential depth slices)
+	/// and each cluster gets a compact list of the lights that touch it
+	class CLightCluster
+	{
+	protected:
+		u32 m_tileX;
+		u32 m_tileY;
+		u32 m_sliceZ;
+
+		f32 m_near;
+		f32 m_far;
+		f32 m_sliceScale;
+
+		core::matrix4 m_projection;
+		bool m_needBuildClusters;
+
+		// view space bbox of clusters, SoA layout for SIMD
+		core::array<f32> m_minX;
+		core::array<f32> m_minY;
+		core::array<f32> m_minZ;
+		core::array<f32> m_maxX;
+		core::array<f32> m_maxY;
+		core::array<f32> m_maxZ;
+
+		// light list of cluster: m_lightIndex[m_offset[c]] .. count m_count[c]
+		core::array<u32> m_offset;
+		core::array<u32> m_count;
+		CFastArray<u16> m_lightIndex;
+
+		// (cluster << 16 | light) pairs of the last assign
+		CFastArray<u32> m_pairs;
+
+		// the tile rect that a light covers, empty if no cluster
+		core::array<core::recti> m_lightTiles;
+
+	public:
+		CLightCluster();
+
+		virtual ~CLightCluster();
+
+		void setGridSize(u32 tileX, u32 tileY, u32 sliceZ);
+
+		// rebuild the cluster bbox if the projection is changed
+		void update(const core::matrix4& projection, f32 nearValue, f32 farValue);
+
+		// bin the lights (the view matrix transforms the lights to view space)
+		void assignLights(const core::matrix4& view, const SClusterLight* lights, u32 numLight);
+
+		inline u32 getTileX()
+		{
+			return m_tileX;
+		}
+
+		inline u32 getTileY()
+		{
+			return m_tileY;
+		}
+
+		inline u32 getSliceZ()
+		{
+			return m_sliceZ;
+		}
+
+		inline u32 getNumCluster()
+		{
+			return m_tileX * m_tileY * m_sliceZ;
+		}
+
+		inline u32 getClusterID(u32 x, u32 y, u32 z)
+		{
+			return (z * m_tileY + y) * m_tileX + x;
+		}
+
+		// the depth slice of the view space z
+		u32 getSlice(f32 z);
+
+		// light indices of a cluster
+		const u16* getClusterLights(u32 cluster, u32& count);
+
+		inline u32 getNumLightIndex()
+		{
+			return (u32)m_lightIndex.count();
+		}
+
+		// the screen rect (x, y from the top left) that need shade the light, return false if the light is culled
+		bool getLightScreenRect(u32 light, f32 screenW, f32 screenH, core::rectf& rect);
+
+	protected:
+
+		void buildClusters();
+
+		void addLight(u32 lightID, const SClusterLight& light, const core::vector3df& center, const core::vector3df& direction);
+	};
+}
@@ -55,6 +55,12 @@ namespace Skylicht
 
 		bool needRenderShadowDepth();
 
+		// the static shadow depth is rendered again on the next frame
+		inline void setNeedRenderShadowDepth()
+		{
+			m_needRenderShadowDepth = true;
+		}
+
 		void beginRenderShadowDepth();
 
 		void endRenderShadowDepth();
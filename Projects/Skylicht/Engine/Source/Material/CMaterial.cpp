@@ -221,6 +221,56 @@ namespace Skylicht
 		}
 	}
 
+	int CMaterial::getUniformHandle(const char* name)
+	{
+		SUniformValue* p = getUniform(name);
+
+		if (p->Type == NUM_SHADER_TYPE && m_shader != NULL)
+		{
+			int valueIndex = m_shader->getMaterialParamHandle(name);
+			if (valueIndex >= 0)
+			{
+				p->Type = MATERIAL_PARAM;
+				p->ValueIndex = valueIndex;
+			}
+		}
+
+		for (int i = 0, n = (int)m_uniformParams.size(); i < n; i++)
+		{
+			if (m_uniformParams[i] == p)
+				return i;
+		}
+
+		return -1;
+	}
+
+	void CMaterial::setUniform(int handle, float f)
+	{
+		if (handle >= 0 && handle < (int)m_uniformParams.size())
+		{
+			SUniformValue* p = m_uniformParams[handle];
+			p->FloatValue[0] = f;
+			updateShaderParam(p);
+		}
+	}
+
+	void CMaterial::setUniform4(int handle, float* f)
+	{
+		if (handle >= 0 && handle < (int)m_uniformParams.size())
+		{
+			SUniformValue* p = m_uniformParams[handle];
+			memcpy(p->FloatValue, f, sizeof(float) * 4);
+			updateShaderParam(p);
+		}
+	}
+
+	void CMaterial::setUniform4(int handle, const SColor& color)
+	{
+		SColorf c(color);
+		float f[] = { c.r, c.g, c.b, c.a };
+		setUniform4(handle, f);
+	}
+
 	const char* CMaterial::getUniformTextureName(int slot)
 	{
 		if (slot >= 0 && slot < (int)m_uniformTextures.size())
@@ -1150,6 +1200,15 @@ namespace Skylicht
 		}
 	}
 
+	void CMaterial::updateShaderParam(SUniformValue* v)
+	{
+		if (v->Type == MATERIAL_PARAM && v->ValueIndex >= 0 && v->ValueIndex < MAX_SHADERPARAMS)
+		{
+			memcpy(m_shaderParams.getParamData(v->ValueIndex), v->FloatValue, sizeof(float) * 4);
+			v->ShaderDefaultValue = false;
+		}
+	}
+
 	void CMaterial::setDefaultValue(SUniformValue* v, SUniform* u)
 	{
 		memcpy(v->FloatValue, u->Value, sizeof(float) * 4);
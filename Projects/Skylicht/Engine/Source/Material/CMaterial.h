@@ -185,6 +185,12 @@ namespace Skylicht
 		void setUniform4(const char* name, float* f);
 		void setUniform4(const char* name, const SColor& color);
 
+		// the handle is resolved once (invalid after changeShader), set by handle write directly to the shader params
+		int getUniformHandle(const char* name);
+		void setUniform(int handle, float f);
+		void setUniform4(int handle, float* f);
+		void setUniform4(int handle, const SColor& color);
+
 		const char* getUniformTextureName(int slot);
 		void setUniformTexture(const char* name, const char* path, bool loadTexture = true);
 		void setUniformTexture(const char* name, const char* path, std::vector<std::string>& folder, bool loadTexture = true);
@@ -319,6 +325,8 @@ namespace Skylicht
 
 		void setDefaultValue(SUniformValue* v, SUniform* u);
 
+		void updateShaderParam(SUniformValue* v);
+
 		SUniformValue* newUniform(const char* name, int floatSize);
 
 		SUniformTexture* newUniformTexture(const char* name);
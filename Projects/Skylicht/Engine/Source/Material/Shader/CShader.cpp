@@ -26,6 +26,7 @@ https://github.com/skylicht-lab/skylicht-engine
 #include "CShader.h"
 
 #include "Utils/CStringImp.h"
+#include "Material/CMaterial.h"
 
 #include "ShaderCallback/CShaderLighting.h"
 #include "ShaderCallback/CShaderCamera.h"
@@ -44,7 +45,9 @@ namespace Skylicht
 		m_numFSUniform(0),
 		m_deferred(false),
 		m_instancing(NULL),
-		m_instancingShader(NULL)
+		m_instancingShader(NULL),
+		m_materialParamMask(0),
+		m_uploadedParamMask(0)
 	{
 		// builtin callback
 		addCallback<CShaderLighting>();
@@ -690,6 +693,18 @@ namespace Skylicht
 		return NULL;
 	}
 
+	int CShader::getMaterialParamHandle(const char* name)
+	{
+		SUniform* uniform = getFSUniform(name);
+		if (uniform == NULL)
+			uniform = getVSUniform(name);
+
+		if (uniform == NULL || uniform->Type != MATERIAL_PARAM)
+			return -1;
+
+		return uniform->ValueIndex;
+	}
+
 	std::string CShader::getVSShaderFileName()
 	{
 		std::string ret;
@@ -814,6 +829,8 @@ namespace Skylicht
 #endif
 			}
 
+			buildMaterialParams();
+
 			m_initCallback = false;
 		}
 
@@ -821,7 +838,7 @@ namespace Skylicht
 		for (int i = 0; i < m_numVSUniform; i++)
 		{
 			SUniform& uniform = m_listVSUniforms[i];
-			if (uniform.UniformShaderID >= 0)
+			if (uniform.UniformShaderID >= 0 && uniform.Type != MATERIAL_PARAM)
 			{
 				// builtin callback
 				if (setUniform(uniform, matRender, true, updateTransform) == false)
@@ -840,7 +857,7 @@ namespace Skylicht
 		for (int i = 0; i < m_numFSUniform; i++)
 		{
 			SUniform& uniform = m_listFSUniforms[i];
-			if (uniform.UniformShaderID >= 0)
+			if (uniform.UniformShaderID >= 0 && uniform.Type != MATERIAL_PARAM)
 			{
 				// builtin callback
 				if (setUniform(uniform, matRender, false, updateTransform) == false)
@@ -853,6 +870,76 @@ namespace Skylicht
 				}
 			}
 		}
+
+		// material params
+		CMaterial* material = CShaderMaterial::getMaterial();
+		if (material != NULL)
+			setMaterialParams(material->getShaderParams(), matRender);
+	}
+
+	void CShader::buildMaterialParams()
+	{
+		m_materialUniforms.set_used(0);
+		m_materialParamMask = 0;
+
+		// the program is new, need upload all params
+		m_uploadedParamMask = 0;
+
+		for (int i = 0, n = m_numVSUniform + m_numFSUniform; i < n; i++)
+		{
+			SUniform* uniform = i < m_numVSUniform ? &m_listVSUniforms[i] : &m_listFSUniforms[i - m_numVSUniform];
+
+			if (uniform->Type == MATERIAL_PARAM &&
+				uniform->UniformShaderID >= 0 &&
+				uniform->ValueIndex >= 0 &&
+				uniform->ValueIndex < MAX_SHADERPARAMS)
+			{
+				m_materialUniforms.push_back(uniform);
+				m_materialParamMask |= (1 << uniform->ValueIndex);
+			}
+		}
+	}
+
+	void CShader::setMaterialParams(CShaderParams& params, IMaterialRenderer* matRender)
+	{
+		// the params that the program does not have, or the value is changed
+		u32 dirty = m_materialParamMask & ~m_uploadedParamMask;
+		u32 check = m_materialParamMask & m_uploadedParamMask;
+
+		for (int i = 0; check != 0; i++, check >>= 1)
+		{
+			if ((check & 1) && memcmp(params.getParamData(i), m_uploadedParams.getParamData(i), sizeof(SVec4)) != 0)
+				dirty |= (1 << i);
+		}
+
+		if (dirty == 0)
+			return;
+
+		int numVS = m_numVSUniform;
+
+		for (u32 i = 0, n = m_materialUniforms.size(); i < n; i++)
+		{
+			SUniform* uniform = m_materialUniforms[i];
+			if ((dirty & (1 << uniform->ValueIndex)) == 0)
+				continue;
+
+			bool vertexShader = uniform >= m_listVSUniforms && uniform < m_listVSUniforms + numVS;
+
+			matRender->setShaderVariable(
+				uniform->UniformShaderID,
+				params.getParamData(uniform->ValueIndex),
+				uniform->SizeOfUniform,
+				vertexShader ? video::EST_VERTEX_SHADER : video::EST_PIXEL_SHADER);
+		}
+
+		for (int i = 0; dirty != 0; i++, dirty >>= 1)
+		{
+			if (dirty & 1)
+			{
+				memcpy(m_uploadedParams.getParamData(i), params.getParamData(i), sizeof(SVec4));
+				m_uploadedParamMask |= (1 << i);
+			}
+		}
 	}
 
 	bool CShader::setUniform(SUniform& uniform, IMaterialRenderer* matRender, bool vertexShader, bool updateTransform)
@@ -25,6 +25,7 @@ https://github.com/skylicht-lab/skylicht-engine
 #pragma once
 
 #include "CBaseShaderCallback.h"
+#include "CShaderParams.h"
 #include "Instancing/IShaderInstancing.h"
 
 namespace Skylicht
@@ -245,6 +246,14 @@ namespace Skylicht
 		IShaderInstancing* m_instancing;
 		CShader* m_instancingShader;
 
+		// the MATERIAL_PARAM uniforms (resolved on first callback), bit i of mask is ValueIndex i
+		core::array<SUniform*> m_materialUniforms;
+		u32 m_materialParamMask;
+
+		// the material params that the program is holding
+		CShaderParams m_uploadedParams;
+		u32 m_uploadedParamMask;
+
 	public:
 
 		CShader();
@@ -339,6 +348,9 @@ namespace Skylicht
 
 		SUniform* getFSUniform(const char* name);
 
+		// the handle (ValueIndex on CShaderParams) of a material param, -1 if not found
+		int getMaterialParamHandle(const char* name);
+
 		bool isDeferred()
 		{
 			return m_deferred;
@@ -430,6 +442,10 @@ namespace Skylicht
 
 		bool setUniform(SUniform& uniform, IMaterialRenderer* matRender, bool vertexShader, bool updateTransform);
 
+		void buildMaterialParams();
+
+		void setMaterialParams(CShaderParams& params, IMaterialRenderer* matRender);
+
 		void deleteAllUI();
 
 		void deleteAllResource();
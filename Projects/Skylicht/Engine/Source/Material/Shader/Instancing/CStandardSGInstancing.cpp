@@ -114,13 +114,7 @@ namespace Skylicht
 		return new CMeshBuffer<S3DVertex>(m_baseVtxDescriptor, type);
 	}
 
-	void CStandardSGInstancing::batchIntancing(
-		IVertexBuffer* vtxBuffer,
-		IVertexBuffer* tBuffer,
-		IVertexBuffer* lBuffer,
-		CMaterial** materials,
-		CEntity** entities,
-		int count)
+	void CStandardSGInstancing::batchMaterial(IVertexBuffer* vtxBuffer, CMaterial** materials, int count)
 	{
 		CVertexBuffer<SVtxSGInstancing>* instanceBuffer = dynamic_cast<CVertexBuffer<SVtxSGInstancing>*>(vtxBuffer);
 		if (instanceBuffer == NULL)
@@ -141,7 +135,5 @@ namespace Skylicht
 		}
 
 		vtxBuffer->setDirty();
-
-		batchTransformAndLighting(tBuffer, lBuffer, entities, count);
 	}
 }
\ No newline at end of file
@@ -53,9 +53,6 @@ namespace Skylicht
 
 		virtual IMeshBuffer* createMeshBuffer(video::E_INDEX_TYPE type);
 
-		virtual void batchIntancing(IVertexBuffer* vtxBuffer, IVertexBuffer* tBuffer, IVertexBuffer* lBuffer,
-			CMaterial** materials,
-			CEntity** entities,
-			int count);
+		virtual void batchMaterial(IVertexBuffer* vtxBuffer, CMaterial** materials, int count);
 	};
 }
\ No newline at end of file
@@ -114,10 +114,7 @@ namespace Skylicht
 		return new CMeshBuffer<S3DVertexTangents>(m_baseVtxDescriptor, type);
 	}
 
-	void CTBNSGInstancing::batchIntancing(IVertexBuffer* vtxBuffer, IVertexBuffer* tBuffer, IVertexBuffer* lBuffer,
-		CMaterial** materials,
-		CEntity** entities,
-		int count)
+	void CTBNSGInstancing::batchMaterial(IVertexBuffer* vtxBuffer, CMaterial** materials, int count)
 	{
 		CVertexBuffer<SVtxSGInstancing>* instanceBuffer = dynamic_cast<CVertexBuffer<SVtxSGInstancing>*>(vtxBuffer);
 		if (instanceBuffer == NULL)
@@ -138,7 +135,5 @@ namespace Skylicht
 		}
 
 		vtxBuffer->setDirty();
-
-		batchTransformAndLighting(tBuffer, lBuffer, entities, count);
 	}
 }
\ No newline at end of file
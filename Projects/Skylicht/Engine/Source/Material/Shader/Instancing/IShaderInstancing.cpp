@@ -219,6 +219,15 @@ namespace Skylicht
 		return dmb;
 	}
 
+	void IShaderInstancing::batchIntancing(IVertexBuffer* vtxBuffer, IVertexBuffer* tBuffer, IVertexBuffer* lBuffer,
+		CMaterial** materials,
+		CEntity** entities,
+		int count)
+	{
+		batchMaterial(vtxBuffer, materials, count);
+		batchTransformAndLighting(tBuffer, lBuffer, entities, count);
+	}
+
 	void IShaderInstancing::batchTransformAndLighting(
 		IVertexBuffer* tBuffer,
 		IVertexBuffer* lBuffer,
@@ -236,56 +245,101 @@ namespace Skylicht
 		transformBuffer->set_used(count);
 		indirectLightBuffer->set_used(count);
 
-		float invColor = 1.111f / 255.0f;
-
 		for (int i = 0; i < count; i++)
 		{
-			SVtxTransform& transform = transformBuffer->getVertex(i);
-			SVtxIndirectLighting& indirectLight = indirectLightBuffer->getVertex(i);
+			getTransformAndLighting(entities[i],
+				transformBuffer->getVertex(i),
+				indirectLightBuffer->getVertex(i));
+		}
 
-			// world transform
-			CWorldTransformData* world = GET_ENTITY_DATA(entities[i], CWorldTransformData);
-			transform.World = world->World;
+		tBuffer->setDirty();
+		lBuffer->setDirty();
+	}
 
-			// indirect lighting
-			CIndirectLightingData* indirectLighting = GET_ENTITY_DATA(entities[i], CIndirectLightingData);
-			if (indirectLighting)
+	void IShaderInstancing::batchTransformAndLighting(
+		IVertexBuffer* tBuffer,
+		IVertexBuffer* lBuffer,
+		CEntity** entities,
+		int count,
+		const int* slots,
+		int numSlot)
+	{
+		CVertexBuffer<SVtxTransform>* transformBuffer = dynamic_cast<CVertexBuffer<SVtxTransform>*>(tBuffer);
+		if (transformBuffer == NULL)
+			return;
+
+		CVertexBuffer<SVtxIndirectLighting>* indirectLightBuffer = dynamic_cast<CVertexBuffer<SVtxIndirectLighting>*>(lBuffer);
+		if (indirectLightBuffer == NULL)
+			return;
+
+		bool changed = transformBuffer->getVertexCount() != (u32)count;
+
+		transformBuffer->set_used(count);
+		indirectLightBuffer->set_used(count);
+
+		for (int i = 0; i < numSlot; i++)
+		{
+			int slot = slots[i];
+			if (slot >= count)
+				continue;
+
+			getTransformAndLighting(entities[slot],
+				transformBuffer->getVertex(slot),
+				indirectLightBuffer->getVertex(slot));
+
+			changed = true;
+		}
+
+		if (changed)
+		{
+			tBuffer->setDirty();
+			lBuffer->setDirty();
+		}
+	}
+
+	void IShaderInstancing::getTransformAndLighting(CEntity* entity, SVtxTransform& transform, SVtxIndirectLighting& indirectLight)
+	{
+		float invColor = 1.111f / 255.0f;
+
+		// world transform
+		CWorldTransformData* world = GET_ENTITY_DATA(entity, CWorldTransformData);
+		transform.World = world->World;
+
+		// indirect lighting
+		CIndirectLightingData* indirectLighting = GET_ENTITY_DATA(entity, CIndirectLightingData);
+		if (indirectLighting)
+		{
+			switch (indirectLighting->Type)
 			{
-				switch (indirectLighting->Type)
-				{
-				case CIndirectLightingData::SH9:
-				{
-					if (indirectLighting->SH)
-					{
-						indirectLight.D0 = indirectLighting->SH[0];
-						indirectLight.D1 = indirectLighting->SH[1];
-						indirectLight.D2 = indirectLighting->SH[2];
-						indirectLight.D3 = indirectLighting->SH[3];
-					}
-				}
-				break;
-				case CIndirectLightingData::AmbientColor:
-				{
-					indirectLight.D0.set(
-						indirectLighting->Color.getRed() * invColor,
-						indirectLighting->Color.getGreen() * invColor,
-						indirectLighting->Color.getBlue() * invColor
-					);
-
-					indirectLight.D1.set(0.0f, 0.0f, 0.0f);
-					indirectLight.D2.set(0.0f, 0.0f, 0.0f);
-					indirectLight.D3.set(0.0f, 0.0f, 0.0f);
-				}
-				break;
-				default:
+			case CIndirectLightingData::SH9:
+			{
+				if (indirectLighting->SH)
 				{
+					indirectLight.D0 = indirectLighting->SH[0];
+					indirectLight.D1 = indirectLighting->SH[1];
+					indirectLight.D2 = indirectLighting->SH[2];
+					indirectLight.D3 = indirectLighting->SH[3];
 				}
-				break;
-				}
+			}
+			break;
+			case CIndirectLightingData::AmbientColor:
+			{
+				indirectLight.D0.set(
+					indirectLighting->Color.getRed() * invColor,
+					indirectLighting->Color.getGreen() * invColor,
+					indirectLighting->Color.getBlue() * invColor
+				);
+
+				indirectLight.D1.set(0.0f, 0.0f, 0.0f);
+				indirectLight.D2.set(0.0f, 0.0f, 0.0f);
+				indirectLight.D3.set(0.0f, 0.0f, 0.0f);
+			}
+			break;
+			default:
+			{
+			}
+			break;
 			}
 		}
-
-		tBuffer->setDirty();
-		lBuffer->setDirty();
 	}
-}
\ No newline at end of file
+}
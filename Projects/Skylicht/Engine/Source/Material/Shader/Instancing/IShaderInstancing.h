@@ -97,7 +97,9 @@ namespace Skylicht
 		virtual void batchIntancing(IVertexBuffer* vtxBuffer, IVertexBuffer* tBuffer, IVertexBuffer* lBuffer,
 			CMaterial** materials,
 			CEntity** entities,
-			int count) = 0;
+			int count);
+
+		virtual void batchMaterial(IVertexBuffer* vtxBuffer, CMaterial** materials, int count) = 0;
 
 		virtual void batchTransformAndLighting(
 			IVertexBuffer* tBuffer,
@@ -105,6 +107,15 @@ namespace Skylicht
 			CEntity** entities,
 			int count);
 
+		// resize the buffers to count, but only write the changed slots
+		virtual void batchTransformAndLighting(
+			IVertexBuffer* tBuffer,
+			IVertexBuffer* lBuffer,
+			CEntity** entities,
+			int count,
+			const int* slots,
+			int numSlot);
+
 		video::IVertexDescriptor* getBaseVertexDescriptor()
 		{
 			return m_baseVtxDescriptor;
@@ -114,5 +125,9 @@ namespace Skylicht
 		{
 			return m_vtxDescriptor;
 		}
+
+	protected:
+
+		void getTransformAndLighting(CEntity* entity, SVtxTransform& transform, SVtxIndirectLighting& indirectLight);
 	};
 }
\ No newline at end of file
@@ -47,22 +47,6 @@ namespace Skylicht
 
 	void CShaderMaterial::OnSetConstants(CShader* shader, SUniform* uniform, IMaterialRenderer* matRender, bool vertexShader)
 	{
-		switch (uniform->Type)
-		{
-		case MATERIAL_PARAM:
-		{
-			if (s_material != NULL)
-			{
-				float* f = s_material->getShaderParams().getParamData(uniform->ValueIndex);
-				if (vertexShader == true)
-					matRender->setShaderVariable(uniform->UniformShaderID, f, uniform->SizeOfUniform, video::EST_VERTEX_SHADER);
-				else
-					matRender->setShaderVariable(uniform->UniformShaderID, f, uniform->SizeOfUniform, video::EST_PIXEL_SHADER);
-			}
-		}
-		break;
-		default:
-			break;
-		}
+		// MATERIAL_PARAM is uploaded by CShader::setMaterialParams (only the changed params)
 	}
 }
\ No newline at end of file
@@ -45,5 +45,10 @@ namespace Skylicht
 	public:
 		static void setMaterial(CMaterial *material);
 
+		static CMaterial* getMaterial()
+		{
+			return s_material;
+		}
+
 	};
 }
\ No newline at end of file
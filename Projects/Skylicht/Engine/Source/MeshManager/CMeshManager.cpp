@@ -1,6 +1,7 @@
 #include "pch.h"
 #include "Utils/CPath.h"
 #include "CMeshManager.h"
+#include "CStaticMeshBatching.h"
 
 #include "Importer/Collada/CColladaLoader.h"
 #include "Importer/WavefrontOBJ/COBJMeshFileLoader.h"
@@ -119,6 +120,13 @@ namespace Skylicht
 			// load model
 			if (importer->loadModel(resource, output, loadNormalMap, flipNormalMap, loadTexcoord2, createBatching) == true)
 			{
+				// merge the static meshes to the shared megabuffers
+				if (createBatching)
+				{
+					CStaticMeshBatching batching;
+					batching.batchPrefab(output);
+				}
+
 				// cached resource
 				m_meshPrefabs[resource] = output;
 			}
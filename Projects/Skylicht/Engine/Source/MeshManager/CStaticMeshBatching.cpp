@@ -0,0 +1,387 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2023 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#include "pch.h"
+#include "CStaticMeshBatching.h"
+#include "RenderMesh/CRenderMeshData.h"
+#include "Transform/CWorldTransformData.h"
+#include "Culling/CCullingData.h"
+
+namespace Skylicht
+{
+	CMeshMegaBuffer::CMeshMegaBuffer(IMeshBuffer* mb, const char* materialName, CMaterial* material) :
+		m_meshBuffer(NULL),
+		m_materialName(materialName),
+		m_material(material)
+	{
+		IVertexDescriptor* vertexDes = mb->getVertexDescriptor();
+		E_INDEX_TYPE indexType = mb->getIndexBuffer()->getType();
+
+		E_VERTEX_TYPE vtxType = (E_VERTEX_TYPE)vertexDes->getID();
+		switch (vtxType)
+		{
+		case EVT_STANDARD:
+			m_meshBuffer = new CMeshBuffer<S3DVertex>(vertexDes, indexType);
+			break;
+		case EVT_2TCOORDS:
+			m_meshBuffer = new CMeshBuffer<S3DVertex2TCoords>(vertexDes, indexType);
+			break;
+		case EVT_TANGENTS:
+			m_meshBuffer = new CMeshBuffer<S3DVertexTangents>(vertexDes, indexType);
+			break;
+		case EVT_2TCOORDS_TANGENTS:
+			m_meshBuffer = new CMeshBuffer<S3DVertex2TCoordsTangents>(vertexDes, indexType);
+			break;
+		default:
+			break;
+		}
+
+		if (m_meshBuffer)
+		{
+			m_meshBuffer->getMaterial() = mb->getMaterial();
+			m_meshBuffer->setHardwareMappingHint(EHM_STATIC);
+		}
+	}
+
+	CMeshMegaBuffer::~CMeshMegaBuffer()
+	{
+		if (m_meshBuffer)
+			m_meshBuffer->drop();
+	}
+
+	bool CMeshMegaBuffer::canPack(IMeshBuffer* mb)
+	{
+		if (mb == NULL || mb->getVertexBufferCount() != 1)
+			return false;
+
+		if (mb->getPrimitiveType() != EPT_TRIANGLES)
+			return false;
+
+		// the static vertex types
+		switch ((E_VERTEX_TYPE)mb->getVertexDescriptor()->getID())
+		{
+		case EVT_STANDARD:
+		case EVT_2TCOORDS:
+		case EVT_TANGENTS:
+		case EVT_2TCOORDS_TANGENTS:
+			return true;
+		default:
+			break;
+		}
+
+		return false;
+	}
+
+	bool CMeshMegaBuffer::canAllocate(IMeshBuffer* mb, const char* materialName, CMaterial* material)
+	{
+		if (m_meshBuffer == NULL)
+			return false;
+
+		if (m_material != material || m_materialName != materialName)
+			return false;
+
+		if (m_meshBuffer->getVertexDescriptor() != mb->getVertexDescriptor())
+			return false;
+
+		IIndexBuffer* ib = m_meshBuffer->getIndexBuffer();
+		if (ib->getType() != mb->getIndexBuffer()->getType())
+			return false;
+
+		// the 16bit index can not address the vertex over 65535
+		if (ib->getType() == EIT_16BIT)
+		{
+			u32 numVertex = m_meshBuffer->getVertexBuffer(0)->getVertexCount() + mb->getVertexBuffer(0)->getVertexCount();
+			if (numVertex > 65535)
+				return false;
+		}
+
+		return true;
+	}
+
+	int CMeshMegaBuffer::allocate(IMeshBuffer* mb, const core::matrix4& transform)
+	{
+		IVertexBuffer* srcVB = mb->getVertexBuffer(0);
+		IIndexBuffer* srcIB = mb->getIndexBuffer();
+
+		IVertexBuffer* vb = m_meshBuffer->getVertexBuffer(0);
+		IIndexBuffer* ib = m_meshBuffer->getIndexBuffer();
+
+		SMegaBufferRange range;
+		range.VertexStart = vb->getVertexCount();
+		range.VertexCount = srcVB->getVertexCount();
+		range.IndexStart = ib->getIndexCount();
+		range.IndexCount = srcIB->getIndexCount();
+
+		// copy vertices
+		vb->reallocate(range.VertexStart + range.VertexCount);
+		for (u32 i = 0; i < range.VertexCount; i++)
+			vb->addVertex(srcVB->getVertex(i));
+
+		// the mirrored transform (negative determinant) flips the triangle winding
+		const f32* m = transform.pointer();
+		core::vector3df axisX(m[0], m[1], m[2]);
+		core::vector3df axisY(m[4], m[5], m[6]);
+		core::vector3df axisZ(m[8], m[9], m[10]);
+		bool mirror = axisX.crossProduct(axisY).dotProduct(axisZ) < 0.0f;
+
+		// copy indices, that rebased to the range
+		ib->reallocate(range.IndexStart + range.IndexCount);
+		for (u32 i = 0; i < range.IndexCount; i++)
+		{
+			// swap the last 2 indices of the triangle to keep the front face
+			u32 index = i;
+			if (mirror && (i % 3) != 0)
+				index = (i % 3) == 1 ? i + 1 : i - 1;
+
+			ib->addIndex(srcIB->getIndex(index) + range.VertexStart);
+		}
+
+		// bake the transform to the float3 attributes
+		core::matrix4 normalTransform;
+		transform.getInverse(normalTransform);
+		normalTransform = normalTransform.getTransposed();
+
+		IVertexDescriptor* vertexDes = m_meshBuffer->getVertexDescriptor();
+		u32 vertexSize = vb->getVertexSize();
+		u8* vertices = (u8*)vb->getVertices() + range.VertexStart * vertexSize;
+
+		for (u32 i = 0, n = vertexDes->getAttributeCount(); i < n; i++)
+		{
+			IVertexAttribute* attribute = vertexDes->getAttribute(i);
+			if (attribute->getBufferID() != 0 ||
+				attribute->getType() != EVAT_FLOAT ||
+				attribute->getElementCount() != 3)
+				continue;
+
+			E_VERTEX_ATTRIBUTE_SEMANTIC semantic = attribute->getSemantic();
+			u8* data = vertices + attribute->getOffset();
+
+			for (u32 j = 0; j < range.VertexCount; j++, data += vertexSize)
+			{
+				core::vector3df* v = (core::vector3df*)data;
+
+				switch (semantic)
+				{
+				case EVAS_POSITION:
+					transform.transformVect(*v);
+					break;
+				case EVAS_NORMAL:
+					normalTransform.rotateVect(*v);
+					v->normalize();
+					break;
+				case EVAS_TANGENT:
+				case EVAS_BINORMAL:
+					transform.rotateVect(*v);
+					v->normalize();
+					break;
+				default:
+					break;
+				}
+			}
+		}
+
+		m_meshBuffer->recalculateBoundingBox();
+		m_meshBuffer->setDirty();
+
+		m_ranges.push_back(range);
+		return (int)m_ranges.size() - 1;
+	}
+
+	CStaticMeshBatching::CStaticMeshBatching()
+	{
+
+	}
+
+	CStaticMeshBatching::~CStaticMeshBatching()
+	{
+		clear();
+	}
+
+	void CStaticMeshBatching::clear()
+	{
+		for (u32 i = 0, n = m_buffers.size(); i < n; i++)
+			delete m_buffers[i];
+		m_buffers.set_used(0);
+	}
+
+	bool CStaticMeshBatching::canBatch(CMesh* mesh)
+	{
+		if (mesh == NULL || mesh->BlendShape.size() > 0)
+			return false;
+
+		u32 mbCount = mesh->getMeshBufferCount();
+		if (mbCount == 0)
+			return false;
+
+		for (u32 i = 0; i < mbCount; i++)
+		{
+			if (!CMeshMegaBuffer::canPack(mesh->getMeshBuffer(i)))
+				return false;
+		}
+
+		return true;
+	}
+
+	void CStaticMeshBatching::addMesh(CMesh* mesh, const core::matrix4& transform)
+	{
+		for (u32 i = 0, n = mesh->getMeshBufferCount(); i < n; i++)
+		{
+			IMeshBuffer* mb = mesh->getMeshBuffer(i);
+			const char* materialName = mesh->MaterialName[i].c_str();
+			CMaterial* material = mesh->Materials[i];
+
+			// find the megabuffer that has the free space
+			CMeshMegaBuffer* megaBuffer = NULL;
+			for (u32 j = 0, m = m_buffers.size(); j < m; j++)
+			{
+				if (m_buffers[j]->canAllocate(mb, materialName, material))
+				{
+					megaBuffer = m_buffers[j];
+					break;
+				}
+			}
+
+			if (megaBuffer == NULL)
+			{
+				megaBuffer = new CMeshMegaBuffer(mb, materialName, material);
+				m_buffers.push_back(megaBuffer);
+			}
+
+			megaBuffer->allocate(mb, transform);
+		}
+	}
+
+	CMesh* CStaticMeshBatching::buildDrawList()
+	{
+		// sort by material, the same material is drawn contiguous
+		core::array<CMeshMegaBuffer*> sorted;
+		for (u32 i = 0, n = m_buffers.size(); i < n; i++)
+		{
+			CMeshMegaBuffer* buffer = m_buffers[i];
+
+			u32 pos = sorted.size();
+			while (pos > 0 && buffer->getMaterialName() < sorted[pos - 1]->getMaterialName())
+				pos--;
+
+			sorted.insert(buffer, pos);
+		}
+
+		CMesh* mesh = new CMesh();
+		for (u32 i = 0, n = sorted.size(); i < n; i++)
+		{
+			mesh->addMeshBuffer(
+				sorted[i]->getMeshBuffer(),
+				sorted[i]->getMaterialName().c_str(),
+				sorted[i]->getMaterial()
+			);
+		}
+
+		mesh->recalculateBoundingBox();
+		mesh->setHardwareMappingHint(EHM_STATIC);
+		return mesh;
+	}
+
+	bool CStaticMeshBatching::batchPrefab(CEntityPrefab* prefab)
+	{
+		clear();
+
+		core::array<CEntity*> batchEntities;
+		u32 numMeshBuffer = 0;
+
+		int numEntities = prefab->getNumEntities();
+		for (int i = 0; i < numEntities; i++)
+		{
+			CEntity* entity = prefab->getEntity(i);
+			if (!entity->isAlive())
+				continue;
+
+			CRenderMeshData* renderData = entity->getData<CRenderMeshData>();
+			if (renderData == NULL || renderData->isSkinnedMesh())
+				continue;
+
+			CMesh* mesh = renderData->getMesh();
+			if (!canBatch(mesh))
+				continue;
+
+			batchEntities.push_back(entity);
+			numMeshBuffer += mesh->getMeshBufferCount();
+		}
+
+		// nothing to merge
+		if (batchEntities.size() < 2)
+			return false;
+
+		for (u32 i = 0, n = batchEntities.size(); i < n; i++)
+		{
+			CEntity* entity = batchEntities[i];
+
+			// get the world matrix in prefab
+			core::matrix4 m;
+			CWorldTransformData* transform = entity->getData<CWorldTransformData>();
+			if (transform)
+			{
+				m = transform->Relative;
+				int parentID = transform->ParentIndex;
+				while (parentID != -1)
+				{
+					CEntity* parent = prefab->getEntity(parentID);
+					CWorldTransformData* parentTransform = parent->getData<CWorldTransformData>();
+
+					m = parentTransform->Relative * m;
+					parentID = parentTransform->ParentIndex;
+				}
+			}
+
+			addMesh(entity->getData<CRenderMeshData>()->getMesh(), m);
+		}
+
+		if (m_buffers.size() >= numMeshBuffer)
+		{
+			// the buffers are not shared, keep the source meshes
+			clear();
+			return false;
+		}
+
+		// the source entities just keep the transform
+		for (u32 i = 0, n = batchEntities.size(); i < n; i++)
+		{
+			batchEntities[i]->removeData<CRenderMeshData>();
+			batchEntities[i]->removeData<CCullingData>();
+		}
+
+		CMesh* mesh = buildDrawList();
+
+		CEntity* entity = prefab->createEntity();
+		prefab->addTransformData(entity, NULL, core::IdentityMatrix, "StaticBatching");
+
+		CRenderMeshData* meshData = entity->addData<CRenderMeshData>();
+		meshData->setMesh(mesh);
+		mesh->drop();
+
+		entity->addData<CCullingData>();
+
+		clear();
+		return true;
+	}
+}
@@ -0,0 +1,125 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2023 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#pragma once
+
+#include "Entity/CEntityPrefab.h"
+#include "RenderMesh/CMesh.h"
+
+namespace Skylicht
+{
+	// the sub-allocated range of a source mesh buffer in the megabuffer
+	struct SMegaBufferRange
+	{
+		u32 VertexStart;
+		u32 VertexCount;
+		u32 IndexStart;
+		u32 IndexCount;
+	};
+
+	/// Shared vertex/index buffer that packs the static mesh buffers of the same vertex descriptor and material
+	class CMeshMegaBuffer
+	{
+	protected:
+		IMeshBuffer* m_meshBuffer;
+
+		std::string m_materialName;
+
+		CMaterial* m_material;
+
+		core::array<SMegaBufferRange> m_ranges;
+
+	public:
+		CMeshMegaBuffer(IMeshBuffer* mb, const char* materialName, CMaterial* material);
+
+		virtual ~CMeshMegaBuffer();
+
+		// the static mesh buffer can copy to a megabuffer
+		static bool canPack(IMeshBuffer* mb);
+
+		bool canAllocate(IMeshBuffer* mb, const char* materialName, CMaterial* material);
+
+		// copy the mesh buffer (baked by the transform) to the end of buffer, return the range id
+		int allocate(IMeshBuffer* mb, const core::matrix4& transform);
+
+		inline IMeshBuffer* getMeshBuffer()
+		{
+			return m_meshBuffer;
+		}
+
+		inline const std::string& getMaterialName()
+		{
+			return m_materialName;
+		}
+
+		inline CMaterial* getMaterial()
+		{
+			return m_material;
+		}
+
+		inline u32 getRangeCount()
+		{
+			return m_ranges.size();
+		}
+
+		inline const SMegaBufferRange& getRange(u32 id)
+		{
+			return m_ranges[id];
+		}
+	};
+
+	/// Merge the static meshes of a prefab to the megabuffers, so each material is drawn by the contiguous ranges of a shared buffer
+	class CStaticMeshBatching
+	{
+	protected:
+		core::array<CMeshMegaBuffer*> m_buffers;
+
+	public:
+		CStaticMeshBatching();
+
+		virtual ~CStaticMeshBatching();
+
+		void clear();
+
+		bool canBatch(CMesh* mesh);
+
+		void addMesh(CMesh* mesh, const core::matrix4& transform);
+
+		// the mesh that has a buffer per megabuffer, sorted by material
+		CMesh* buildDrawList();
+
+		// replace the static render meshes of prefab by a batching entity, return false if nothing is merged
+		bool batchPrefab(CEntityPrefab* prefab);
+
+		inline u32 getMegaBufferCount()
+		{
+			return m_buffers.size();
+		}
+
+		inline CMeshMegaBuffer* getMegaBuffer(u32 id)
+		{
+			return m_buffers[id];
+		}
+	};
+}
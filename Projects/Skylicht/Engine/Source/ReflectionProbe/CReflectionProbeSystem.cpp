@@ -30,9 +30,15 @@ https://github.com/skylicht-lab/skylicht-engine
 namespace Skylicht
 {
 	CReflectionProbeSystem::CReflectionProbeSystem() :
-		m_groupLighting(NULL),
+		m_probeChange(false),
+		m_groupReflection(NULL),
 		m_groupProbes(NULL)
 	{
+		// the output is on its own data, so it can run at same time with CIndirectLightingSystem
+		readData(CWorldTransformData::DataTypeIndex);
+		writeData(CReflectionProbeData::DataTypeIndex);
+		writeData(CIndirectReflectionData::DataTypeIndex);
+
 		m_kdtree = kd_create(3);
 	}
 
@@ -43,10 +49,10 @@ namespace Skylicht
 
 	void CReflectionProbeSystem::beginQuery(CEntityManager* entityManager)
 	{
-		if (m_groupLighting == NULL)
+		if (m_groupReflection == NULL)
 		{
-			const u32 type[] = GET_LIST_ENTITY_DATA(CIndirectLightingData);
-			m_groupLighting = entityManager->createGroupFromVisible(type, 1);
+			const u32 type[] = GET_LIST_ENTITY_DATA(CIndirectReflectionData);
+			m_groupReflection = entityManager->createGroupFromVisible(type, 1);
 		}
 
 		if (m_groupProbes == NULL)
@@ -87,19 +93,19 @@ namespace Skylicht
 			}
 		}
 
-		entities = m_groupLighting->getEntities();
-		numEntity = m_groupLighting->getEntityCount();
+		entities = m_groupReflection->getEntities();
+		numEntity = m_groupReflection->getEntityCount();
 
 		for (int i = 0; i < numEntity; i++)
 		{
 			CEntity* entity = entities[i];
 
 			CWorldTransformData* transformData = GET_ENTITY_DATA(entity, CWorldTransformData);
-			CIndirectLightingData* lightData = GET_ENTITY_DATA(entity, CIndirectLightingData);
+			CIndirectReflectionData* reflectionData = GET_ENTITY_DATA(entity, CIndirectReflectionData);
 
-			if (transformData->NeedValidate || lightData->Init || m_probeChange)
+			if (transformData->NeedValidate || reflectionData->Init || m_probeChange)
 			{
-				m_entities.push(lightData);
+				m_entities.push(reflectionData);
 				m_entitiesPositions.push(transformData);
 			}
 		}
@@ -131,7 +137,7 @@ namespace Skylicht
 		}
 
 		CWorldTransformData** positions = m_entitiesPositions.pointer();
-		CIndirectLightingData** lightings = m_entities.pointer();
+		CIndirectReflectionData** reflections = m_entities.pointer();
 
 		for (u32 i = 0, n = m_entities.count(); i < n; i++)
 		{
@@ -147,10 +153,9 @@ namespace Skylicht
 					CReflectionProbeData* probe = (CReflectionProbeData*)kd_res_item_data(res);
 					if (probe != NULL)
 					{
-						// get indirectData
-						CIndirectLightingData* indirectData = lightings[i];
-						indirectData->ReflectionTexture = probe->ReflectionTexture;
-						indirectData->Init = false;
+						CIndirectReflectionData* reflectionData = reflections[i];
+						reflectionData->ReflectionTexture = probe->ReflectionTexture;
+						reflectionData->Init = false;
 					}
 
 					// kd_res_next(res);
@@ -28,8 +28,8 @@ https://github.com/skylicht-lab/skylicht-engine
 #include "Entity/IRenderSystem.h"
 #include "Entity/CEntityGroup.h"
 #include "CReflectionProbeData.h"
+#include "CIndirectReflectionData.h"
 #include "Transform/CWorldTransformData.h"
-#include "IndirectLighting/CIndirectLightingData.h"
 
 #include "kdtree.h"
 
@@ -41,13 +41,13 @@ namespace Skylicht
 		CFastArray<CReflectionProbeData*> m_probes;
 		CFastArray<CWorldTransformData*> m_probePositions;
 
-		CFastArray<CIndirectLightingData*> m_entities;
+		CFastArray<CIndirectReflectionData*> m_entities;
 		CFastArray<CWorldTransformData*> m_entitiesPositions;
 
 		kdtree* m_kdtree;
 		bool m_probeChange;
 
-		CEntityGroup* m_groupLighting;
+		CEntityGroup* m_groupReflection;
 		CEntityGroup* m_groupProbes;
 
 	public:
@@ -32,7 +32,9 @@ namespace Skylicht
 	CJointAnimationSystem::CJointAnimationSystem() :
 		m_group(NULL)
 	{
-
+		readData(CWorldTransformData::DataTypeIndex);
+		readData(CWorldInverseTransformData::DataTypeIndex);
+		writeData(CJointData::DataTypeIndex);
 	}
 
 	CJointAnimationSystem::~CJointAnimationSystem()
@@ -71,14 +73,26 @@ namespace Skylicht
 			CEntity* entity = entities[i];
 
 			CJointData* joint = GET_ENTITY_DATA(entity, CJointData);
+
 			if (joint->RootIndex != 0)
 			{
+				joint->Changed = false;
+
+				CEntity* root = allEntities[joint->RootIndex];
+
 				CWorldTransformData* transform = GET_ENTITY_DATA(entity, CWorldTransformData);
-				CWorldInverseTransformData* rootInvTransform = GET_ENTITY_DATA(allEntities[joint->RootIndex], CWorldInverseTransformData);
+				CWorldTransformData* rootTransform = GET_ENTITY_DATA(root, CWorldTransformData);
+				CWorldInverseTransformData* rootInvTransform = GET_ENTITY_DATA(root, CWorldInverseTransformData);
+
+				// the world of the bone & the root are not changed, so the animation matrix is same as the last frame.
+				// the skip is exact, it does not depend on the animation LOD (that just makes more bones skip)
+				if (!transform->NeedValidate && !rootTransform->NeedValidate)
+					continue;
 
 				if (rootInvTransform != NULL)
 				{
 					joint->AnimationMatrix.setbyproduct_nocheck(rootInvTransform->WorldInverse, transform->World);
+					joint->Changed = true;
 				}
 			}
 		}
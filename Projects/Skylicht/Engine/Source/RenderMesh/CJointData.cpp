@@ -33,7 +33,8 @@ namespace Skylicht
 
 	CJointData::CJointData() :
 		BoneRoot(false),
-		RootIndex(-1)
+		RootIndex(-1),
+		Changed(true)
 	{
 
 	}
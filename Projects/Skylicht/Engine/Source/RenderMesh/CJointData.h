@@ -41,6 +41,9 @@ namespace Skylicht
 		// absolute joint transform at (0,0,0)
 		core::matrix4 AnimationMatrix;
 
+		// the AnimationMatrix is updated on this frame
+		bool Changed;
+
 		DECLARE_DATA_TYPE_INDEX;
 
 	public:
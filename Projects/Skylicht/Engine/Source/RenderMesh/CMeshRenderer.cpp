@@ -27,6 +27,7 @@ https://github.com/skylicht-lab/skylicht-engine
 
 #include "Culling/CCullingData.h"
 #include "Entity/CEntityManager.h"
+#include "Camera/CCamera.h"
 
 #include "Material/Shader/ShaderCallback/CShaderSH.h"
 #include "Material/Shader/ShaderCallback/CShaderLighting.h"
@@ -81,120 +82,91 @@ namespace Skylicht
 
 	}
 
-	int cmpRenderMeshFunc(const void* a, const void* b)
+	void CMeshRenderer::update(CEntityManager* entityManager)
 	{
-		CRenderMeshData* pa = *((CRenderMeshData**)a);
-		CRenderMeshData* pb = *((CRenderMeshData**)b);
-
-		CMesh* meshA = pa->getMesh();
-		CMesh* meshB = pb->getMesh();
-
-		std::vector<CMaterial*>& materialsA = meshA->Materials;
-		std::vector<CMaterial*>& materialsB = meshB->Materials;
+		// sort the mesh buffers by shader, material, texture, mesh & depth
+		m_queue.clear();
 
-		// no material, compare by mesh
-		if (materialsA.size() == 0 || materialsA.size() == 0)
-		{
-			if (meshA == meshB)
-				return 0;
-
-			return meshA < meshB ? -1 : 1;
-		}
+		u32 count = m_meshs.size();
+		if (count == 0)
+			return;
 
-		CMaterial* materialA = materialsA[0];
-		CMaterial* materialB = materialsB[0];
+		core::vector3df cameraPosition;
 
-		// compare by mesh
-		if (materialA == NULL || materialB == NULL)
+		CCamera* camera = entityManager->getCamera();
+		if (camera != NULL)
 		{
-			IMeshBuffer* mbA = meshA->getMeshBuffer(0);
-			IMeshBuffer* mbB = meshB->getMeshBuffer(0);
-
-			if (mbA == mbB)
-				return 0;
-
-			return mbA < mbB ? -1 : 1;
+			cameraPosition = camera->getGameObject()->getPosition();
+			m_queue.setMaxDepth(camera->getFarValue());
 		}
 
-		// comprate by texture
-		ITexture* textureA = materialA->getTexture(0);
-		ITexture* textureB = materialB->getTexture(0);
+		CRenderMeshData** meshs = m_meshs.pointer();
+		CEntity** allEntities = entityManager->getEntities();
 
-		// if no texture
-		if (textureA == NULL || textureB == NULL)
+		for (u32 i = 0; i < count; i++)
 		{
-			if (materialA == materialB)
-			{
-				// compare mesh
-				IMeshBuffer* mbA = meshA->getMeshBuffer(0);
-				IMeshBuffer* mbB = meshB->getMeshBuffer(0);
-
-				if (mbA == mbB)
-					return 0;
-			}
-
-			return materialA < materialB ? -1 : 1;
-		}
+			CRenderMeshData* meshData = meshs[i];
+			CEntity* entity = allEntities[meshData->EntityIndex];
 
-		// sort by texture 0
-		if (textureA == textureB)
-		{
-			// compare mesh
-			IMeshBuffer* mbA = meshA->getMeshBuffer(0);
-			IMeshBuffer* mbB = meshB->getMeshBuffer(0);
+			CMesh* mesh = meshData->getMesh();
+			if (meshData->isSoftwareBlendShape())
+				mesh = meshData->getSoftwareBlendShapeMesh();
+			if (meshData->isSoftwareSkinning())
+				mesh = meshData->getSoftwareSkinnedMesh();
 
-			if (mbA == mbB)
-				return 0;
+			CWorldTransformData* transform = GET_ENTITY_DATA(entity, CWorldTransformData);
+			f32 depth = transform->World.getTranslation().getDistanceFrom(cameraPosition);
 
-			return mbA < mbB ? -1 : 1;
+			m_queue.add(meshData, mesh, depth);
 		}
 
-		return textureA < textureB ? -1 : 1;
+		m_queue.sort();
 	}
 
-	void CMeshRenderer::update(CEntityManager* entityManager)
+	void CMeshRenderer::render(CEntityManager* entityManager)
 	{
-		// need sort render by material, texture, mesh		
-		u32 count = m_meshs.size();
-		if (count > 0)
-		{
-			// need sort by material
-			qsort(m_meshs.pointer(), count, sizeof(CRenderMeshData*), cmpRenderMeshFunc);
-		}
+		m_commands.reset();
+		recordRender(entityManager, &m_commands);
+		m_commands.replay(entityManager);
 	}
 
-	void CMeshRenderer::render(CEntityManager* entityManager)
+	bool CMeshRenderer::recordRender(CEntityManager* entityManager, CRenderCommandBuffer* commands)
 	{
-		IVideoDriver* driver = getVideoDriver();
-		IRenderPipeline* rp = entityManager->getRenderPipeline();
-		CRenderMeshData** meshs = m_meshs.pointer();
 		CEntity** allEntities = entityManager->getEntities();
 
-		for (u32 i = 0, n = m_meshs.size(); i < n; i++)
+		CRenderMeshData* lastMeshData = NULL;
+
+		for (int i = 0, n = m_queue.getCount(); i < n; i++)
 		{
-			CRenderMeshData* meshData = m_meshs[i];
-			CEntity* entity = allEntities[meshData->EntityIndex];
+			CRenderQueue::SRenderItem* item = m_queue.getItem(i);
+			CRenderMeshData* meshData = item->MeshData;
 
-			CMesh* mesh = meshData->getMesh();
-			if (meshData->isSoftwareBlendShape())
-				mesh = meshData->getSoftwareBlendShapeMesh();
-			if (meshData->isSoftwareSkinning())
-				mesh = meshData->getSoftwareSkinnedMesh();
+			// the entity state is same with the last item
+			if (meshData == lastMeshData)
+			{
+				commands->drawMeshBuffer(item->Mesh, item->BufferID, meshData->EntityIndex, false);
+				continue;
+			}
+
+			lastMeshData = meshData;
+
+			CEntity* entity = allEntities[meshData->EntityIndex];
 
 			CIndirectLightingData* lightingData = GET_ENTITY_DATA(entity, CIndirectLightingData);
 			if (lightingData != NULL)
 			{
 				if (lightingData->Type == CIndirectLightingData::SH9)
-					CShaderSH::setSH9(lightingData->SH);
+					commands->setSH9(lightingData->SH);
 				else if (lightingData->Type == CIndirectLightingData::AmbientColor)
-					CShaderLighting::setLightAmbient(lightingData->Color);
+					commands->setAmbientColor(lightingData->Color);
 			}
 
 			CWorldTransformData* transform = GET_ENTITY_DATA(entity, CWorldTransformData);
-			driver->setTransform(video::ETS_WORLD, transform->World);
+			commands->setWorldTransform(&transform->World);
 
-			for (u32 j = 0, m = mesh->getMeshBufferCount(); j < m; j++)
-				rp->drawMeshBuffer(mesh, j, entityManager, meshData->EntityIndex, false);
+			commands->drawMeshBuffer(item->Mesh, item->BufferID, meshData->EntityIndex, false);
 		}
+
+		return true;
 	}
 }
\ No newline at end of file
@@ -26,6 +26,8 @@ https://github.com/skylicht-lab/skylicht-engine
 
 #include "CRenderMeshData.h"
 #include "CMeshRenderSystem.h"
+#include "RenderPipeline/CRenderCommandBuffer.h"
+#include "CRenderQueue.h"
 #include "Transform/CWorldTransformData.h"
 #include "IndirectLighting/CIndirectLightingData.h"
 
@@ -36,6 +38,10 @@ namespace Skylicht
 	protected:
 		core::array<CRenderMeshData*> m_meshs;
 
+		CRenderCommandBuffer m_commands;
+
+		CRenderQueue m_queue;
+
 	public:
 		CMeshRenderer();
 
@@ -50,5 +56,7 @@ namespace Skylicht
 		virtual void update(CEntityManager* entityManager);
 
 		virtual void render(CEntityManager* entityManager);
+
+		virtual bool recordRender(CEntityManager* entityManager, CRenderCommandBuffer* commands);
 	};
 }
\ No newline at end of file
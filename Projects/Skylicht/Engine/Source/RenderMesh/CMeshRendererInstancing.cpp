@@ -27,6 +27,7 @@ https://github.com/skylicht-lab/skylicht-engine
 
 #include "Culling/CCullingData.h"
 #include "Entity/CEntityManager.h"
+#include "Camera/CCamera.h"
 
 #include "Material/Shader/ShaderCallback/CShaderSH.h"
 #include "Material/Shader/ShaderCallback/CShaderLighting.h"
@@ -34,7 +35,8 @@ https://github.com/skylicht-lab/skylicht-engine
 
 namespace Skylicht
 {
-	CMeshRendererInstancing::CMeshRendererInstancing()
+	CMeshRendererInstancing::CMeshRendererInstancing() :
+		m_visitID(0)
 	{
 		m_pipelineType = IRenderPipeline::Mix;
 	}
@@ -51,13 +53,6 @@ namespace Skylicht
 	{
 		m_meshs.set_used(0);
 
-		for (auto it : m_groups)
-		{
-			SMeshInstancingGroup* group = it.second;
-			group->Materials.reset();
-			group->Entities.reset();
-		}
-
 		CMeshRenderSystem::beginQuery(entityManager);
 	}
 
@@ -66,6 +61,9 @@ namespace Skylicht
 		numEntity = m_groupMesh->getNumInstancingMesh();
 		entities = m_groupMesh->getInstancingMeshes();
 
+		CCamera* camera = entityManager->getCamera();
+		u32 cullingMask = camera != NULL ? camera->getCullingMask() : 0xFFFFFFFF;
+
 		for (int i = 0; i < numEntity; i++)
 		{
 			CEntity* entity = entities[i];
@@ -77,7 +75,7 @@ namespace Skylicht
 			// get culling result from CCullingSystem
 			CCullingData* cullingData = GET_ENTITY_DATA(entity, CCullingData);
 			if (cullingData != NULL)
-				cullingVisible = cullingData->Visible;
+				cullingVisible = isInstanceVisible(cullingData, cullingMask);
 
 			// only render visible culling mesh
 			if (cullingVisible == true)
@@ -85,11 +83,36 @@ namespace Skylicht
 		}
 	}
 
+	bool CMeshRendererInstancing::isInstanceVisible(CCullingData* culling, u32 cullingMask)
+	{
+		if (culling->Visible)
+			return true;
+
+		// the shadow cascades & camera pass cull the different views on the same frame,
+		// keep the instance that is visible on any view, so its slot is not released & added again between the passes.
+		// the instances outside the current view are clipped when draw
+		return culling->ViewMask != 0 && (culling->CullingLayer & cullingMask) != 0;
+	}
+
 	void CMeshRendererInstancing::init(CEntityManager* entityManager)
 	{
 
 	}
 
+	SMeshInstancingGroup* CMeshRendererInstancing::getGroup(SMeshInstancingData* data)
+	{
+		auto it = m_groups.find(data);
+		if (it != m_groups.end())
+			return it->second;
+
+		SMeshInstancingGroup* group = new SMeshInstancingGroup();
+		group->Data = data;
+
+		m_groups[data] = group;
+		m_listGroups.push(group);
+		return group;
+	}
+
 	void CMeshRendererInstancing::update(CEntityManager* entityManager)
 	{
 		u32 numEntity = m_meshs.size();
@@ -97,65 +120,194 @@ namespace Skylicht
 
 		CEntity** allEntities = entityManager->getEntities();
 
-		// update instancing
+		// set_used does not construct the new slots
+		u32 numSlot = (u32)entityManager->getNumEntities();
+		while (m_slots.size() < numSlot)
+			m_slots.push_back(SMeshInstancingSlot());
+
+		m_visitID++;
+
+		// update instancing slot
 		for (u32 i = 0; i < numEntity; i++)
 		{
 			SMeshInstancingData* data = renderData[i]->getInstancingData();
 
-			SMeshInstancingGroup* group = m_groups[data];
-			if (group == NULL)
+			u32 entityIndex = renderData[i]->EntityIndex;
+			CEntity* entity = allEntities[entityIndex];
+
+			CWorldTransformData* world = GET_ENTITY_DATA(entity, CWorldTransformData);
+			CIndirectLightingData* lighting = GET_ENTITY_DATA(entity, CIndirectLightingData);
+			u32 lightingID = lighting ? lighting->ChangedID : 0;
+
+			SMeshInstancingSlot& slot = m_slots[entityIndex];
+			SMeshInstancingGroup* group = slot.Group;
+
+			bool hasSlot = group != NULL &&
+				group->Data == data &&
+				slot.Slot < (int)group->Entities.size() &&
+				group->EntityIndex[slot.Slot] == entityIndex;
+
+			if (!hasSlot)
 			{
-				group = new SMeshInstancingGroup();
-				m_groups[data] = group;
-			}
+				// new instance, add at the end of group
+				group = getGroup(data);
 
-			CEntity* entity = allEntities[renderData[i]->EntityIndex];
-			group->Entities.push(entity);
+				slot.Group = group;
+				slot.Slot = (int)group->Entities.size();
+
+				group->Entities.push_back(entity);
+				group->EntityIndex.push_back(entityIndex);
+				group->LightingID.push_back(lightingID);
+				group->Visit.push_back(m_visitID);
+				group->DirtySlots.push(slot.Slot);
+			}
+			else
+			{
+				int id = slot.Slot;
+				if (world->NeedValidate || group->LightingID[id] != lightingID)
+				{
+					group->LightingID[id] = lightingID;
+					group->DirtySlots.push(id);
+				}
+
+				group->Entities[id] = entity;
+				group->Visit[id] = m_visitID;
+			}
 		}
 
 		// bake instancing in group
-		for (auto it : m_groups)
+		SMeshInstancingGroup** groups = m_listGroups.pointer();
+		for (int i = 0, n = m_listGroups.count(); i < n; i++)
 		{
-			SMeshInstancingData* data = it.first;
-			SMeshInstancingGroup* group = it.second;
+			SMeshInstancingGroup* group = groups[i];
 
-			u32 count = group->Entities.count();
-			if (count == 0)
+			removeInvisibleSlots(group);
+
+			if (group->Entities.size() > 0)
+				batchGroup(group);
+		}
+	}
+
+	void CMeshRendererInstancing::removeInvisibleSlots(SMeshInstancingGroup* group)
+	{
+		u32 i = 0;
+		while (i < group->Entities.size())
+		{
+			if (group->Visit[i] == m_visitID)
+			{
+				i++;
 				continue;
+			}
 
-			for (u32 i = 0, n = data->RenderMeshBuffers.size(); i < n; i++)
+			// release the slot
+			SMeshInstancingSlot& slot = m_slots[group->EntityIndex[i]];
+			if (slot.Group == group && slot.Slot == (int)i)
 			{
-				group->Materials.reset();
+				slot.Group = NULL;
+				slot.Slot = -1;
+			}
+
+			// move the last instance to this slot
+			u32 last = group->Entities.size() - 1;
+			if (i != last)
+			{
+				group->Entities[i] = group->Entities[last];
+				group->EntityIndex[i] = group->EntityIndex[last];
+				group->LightingID[i] = group->LightingID[last];
+				group->Visit[i] = group->Visit[last];
+
+				SMeshInstancingSlot& moved = m_slots[group->EntityIndex[i]];
+				if (moved.Group == group && moved.Slot == (int)last)
+					moved.Slot = (int)i;
+
+				group->DirtySlots.push((int)i);
+			}
+
+			group->Entities.set_used(last);
+			group->EntityIndex.set_used(last);
+			group->LightingID.set_used(last);
+			group->Visit.set_used(last);
+		}
+	}
+
+	void CMeshRendererInstancing::batchGroup(SMeshInstancingGroup* group)
+	{
+		SMeshInstancingData* data = group->Data;
+
+		u32 count = group->Entities.size();
+		u32 numMeshBuffer = data->RenderMeshBuffers.size();
+
+		const u32 paramSize = MAX_SHADERPARAMS * 4;
+
+		bool resize = group->BatchedCount != count;
+		if (group->MaterialParams.size() != numMeshBuffer * paramSize)
+		{
+			group->MaterialParams.set_used(numMeshBuffer * paramSize);
+			resize = true;
+		}
+
+		for (u32 i = 0; i < numMeshBuffer; i++)
+		{
+			CMaterial* material = data->Materials[i];
 
+			// material params changed
+			f32* params = material->getShaderParams().getParamData(0);
+			f32* baked = group->MaterialParams.pointer() + i * paramSize;
+
+			bool changed = memcmp(params, baked, paramSize * sizeof(f32)) != 0;
+			if (resize || changed)
+			{
+				group->Materials.reset();
 				for (u32 j = 0; j < count; j++)
-					group->Materials.push(data->Materials[i]);
+					group->Materials.push(material);
 
-				// batching transform & material data to buffer
-				data->Instancing[i]->batchIntancing(
+				data->Instancing[i]->batchMaterial(
 					data->InstancingBuffer[i],
+					group->Materials.pointer(),
+					count
+				);
+
+				memcpy(baked, params, paramSize * sizeof(f32));
+			}
+
+			// batching the changed transform & lighting to buffer
+			if (resize || group->DirtySlots.count() > 0)
+			{
+				data->Instancing[i]->batchTransformAndLighting(
 					data->TransformBuffer[i],
 					data->IndirectLightingBuffer[i],
-					group->Materials.pointer(),
 					group->Entities.pointer(),
-					count
+					count,
+					group->DirtySlots.pointer(),
+					group->DirtySlots.count()
 				);
 			}
 		}
+
+		group->DirtySlots.reset();
+		group->BatchedCount = count;
 	}
 
 	void CMeshRendererInstancing::render(CEntityManager* entityManager)
 	{
-		IVideoDriver* driver = getVideoDriver();
+		m_commands.reset();
+		recordRender(entityManager, &m_commands);
+		m_commands.replay(entityManager);
+	}
+
+	bool CMeshRendererInstancing::recordRender(CEntityManager* entityManager, CRenderCommandBuffer* commands)
+	{
 		IRenderPipeline* rp = entityManager->getRenderPipeline();
 
-		driver->setTransform(video::ETS_WORLD, core::IdentityMatrix);
+		commands->setWorldTransform(&core::IdentityMatrix);
 
-		for (auto& it : m_groups)
+		SMeshInstancingGroup** groups = m_listGroups.pointer();
+		for (int g = 0, n = m_listGroups.count(); g < n; g++)
 		{
-			SMeshInstancingData* data = it.first;
-			SMeshInstancingGroup* group = it.second;
+			SMeshInstancingGroup* group = groups[g];
+			SMeshInstancingData* data = group->Data;
 
-			int count = group->Entities.count();
+			int count = (int)group->Entities.size();
 			if (count == 0)
 				continue;
 
@@ -167,18 +319,19 @@ namespace Skylicht
 				if (!rp->canRenderShader(shader))
 					continue;
 
-				CShaderMaterial::setMaterial(NULL);
+				commands->setShaderMaterial(NULL);
 
 				int materialType = shader->getInstancingShader()->getMaterialRenderID();
 
-				rp->drawInstancingMeshBuffer(
+				commands->drawInstancing(
 					(CMesh*)data->InstancingMesh,
 					i,
 					materialType,
-					entityManager,
 					false
 				);
 			}
 		}
+
+		return true;
 	}
 }
\ No newline at end of file
@@ -26,15 +26,52 @@ https://github.com/skylicht-lab/skylicht-engine
 
 #include "CRenderMeshData.h"
 #include "CMeshRenderSystem.h"
+#include "RenderPipeline/CRenderCommandBuffer.h"
 #include "Transform/CWorldTransformData.h"
 #include "IndirectLighting/CIndirectLightingData.h"
+#include "Culling/CCullingData.h"
+
+#include <unordered_map>
 
 namespace Skylicht
 {
+	// the instances of a SMeshInstancingData, they keep the slot on the instancing buffer until culled
 	struct SMeshInstancingGroup
 	{
+		SMeshInstancingData* Data;
+
+		// slot data
+		core::array<CEntity*> Entities;
+		core::array<u32> EntityIndex;
+		core::array<u32> LightingID;
+		core::array<u32> Visit;
+
+		// the slots need write to transform & lighting buffer
+		CFastArray<int> DirtySlots;
+
+		// the material params that baked to instancing buffer (MAX_SHADERPARAMS vec4 each mesh buffer)
+		core::array<f32> MaterialParams;
 		CFastArray<CMaterial*> Materials;
-		CFastArray<CEntity*> Entities;
+
+		u32 BatchedCount;
+
+		SMeshInstancingGroup() :
+			Data(NULL),
+			BatchedCount(0)
+		{
+		}
+	};
+
+	struct SMeshInstancingSlot
+	{
+		SMeshInstancingGroup* Group;
+		int Slot;
+
+		SMeshInstancingSlot() :
+			Group(NULL),
+			Slot(-1)
+		{
+		}
 	};
 
 	class CMeshRendererInstancing : public CMeshRenderSystem
@@ -42,7 +79,15 @@ namespace Skylicht
 	protected:
 		core::array<CRenderMeshData*> m_meshs;
 
-		std::map<SMeshInstancingData*, SMeshInstancingGroup*> m_groups;
+		CRenderCommandBuffer m_commands;
+
+		std::unordered_map<SMeshInstancingData*, SMeshInstancingGroup*> m_groups;
+		CFastArray<SMeshInstancingGroup*> m_listGroups;
+
+		// the slot of instance (by entity index)
+		core::array<SMeshInstancingSlot> m_slots;
+
+		u32 m_visitID;
 
 	public:
 		CMeshRendererInstancing();
@@ -58,5 +103,17 @@ namespace Skylicht
 		virtual void update(CEntityManager* entityManager);
 
 		virtual void render(CEntityManager* entityManager);
+
+		virtual bool recordRender(CEntityManager* entityManager, CRenderCommandBuffer* commands);
+
+	protected:
+
+		SMeshInstancingGroup* getGroup(SMeshInstancingData* data);
+
+		bool isInstanceVisible(CCullingData* culling, u32 cullingMask);
+
+		void removeInvisibleSlots(SMeshInstancingGroup* group);
+
+		virtual void batchGroup(SMeshInstancingGroup* group);
 	};
 }
\ No newline at end of file
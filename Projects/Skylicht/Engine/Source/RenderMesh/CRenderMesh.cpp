@@ -45,7 +45,8 @@ namespace Skylicht
 		m_optimizeForRender(false),
 		m_loadTexcoord2(false),
 		m_loadNormal(true),
-		m_fixInverseNormal(true)
+		m_fixInverseNormal(true),
+		m_entitiesChangedID(0)
 	{
 
 	}
@@ -77,6 +78,8 @@ namespace Skylicht
 		m_allEntities.clear();
 		m_renderers.clear();
 		m_entities.clear();
+
+		m_entitiesChangedID++;
 	}
 
 	void CRenderMesh::initComponent()
@@ -54,6 +54,9 @@ namespace Skylicht
 		bool m_fixInverseNormal;
 		bool m_enableInstancing;
 
+		// increase when the entities are released, the handles of entity data are invalid
+		u32 m_entitiesChangedID;
+
 	public:
 		CRenderMesh();
 
@@ -101,6 +104,11 @@ namespace Skylicht
 			return m_allEntities;
 		}
 
+		inline u32 getEntitiesChangedID()
+		{
+			return m_entitiesChangedID;
+		}
+
 		std::vector<CRenderMeshData*>& getRenderers()
 		{
 			return m_renderers;
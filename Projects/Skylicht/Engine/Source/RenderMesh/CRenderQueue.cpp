@@ -0,0 +1,213 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2023 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#include "pch.h"
+#include "CRenderQueue.h"
+#include "Material/CMaterial.h"
+
+#define RENDER_KEY_SHADER_BITS 10
+#define RENDER_KEY_MATERIAL_BITS 12
+#define RENDER_KEY_TEXTURE_BITS 12
+#define RENDER_KEY_BUFFER_BITS 12
+#define RENDER_KEY_DEPTH_BITS 16
+
+namespace Skylicht
+{
+	CRenderQueue::CRenderQueue() :
+		m_maxDepth(1000.0f)
+	{
+
+	}
+
+	CRenderQueue::~CRenderQueue()
+	{
+
+	}
+
+	void CRenderQueue::clear()
+	{
+		m_items.reset();
+		m_index.reset();
+	}
+
+	u32 CRenderQueue::getPointerID(const void* p, u32 bits)
+	{
+		if (p == NULL)
+			return 0;
+
+		// hash the address, the collision only breaks the batching
+		u64 v = (u64)(uintptr_t)p;
+		u32 h = (u32)((v >> 4) ^ (v >> 32)) * 2654435761u;
+		return h >> (32 - bits);
+	}
+
+	u64 CRenderQueue::packKey(ERenderQueuePass pass, u32 shader, u32 material, u32 texture, u32 buffer, u32 depth)
+	{
+		u64 state = (u64)(shader & ((1 << RENDER_KEY_SHADER_BITS) - 1));
+		state = (state << RENDER_KEY_MATERIAL_BITS) | (material & ((1 << RENDER_KEY_MATERIAL_BITS) - 1));
+		state = (state << RENDER_KEY_TEXTURE_BITS) | (texture & ((1 << RENDER_KEY_TEXTURE_BITS) - 1));
+		state = (state << RENDER_KEY_BUFFER_BITS) | (buffer & ((1 << RENDER_KEY_BUFFER_BITS) - 1));
+
+		u64 d = (u64)(depth & ((1 << RENDER_KEY_DEPTH_BITS) - 1));
+		u64 key = (u64)pass << 62;
+
+		if (pass == Opaque)
+		{
+			// sort by state, then front to back
+			key |= (state << RENDER_KEY_DEPTH_BITS) | d;
+		}
+		else
+		{
+			// back to front, then by state
+			u64 farDepth = ((1 << RENDER_KEY_DEPTH_BITS) - 1) - d;
+			key |= (farDepth << 46) | state;
+		}
+
+		return key;
+	}
+
+	u32 CRenderQueue::quantizeDepth(f32 depth)
+	{
+		f32 d = core::clamp(depth / m_maxDepth, 0.0f, 1.0f);
+		return (u32)(d * (f32)((1 << RENDER_KEY_DEPTH_BITS) - 1));
+	}
+
+	CRenderQueue::SRenderItem* CRenderQueue::addItem(u64 key)
+	{
+		SRenderItem* item = m_items.getPush();
+		item->Key = key;
+		item->MeshData = NULL;
+		item->Mesh = NULL;
+		item->BufferID = 0;
+		return item;
+	}
+
+	void CRenderQueue::add(CRenderMeshData* meshData, CMesh* mesh, f32 depth)
+	{
+		u32 d = quantizeDepth(depth);
+
+		for (u32 i = 0, n = mesh->getMeshBufferCount(); i < n; i++)
+		{
+			IMeshBuffer* mb = mesh->getMeshBuffer(i);
+			video::SMaterial& irrMaterial = mb->getMaterial();
+
+			CMaterial* material = i < mesh->Materials.size() ? mesh->Materials[i] : NULL;
+			CShader* shader = material != NULL ? material->getShader() : NULL;
+
+			ERenderQueuePass pass = Opaque;
+			if (shader != NULL && !shader->isOpaque())
+				pass = Transparent;
+
+			u64 key = packKey(pass,
+				(u32)irrMaterial.MaterialType,
+				getPointerID(material, RENDER_KEY_MATERIAL_BITS),
+				getPointerID(material != NULL ? material->getTexture(0) : irrMaterial.TextureLayer[0].Texture, RENDER_KEY_TEXTURE_BITS),
+				getPointerID(mb, RENDER_KEY_BUFFER_BITS),
+				d);
+
+			SRenderItem* item = addItem(key);
+			item->MeshData = meshData;
+			item->Mesh = mesh;
+			item->BufferID = i;
+		}
+	}
+
+	void CRenderQueue::sort()
+	{
+		int count = m_items.count();
+
+		m_index.reset();
+		m_keys.reset();
+		m_tempKeys.reset();
+		m_tempIndex.reset();
+
+		SRenderItem* items = m_items.pointer();
+		for (int i = 0; i < count; i++)
+		{
+			m_index.push((u32)i);
+			m_keys.push(items[i].Key);
+			m_tempIndex.push(0);
+			m_tempKeys.push(0);
+		}
+
+		if (count <= 1)
+			return;
+
+		// count all 8 bits digits at once
+		u32 histogram[8][256];
+		memset(histogram, 0, sizeof(histogram));
+
+		u64* keys = m_keys.pointer();
+		for (int i = 0; i < count; i++)
+		{
+			u64 k = keys[i];
+			for (int b = 0; b < 8; b++)
+				histogram[b][(k >> (b * 8)) & 0xff]++;
+		}
+
+		u64* srcKeys = m_keys.pointer();
+		u64* dstKeys = m_tempKeys.pointer();
+		u32* srcIndex = m_index.pointer();
+		u32* dstIndex = m_tempIndex.pointer();
+		bool swapped = false;
+
+		// LSD radix sort, it is stable
+		for (int b = 0; b < 8; b++)
+		{
+			u32* h = histogram[b];
+			u32 shift = b * 8;
+
+			// skip the digit that all keys are same
+			if (h[(srcKeys[0] >> shift) & 0xff] == (u32)count)
+				continue;
+
+			u32 offset = 0;
+			for (int j = 0; j < 256; j++)
+			{
+				u32 c = h[j];
+				h[j] = offset;
+				offset += c;
+			}
+
+			for (int i = 0; i < count; i++)
+			{
+				u32 digit = (u32)((srcKeys[i] >> shift) & 0xff);
+				u32 pos = h[digit]++;
+				dstKeys[pos] = srcKeys[i];
+				dstIndex[pos] = srcIndex[i];
+			}
+
+			core::swap(srcKeys, dstKeys);
+			core::swap(srcIndex, dstIndex);
+			swapped = !swapped;
+		}
+
+		// the result is on the temp buffer
+		if (swapped)
+		{
+			memcpy(m_index.pointer(), m_tempIndex.pointer(), count * sizeof(u32));
+			memcpy(m_keys.pointer(), m_tempKeys.pointer(), count * sizeof(u64));
+		}
+	}
+}
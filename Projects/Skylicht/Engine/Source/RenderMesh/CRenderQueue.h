@@ -0,0 +1,107 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2023 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#pragma once
+
+#include "CRenderMeshData.h"
+#include "Entity/CArrayUtils.h"
+
+namespace Skylicht
+{
+	/// Draw items (per mesh buffer) sorted by a 64 bit key
+	/// opaque:      pass(2) | shader(10) | material(12) | texture(12) | buffer(12) | depth(16)
+	/// transparent: pass(2) | far depth(16) | shader(10) | material(12) | texture(12) | buffer(12)
+	class CRenderQueue
+	{
+	public:
+		enum ERenderQueuePass
+		{
+			Opaque = 0,
+			Transparent
+		};
+
+		struct SRenderItem
+		{
+			u64 Key;
+
+			CRenderMeshData* MeshData;
+
+			// the mesh to draw (it can be the software skinned mesh)
+			CMesh* Mesh;
+
+			u32 BufferID;
+		};
+
+	protected:
+		CFastArray<SRenderItem> m_items;
+
+		CFastArray<u64> m_keys;
+		CFastArray<u64> m_tempKeys;
+
+		CFastArray<u32> m_index;
+		CFastArray<u32> m_tempIndex;
+
+		f32 m_maxDepth;
+
+	public:
+		CRenderQueue();
+
+		virtual ~CRenderQueue();
+
+		void clear();
+
+		// the depth is quantized in [0, maxDepth]
+		inline void setMaxDepth(f32 depth)
+		{
+			m_maxDepth = depth;
+		}
+
+		// add all mesh buffers of the mesh
+		void add(CRenderMeshData* meshData, CMesh* mesh, f32 depth);
+
+		SRenderItem* addItem(u64 key);
+
+		// radix sort the keys
+		void sort();
+
+		inline int getCount()
+		{
+			return m_items.count();
+		}
+
+		// the item at sorted position
+		inline SRenderItem* getItem(int i)
+		{
+			return &m_items.pointer()[m_index.pointer()[i]];
+		}
+
+		static u64 packKey(ERenderQueuePass pass, u32 shader, u32 material, u32 texture, u32 buffer, u32 depth);
+
+		static u32 getPointerID(const void* p, u32 bits);
+
+	protected:
+
+		u32 quantizeDepth(f32 depth);
+	};
+}
@@ -155,11 +155,13 @@ namespace Skylicht
 
 	void CSkinnedMeshRenderer::render(CEntityManager* entityManager)
 	{
-		IVideoDriver* driver = getVideoDriver();
+		m_commands.reset();
+		recordRender(entityManager, &m_commands);
+		m_commands.replay(entityManager);
+	}
 
-		CRenderMeshData** meshs = m_meshs.pointer();
-		CShaderManager* shaderManager = CShaderManager::getInstance();
-		IRenderPipeline* rp = entityManager->getRenderPipeline();
+	bool CSkinnedMeshRenderer::recordRender(CEntityManager* entityManager, CRenderCommandBuffer* commands)
+	{
 		CEntity** allEntities = entityManager->getEntities();
 
 		for (u32 i = 0, n = m_meshs.size(); i < n; i++)
@@ -171,14 +173,14 @@ namespace Skylicht
 			if (lightingData != NULL)
 			{
 				if (lightingData->Type == CIndirectLightingData::SH9)
-					CShaderSH::setSH9(lightingData->SH);
+					commands->setSH9(lightingData->SH);
 				else if (lightingData->Type == CIndirectLightingData::AmbientColor)
-					CShaderLighting::setLightAmbient(lightingData->Color);
+					commands->setAmbientColor(lightingData->Color);
 			}
 
 			// set bone matrix to shader callback
 			CSkinnedMesh* mesh = (CSkinnedMesh*)renderMeshData->getMesh();
-			shaderManager->BoneMatrix = mesh->SkinningMatrix;
+			commands->setBoneMatrix(mesh->SkinningMatrix);
 
 			// software blendshape
 			if (renderMeshData->isSoftwareBlendShape())
@@ -186,7 +188,7 @@ namespace Skylicht
 
 			// set transform
 			CWorldTransformData* transform = GET_ENTITY_DATA(entity, CWorldTransformData);
-			driver->setTransform(video::ETS_WORLD, transform->World);
+			commands->setWorldTransform(&transform->World);
 
 			bool haveTransparent = false;
 
@@ -197,7 +199,7 @@ namespace Skylicht
 				if (material == NULL)
 				{
 					// draw opaque mesh because unknown material
-					rp->drawMeshBuffer(mesh, j, entityManager, renderMeshData->EntityIndex, true);
+					commands->drawMeshBuffer(mesh, j, renderMeshData->EntityIndex, true);
 				}
 				else if (material->getShader() != NULL && material->getShader()->isOpaque() == false)
 				{
@@ -207,7 +209,7 @@ namespace Skylicht
 				else
 				{
 					// draw opaque mesh
-					rp->drawMeshBuffer(mesh, j, entityManager, renderMeshData->EntityIndex, true);
+					commands->drawMeshBuffer(mesh, j, renderMeshData->EntityIndex, true);
 				}
 			}
 
@@ -217,6 +219,8 @@ namespace Skylicht
 				m_transparents.push_back(i);
 			}
 		}
+
+		return true;
 	}
 
 	void CSkinnedMeshRenderer::renderTransparent(CEntityManager* entityManager)
@@ -26,6 +26,7 @@ https://github.com/skylicht-lab/skylicht-engine
 
 #include "CRenderMeshData.h"
 #include "CMeshRenderSystem.h"
+#include "RenderPipeline/CRenderCommandBuffer.h"
 #include "Transform/CWorldTransformData.h"
 #include "IndirectLighting/CIndirectLightingData.h"
 
@@ -35,6 +36,8 @@ namespace Skylicht
 	{
 	protected:
 		core::array<CRenderMeshData*> m_meshs;
+
+		CRenderCommandBuffer m_commands;
 		core::array<u32> m_transparents;
 
 	public:
@@ -52,6 +55,8 @@ namespace Skylicht
 
 		virtual void render(CEntityManager* entityManager);
 
+		virtual bool recordRender(CEntityManager* entityManager, CRenderCommandBuffer* commands);
+
 		virtual void renderTransparent(CEntityManager* entityManager);
 	};
 }
\ No newline at end of file
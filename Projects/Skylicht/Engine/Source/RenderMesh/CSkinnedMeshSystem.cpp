@@ -26,12 +26,15 @@ https://github.com/skylicht-lab/skylicht-engine
 #include "Culling/CVisibleData.h"
 #include "Entity/CEntityManager.h"
 #include "CSkinnedMeshSystem.h"
+#include "CJointData.h"
 
 namespace Skylicht
 {
 	CSkinnedMeshSystem::CSkinnedMeshSystem()
 	{
-
+		// read joint animation matrix, write skinning matrix on mesh
+		readData(CJointData::DataTypeIndex);
+		writeData(CRenderMeshData::DataTypeIndex);
 	}
 
 	CSkinnedMeshSystem::~CSkinnedMeshSystem()
@@ -69,6 +72,10 @@ namespace Skylicht
 			{
 				CSkinnedMesh::SJoint& joint = skinnedMesh->Joints[j];
 
+				// the animation matrix is not changed (see CJointAnimationSystem), the skinning matrix is still valid
+				if (!joint.JointData->Changed)
+					continue;
+
 				// gpuSkinMat = animMat * bindPoseMatrix
 				// bindPoseMatrix = invMat * bindShapMat (see collada loader)
 				// animMat = transform of joint at pos (0,0,0)
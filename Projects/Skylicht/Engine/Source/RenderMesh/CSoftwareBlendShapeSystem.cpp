@@ -32,7 +32,8 @@ namespace Skylicht
 {
 	CSoftwareBlendShapeSystem::CSoftwareBlendShapeSystem()
 	{
-
+		readData(CCullingData::DataTypeIndex);
+		writeData(CRenderMeshData::DataTypeIndex);
 	}
 
 	CSoftwareBlendShapeSystem::~CSoftwareBlendShapeSystem()
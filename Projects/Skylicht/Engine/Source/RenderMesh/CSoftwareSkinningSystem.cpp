@@ -30,7 +30,8 @@ namespace Skylicht
 {
 	CSoftwareSkinningSystem::CSoftwareSkinningSystem()
 	{
-
+		readData(CCullingData::DataTypeIndex);
+		writeData(CRenderMeshData::DataTypeIndex);
 	}
 
 	CSoftwareSkinningSystem::~CSoftwareSkinningSystem()
@@ -24,6 +24,7 @@ https://github.com/skylicht-lab/skylicht-engine
 
 #include "pch.h"
 #include "CBaseRP.h"
+#include "CRenderStateCache.h"
 #include "RenderMesh/CMesh.h"
 #include "Material/CMaterial.h"
 #include "Material/Shader/CShaderManager.h"
@@ -33,6 +34,7 @@ https://github.com/skylicht-lab/skylicht-engine
 #include "Material/Shader/ShaderCallback/CShaderShadow.h"
 
 #include "IndirectLighting/CIndirectLightingData.h"
+#include "ReflectionProbe/CIndirectReflectionData.h"
 #include "RenderPipeline/CShadowMapRP.h"
 
 
@@ -153,11 +155,11 @@ namespace Skylicht
 						SUniform* uniform = shader->getFSUniform(res->Name.c_str());
 						if (uniform != NULL)
 						{
-							CIndirectLightingData* lightData = GET_ENTITY_DATA(entity->getEntity(entityID), CIndirectLightingData);
+							CIndirectReflectionData* reflectionData = GET_ENTITY_DATA(entity->getEntity(entityID), CIndirectReflectionData);
 							u32 textureID = (u32)uniform->Value[0];
 
-							if (lightData != NULL && lightData->ReflectionTexture != NULL && textureID < MATERIAL_MAX_TEXTURES)
-								irrMaterial.setTexture(textureID, lightData->ReflectionTexture);
+							if (reflectionData != NULL && reflectionData->ReflectionTexture != NULL && textureID < MATERIAL_MAX_TEXTURES)
+								irrMaterial.setTexture(textureID, reflectionData->ReflectionTexture);
 						}
 					}
 					else if (res->Type == CShader::ShadowMap)
@@ -195,10 +197,10 @@ namespace Skylicht
 		video::SMaterial& irrMaterial = mb->getMaterial();
 
 		// set irrlicht material
-		driver->setMaterial(irrMaterial);
+		CRenderStateCache::setMaterial(driver, irrMaterial);
 
 		// draw mesh buffer
-		driver->drawMeshBuffer(mb);
+		CRenderStateCache::drawMeshBuffer(driver, mb);
 	}
 
 	void CBaseRP::drawInstancingMeshBuffer(CMesh* mesh, int bufferID, int materialRenderID, CEntityManager* entity, bool skinnedMesh)
@@ -209,8 +211,8 @@ namespace Skylicht
 		video::SMaterial& irrMaterial = mb->getMaterial();
 		irrMaterial.MaterialType = materialRenderID;
 
-		driver->setMaterial(irrMaterial);
-		driver->drawMeshBuffer(mb);
+		CRenderStateCache::setMaterial(driver, irrMaterial);
+		CRenderStateCache::drawMeshBuffer(driver, mb);
 	}
 
 	void CBaseRP::beginRender2D(float w, float h)
@@ -254,8 +256,8 @@ namespace Skylicht
 		m_drawBuffer->setDirty(scene::EBT_VERTEX);
 
 		// draw buffer
-		driver->setMaterial(m_unbindMaterial);
-		driver->drawMeshBuffer(m_drawBuffer);
+		CRenderStateCache::setMaterial(driver, m_unbindMaterial);
+		CRenderStateCache::drawMeshBuffer(driver, m_drawBuffer);
 	}
 
 	void CBaseRP::renderBufferToTarget(float dx, float dy, float dw, float dh, float sx, float sy, float sw, float sh, SMaterial& material, bool flipY, bool flipX)
@@ -328,8 +330,8 @@ namespace Skylicht
 		material.ZWriteEnable = false;
 
 		// draw buffer
-		driver->setMaterial(material);
-		driver->drawMeshBuffer(m_drawBuffer);
+		CRenderStateCache::setMaterial(driver, material);
+		CRenderStateCache::drawMeshBuffer(driver, m_drawBuffer);
 	}
 
 	void CBaseRP::renderBufferToTarget(float sx, float sy, float sw, float sh, SMaterial& material, bool flipY, bool flipX)
@@ -402,8 +404,8 @@ namespace Skylicht
 		material.ZWriteEnable = false;
 
 		// draw buffer
-		driver->setMaterial(material);
-		driver->drawMeshBuffer(m_drawBuffer);
+		CRenderStateCache::setMaterial(driver, material);
+		CRenderStateCache::drawMeshBuffer(driver, m_drawBuffer);
 	}
 
 	void CBaseRP::renderEnvironment(CCamera* camera, CEntityManager* entityMgr, const core::vector3df& position, ITexture* texture[], int* face, int numFace)
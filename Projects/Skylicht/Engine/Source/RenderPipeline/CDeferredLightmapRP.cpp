@@ -25,6 +25,7 @@ https://github.com/skylicht-lab/skylicht-engine
 #include "pch.h"
 #include "CDeferredLightmapRP.h"
 #include "CForwardRP.h"
+#include "CRenderStateCache.h"
 #include "RenderMesh/CMesh.h"
 #include "Material/CMaterial.h"
 #include "Material/Shader/CShaderManager.h"
@@ -274,10 +275,10 @@ namespace Skylicht
 				CShaderManager::getInstance()->LightmapIndex = (float)lightmapData->LightmapIndex;
 
 				// set irrlicht material
-				driver->setMaterial(lightmapDeferredMat);
+				CRenderStateCache::setMaterial(driver, lightmapDeferredMat);
 
 				// draw mesh buffer
-				driver->drawMeshBuffer(mb);
+				CRenderStateCache::drawMeshBuffer(driver, mb);
 			}
 		}
 		else
@@ -294,10 +295,10 @@ namespace Skylicht
 				irrMaterial.BackfaceCulling = false;
 
 				// set irrlicht material
-				driver->setMaterial(irrMaterial);
+				CRenderStateCache::setMaterial(driver, irrMaterial);
 
 				// draw mesh buffer
-				driver->drawMeshBuffer(mb);
+				CRenderStateCache::drawMeshBuffer(driver, mb);
 			}
 			else
 			{
@@ -327,8 +328,8 @@ namespace Skylicht
 				irrMaterial.MaterialType = materialRenderID;
 				irrMaterial.BackfaceCulling = false;
 
-				driver->setMaterial(irrMaterial);
-				driver->drawMeshBuffer(mb);
+				CRenderStateCache::setMaterial(driver, irrMaterial);
+				CRenderStateCache::drawMeshBuffer(driver, mb);
 			}
 			else
 			{
@@ -342,6 +343,9 @@ namespace Skylicht
 		if (camera == NULL)
 			return;
 
+		// the driver material may be changed by the last pass
+		CRenderStateCache::invalidate();
+
 		IVideoDriver* driver = getVideoDriver();
 
 		// custom viewport
@@ -25,6 +25,7 @@ https://github.com/skylicht-lab/skylicht-engine
 #include "pch.h"
 #include "CDeferredRP.h"
 #include "CForwardRP.h"
+#include "CRenderStateCache.h"
 #include "RenderMesh/CMesh.h"
 #include "Material/CMaterial.h"
 #include "Material/Shader/CShaderManager.h"
@@ -45,12 +46,18 @@ namespace Skylicht
 {
 	bool CDeferredRP::s_enableRenderIndirect = true;
 	bool CDeferredRP::s_enableRenderTestIndirect = false;
+	bool CDeferredRP::s_enableLightCluster = true;
 
 	CDeferredRP::CDeferredRP() :
 		m_albedo(NULL),
 		m_position(NULL),
 		m_normal(NULL),
 		m_data(NULL),
+		m_indirect(NULL),
+		m_lightBuffer(NULL),
+		m_target(NULL),
+		m_needBuildFrameGraph(true),
+		m_frameGraphTestIndirect(false),
 		m_isIndirectPass(false),
 		m_vertexColorShader(0),
 		m_textureColorShader(0),
@@ -80,54 +87,111 @@ namespace Skylicht
 
 	void CDeferredRP::initRTT(int w, int h)
 	{
-		IVideoDriver* driver = getVideoDriver();
-
 		// init render target
 		m_size = core::dimension2du((u32)w, (u32)h);
-		m_albedo = driver->addRenderTargetTexture(m_size, "albedo", ECF_A8R8G8B8);
-		m_position = driver->addRenderTargetTexture(m_size, "position", ECF_A32B32G32R32F);
-		m_normal = driver->addRenderTargetTexture(m_size, "normal", ECF_A32B32G32R32F);
-		m_data = driver->addRenderTargetTexture(m_size, "data", ECF_A8R8G8B8);
-
-		m_indirect = driver->addRenderTargetTexture(m_size, "indirect", ECF_A16B16G16R16F);
-		m_lightBuffer = driver->addRenderTargetTexture(m_size, "light", ECF_A16B16G16R16F);
 
-		m_target = driver->addRenderTargetTexture(m_size, "target", ECF_A16B16G16R16F);
-
-		// setup multi render target
-		// opengles just support 4 buffer
-		m_multiRenderTarget.push_back(m_albedo);
-		m_multiRenderTarget.push_back(m_position);
-		m_multiRenderTarget.push_back(m_normal);
-		m_multiRenderTarget.push_back(m_data);
+		buildFrameGraph();
 	}
 
 	void CDeferredRP::releaseRTT()
 	{
-		IVideoDriver* driver = getVideoDriver();
+		// the textures are owned by the frame graph
+		m_frameGraph.clear();
+		m_frameGraph.releaseTextures();
 
-		if (m_albedo != NULL)
-			driver->removeTexture(m_albedo);
+		if (m_postProcessor != NULL)
+			m_postProcessor->releaseFrameGraph();
 
-		if (m_position != NULL)
-			driver->removeTexture(m_position);
+		m_albedo = NULL;
+		m_position = NULL;
+		m_normal = NULL;
+		m_data = NULL;
+		m_indirect = NULL;
+		m_lightBuffer = NULL;
+		m_target = NULL;
 
-		if (m_normal != NULL)
-			driver->removeTexture(m_normal);
-
-		if (m_data != NULL)
-			driver->removeTexture(m_data);
-
-		if (m_indirect != NULL)
-			driver->removeTexture(m_indirect);
-
-		if (m_lightBuffer != NULL)
-			driver->removeTexture(m_lightBuffer);
+		m_multiRenderTarget.clear();
+	}
 
-		if (m_target != NULL)
-			driver->removeTexture(m_target);
+	void CDeferredRP::buildFrameGraph()
+	{
+		CFrameGraph& graph = m_frameGraph;
+		graph.clear();
+
+		int albedo = graph.createTexture("albedo", m_size, ECF_A8R8G8B8);
+		int position = graph.createTexture("position", m_size, ECF_A32B32G32R32F);
+		int normal = graph.createTexture("normal", m_size, ECF_A32B32G32R32F);
+		int data = graph.createTexture("data", m_size, ECF_A8R8G8B8);
+		int indirect = graph.createTexture("indirect", m_size, ECF_A16B16G16R16F);
+		int light = graph.createTexture("light", m_size, ECF_A16B16G16R16F);
+		int target = graph.createTexture("target", m_size, ECF_A16B16G16R16F);
+
+		// STEP 01: indirect
+		int pass = graph.addPass("Indirect");
+		graph.write(pass, indirect);
+
+		// STEP 02: gbuffer
+		pass = graph.addPass("GBuffer");
+		graph.write(pass, albedo);
+		graph.write(pass, position);
+		graph.write(pass, normal);
+		graph.write(pass, data);
+
+		// STEP 03: point & spot lighting
+		pass = graph.addPass("Lighting");
+		graph.read(pass, position);
+		graph.read(pass, normal);
+		graph.read(pass, data);
+		graph.write(pass, light);
+
+		// STEP 04: directional lighting
+		pass = graph.addPass("Composite");
+		graph.read(pass, albedo);
+		graph.read(pass, position);
+		graph.read(pass, normal);
+		graph.read(pass, data);
+		graph.read(pass, light);
+		graph.read(pass, indirect);
+		graph.write(pass, target);
+
+		// STEP 05: forwarder
+		pass = graph.addPass("Forward");
+		graph.read(pass, target);
+		graph.write(pass, target);
+
+		// STEP 06: final pass to screen
+		if (m_postProcessor != NULL)
+			m_postProcessor->declareFrameGraph(&graph, target, normal, position);
+
+		pass = graph.addPass("Final", true);
+		graph.read(pass, target);
+
+		// the test pass is culled if it is disabled, so the indirect target is free after composite
+		m_frameGraphTestIndirect = s_enableRenderTestIndirect;
+
+		pass = graph.addPass("TestIndirect", m_frameGraphTestIndirect);
+		graph.read(pass, indirect);
+
+		graph.compile();
+		graph.realize();
+
+		m_albedo = graph.getTexture(albedo);
+		m_position = graph.getTexture(position);
+		m_normal = graph.getTexture(normal);
+		m_data = graph.getTexture(data);
+		m_indirect = graph.getTexture(indirect);
+		m_lightBuffer = graph.getTexture(light);
+		m_target = graph.getTexture(target);
 
+		// setup multi render target
+		// opengles just support 4 buffer
 		m_multiRenderTarget.clear();
+		m_multiRenderTarget.push_back(m_albedo);
+		m_multiRenderTarget.push_back(m_position);
+		m_multiRenderTarget.push_back(m_normal);
+		m_multiRenderTarget.push_back(m_data);
+
+		m_needBuildFrameGraph = false;
 	}
 
 	void CDeferredRP::initRender(int w, int h)
@@ -171,6 +235,9 @@ namespace Skylicht
 
 		initDefferredMaterial();
 		initPointLightMaterial();
+
+		// the post processor may be resized after this pipeline
+		m_needBuildFrameGraph = true;
 	}
 
 	void CDeferredRP::initDefferredMaterial()
@@ -270,6 +337,16 @@ namespace Skylicht
 		return s_enableRenderIndirect;
 	}
 
+	void CDeferredRP::enableLightCluster(bool b)
+	{
+		s_enableLightCluster = b;
+	}
+
+	bool CDeferredRP::isEnableLightCluster()
+	{
+		return s_enableLightCluster;
+	}
+
 	bool CDeferredRP::canRenderMaterial(CMaterial* material)
 	{
 		if (material->isDeferred() == true)
@@ -311,10 +388,10 @@ namespace Skylicht
 				vertexLightmap.MaterialType = m_lightmapVertexShader;
 
 				// set irrlicht material
-				driver->setMaterial(vertexLightmap);
+				CRenderStateCache::setMaterial(driver, vertexLightmap);
 
 				// draw mesh buffer
-				driver->drawMeshBuffer(mb);
+				CRenderStateCache::drawMeshBuffer(driver, mb);
 			}
 			else if (indirectData->Type == CIndirectLightingData::LightmapArray)
 			{
@@ -327,10 +404,10 @@ namespace Skylicht
 					indirectColor.setTexture(0, indirectData->IndirectTexture);
 
 					// set irrlicht material
-					driver->setMaterial(indirectColor);
+					CRenderStateCache::setMaterial(driver, indirectColor);
 
 					// draw mesh buffer
-					driver->drawMeshBuffer(mb);
+					CRenderStateCache::drawMeshBuffer(driver, mb);
 				}
 			}
 			else if (indirectData->Type == CIndirectLightingData::SH9 && indirectData->SH)
@@ -342,10 +419,10 @@ namespace Skylicht
 				shMaterial.MaterialType = m_lightmapSHShader;
 
 				// set irrlicht material
-				driver->setMaterial(shMaterial);
+				CRenderStateCache::setMaterial(driver, shMaterial);
 
 				// draw mesh buffer
-				driver->drawMeshBuffer(mb);
+				CRenderStateCache::drawMeshBuffer(driver, mb);
 			}
 			else if (indirectData->Type == CIndirectLightingData::AmbientColor)
 			{
@@ -356,10 +433,10 @@ namespace Skylicht
 				shMaterial.MaterialType = m_lightmapColorShader;
 
 				// set irrlicht material
-				driver->setMaterial(shMaterial);
+				CRenderStateCache::setMaterial(driver, shMaterial);
 
 				// draw mesh buffer
-				driver->drawMeshBuffer(mb);
+				CRenderStateCache::drawMeshBuffer(driver, mb);
 			}
 		}
 		else
@@ -376,10 +453,10 @@ namespace Skylicht
 				irrMaterial.BackfaceCulling = false;
 
 				// set irrlicht material
-				driver->setMaterial(irrMaterial);
+				CRenderStateCache::setMaterial(driver, irrMaterial);
 
 				// draw mesh buffer
-				driver->drawMeshBuffer(mb);
+				CRenderStateCache::drawMeshBuffer(driver, mb);
 			}
 			else
 			{
@@ -408,8 +485,8 @@ namespace Skylicht
 					irrMaterial.MaterialType = m_lmInstancingTBN;
 
 				IVideoDriver* driver = getVideoDriver();
-				driver->setMaterial(irrMaterial);
-				driver->drawMeshBuffer(mb);
+				CRenderStateCache::setMaterial(driver, irrMaterial);
+				CRenderStateCache::drawMeshBuffer(driver, mb);
 			}
 		}
 		else
@@ -423,8 +500,8 @@ namespace Skylicht
 				irrMaterial.MaterialType = materialRenderID;
 				irrMaterial.BackfaceCulling = false;
 
-				driver->setMaterial(irrMaterial);
-				driver->drawMeshBuffer(mb);
+				CRenderStateCache::setMaterial(driver, irrMaterial);
+				CRenderStateCache::drawMeshBuffer(driver, mb);
 			}
 			else
 			{
@@ -438,8 +515,20 @@ namespace Skylicht
 		if (camera == NULL)
 			return;
 
+		// the driver material may be changed by the last pass
+		CRenderStateCache::invalidate();
+
 		IVideoDriver* driver = getVideoDriver();
 
+		// the post processor or the test pass is changed
+		if (m_needBuildFrameGraph || m_frameGraphTestIndirect != s_enableRenderTestIndirect)
+		{
+			buildFrameGraph();
+
+			initDefferredMaterial();
+			initPointLightMaterial();
+		}
+
 		// custom viewport
 		bool useCustomViewport = false;
 		core::recti customViewport;
@@ -541,12 +630,36 @@ namespace Skylicht
 			CShadowRTTManager* shadowRTT = CShadowRTTManager::getInstance();
 
 			core::array<CLightCullingData*>& listLight = lightCullingSystem->getLightVisible();
-			for (u32 i = 0, n = (u32)listLight.size(); i < n && i < s_maxLight; i++)
+			u32 numLight = core::min_((u32)listLight.size(), s_maxLight);
+
+			// the bake camera renders the full light pass
+			bool useCluster = s_enableLightCluster && s_bakeMode == false;
+			if (useCluster)
+			{
+				m_clusterLights.set_used(numLight);
+				for (u32 i = 0; i < numLight; i++)
+					m_clusterLights[i].init(listLight[i]->Light);
+
+				m_lightCluster.update(m_projectionMatrix, camera->getNearValue(), camera->getFarValue());
+				m_lightCluster.assignLights(m_viewMatrix, m_clusterLights.pointer(), numLight);
+			}
+
+			for (u32 i = 0; i < numLight; i++)
 			{
 				CLight* light = listLight[i]->Light;
 
 				bool renderLight = true;
 
+				// the screen rect of clusters that the light touches
+				core::rectf lightRect(0.0f, 0.0f, renderW, renderH);
+				if (useCluster && !m_lightCluster.getLightScreenRect(i, renderW, renderH, lightRect))
+					renderLight = false;
+
+				f32 x = lightRect.UpperLeftCorner.X;
+				f32 y = lightRect.UpperLeftCorner.Y;
+				f32 w = lightRect.getWidth();
+				f32 h = lightRect.getHeight();
+
 				if (s_bakeMode == true && s_bakeLMMode == true)
 				{
 					u32 lightBounce = light->getBounce();
@@ -579,7 +692,7 @@ namespace Skylicht
 						}
 
 						beginRender2D(renderW, renderH);
-						renderBufferToTarget(0.0f, 0.0f, renderW, renderH, m_pointLightPass);
+						renderBufferToTarget(x, y, w, h, x, y, w, h, m_pointLightPass);
 					}
 					else
 					{
@@ -592,7 +705,7 @@ namespace Skylicht
 							m_spotLightPass.setTexture(3, NULL);
 
 							beginRender2D(renderW, renderH);
-							renderBufferToTarget(0.0f, 0.0f, renderW, renderH, m_spotLightPass);
+							renderBufferToTarget(x, y, w, h, x, y, w, h, m_spotLightPass);
 						}
 					}
 				}
@@ -26,6 +26,8 @@ https://github.com/skylicht-lab/skylicht-engine
 
 #include "CBaseRP.h"
 #include "CPostProcessorRP.h"
+#include "CFrameGraph.h"
+#include "Lighting/CLightCluster.h"
 
 namespace Skylicht
 {
@@ -34,6 +36,7 @@ namespace Skylicht
 	protected:
 		static bool s_enableRenderIndirect;
 		static bool s_enableRenderTestIndirect;
+		static bool s_enableLightCluster;
 
 	protected:
 		ITexture* m_target;
@@ -48,6 +51,11 @@ namespace Skylicht
 
 		core::dimension2du m_size;
 
+		// the transient targets of this chain, the targets that are not alive at the same time share the texture
+		CFrameGraph m_frameGraph;
+		bool m_needBuildFrameGraph;
+		bool m_frameGraphTestIndirect;
+
 		core::array<irr::video::IRenderTarget> m_multiRenderTarget;
 
 		core::matrix4 m_viewMatrix;
@@ -88,6 +96,10 @@ namespace Skylicht
 
 		IPostProcessor* m_postProcessor;
 
+		// bin the point & spot lights to the clusters, the light pass just shades the tiles that the light touches
+		CLightCluster m_lightCluster;
+		core::array<SClusterLight> m_clusterLights;
+
 	protected:
 
 		void initDefferredMaterial();
@@ -113,9 +125,14 @@ namespace Skylicht
 
 		virtual void drawInstancingMeshBuffer(CMesh* mesh, int bufferID, int materialRenderID, CEntityManager* entityMgr, bool skinnedMesh);
 
+		// the post processor shares the frame graph, it must be deleted after this pipeline
 		inline void setPostProcessor(IPostProcessor* pp)
 		{
+			if (m_postProcessor != NULL && m_postProcessor != pp)
+				m_postProcessor->releaseFrameGraph();
+
 			m_postProcessor = pp;
+			m_needBuildFrameGraph = true;
 		}
 
 		inline void setIndirectMultipler(float f)
@@ -139,11 +156,27 @@ namespace Skylicht
 
 		static void enableTestIndirect(bool b);
 
+		static void enableLightCluster(bool b);
+
+		static bool isEnableLightCluster();
+
+		inline CLightCluster* getLightCluster()
+		{
+			return &m_lightCluster;
+		}
+
+		inline CFrameGraph* getFrameGraph()
+		{
+			return &m_frameGraph;
+		}
+
 	protected:
 
 		void initRTT(int w, int h);
 
 		void releaseRTT();
 
+		void buildFrameGraph();
+
 	};
 }
\ No newline at end of file
@@ -24,6 +24,7 @@ https://github.com/skylicht-lab/skylicht-engine
 
 #include "pch.h"
 #include "CForwardRP.h"
+#include "CRenderStateCache.h"
 
 #include "Material/Shader/CShaderManager.h"
 
@@ -82,6 +83,9 @@ namespace Skylicht
 		if (camera == NULL)
 			return;
 
+		// the driver material may be changed by the last pass
+		CRenderStateCache::invalidate();
+
 		IVideoDriver* driver = getVideoDriver();
 
 		ITexture* currentTarget = NULL;
@@ -0,0 +1,325 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2023 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#include "pch.h"
+#include "CFrameGraph.h"
+
+namespace Skylicht
+{
+	CFrameGraph::CFrameGraph() :
+		m_compiled(false)
+	{
+
+	}
+
+	CFrameGraph::~CFrameGraph()
+	{
+		releaseTextures();
+	}
+
+	void CFrameGraph::clear()
+	{
+		m_passes.clear();
+		m_resources.clear();
+		m_compiled = false;
+	}
+
+	int CFrameGraph::addPass(const char* name, bool sideEffect)
+	{
+		SPass pass;
+		pass.Name = name;
+		pass.SideEffect = sideEffect;
+		pass.Culled = false;
+		pass.RefCount = 0;
+
+		m_passes.push_back(pass);
+		m_compiled = false;
+		return (int)m_passes.size() - 1;
+	}
+
+	int CFrameGraph::createTexture(const char* name, const core::dimension2du& size, ECOLOR_FORMAT format)
+	{
+		SResource res;
+		res.Name = name;
+		res.Size = size;
+		res.Format = format;
+		res.Imported = NULL;
+		res.Physical = -1;
+		res.FirstPass = -1;
+		res.LastPass = -1;
+		res.RefCount = 0;
+
+		m_resources.push_back(res);
+		m_compiled = false;
+		return (int)m_resources.size() - 1;
+	}
+
+	int CFrameGraph::importTexture(const char* name, ITexture* texture)
+	{
+		core::dimension2du size;
+		if (texture != NULL)
+			size = texture->getSize();
+
+		int id = createTexture(name, size, texture != NULL ? texture->getColorFormat() : ECF_A8R8G8B8);
+		m_resources[id].Imported = texture;
+		return id;
+	}
+
+	void CFrameGraph::read(int pass, int resource)
+	{
+		if (pass < 0 || resource < 0)
+			return;
+
+		m_passes[pass].Reads.push_back(resource);
+		m_compiled = false;
+	}
+
+	void CFrameGraph::write(int pass, int resource)
+	{
+		if (pass < 0 || resource < 0)
+			return;
+
+		m_passes[pass].Writes.push_back(resource);
+		m_compiled = false;
+	}
+
+	void CFrameGraph::compile()
+	{
+		u32 numPass = m_passes.size();
+		u32 numResource = m_resources.size();
+
+		// reference count: pass = number of written resources, resource = number of readers
+		for (u32 i = 0; i < numResource; i++)
+		{
+			SResource& res = m_resources[i];
+			res.RefCount = 0;
+			res.Physical = -1;
+			res.FirstPass = -1;
+			res.LastPass = -1;
+		}
+
+		for (u32 i = 0; i < numPass; i++)
+		{
+			SPass& pass = m_passes[i];
+			pass.RefCount = pass.Writes.size();
+			pass.Culled = false;
+
+			for (u32 j = 0, n = pass.Reads.size(); j < n; j++)
+				m_resources[pass.Reads[j]].RefCount++;
+
+			// the imported texture is still used after this frame
+			for (u32 j = 0, n = pass.Writes.size(); j < n; j++)
+			{
+				if (m_resources[pass.Writes[j]].Imported != NULL)
+					pass.SideEffect = true;
+			}
+		}
+
+		// cull the passes that all written resources are not read
+		core::array<int> unused;
+		for (u32 i = 0; i < numResource; i++)
+		{
+			if (m_resources[i].RefCount == 0)
+				unused.push_back(i);
+		}
+
+		while (unused.size() > 0)
+		{
+			int resource = unused.getLast();
+			unused.erase(unused.size() - 1);
+
+			for (u32 i = 0; i < numPass; i++)
+			{
+				SPass& pass = m_passes[i];
+				if (pass.SideEffect || pass.RefCount == 0 || pass.Writes.linear_search(resource) < 0)
+					continue;
+
+				pass.RefCount--;
+				if (pass.RefCount > 0)
+					continue;
+
+				// this pass is culled, release its inputs
+				for (u32 j = 0, n = pass.Reads.size(); j < n; j++)
+				{
+					SResource& res = m_resources[pass.Reads[j]];
+					if (res.RefCount > 0 && --res.RefCount == 0)
+						unused.push_back(pass.Reads[j]);
+				}
+			}
+		}
+
+		for (u32 i = 0; i < numPass; i++)
+		{
+			SPass& pass = m_passes[i];
+			pass.Culled = !pass.SideEffect && pass.RefCount == 0;
+		}
+
+		// the lifetime of resources on the passes that are not culled
+		for (u32 i = 0; i < numPass; i++)
+		{
+			SPass& pass = m_passes[i];
+			if (pass.Culled)
+				continue;
+
+			for (int k = 0; k < 2; k++)
+			{
+				core::array<int>& list = k == 0 ? pass.Reads : pass.Writes;
+				for (u32 j = 0, n = list.size(); j < n; j++)
+				{
+					SResource& res = m_resources[list[j]];
+					if (res.FirstPass < 0)
+						res.FirstPass = (int)i;
+					res.LastPass = (int)i;
+				}
+			}
+		}
+
+		// assign the physical slots in pass order, the slot is free after the last pass of its resource
+		core::array<int> slotEnd;
+		core::array<SPhysicalTarget> slots;
+
+		for (u32 i = 0; i < numPass; i++)
+		{
+			for (u32 r = 0; r < numResource; r++)
+			{
+				SResource& res = m_resources[r];
+				if (res.Imported != NULL || res.FirstPass != (int)i)
+					continue;
+
+				int found = -1;
+				for (u32 s = 0, n = slots.size(); s < n; s++)
+				{
+					if (slotEnd[s] < (int)i &&
+						slots[s].Size == res.Size &&
+						slots[s].Format == res.Format)
+					{
+						found = (int)s;
+						break;
+					}
+				}
+
+				if (found < 0)
+				{
+					SPhysicalTarget slot;
+					slot.Size = res.Size;
+					slot.Format = res.Format;
+					slot.Texture = NULL;
+
+					slots.push_back(slot);
+					slotEnd.push_back(-1);
+					found = (int)slots.size() - 1;
+				}
+
+				res.Physical = found;
+				slotEnd[found] = res.LastPass;
+			}
+		}
+
+		// keep the created textures that match the new slots
+		for (u32 s = 0, n = slots.size(); s < n; s++)
+		{
+			for (u32 i = 0, m = m_physical.size(); i < m; i++)
+			{
+				SPhysicalTarget& old = m_physical[i];
+				if (old.Texture != NULL && old.Size == slots[s].Size && old.Format == slots[s].Format)
+				{
+					slots[s].Texture = old.Texture;
+					old.Texture = NULL;
+					break;
+				}
+			}
+		}
+
+		releaseTextures();
+
+		m_physical = slots;
+		m_compiled = true;
+	}
+
+	void CFrameGraph::realize()
+	{
+		IVideoDriver* driver = getVideoDriver();
+
+		for (u32 i = 0, n = m_physical.size(); i < n; i++)
+		{
+			SPhysicalTarget& slot = m_physical[i];
+			if (slot.Texture == NULL)
+				slot.Texture = driver->addRenderTargetTexture(slot.Size, "frame_graph", slot.Format);
+		}
+	}
+
+	void CFrameGraph::releaseTextures()
+	{
+		IVideoDriver* driver = getVideoDriver();
+
+		for (u32 i = 0, n = m_physical.size(); i < n; i++)
+		{
+			if (m_physical[i].Texture != NULL)
+			{
+				driver->removeTexture(m_physical[i].Texture);
+				m_physical[i].Texture = NULL;
+			}
+		}
+	}
+
+	ITexture* CFrameGraph::getTexture(int resource)
+	{
+		if (resource < 0)
+			return NULL;
+
+		SResource& res = m_resources[resource];
+		if (res.Imported != NULL)
+			return res.Imported;
+
+		if (res.Physical < 0)
+			return NULL;
+
+		return m_physical[res.Physical].Texture;
+	}
+
+	u32 CFrameGraph::getTransientMemory()
+	{
+		u32 bytes = 0;
+		for (u32 i = 0, n = m_resources.size(); i < n; i++)
+		{
+			SResource& res = m_resources[i];
+			if (res.Imported == NULL && res.Physical >= 0)
+				bytes += getTextureMemory(res.Size, res.Format);
+		}
+		return bytes;
+	}
+
+	u32 CFrameGraph::getPhysicalMemory()
+	{
+		u32 bytes = 0;
+		for (u32 i = 0, n = m_physical.size(); i < n; i++)
+			bytes += getTextureMemory(m_physical[i].Size, m_physical[i].Format);
+		return bytes;
+	}
+
+	u32 CFrameGraph::getTextureMemory(const core::dimension2du& size, ECOLOR_FORMAT format)
+	{
+		return size.Width * size.Height * IImage::getBitsPerPixelFromFormat(format) / 8;
+	}
+}
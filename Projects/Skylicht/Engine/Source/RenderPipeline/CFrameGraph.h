@@ -0,0 +1,152 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2023 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#pragma once
+
+namespace Skylicht
+{
+	/// The render passes of a frame declare the textures that they read & write.
+	/// compile() culls the passes that do not contribute to the output, and the transient
+	/// render targets that are never alive at the same time share the same texture.
+	class CFrameGraph
+	{
+	public:
+		struct SResource
+		{
+			std::string Name;
+			core::dimension2du Size;
+			ECOLOR_FORMAT Format;
+
+			// the external texture, it is not aliased
+			ITexture* Imported;
+
+			// the physical texture slot
+			int Physical;
+
+			// the first & last pass that use this resource
+			int FirstPass;
+			int LastPass;
+
+			u32 RefCount;
+		};
+
+		struct SPass
+		{
+			std::string Name;
+
+			core::array<int> Reads;
+			core::array<int> Writes;
+
+			// the pass writes to the screen or to the persistent state, it is never culled
+			bool SideEffect;
+
+			bool Culled;
+
+			u32 RefCount;
+		};
+
+		struct SPhysicalTarget
+		{
+			core::dimension2du Size;
+			ECOLOR_FORMAT Format;
+			ITexture* Texture;
+		};
+
+	protected:
+		core::array<SPass> m_passes;
+		core::array<SResource> m_resources;
+		core::array<SPhysicalTarget> m_physical;
+
+		bool m_compiled;
+
+	public:
+		CFrameGraph();
+
+		virtual ~CFrameGraph();
+
+		// remove all passes & resources, the textures are kept for the next realize
+		void clear();
+
+		int addPass(const char* name, bool sideEffect = false);
+
+		int createTexture(const char* name, const core::dimension2du& size, ECOLOR_FORMAT format);
+
+		int importTexture(const char* name, ITexture* texture);
+
+		void read(int pass, int resource);
+
+		void write(int pass, int resource);
+
+		// cull the passes & assign the physical slot of transient resources
+		void compile();
+
+		// create the textures of physical slots
+		void realize();
+
+		// remove all textures
+		void releaseTextures();
+
+		ITexture* getTexture(int resource);
+
+		inline bool isCompiled()
+		{
+			return m_compiled;
+		}
+
+		inline bool isPassCulled(int pass)
+		{
+			return m_passes[pass].Culled;
+		}
+
+		inline int getPhysicalID(int resource)
+		{
+			return m_resources[resource].Physical;
+		}
+
+		inline u32 getNumPhysical()
+		{
+			return m_physical.size();
+		}
+
+		inline u32 getNumPass()
+		{
+			return m_passes.size();
+		}
+
+		inline u32 getNumResource()
+		{
+			return m_resources.size();
+		}
+
+		// bytes of the transient resources if each has its own texture
+		u32 getTransientMemory();
+
+		// bytes of the physical textures after aliasing
+		u32 getPhysicalMemory();
+
+	protected:
+
+		static u32 getTextureMemory(const core::dimension2du& size, ECOLOR_FORMAT format);
+	};
+}
@@ -24,6 +24,7 @@ https://github.com/skylicht-lab/skylicht-engine
 
 #include "pch.h"
 #include "CPostProcessorRP.h"
+#include "CRenderStateCache.h"
 #include "Material/Shader/CShaderManager.h"
 #include "Material/Shader/CShaderParams.h"
 #include "Material/Shader/ShaderCallback/CShaderMaterial.h"
@@ -46,11 +47,15 @@ namespace Skylicht
 		m_numTarget(0),
 		m_bloomThreshold(0.9f),
 		m_bloomIntensity(1.0f),
-		m_lastFrameBuffer(NULL)
+		m_lastFrameBuffer(NULL),
+		m_frameGraph(NULL)
 	{
 		m_luminance[0] = NULL;
 		m_luminance[1] = NULL;
 
+		m_rttResource[0] = -1;
+		m_rttResource[1] = -1;
+
 		for (int i = 0; i < 10; i++)
 			m_rtt[i] = NULL;
 	}
@@ -91,8 +96,8 @@ namespace Skylicht
 
 		if (m_bloomEffect == true || m_fxaa == true)
 		{
-			m_rtt[0] = driver->addRenderTargetTexture(m_size, "rtt_0", ECF_A16B16G16R16F);
-			m_rtt[1] = driver->addRenderTargetTexture(m_size, "rtt_1", ECF_A16B16G16R16F);
+			if (m_frameGraph == NULL)
+				initFullSizeRTT();
 
 			if (m_bloomEffect == true)
 			{
@@ -122,18 +127,52 @@ namespace Skylicht
 			m_lastFrameBuffer = NULL;
 	}
 
+	void CPostProcessorRP::initFullSizeRTT()
+	{
+		IVideoDriver* driver = getVideoDriver();
+		m_rtt[0] = driver->addRenderTargetTexture(m_size, "rtt_0", ECF_A16B16G16R16F);
+		m_rtt[1] = driver->addRenderTargetTexture(m_size, "rtt_1", ECF_A16B16G16R16F);
+	}
+
+	void CPostProcessorRP::updateFullSizeRTT()
+	{
+		if (m_frameGraph != NULL)
+		{
+			m_rtt[0] = m_frameGraph->getTexture(m_rttResource[0]);
+			m_rtt[1] = m_frameGraph->getTexture(m_rttResource[1]);
+		}
+		else if ((m_bloomEffect == true || m_fxaa == true) && m_rtt[0] == NULL)
+		{
+			// the frame graph is released, use the own targets
+			initFullSizeRTT();
+		}
+	}
+
 	void CPostProcessorRP::releaseMainRTT()
 	{
 		IVideoDriver* driver = getVideoDriver();
 
 		for (int i = 0; i < 8; i++)
 		{
+			// the texture of frame graph
+			if (i < 2 && m_frameGraph != NULL)
+			{
+				m_rtt[i] = NULL;
+				continue;
+			}
+
 			if (m_rtt[i] != NULL)
+			{
 				driver->removeTexture(m_rtt[i]);
+				m_rtt[i] = NULL;
+			}
 		}
 
 		if (m_lastFrameBuffer != NULL)
+		{
 			driver->removeTexture(m_lastFrameBuffer);
+			m_lastFrameBuffer = NULL;
+		}
 	}
 
 	void CPostProcessorRP::initRender(int w, int h)
@@ -177,6 +216,52 @@ namespace Skylicht
 		initMainRTT(w, h);
 	}
 
+	void CPostProcessorRP::declareFrameGraph(CFrameGraph* graph, int color, int normal, int position)
+	{
+		// release the own full size targets, the graph gives them
+		if (m_frameGraph == NULL)
+		{
+			IVideoDriver* driver = getVideoDriver();
+			for (int i = 0; i < 2; i++)
+			{
+				if (m_rtt[i] != NULL)
+				{
+					driver->removeTexture(m_rtt[i]);
+					m_rtt[i] = NULL;
+				}
+			}
+		}
+
+		m_frameGraph = graph;
+
+		int pass = graph->addPass("PostProcessing", true);
+		graph->read(pass, color);
+		graph->read(pass, normal);
+		graph->read(pass, position);
+
+		m_rttResource[0] = -1;
+		m_rttResource[1] = -1;
+
+		if (m_bloomEffect == true || m_fxaa == true)
+		{
+			m_rttResource[0] = graph->createTexture("rtt_0", m_size, ECF_A16B16G16R16F);
+			m_rttResource[1] = graph->createTexture("rtt_1", m_size, ECF_A16B16G16R16F);
+
+			graph->write(pass, m_rttResource[0]);
+			graph->write(pass, m_rttResource[1]);
+		}
+	}
+
+	void CPostProcessorRP::releaseFrameGraph()
+	{
+		// the textures are owned by the graph, the own targets are created on next post processing
+		m_frameGraph = NULL;
+		m_rtt[0] = NULL;
+		m_rtt[1] = NULL;
+		m_rttResource[0] = -1;
+		m_rttResource[1] = -1;
+	}
+
 	void CPostProcessorRP::render(ITexture* target, CCamera* camera, CEntityManager* entityManager, const core::recti& viewport)
 	{
 		if (camera == NULL)
@@ -252,6 +337,10 @@ namespace Skylicht
 	{
 		IVideoDriver* driver = getVideoDriver();
 
+		CRenderStateCache::invalidate();
+
+		updateFullSizeRTT();
+
 		float renderW = (float)m_size.Width;
 		float renderH = (float)m_size.Height;
 
@@ -48,6 +48,10 @@ namespace Skylicht
 
 		int m_numTarget;
 
+		// the full size targets rtt_0, rtt_1 are aliased on the frame graph of main pipeline
+		CFrameGraph* m_frameGraph;
+		int m_rttResource[2];
+
 		SMaterial m_finalPass;
 		SMaterial m_finalManualExposurePass;
 		SMaterial m_linearPass;
@@ -166,10 +170,18 @@ namespace Skylicht
 			return m_lastFrameBuffer;
 		}
 
+		virtual void declareFrameGraph(CFrameGraph* graph, int color, int normal, int position);
+
+		virtual void releaseFrameGraph();
+
 	protected:
 
 		void initMainRTT(int w, int h);
 
+		void initFullSizeRTT();
+
+		void updateFullSizeRTT();
+
 		void releaseMainRTT();
 
 		void renderEffect(int fromTarget, int toTarget, CMaterial* material);
@@ -0,0 +1,160 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2023 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#include "pch.h"
+#include "CRenderCommandBuffer.h"
+#include "CRenderStateCache.h"
+#include "Entity/CEntityManager.h"
+#include "Material/Shader/CShaderManager.h"
+#include "Material/Shader/ShaderCallback/CShaderSH.h"
+#include "Material/Shader/ShaderCallback/CShaderLighting.h"
+#include "Material/Shader/ShaderCallback/CShaderMaterial.h"
+
+namespace Skylicht
+{
+	CRenderCommandBuffer::CRenderCommandBuffer() :
+		m_numDraw(0)
+	{
+
+	}
+
+	CRenderCommandBuffer::~CRenderCommandBuffer()
+	{
+
+	}
+
+	void CRenderCommandBuffer::setWorldTransform(const core::matrix4* world)
+	{
+		addCommand(SetWorldTransform)->Matrix = world;
+	}
+
+	void CRenderCommandBuffer::setSH9(core::vector3df* sh)
+	{
+		addCommand(SetSH9)->SH = sh;
+	}
+
+	void CRenderCommandBuffer::setAmbientColor(const SColor& color)
+	{
+		addCommand(SetAmbientColor)->Color = color.color;
+	}
+
+	void CRenderCommandBuffer::setBoneMatrix(f32* boneMatrix)
+	{
+		addCommand(SetBoneMatrix)->BoneMatrix = boneMatrix;
+	}
+
+	void CRenderCommandBuffer::setShaderMaterial(CMaterial* material)
+	{
+		addCommand(SetShaderMaterial)->ShaderMaterial = material;
+	}
+
+	void CRenderCommandBuffer::setMaterial(const video::SMaterial* material)
+	{
+		addCommand(SetMaterial)->Material = material;
+	}
+
+	void CRenderCommandBuffer::setRenderTarget(ITexture* target, bool clearColor, bool clearZ, const SColor& color)
+	{
+		SRenderCommand* c = addCommand(SetRenderTarget);
+		c->Target = target;
+		c->Param = (clearColor ? 1 : 0) | (clearZ ? 2 : 0);
+		c->Color = color.color;
+	}
+
+	void CRenderCommandBuffer::drawMeshBuffer(CMesh* mesh, int bufferID, int entityID, bool skinnedMesh)
+	{
+		SRenderCommand* c = addCommand(DrawMeshBuffer);
+		c->Mesh = mesh;
+		c->BufferID = bufferID;
+		c->Param = entityID;
+		c->SkinnedMesh = skinnedMesh;
+		m_numDraw++;
+	}
+
+	void CRenderCommandBuffer::drawInstancing(CMesh* mesh, int bufferID, int materialRenderID, bool skinnedMesh)
+	{
+		SRenderCommand* c = addCommand(DrawInstancing);
+		c->Mesh = mesh;
+		c->BufferID = bufferID;
+		c->Param = materialRenderID;
+		c->SkinnedMesh = skinnedMesh;
+		m_numDraw++;
+	}
+
+	void CRenderCommandBuffer::drawBuffer(IMeshBuffer* mb)
+	{
+		addCommand(DrawBuffer)->MeshBuffer = mb;
+		m_numDraw++;
+	}
+
+	void CRenderCommandBuffer::replay(CEntityManager* entityManager)
+	{
+		IVideoDriver* driver = getVideoDriver();
+		IRenderPipeline* rp = entityManager->getRenderPipeline();
+
+		SRenderCommand* commands = m_commands.pointer();
+
+		for (int i = 0, n = m_commands.count(); i < n; i++)
+		{
+			SRenderCommand& c = commands[i];
+
+			switch (c.Type)
+			{
+			case SetWorldTransform:
+				driver->setTransform(video::ETS_WORLD, *c.Matrix);
+				break;
+			case SetSH9:
+				CShaderSH::setSH9(c.SH);
+				break;
+			case SetAmbientColor:
+				CShaderLighting::setLightAmbient(SColor(c.Color));
+				break;
+			case SetBoneMatrix:
+				CShaderManager::getInstance()->BoneMatrix = c.BoneMatrix;
+				break;
+			case SetShaderMaterial:
+				CShaderMaterial::setMaterial(c.ShaderMaterial);
+				break;
+			case SetMaterial:
+				CRenderStateCache::setMaterial(driver, *c.Material);
+				break;
+			case SetRenderTarget:
+				driver->setRenderTarget(c.Target, (c.Param & 1) != 0, (c.Param & 2) != 0, SColor(c.Color));
+				CRenderStateCache::invalidate();
+				break;
+			case DrawMeshBuffer:
+				rp->drawMeshBuffer(c.Mesh, c.BufferID, entityManager, c.Param, c.SkinnedMesh);
+				break;
+			case DrawInstancing:
+				rp->drawInstancingMeshBuffer(c.Mesh, c.BufferID, c.Param, entityManager, c.SkinnedMesh);
+				break;
+			case DrawBuffer:
+				CRenderStateCache::drawMeshBuffer(driver, c.MeshBuffer);
+				break;
+			default:
+				break;
+			}
+		}
+	}
+}
@@ -0,0 +1,157 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2023 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#pragma once
+
+#include "Entity/CArrayUtils.h"
+
+namespace Skylicht
+{
+	class CMesh;
+	class CMaterial;
+	class CEntityManager;
+
+	/// The render commands of a system on a pass. The commands can be recorded on a worker thread,
+	/// the main thread replays them to the render pipeline & driver.
+	/// The pointers must be valid until the commands are replayed.
+	class CRenderCommandBuffer
+	{
+	public:
+		enum ECommandType
+		{
+			SetWorldTransform = 0,
+			SetSH9,
+			SetAmbientColor,
+			SetBoneMatrix,
+			SetShaderMaterial,
+			SetMaterial,
+			SetRenderTarget,
+			DrawMeshBuffer,
+			DrawInstancing,
+			DrawBuffer,
+			CommandCount
+		};
+
+		struct SRenderCommand
+		{
+			ECommandType Type;
+
+			// DrawMeshBuffer, DrawInstancing: mesh buffer id
+			int BufferID;
+
+			// DrawMeshBuffer: entity index, DrawInstancing: material render id, SetRenderTarget: clear flags (1: color, 2: z)
+			int Param;
+
+			bool SkinnedMesh;
+
+			union
+			{
+				CMesh* Mesh;
+				IMeshBuffer* MeshBuffer;
+				CMaterial* ShaderMaterial;
+				const video::SMaterial* Material;
+				ITexture* Target;
+			};
+
+			union
+			{
+				const core::matrix4* Matrix;
+				core::vector3df* SH;
+				f32* BoneMatrix;
+				u32 Color;
+			};
+		};
+
+	protected:
+		CFastArray<SRenderCommand> m_commands;
+
+		u32 m_numDraw;
+
+	public:
+		CRenderCommandBuffer();
+
+		virtual ~CRenderCommandBuffer();
+
+		inline void reset()
+		{
+			m_commands.reset();
+			m_numDraw = 0;
+		}
+
+		inline int getCount()
+		{
+			return m_commands.count();
+		}
+
+		inline SRenderCommand* getCommand(int i)
+		{
+			return m_commands.pointer() + i;
+		}
+
+		inline u32 getNumDraw()
+		{
+			return m_numDraw;
+		}
+
+		void setWorldTransform(const core::matrix4* world);
+
+		void setSH9(core::vector3df* sh);
+
+		void setAmbientColor(const SColor& color);
+
+		void setBoneMatrix(f32* boneMatrix);
+
+		// the material of shader params (CShaderMaterial)
+		void setShaderMaterial(CMaterial* material);
+
+		void setMaterial(const video::SMaterial* material);
+
+		void setRenderTarget(ITexture* target, bool clearColor, bool clearZ, const SColor& color);
+
+		// draw by the render pipeline
+		void drawMeshBuffer(CMesh* mesh, int bufferID, int entityID, bool skinnedMesh);
+
+		void drawInstancing(CMesh* mesh, int bufferID, int materialRenderID, bool skinnedMesh);
+
+		// draw by the driver with the current material
+		void drawBuffer(IMeshBuffer* mb);
+
+		// run the commands on the main thread
+		void replay(CEntityManager* entityManager);
+
+	protected:
+
+		inline SRenderCommand* addCommand(ECommandType type)
+		{
+			SRenderCommand* c = m_commands.getPush();
+			c->Type = type;
+			c->BufferID = 0;
+			c->Param = 0;
+			c->SkinnedMesh = false;
+			c->Mesh = NULL;
+			c->Matrix = NULL;
+			return c;
+		}
+	};
+}
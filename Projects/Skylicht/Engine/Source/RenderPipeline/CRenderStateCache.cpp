@@ -0,0 +1,90 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2023 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#include "pch.h"
+#include "CRenderStateCache.h"
+
+namespace Skylicht
+{
+	video::SMaterial CRenderStateCache::s_material;
+	video::IVertexDescriptor* CRenderStateCache::s_vertexDescriptor = NULL;
+	bool CRenderStateCache::s_valid = false;
+	bool CRenderStateCache::s_enable = true;
+	SRenderStateStats CRenderStateCache::s_stats;
+
+	void CRenderStateCache::setMaterial(IVideoDriver* driver, const video::SMaterial& material)
+	{
+		if (s_enable && s_valid)
+		{
+			if (s_material == material)
+			{
+				s_stats.RedundantSkipped++;
+				return;
+			}
+
+			// count what is changed
+			if (s_material.MaterialType != material.MaterialType)
+				s_stats.ShaderChanged++;
+
+			video::SMaterial state = material;
+			state.MaterialType = s_material.MaterialType;
+
+			for (u32 i = 0; i < video::MATERIAL_MAX_TEXTURES; i++)
+			{
+				if (s_material.TextureLayer[i].Texture != material.TextureLayer[i].Texture)
+				{
+					s_stats.TextureChanged++;
+					state.TextureLayer[i].Texture = s_material.TextureLayer[i].Texture;
+				}
+			}
+
+			if (state != s_material)
+				s_stats.StateChanged++;
+		}
+
+		s_material = material;
+		s_valid = true;
+		s_stats.MaterialChanged++;
+
+		driver->setMaterial(material);
+	}
+
+	void CRenderStateCache::drawMeshBuffer(IVideoDriver* driver, IMeshBuffer* mb)
+	{
+		video::IVertexDescriptor* vertexDescriptor = mb->getVertexDescriptor();
+		if (vertexDescriptor != s_vertexDescriptor)
+		{
+			s_vertexDescriptor = vertexDescriptor;
+			s_stats.VertexDescriptorChanged++;
+		}
+
+		driver->drawMeshBuffer(mb);
+	}
+
+	void CRenderStateCache::invalidate()
+	{
+		s_valid = false;
+		s_vertexDescriptor = NULL;
+	}
+}
@@ -0,0 +1,100 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2023 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#pragma once
+
+namespace Skylicht
+{
+	struct SRenderStateStats
+	{
+		// the material is sent to the driver
+		u32 MaterialChanged;
+
+		// the material is same as the bound material, skip
+		u32 RedundantSkipped;
+
+		// the detail of changed materials
+		u32 ShaderChanged;
+		u32 TextureChanged;
+		u32 StateChanged;
+
+		u32 VertexDescriptorChanged;
+
+		SRenderStateStats()
+		{
+			reset();
+		}
+
+		void reset()
+		{
+			MaterialChanged = 0;
+			RedundantSkipped = 0;
+			ShaderChanged = 0;
+			TextureChanged = 0;
+			StateChanged = 0;
+			VertexDescriptorChanged = 0;
+		}
+	};
+
+	/// Cache the material that bound on the driver, the render pipeline only send the changed material.
+	/// Call invalidate after someone set the driver material directly.
+	class CRenderStateCache
+	{
+	protected:
+		static video::SMaterial s_material;
+		static video::IVertexDescriptor* s_vertexDescriptor;
+		static bool s_valid;
+		static bool s_enable;
+
+		static SRenderStateStats s_stats;
+
+	public:
+		static void setMaterial(IVideoDriver* driver, const video::SMaterial& material);
+
+		static void drawMeshBuffer(IVideoDriver* driver, IMeshBuffer* mb);
+
+		static void invalidate();
+
+		static void enable(bool b)
+		{
+			s_enable = b;
+			s_valid = false;
+		}
+
+		static bool isEnable()
+		{
+			return s_enable;
+		}
+
+		static SRenderStateStats& getStats()
+		{
+			return s_stats;
+		}
+
+		static void resetStats()
+		{
+			s_stats.reset();
+		}
+	};
+}
@@ -24,12 +24,14 @@ https://github.com/skylicht-lab/skylicht-engine
 
 #include "pch.h"
 #include "CShadowMapRP.h"
+#include "CRenderStateCache.h"
 #include "RenderMesh/CMesh.h"
 #include "Material/Shader/ShaderCallback/CShaderMaterial.h"
 #include "Material/Shader/ShaderCallback/CShaderShadow.h"
 #include "Material/Shader/ShaderCallback/CShaderLighting.h"
 #include "Material/Shader/CShaderManager.h"
 #include "Lighting/CLightCullingSystem.h"
+#include "Culling/CCullingSystem.h"
 #include "Lighting/CPointLight.h"
 #include "Lighting/CSpotLight.h"
 #include "Lighting/CDirectionalLight.h"
@@ -44,7 +46,10 @@ namespace Skylicht
 		m_shadowMapSize(2048),
 		m_numCascade(3),
 		m_currentCSM(0),
-		m_saveDebug(false)
+		m_saveDebug(false),
+		m_cacheShadow(true),
+		m_farCascadeInterval(1),
+		m_frameCount(0)
 	{
 		m_type = ShadowMap;
 		m_lightDirection.set(-1.0f, -1.0f, -1.0f);
@@ -68,6 +73,9 @@ namespace Skylicht
 		m_writeDepthMaterial.BackfaceCulling = false;
 		m_writeDepthMaterial.FrontfaceCulling = false;
 
+		memset(m_shadowMatrices, 0, sizeof(m_shadowMatrices));
+		invalidateShadowCache();
+
 		// CEventManager::getInstance()->registerEvent("ShadowRP", this);
 	}
 
@@ -89,6 +97,42 @@ namespace Skylicht
 
 		core::dimension2du size = core::dimension2du((u32)m_shadowMapSize, (u32)m_shadowMapSize);
 		m_depthTexture = getVideoDriver()->addRenderTargetTextureArray(size, m_numCascade, "shadow_depth", ECF_R32F);
+
+		invalidateShadowCache();
+	}
+
+	void CShadowMapRP::invalidateShadowCache()
+	{
+		for (int i = 0; i < MAX_FRUSTUM_SPLITS; i++)
+			m_cascadeValid[i] = false;
+	}
+
+	bool CShadowMapRP::needRenderCascade(int cascade, CCullingSystem* cullingSystem)
+	{
+		if (!m_cacheShadow || !m_cascadeValid[cascade])
+			return true;
+
+		core::matrix4 viewProj = m_csm->getProjectionMatrices(cascade) * m_csm->getViewMatrices(cascade);
+
+		bool needRender = !m_cascadeViewProj[cascade].equals(viewProj, 0.0001f);
+
+		if (!needRender && cullingSystem != NULL)
+			needRender = cullingSystem->isChanged(m_csm->getCullingFrustum(cascade));
+
+		// the far cascades are updated at a reduced rate
+		if (needRender && cascade > 0 && ((m_frameCount + cascade) % m_farCascadeInterval) != 0)
+			needRender = false;
+
+		return needRender;
+	}
+
+	void CShadowMapRP::updateCascadeCache(int cascade, bool valid)
+	{
+		// the shader samples the depth by the matrix that rendered it
+		memcpy(m_shadowMatrices + cascade * 16, m_csm->getShadowMatrices() + cascade * 16, 16 * sizeof(float));
+
+		m_cascadeViewProj[cascade] = m_csm->getProjectionMatrices(cascade) * m_csm->getViewMatrices(cascade);
+		m_cascadeValid[cascade] = valid;
 	}
 
 	void CShadowMapRP::resize(int w, int h)
@@ -128,7 +172,7 @@ namespace Skylicht
 			else
 				m.MaterialType = m_texColorShader;
 
-			driver->setMaterial(m);
+			CRenderStateCache::setMaterial(driver, m);
 		}
 		else
 		{
@@ -148,11 +192,11 @@ namespace Skylicht
 				break;
 			}
 
-			driver->setMaterial(m_writeDepthMaterial);
+			CRenderStateCache::setMaterial(driver, m_writeDepthMaterial);
 		}
 
 		// draw mesh buffer
-		driver->drawMeshBuffer(mb);
+		CRenderStateCache::drawMeshBuffer(driver, mb);
 	}
 
 	void CShadowMapRP::drawInstancingMeshBuffer(CMesh* mesh, int bufferID, int materialRenderID, CEntityManager* entityMgr, bool skinnedMesh)
@@ -197,8 +241,8 @@ namespace Skylicht
 
 		if (setMaterial)
 		{
-			driver->setMaterial(m_writeDepthMaterial);
-			driver->drawMeshBuffer(mb);
+			CRenderStateCache::setMaterial(driver, m_writeDepthMaterial);
+			CRenderStateCache::drawMeshBuffer(driver, mb);
 		}
 	}
 
@@ -226,7 +270,7 @@ namespace Skylicht
 
 	float* CShadowMapRP::getShadowMatrices()
 	{
-		return m_csm->getShadowMatrices();
+		return m_shadowMatrices;
 	}
 
 	void CShadowMapRP::render(ITexture* target, CCamera* camera, CEntityManager* entityManager, const core::recti& viewport)
@@ -234,6 +278,9 @@ namespace Skylicht
 		if (camera == NULL)
 			return;
 
+		// the driver material may be changed by the last pass
+		CRenderStateCache::invalidate();
+
 		// use direction light
 		bool castShadow = true;
 
@@ -260,12 +307,36 @@ namespace Skylicht
 
 		CShaderShadow::setShadowMapRP(this);
 
+		// cull the cascades and the camera at once, the next pipelines use the camera view
+		CCullingSystem* cullingSystem = entityManager->getSystem<CCullingSystem>();
+		int cameraView = -1;
+		int cascadeView[MAX_FRUSTUM_SPLITS];
+
+		if (cullingSystem != NULL)
+		{
+			cullingSystem->clearViews();
+
+			for (int i = 0; i < m_numCascade; i++)
+				cascadeView[i] = cullingSystem->addView(m_csm->getCullingFrustum(i));
+
+			cameraView = cullingSystem->addView(camera->getViewFrustum());
+
+			// cull all views once, that also collects the casters changed on this frame
+			cullingSystem->queryViews(entityManager);
+		}
+
 		// render directional light shadow
 		m_renderShadowState = CShadowMapRP::DirectionLight;
+		m_frameCount++;
+
+		bool queried = false;
 
 		IVideoDriver* driver = getVideoDriver();
 		for (int i = m_numCascade - 1; i >= 0; i--)
 		{
+			if (castShadow && !needRenderCascade(i, cullingSystem))
+				continue;
+
 			// note: clear while 0xFFFFFFFF for max depth value
 			driver->setRenderTargetArray(m_depthTexture, i, true, true, SColor(255, 255, 255, 255));
 			driver->setTransform(video::ETS_PROJECTION, m_csm->getProjectionMatrices(i));
@@ -273,12 +344,23 @@ namespace Skylicht
 
 			m_currentCSM = i;
 
+			updateCascadeCache(i, castShadow);
+
 			if (castShadow)
 			{
-				if (i == m_numCascade - 1)
+				if (cullingSystem != NULL)
+				{
+					cullingSystem->setCurrentView(cascadeView[i]);
 					entityManager->cullingAndRender();
+				}
 				else
-					entityManager->render();
+				{
+					if (!queried)
+						entityManager->cullingAndRender();
+					else
+						entityManager->render();
+				}
+				queried = true;
 			}
 		}
 
@@ -297,6 +379,9 @@ namespace Skylicht
 
 				m_currentCSM = i;
 
+				if (cullingSystem != NULL)
+					cullingSystem->setCurrentView(cascadeView[i]);
+
 				entityManager->cullingAndRender();
 
 				driver->setRenderTarget(NULL, false, false);
@@ -315,15 +400,27 @@ namespace Skylicht
 		// render point light shadow
 		m_renderShadowState = CShadowMapRP::PointLight;
 
+		// all cascades are cached, query now for the visible lights of this frame
+		if (!queried)
+		{
+			if (cullingSystem != NULL)
+				cullingSystem->setCurrentView(cameraView);
+			entityManager->cullingQuery();
+		}
+
 		std::vector<ITexture*> listDepthTexture;
 
+		// the culling view of the light range, it is reused by all lights
+		int lightView = -1;
+
 		CLightCullingSystem* lightCullingSystem = entityManager->getSystem<CLightCullingSystem>();
 		if (lightCullingSystem != NULL)
 		{
 			CShadowRTTManager* shadowRTT = CShadowRTTManager::getInstance();
 			shadowRTT->clearLightData();
 
-			core::array<CLightCullingData*>& listLight = lightCullingSystem->getLightVisible();
+			// copy the list, the light query below updates the light culling again
+			core::array<CLightCullingData*> listLight = lightCullingSystem->getLightVisible();
 			for (u32 i = 0, n = listLight.size(); i < n && i < s_maxLight; i++)
 			{
 				CLight* light = listLight[i]->Light;
@@ -333,6 +430,10 @@ namespace Skylicht
 				if (s_bakeMode == false && light->getLightType() == CLight::Baked)
 					continue;
 
+				// a caster moved inside the light range
+				if (pointLight != NULL && cullingSystem != NULL && cullingSystem->isChanged(light->getBBBox()))
+					pointLight->setNeedRenderShadowDepth();
+
 				if (pointLight != NULL &&
 					pointLight->isCastShadow() == true &&
 					(pointLight->needRenderShadowDepth() || pointLight->isDynamicShadow()))
@@ -345,6 +446,18 @@ namespace Skylicht
 					ITexture* depth = shadowRTT->createGetPointLightDepth(pointLight);
 					if (depth != NULL)
 					{
+						// query the casters in the light range, the cube faces render this list
+						if (cullingSystem != NULL)
+						{
+							if (lightView < 0)
+								lightView = cullingSystem->addView(light->getBBBox());
+							else
+								cullingSystem->setView(lightView, light->getBBBox());
+
+							cullingSystem->setCurrentView(lightView);
+						}
+						entityManager->cullingQuery();
+
 						renderCubeEnvironment(camera, entityManager, lightPosition, depth, NULL, 0);
 						listDepthTexture.push_back(depth);
 					}
@@ -378,6 +491,13 @@ namespace Skylicht
 				d->regenerateMipMapLevels();
 		}
 
+		// the next pipelines use the camera view
+		if (cullingSystem != NULL)
+			cullingSystem->setCurrentView(cameraView);
+
 		onNext(target, camera, entityManager, viewport);
+
+		if (cullingSystem != NULL)
+			cullingSystem->clearViews();
 	}
 }
\ No newline at end of file
@@ -29,6 +29,8 @@ https://github.com/skylicht-lab/skylicht-engine
 
 namespace Skylicht
 {
+	class CCullingSystem;
+
 	class CShadowMapRP :
 		public CBaseRP,
 		public IEventReceiver
@@ -67,6 +69,17 @@ namespace Skylicht
 		int m_cubeDepthWriteTBNSGInstancing;
 
 		bool m_saveDebug;
+
+		// cached shadow: the cascade is rendered again if its matrix is changed or a caster inside moved
+		bool m_cacheShadow;
+		u32 m_farCascadeInterval;
+		u32 m_frameCount;
+
+		bool m_cascadeValid[MAX_FRUSTUM_SPLITS];
+		core::matrix4 m_cascadeViewProj[MAX_FRUSTUM_SPLITS];
+
+		// the shadow matrices of the depth that is rendered on the cascades
+		float m_shadowMatrices[16 * MAX_FRUSTUM_SPLITS];
 	public:
 		CShadowMapRP();
 
@@ -101,10 +114,41 @@ namespace Skylicht
 
 		virtual float* getShadowMatrices();
 
+		inline void setCacheShadow(bool b)
+		{
+			m_cacheShadow = b;
+			invalidateShadowCache();
+		}
+
+		inline bool isCacheShadow()
+		{
+			return m_cacheShadow;
+		}
+
+		// the far cascades (index > 0) are updated every n frames, 1 to update all cascades on every frame
+		inline void setFarCascadeUpdateInterval(u32 n)
+		{
+			m_farCascadeInterval = core::max_(n, 1u);
+		}
+
+		inline u32 getFarCascadeUpdateInterval()
+		{
+			return m_farCascadeInterval;
+		}
+
+		// render all cascades on the next frame
+		void invalidateShadowCache();
+
+		// the cached cascade is rendered again if its matrix is changed or a caster inside is changed
+		bool needRenderCascade(int cascade, CCullingSystem* cullingSystem);
+
 	protected:
 		CCascadedShadowMaps* getCSM()
 		{
 			return m_csm;
 		}
+
+		// save the matrix that the cascade is rendered by
+		void updateCascadeCache(int cascade, bool valid);
 	};
 }
\ No newline at end of file
@@ -25,6 +25,7 @@ https://github.com/skylicht-lab/skylicht-engine
 #pragma once
 
 #include "pch.h"
+#include "CFrameGraph.h"
 
 namespace Skylicht
 {
@@ -45,5 +46,15 @@ namespace Skylicht
 		virtual ITexture* getLastFrameBuffer() = 0;
 
 		virtual bool isEnableScreenSpaceReflection() = 0;
+
+		// declare the post processing pass & its transient targets on the graph of the main pipeline
+		virtual void declareFrameGraph(CFrameGraph* graph, int color, int normal, int position)
+		{
+		}
+
+		// the graph is released or the post processor is detached from the main pipeline
+		virtual void releaseFrameGraph()
+		{
+		}
 	};
 }
\ No newline at end of file
@@ -36,7 +36,10 @@ namespace Skylicht
 		m_shadowMapSize(2048),
 		m_lambda(0.9f),
 		m_nearOffset(300.0f),
-		m_farValue(500.0f)
+		m_farValue(500.0f),
+		m_lastFov(0.0f),
+		m_lastNear(0.0f),
+		m_needUpdate(true)
 	{
 
 	}
@@ -51,6 +54,7 @@ namespace Skylicht
 		m_splitCount = splitCount;
 		m_shadowMapSize = shadowMapSize;
 		m_farValue = farValue;
+		m_needUpdate = true;
 
 		float ratio = 1.0f;
 		if (screenHeight > 0)
@@ -85,6 +89,23 @@ namespace Skylicht
 	{
 		float cameraFov = camera->getFOV();
 
+		CTransform *cameraTransform = camera->getGameObject()->getTransform();
+		const core::matrix4& mat = cameraTransform->getRelativeTransform();
+
+		// the cascades are stable while the camera & light do not change
+		if (!m_needUpdate &&
+			m_lastCamera == mat &&
+			m_lastLightDirection == lightDir &&
+			m_lastFov == cameraFov &&
+			m_lastNear == camera->getNearValue())
+			return;
+
+		m_needUpdate = false;
+		m_lastCamera = mat;
+		m_lastLightDirection = lightDir;
+		m_lastFov = cameraFov;
+		m_lastNear = camera->getNearValue();
+
 		// note that fov is in radians here and in OpenGL it is in degrees.
 		// the 0.2f factor is important because we might get artifacts at
 		// the screen borders.
@@ -94,10 +115,7 @@ namespace Skylicht
 		m_lightDirection = lightDir;
 		m_lightDirection.normalize();
 
-		CTransform *cameraTransform = camera->getGameObject()->getTransform();
-
 		// camera position
-		const core::matrix4& mat = cameraTransform->getRelativeTransform();
 		core::vector3df cameraPosition = mat.getTranslation();
 
 		// camera forward
@@ -178,7 +196,14 @@ namespace Skylicht
 
 	void CCascadedShadowMaps::updateMatrix(core::vector3df& camPos)
 	{
-		core::matrix4 projection;
+		// the light space rotation, it does not depend on the camera
+		core::vector3df up = fabsf(m_lightDirection.Y) > 0.99f ? CTransform::s_oz : CTransform::s_oy;
+
+		core::matrix4 lightRotation;
+		lightRotation.buildCameraLookAtMatrixLH(core::vector3df(0.0f, 0.0f, 0.0f), m_lightDirection, up);
+
+		core::matrix4 invLightRotation;
+		lightRotation.getInverse(invLightRotation);
 
 		for (int i = 0; i < m_splitCount; i++)
 		{
@@ -192,7 +217,7 @@ namespace Skylicht
 
 			frustum.Center /= 8.0f;
 
-			// Calculate bounding sphere radius
+			// Calculate bounding sphere radius, it only depends on the split distances & fov
 			float radius = 0.0f;
 
 			for (int j = 0; j < 8; j++)
@@ -203,59 +228,59 @@ namespace Skylicht
 
 			radius = ceil(radius * 16.0f) / 16.0f;
 
-			// Find bounding box that fits the sphere
-			core::vector3df radius3(radius, radius, radius);
-
-			core::vector3df max = radius3;
-			core::vector3df min = -radius3;
+			// Grow 2 texels, the snapped sphere still covers the split
+			radius += 4.0f * radius / (float)m_shadowMapSize;
 
-			core::vector3df cascadeExtents = max - min;
+			// Snap the center to the shadow texel in light space, the matrices just change by the texel step
+			float texelSize = 2.0f * radius / (float)m_shadowMapSize;
 
-			// Push the light position back along the light direction by the near offset.
-			core::vector3df shadowCameraPos = frustum.Center - m_lightDirection * m_nearOffset;
+			core::vector3df center = frustum.Center;
+			lightRotation.transformVect(center);
 
-			// Compute bounding box for culling
-			m_frustumBox[i].MinEdge = frustum.Center - radius3;
-			m_frustumBox[i].MaxEdge = frustum.Center + radius3;
+			center.X = floorf(center.X / texelSize) * texelSize;
+			center.Y = floorf(center.Y / texelSize) * texelSize;
+			center.Z = floorf(center.Z / texelSize) * texelSize;
 
-			m_frustumBox[i].addInternalPoint(camPos);
+			invLightRotation.transformVect(center);
 
-			// Fix: object shadow culling above camera
-			core::vector3df highCameraPos = frustum.Center - m_lightDirection * radius * 2.0f;
-			m_frustumBox[i].addInternalPoint(highCameraPos);
+			// Push the light position back along the light direction by the near offset.
+			core::vector3df shadowCameraPos = center - m_lightDirection * m_nearOffset;
 
-			// Add the near offset to the Z value of the cascade extents to make sure the orthographic frustum captures the entire frustum split (else it will exhibit cut-off issues).
 			core::matrix4 ortho;
-			ortho.buildProjectionMatrixOrthoLH(max.X - min.X, max.Y - min.Y, -m_nearOffset, m_nearOffset + cascadeExtents.Z);
+			ortho.buildProjectionMatrixOrthoLH(radius * 2.0f, radius * 2.0f, -m_nearOffset, m_nearOffset + radius * 2.0f);
 
 			core::matrix4 view;
-			view.buildCameraLookAtMatrixLH(shadowCameraPos, frustum.Center, CTransform::s_oy);
+			view.buildCameraLookAtMatrixLH(shadowCameraPos, center, up);
 
 			m_projMatrices[i] = ortho;
 			m_viewMatrices[i] = view;
 
+			// Culling volume: the casters between the light near plane and the back of split sphere
+			core::matrix4 cullingOrtho;
+			cullingOrtho.buildProjectionMatrixOrthoLH(radius * 2.0f, radius * 2.0f, -m_nearOffset, m_nearOffset + radius);
 
-			core::matrix4 cropMatrix = ortho * view;
+			SViewFrustum& culling = m_cullingFrustum[i];
+			culling.setFrom(cullingOrtho * view);
 
-			core::vector3df shadowOrigin(0.0f, 0.0f, 0.0f);
-			cropMatrix.transformVect(shadowOrigin);
-			shadowOrigin = shadowOrigin * (m_shadowMapSize / 2.0f);
+			core::matrix4 invView;
+			view.getInverse(invView);
 
-			core::vector3df roundedOrigin;
-			roundedOrigin.X = round(shadowOrigin.X);
-			roundedOrigin.Y = round(shadowOrigin.Y);
-			roundedOrigin.Z = round(shadowOrigin.Z);
-
-			core::vector3df roundOffset = roundedOrigin - shadowOrigin;
+			for (int j = 0; j < 8; j++)
+			{
+				core::vector3df p(
+					(j & 1) ? radius : -radius,
+					(j & 2) ? radius : -radius,
+					(j & 4) ? m_nearOffset + radius : -m_nearOffset);
 
-			roundOffset = roundOffset * (2.0f / m_shadowMapSize);
-			roundOffset.Z = 0.0f;
+				invView.transformVect(p);
 
-			core::matrix4& shadowProj = m_projMatrices[i];
+				if (j == 0)
+					culling.boundingBox.reset(p);
+				else
+					culling.boundingBox.addInternalPoint(p);
+			}
 
-			shadowProj(3, 0) += roundOffset.X;
-			shadowProj(3, 1) += roundOffset.Y;
-			shadowProj(3, 2) += roundOffset.Z;
+			m_frustumBox[i] = culling.boundingBox;
 
 			core::matrix4 mvp = m_projMatrices[i] * m_viewMatrices[i];
 			core::matrix4 shadowMatrix = m_bias * mvp;
@@ -60,6 +60,16 @@ namespace Skylicht
 
 		core::aabbox3df m_frustumBox[MAX_FRUSTUM_SPLITS];
 
+		// the light space volume that casters can shadow the split, used to cull the casters
+		SViewFrustum m_cullingFrustum[MAX_FRUSTUM_SPLITS];
+
+		// the last update input, the matrices are not recomputed if nothing is changed
+		core::matrix4 m_lastCamera;
+		core::vector3df m_lastLightDirection;
+		float m_lastFov;
+		float m_lastNear;
+		bool m_needUpdate;
+
 		float m_shadowMatrices[16 * MAX_FRUSTUM_SPLITS];
 
 		float m_farValue;
@@ -78,6 +88,11 @@ namespace Skylicht
 			return m_frustumBox[cascaded];
 		}
 
+		const SViewFrustum& getCullingFrustum(int cascaded)
+		{
+			return m_cullingFrustum[cascaded];
+		}
+
 		int getSplitCount()
 		{
 			return m_splitCount;
@@ -25,6 +25,9 @@ https://github.com/skylicht-lab/skylicht-engine
 #include "pch.h"
 #include "Skylicht.h"
 
+// Job
+#include "Job/CJobSystem.h"
+
 // Event
 #include "EventManager/CEventManager.h"
 
@@ -73,6 +76,8 @@ namespace Skylicht
 		g_video = device->getVideoDriver();
 
 		os::Printer::log("Init Skylicht Engine");
+		SkylichtSystem::CJobSystem::createGetInstance();
+
 		CEventManager::createGetInstance();
 
 		CTouchManager::createGetInstance();
@@ -137,6 +142,8 @@ namespace Skylicht
 		CJoystick::releaseInstance();
 
 		CEventManager::releaseInstance();
+
+		SkylichtSystem::CJobSystem::releaseInstance();
 	}
 
 	void updateSkylicht()
@@ -53,51 +53,81 @@ namespace Skylicht
 		m_entities.reset();
 		m_roots.reset();
 		m_childs.reset();
+		m_childLevels.reset();
+
+		// sort by depth, the parent must be updated before its childs
+		int maxDepth = 0;
 
 		for (int i = 0; i < numEntity; i++)
 		{
 			CEntity* entity = entities[i];
 			CWorldTransformData* transform = GET_ENTITY_DATA(entity, CWorldTransformData);
 
-			// set disable flag
-			transform->NeedValidate = false;
-
-			int parentID = transform->AttachParentIndex >= 0 ?
-				transform->AttachParentIndex :
-				transform->ParentIndex;
+			m_depth[transform->Depth].push(entity);
 
-			if (parentID != -1)
-			{
-				transform->Parent = GET_ENTITY_DATA(allEntities[parentID], CWorldTransformData);
-
-				// this transform changed because parent is changed
-				if (transform->Parent->NeedValidate)
-					transform->HasChanged = true;
-			}
-			else
-			{
-				transform->Parent = NULL;
-			}
+			if (maxDepth < transform->Depth)
+				maxDepth = transform->Depth;
+		}
 
-			// tag to update list
-			if (transform->HasChanged)
-			{
-				// set enable flag for another system
-				transform->NeedValidate = true;
+		for (int d = 0; d <= maxDepth; d++)
+		{
+			if (d > 0)
+				m_childLevels.push(m_childs.count());
 
-				m_entities.push(entity);
+			entities = m_depth[d].pointer();
+			numEntity = m_depth[d].count();
 
-				if (transform->Depth == 0)
-					m_roots.push(transform);
-				else
-					m_childs.push(transform);
+			for (int i = 0; i < numEntity; i++)
+				updateTransform(entities[i], allEntities);
 
-				transform->HasChanged = false;
-			}
+			m_depth[d].reset();
 		}
 
+		m_childLevels.push(m_childs.count());
+
 		// notify alway update this group
 		m_needQuery = true;
 		m_needValidate = true;
 	}
+
+	void CGroupTransform::updateTransform(CEntity* entity, CEntity** allEntities)
+	{
+		CWorldTransformData* transform = GET_ENTITY_DATA(entity, CWorldTransformData);
+
+		// set disable flag
+		transform->NeedValidate = false;
+
+		int parentID = transform->AttachParentIndex >= 0 ?
+			transform->AttachParentIndex :
+			transform->ParentIndex;
+
+		if (parentID != -1)
+		{
+			transform->Parent = GET_ENTITY_DATA(allEntities[parentID], CWorldTransformData);
+
+			// this transform changed because parent is changed
+			if (transform->Parent->NeedValidate)
+				transform->HasChanged = true;
+		}
+		else
+		{
+			transform->Parent = NULL;
+		}
+
+		// tag to update list
+		if (transform->HasChanged)
+		{
+			// set enable flag for another system
+			transform->NeedValidate = true;
+
+			m_entities.push(entity);
+
+			if (transform->Depth == 0)
+				m_roots.push(transform);
+			else
+				m_childs.push(transform);
+
+			transform->HasChanged = false;
+		}
+	}
 }
\ No newline at end of file
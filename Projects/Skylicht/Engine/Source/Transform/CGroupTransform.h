@@ -34,6 +34,12 @@ namespace Skylicht
 		CFastArray<CWorldTransformData*> m_roots;
 		CFastArray<CWorldTransformData*> m_childs;
 
+		// m_childs is sorted by depth, this is the begin of each depth level (from depth 1) and the end of m_childs
+		CFastArray<int> m_childLevels;
+
+		// the parent group is not sorted, so the entities are sorted by depth here
+		CFastArray<CEntity*> m_depth[MAX_ENTITY_DEPTH];
+
 	public:
 		CGroupTransform(CEntityGroup* parent);
 
@@ -59,6 +65,21 @@ namespace Skylicht
 			return m_childs.pointer();
 		}
 
+		// the childs on a level do not depend each other, so they can update parallel
+		inline int getNumChildLevel()
+		{
+			return m_childLevels.count() - 1;
+		}
+
+		inline int* getChildLevels()
+		{
+			return m_childLevels.pointer();
+		}
+
 		virtual void onQuery(CEntityManager* entityManager, CEntity** entities, int numEntity);
+
+	protected:
+
+		void updateTransform(CEntity* entity, CEntity** allEntities);
 	};
 }
\ No newline at end of file
@@ -35,6 +35,8 @@ namespace Skylicht
 	CComponentTransformSystem::CComponentTransformSystem() :
 		m_group(NULL)
 	{
+		readData(CTransformComponentData::DataTypeIndex);
+		writeData(CWorldTransformData::DataTypeIndex);
 
 	}
 
@@ -27,12 +27,15 @@ https://github.com/skylicht-lab/skylicht-engine
 #include "Entity/CEntityManager.h"
 #include "Culling/CVisibleData.h"
 #include "Transform/CTransform.h"
+#include "Utils/CMatrixSIMD.h"
 
 namespace Skylicht
 {
 	CWorldInverseTransformSystem::CWorldInverseTransformSystem() :
 		m_group(NULL)
 	{
+		readData(CWorldTransformData::DataTypeIndex);
+		writeData(CWorldInverseTransformData::DataTypeIndex);
 	}
 
 	CWorldInverseTransformSystem::~CWorldInverseTransformSystem()
@@ -63,6 +66,11 @@ namespace Skylicht
 		CEntity** entities = m_group->getEntities();
 		int numEntity = m_group->getEntityCount();
 
+		// the matrices are inversed by batch of 4
+		const core::matrix4* in[4];
+		core::matrix4* out[4];
+		int numBatch = 0;
+
 		for (int i = 0; i < numEntity; i++)
 		{
 			CEntity* entity = entities[i];
@@ -72,9 +80,29 @@ namespace Skylicht
 
 			if (world->NeedValidate)
 			{
-				// Get inverse matrix of world
-				world->World.getInverse(worldInv->WorldInverse);
+				in[numBatch] = &world->World;
+				out[numBatch] = &worldInv->WorldInverse;
+
+				if (++numBatch == 4)
+				{
+					inverse(out, in, numBatch);
+					numBatch = 0;
+				}
 			}
 		}
+
+		if (numBatch > 0)
+			inverse(out, in, numBatch);
+	}
+
+	void CWorldInverseTransformSystem::inverse(core::matrix4** out, const core::matrix4** in, int count)
+	{
+		// world matrix is almost affine, so try the fast inverse
+		if (count == 4 && CMatrixSIMD::inverseAffine4(out, in))
+			return;
+
+		// Get inverse matrix of world
+		for (int i = 0; i < count; i++)
+			in[i]->getInverse(*out[i]);
 	}
 }
\ No newline at end of file
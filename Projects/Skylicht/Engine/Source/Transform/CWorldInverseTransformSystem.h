@@ -48,5 +48,9 @@ namespace Skylicht
 		virtual void init(CEntityManager* entityManager);
 
 		virtual void update(CEntityManager* entityManager);
+
+	protected:
+
+		void inverse(core::matrix4** out, const core::matrix4** in, int count);
 	};
 }
\ No newline at end of file
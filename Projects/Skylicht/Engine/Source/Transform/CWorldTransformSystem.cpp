@@ -28,12 +28,21 @@ https://github.com/skylicht-lab/skylicht-engine
 #include "Entity/CEntityManager.h"
 #include "Transform/CTransform.h"
 #include "Culling/CVisibleData.h"
+#include "Utils/CMatrixSIMD.h"
+#include "Job/CJobSystem.h"
+
+// the level has less transforms will update on the caller thread
+#define TRANSFORM_PARALLEL_MIN 512
+#define TRANSFORM_GRAIN_SIZE 128
 
 namespace Skylicht
 {
+	bool CWorldTransformSystem::s_parallelUpdate = true;
+
 	CWorldTransformSystem::CWorldTransformSystem() :
 		m_groupTransform(NULL)
 	{
+		writeData(CWorldTransformData::DataTypeIndex);
 	}
 
 	CWorldTransformSystem::~CWorldTransformSystem()
@@ -74,8 +83,33 @@ namespace Skylicht
 		}
 
 		transforms = m_groupTransform->getChilds();
-		numEntity = m_groupTransform->getNumChilds();
 
+		// the parents are on previous level, so update level by level
+		int* levels = m_groupTransform->getChildLevels();
+		int numLevel = m_groupTransform->getNumChildLevel();
+
+		SkylichtSystem::CJobSystem* jobSystem = SkylichtSystem::CJobSystem::getInstance();
+
+		for (int i = 0; i < numLevel; i++)
+		{
+			CWorldTransformData** levelTransforms = transforms + levels[i];
+			numEntity = levels[i + 1] - levels[i];
+
+			if (s_parallelUpdate && jobSystem != NULL && numEntity >= TRANSFORM_PARALLEL_MIN)
+			{
+				jobSystem->parallelFor(numEntity, TRANSFORM_GRAIN_SIZE, [&](int begin, int end) {
+					updateChilds(levelTransforms + begin, end - begin);
+					});
+			}
+			else
+			{
+				updateChilds(levelTransforms, numEntity);
+			}
+		}
+	}
+
+	void CWorldTransformSystem::updateChilds(CWorldTransformData** transforms, int numEntity)
+	{
 		for (int i = 0; i < numEntity; i++)
 		{
 			CWorldTransformData* t = transforms[i];
@@ -83,7 +117,7 @@ namespace Skylicht
 			// calc world = parent * relative
 			// - relative is copied from CTransformComponentSystem
 			// - relative is also defined in CEntityPrefab
-			t->World.setbyproduct_nocheck(t->Parent->World, t->Relative);
+			CMatrixSIMD::mul(t->World, t->Parent->World, t->Relative);
 		}
 	}
 }
\ No newline at end of file
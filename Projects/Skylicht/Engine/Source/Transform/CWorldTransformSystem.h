@@ -35,6 +35,8 @@ namespace Skylicht
 	protected:
 		CGroupTransform* m_groupTransform;
 
+		static bool s_parallelUpdate;
+
 	public:
 		CWorldTransformSystem();
 
@@ -47,5 +49,19 @@ namespace Skylicht
 		virtual void init(CEntityManager* entityManager);
 
 		virtual void update(CEntityManager* entityManager);
+
+		static void parallelUpdate(bool b)
+		{
+			s_parallelUpdate = b;
+		}
+
+		static bool parallelUpdate()
+		{
+			return s_parallelUpdate;
+		}
+
+	protected:
+
+		void updateChilds(CWorldTransformData** transforms, int numEntity);
 	};
 }
\ No newline at end of file
@@ -0,0 +1,127 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2023 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#include "pch.h"
+#include "CMatrixSIMD.h"
+
+namespace Skylicht
+{
+#if defined(USE_SIMD)
+	// load a column of 4 matrices, x y z are the column component of each matrix
+	static inline void loadColumn(const f32** m, int offset, SIMDVec& x, SIMDVec& y, SIMDVec& z)
+	{
+		SIMDVec w;
+		x = simdLoad(m[0] + offset);
+		y = simdLoad(m[1] + offset);
+		z = simdLoad(m[2] + offset);
+		w = simdLoad(m[3] + offset);
+		simdTranspose(x, y, z, w);
+	}
+
+	// store a column to 4 matrices
+	static inline void storeColumn(f32** m, int offset, SIMDVec x, SIMDVec y, SIMDVec z, SIMDVec w)
+	{
+		simdTranspose(x, y, z, w);
+		simdStore(m[0] + offset, x);
+		simdStore(m[1] + offset, y);
+		simdStore(m[2] + offset, z);
+		simdStore(m[3] + offset, w);
+	}
+#endif
+
+	bool CMatrixSIMD::inverseAffine4(core::matrix4** out, const core::matrix4** in)
+	{
+#if defined(USE_SIMD)
+		const f32* m[4];
+
+		for (int i = 0; i < 4; i++)
+		{
+			m[i] = in[i]->pointer();
+			if (m[i][3] != 0.0f || m[i][7] != 0.0f || m[i][11] != 0.0f || m[i][15] != 1.0f)
+				return false;
+		}
+
+		// each lane is a matrix
+		SIMDVec ax, ay, az, bx, by, bz, cx, cy, cz, tx, ty, tz;
+		loadColumn(m, 0, ax, ay, az);
+		loadColumn(m, 4, bx, by, bz);
+		loadColumn(m, 8, cx, cy, cz);
+		loadColumn(m, 12, tx, ty, tz);
+
+		// the rows of inverse 3x3 are the cross products of columns
+		SIMDVec r0x = simdSub(simdMul(by, cz), simdMul(bz, cy));
+		SIMDVec r0y = simdSub(simdMul(bz, cx), simdMul(bx, cz));
+		SIMDVec r0z = simdSub(simdMul(bx, cy), simdMul(by, cx));
+
+		SIMDVec r1x = simdSub(simdMul(cy, az), simdMul(cz, ay));
+		SIMDVec r1y = simdSub(simdMul(cz, ax), simdMul(cx, az));
+		SIMDVec r1z = simdSub(simdMul(cx, ay), simdMul(cy, ax));
+
+		SIMDVec r2x = simdSub(simdMul(ay, bz), simdMul(az, by));
+		SIMDVec r2y = simdSub(simdMul(az, bx), simdMul(ax, bz));
+		SIMDVec r2z = simdSub(simdMul(ax, by), simdMul(ay, bx));
+
+		SIMDVec det = simdAdd(simdAdd(simdMul(ax, r0x), simdMul(ay, r0y)), simdMul(az, r0z));
+
+		f32 d[4];
+		simdStore(d, det);
+		for (int i = 0; i < 4; i++)
+		{
+			if (core::iszero(d[i], FLT_MIN))
+				return false;
+		}
+
+		SIMDVec invDet = simdDiv(simdSet(1.0f), det);
+
+		r0x = simdMul(r0x, invDet);
+		r0y = simdMul(r0y, invDet);
+		r0z = simdMul(r0z, invDet);
+		r1x = simdMul(r1x, invDet);
+		r1y = simdMul(r1y, invDet);
+		r1z = simdMul(r1z, invDet);
+		r2x = simdMul(r2x, invDet);
+		r2y = simdMul(r2y, invDet);
+		r2z = simdMul(r2z, invDet);
+
+		// translation = -(inverse 3x3 * t)
+		SIMDVec zero = simdSet(0.0f);
+		SIMDVec itx = simdSub(zero, simdAdd(simdAdd(simdMul(r0x, tx), simdMul(r0y, ty)), simdMul(r0z, tz)));
+		SIMDVec ity = simdSub(zero, simdAdd(simdAdd(simdMul(r1x, tx), simdMul(r1y, ty)), simdMul(r1z, tz)));
+		SIMDVec itz = simdSub(zero, simdAdd(simdAdd(simdMul(r2x, tx), simdMul(r2y, ty)), simdMul(r2z, tz)));
+
+		f32* o[4];
+		for (int i = 0; i < 4; i++)
+			o[i] = out[i]->pointer();
+
+		storeColumn(o, 0, r0x, r1x, r2x, zero);
+		storeColumn(o, 4, r0y, r1y, r2y, zero);
+		storeColumn(o, 8, r0z, r1z, r2z, zero);
+		storeColumn(o, 12, itx, ity, itz, simdSet(1.0f));
+
+		return true;
+#else
+		return false;
+#endif
+	}
+}
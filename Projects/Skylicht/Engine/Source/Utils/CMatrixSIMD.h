@@ -0,0 +1,68 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2023 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#pragma once
+
+#include "CSIMD.h"
+
+namespace Skylicht
+{
+	/// Matrix functions use SSE (x86) or NEON (arm) instructions, scalar if the platform does not support.
+	/// The matrix is column major as irrlicht core::matrix4.
+	class CMatrixSIMD
+	{
+	public:
+		// out = a * b, same result as out.setbyproduct_nocheck(a, b)
+		// out must not be a or b
+		static inline void mul(core::matrix4& out, const core::matrix4& a, const core::matrix4& b)
+		{
+#if defined(USE_SIMD)
+			const f32* m1 = a.pointer();
+			const f32* m2 = b.pointer();
+			f32* m = out.pointer();
+
+			SIMDVec c0 = simdLoad(m1);
+			SIMDVec c1 = simdLoad(m1 + 4);
+			SIMDVec c2 = simdLoad(m1 + 8);
+			SIMDVec c3 = simdLoad(m1 + 12);
+
+			for (int i = 0; i < 16; i += 4)
+			{
+				SIMDVec r = simdMul(c0, simdSet(m2[i]));
+				r = simdAdd(r, simdMul(c1, simdSet(m2[i + 1])));
+				r = simdAdd(r, simdMul(c2, simdSet(m2[i + 2])));
+				r = simdAdd(r, simdMul(c3, simdSet(m2[i + 3])));
+				simdStore(m + i, r);
+			}
+#else
+			out.setbyproduct_nocheck(a, b);
+#endif
+		}
+
+		// inverse 4 affine matrices (the last row is 0, 0, 0, 1) at once
+		// return false if a matrix is not affine or not invertible, the out matrices are not changed
+		// out[i] must not be in[i]
+		static bool inverseAffine4(core::matrix4** out, const core::matrix4** in);
+	};
+}
@@ -0,0 +1,147 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2023 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#pragma once
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define USE_SIMD_SSE
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define USE_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+#if defined(USE_SIMD_SSE) || defined(USE_SIMD_NEON)
+#define USE_SIMD
+#endif
+
+namespace Skylicht
+{
+	// 4 floats SIMD functions, the mask of compare functions has all bits set on true lanes
+#if defined(USE_SIMD_SSE)
+	typedef __m128 SIMDVec;
+
+	static inline SIMDVec simdLoad(const f32* p) { return _mm_loadu_ps(p); }
+	static inline void simdStore(f32* p, SIMDVec v) { _mm_storeu_ps(p, v); }
+	static inline SIMDVec simdSet(f32 f) { return _mm_set1_ps(f); }
+	static inline SIMDVec simdAdd(SIMDVec a, SIMDVec b) { return _mm_add_ps(a, b); }
+	static inline SIMDVec simdSub(SIMDVec a, SIMDVec b) { return _mm_sub_ps(a, b); }
+	static inline SIMDVec simdMul(SIMDVec a, SIMDVec b) { return _mm_mul_ps(a, b); }
+	static inline SIMDVec simdDiv(SIMDVec a, SIMDVec b) { return _mm_div_ps(a, b); }
+	static inline SIMDVec simdSqrt(SIMDVec a) { return _mm_sqrt_ps(a); }
+	static inline SIMDVec simdAbs(SIMDVec a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+	static inline SIMDVec simdLess(SIMDVec a, SIMDVec b) { return _mm_cmplt_ps(a, b); }
+	static inline SIMDVec simdGreater(SIMDVec a, SIMDVec b) { return _mm_cmpgt_ps(a, b); }
+	static inline SIMDVec simdMin(SIMDVec a, SIMDVec b) { return _mm_min_ps(a, b); }
+	static inline SIMDVec simdMax(SIMDVec a, SIMDVec b) { return _mm_max_ps(a, b); }
+	static inline SIMDVec simdOr(SIMDVec a, SIMDVec b) { return _mm_or_ps(a, b); }
+	static inline SIMDVec simdAnd(SIMDVec a, SIMDVec b) { return _mm_and_ps(a, b); }
+
+	// (not a) and b
+	static inline SIMDVec simdAndNot(SIMDVec a, SIMDVec b) { return _mm_andnot_ps(a, b); }
+
+	// bit i is set if lane i of the mask is true
+	static inline int simdMoveMask(SIMDVec mask) { return _mm_movemask_ps(mask); }
+
+	static inline void simdTranspose(SIMDVec& r0, SIMDVec& r1, SIMDVec& r2, SIMDVec& r3)
+	{
+		_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+	}
+#elif defined(USE_SIMD_NEON)
+	typedef float32x4_t SIMDVec;
+
+	static inline SIMDVec simdLoad(const f32* p) { return vld1q_f32(p); }
+	static inline void simdStore(f32* p, SIMDVec v) { vst1q_f32(p, v); }
+	static inline SIMDVec simdSet(f32 f) { return vdupq_n_f32(f); }
+	static inline SIMDVec simdAdd(SIMDVec a, SIMDVec b) { return vaddq_f32(a, b); }
+	static inline SIMDVec simdSub(SIMDVec a, SIMDVec b) { return vsubq_f32(a, b); }
+	static inline SIMDVec simdMul(SIMDVec a, SIMDVec b) { return vmulq_f32(a, b); }
+	static inline SIMDVec simdAbs(SIMDVec a) { return vabsq_f32(a); }
+	static inline SIMDVec simdLess(SIMDVec a, SIMDVec b) { return vreinterpretq_f32_u32(vcltq_f32(a, b)); }
+	static inline SIMDVec simdGreater(SIMDVec a, SIMDVec b) { return vreinterpretq_f32_u32(vcgtq_f32(a, b)); }
+	static inline SIMDVec simdMin(SIMDVec a, SIMDVec b) { return vminq_f32(a, b); }
+	static inline SIMDVec simdMax(SIMDVec a, SIMDVec b) { return vmaxq_f32(a, b); }
+
+	static inline SIMDVec simdOr(SIMDVec a, SIMDVec b)
+	{
+		return vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b)));
+	}
+
+	static inline SIMDVec simdAnd(SIMDVec a, SIMDVec b)
+	{
+		return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b)));
+	}
+
+	// (not a) and b
+	static inline SIMDVec simdAndNot(SIMDVec a, SIMDVec b)
+	{
+		return vreinterpretq_f32_u32(vbicq_u32(vreinterpretq_u32_f32(b), vreinterpretq_u32_f32(a)));
+	}
+
+	static inline int simdMoveMask(SIMDVec mask)
+	{
+		uint32x4_t m = vreinterpretq_u32_f32(mask);
+		return (int)((vgetq_lane_u32(m, 0) >> 31) |
+			((vgetq_lane_u32(m, 1) >> 31) << 1) |
+			((vgetq_lane_u32(m, 2) >> 31) << 2) |
+			((vgetq_lane_u32(m, 3) >> 31) << 3));
+	}
+
+	static inline SIMDVec simdDiv(SIMDVec a, SIMDVec b)
+	{
+#if defined(__aarch64__)
+		return vdivq_f32(a, b);
+#else
+		// reciprocal estimate and 2 newton-raphson steps
+		SIMDVec r = vrecpeq_f32(b);
+		r = vmulq_f32(vrecpsq_f32(b, r), r);
+		r = vmulq_f32(vrecpsq_f32(b, r), r);
+		return vmulq_f32(a, r);
+#endif
+	}
+
+	// a > 0 on armv7
+	static inline SIMDVec simdSqrt(SIMDVec a)
+	{
+#if defined(__aarch64__)
+		return vsqrtq_f32(a);
+#else
+		SIMDVec r = vrsqrteq_f32(a);
+		r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, r), r), r);
+		r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, r), r), r);
+		return vmulq_f32(a, r);
+#endif
+	}
+
+	static inline void simdTranspose(SIMDVec& r0, SIMDVec& r1, SIMDVec& r2, SIMDVec& r3)
+	{
+		float32x4x2_t t01 = vtrnq_f32(r0, r1);
+		float32x4x2_t t23 = vtrnq_f32(r2, r3);
+		r0 = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+		r1 = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+		r2 = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+		r3 = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+	}
+#endif
+}
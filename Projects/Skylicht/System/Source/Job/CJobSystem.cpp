@@ -0,0 +1,348 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2023 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#include "stdafx.h"
+#include "CJobSystem.h"
+
+#include <deque>
+
+namespace SkylichtSystem
+{
+	struct SJobQueue
+	{
+		std::mutex Mutex;
+		std::deque<SJob*> Jobs;
+	};
+
+	// the queue index of current thread, 0 is the caller (main) thread
+	static thread_local int s_threadIndex = 0;
+
+	CJobSystem* CJobSystem::s_instance = NULL;
+
+	CJobSystem::CJobSystem(int numWorkers) :
+		m_numWorkers(numWorkers),
+		m_backend(Worker),
+		m_pendingJobs(0),
+		m_quit(false),
+		m_nextQueue(0)
+	{
+#ifndef USE_JOB_THREAD
+		// no thread support, the jobs run on caller thread
+		m_numWorkers = 0;
+#endif
+
+		if (m_numWorkers < 0)
+			m_numWorkers = 0;
+
+		int numQueue = m_numWorkers + 1;
+		m_queues = new SJobQueue * [numQueue];
+		for (int i = 0; i < numQueue; i++)
+			m_queues[i] = new SJobQueue();
+
+#ifdef USE_JOB_THREAD
+		for (int i = 1; i <= m_numWorkers; i++)
+			m_workers.push_back(new std::thread(&CJobSystem::workerLoop, this, i));
+#endif
+	}
+
+	CJobSystem::~CJobSystem()
+	{
+#ifdef USE_JOB_THREAD
+		{
+			std::lock_guard<std::mutex> lock(m_wakeMutex);
+			m_quit = true;
+		}
+		m_wakeCondition.notify_all();
+
+		for (std::thread* t : m_workers)
+		{
+			t->join();
+			delete t;
+		}
+		m_workers.clear();
+#endif
+
+		for (int i = 0; i <= m_numWorkers; i++)
+		{
+			for (SJob* job : m_queues[i]->Jobs)
+				delete job;
+			delete m_queues[i];
+		}
+		delete[] m_queues;
+
+		if (s_instance == this)
+			s_instance = NULL;
+	}
+
+	CJobSystem* CJobSystem::createGetInstance()
+	{
+		if (s_instance == NULL)
+			s_instance = new CJobSystem(getDefaultNumWorkers());
+		return s_instance;
+	}
+
+	CJobSystem* CJobSystem::getInstance()
+	{
+		return s_instance;
+	}
+
+	void CJobSystem::releaseInstance()
+	{
+		if (s_instance != NULL)
+		{
+			delete s_instance;
+			s_instance = NULL;
+		}
+	}
+
+	int CJobSystem::getDefaultNumWorkers()
+	{
+#ifdef USE_JOB_THREAD
+		// keep 1 core for the caller thread
+		int numWorkers = (int)std::thread::hardware_concurrency() - 1;
+		return numWorkers > 0 ? numWorkers : 0;
+#else
+		return 0;
+#endif
+	}
+
+	void CJobSystem::runParallelFor(int count, int grainSize, const JobRangeFunction& func)
+	{
+		if (s_instance != NULL)
+			s_instance->parallelFor(count, grainSize, func);
+		else if (count > 0)
+			func(0, count);
+	}
+
+	void CJobSystem::run(const JobFunction& func, CJobCounter* counter, CJobCounter* dependency)
+	{
+		if (counter != NULL)
+			counter->m_value++;
+
+		SJob* job = new SJob();
+		job->Function = func;
+		job->Counter = counter;
+
+		if (dependency != NULL)
+		{
+			std::lock_guard<std::mutex> lock(dependency->m_mutex);
+			if (dependency->m_value.load() > 0)
+			{
+				// it will be scheduled when the dependency is done
+				dependency->m_waitJobs.push_back(job);
+				return;
+			}
+		}
+
+		schedule(job);
+	}
+
+	void CJobSystem::schedule(SJob* job)
+	{
+		if (m_numWorkers == 0)
+		{
+			execute(job);
+			return;
+		}
+
+		// the worker pushes on its own queue, the other threads spread jobs to the workers
+		int queueIndex = s_threadIndex;
+		if (queueIndex == 0)
+			queueIndex = 1 + (int)(m_nextQueue++ % (unsigned int)m_numWorkers);
+
+		SJobQueue* queue = m_queues[queueIndex];
+		{
+			std::lock_guard<std::mutex> lock(queue->Mutex);
+			queue->Jobs.push_back(job);
+		}
+
+		m_pendingJobs++;
+
+#ifdef USE_JOB_THREAD
+		{
+			std::lock_guard<std::mutex> lock(m_wakeMutex);
+		}
+		m_wakeCondition.notify_one();
+#endif
+	}
+
+	SJob* CJobSystem::popJob(int threadIndex)
+	{
+		SJob* job = NULL;
+		int numQueue = m_numWorkers + 1;
+
+		// pop the last job on own queue
+		{
+			SJobQueue* queue = m_queues[threadIndex];
+			std::lock_guard<std::mutex> lock(queue->Mutex);
+			if (!queue->Jobs.empty())
+			{
+				job = queue->Jobs.back();
+				queue->Jobs.pop_back();
+			}
+		}
+
+		// steal the first job of other queues
+		for (int i = 1; i < numQueue && job == NULL; i++)
+		{
+			SJobQueue* queue = m_queues[(threadIndex + i) % numQueue];
+			std::lock_guard<std::mutex> lock(queue->Mutex);
+			if (!queue->Jobs.empty())
+			{
+				job = queue->Jobs.front();
+				queue->Jobs.pop_front();
+			}
+		}
+
+		if (job != NULL)
+			m_pendingJobs--;
+
+		return job;
+	}
+
+	void CJobSystem::execute(SJob* job)
+	{
+		job->Function();
+
+		CJobCounter* counter = job->Counter;
+		delete job;
+
+		if (counter == NULL)
+			return;
+
+		std::vector<SJob*> waitJobs;
+		{
+			// decrease in the lock, so wait() can not release the counter while it is used here
+			std::lock_guard<std::mutex> lock(counter->m_mutex);
+			if (--counter->m_value == 0)
+				waitJobs.swap(counter->m_waitJobs);
+		}
+
+		for (SJob* waitJob : waitJobs)
+			schedule(waitJob);
+	}
+
+	bool CJobSystem::runPendingJob()
+	{
+		if (m_numWorkers == 0)
+			return false;
+
+		SJob* job = popJob(s_threadIndex);
+		if (job == NULL)
+			return false;
+
+		execute(job);
+		return true;
+	}
+
+	void CJobSystem::wait(CJobCounter* counter)
+	{
+		if (counter == NULL)
+			return;
+
+		while (!counter->isDone())
+		{
+			// help the workers while waiting
+			if (!runPendingJob())
+			{
+#ifdef USE_JOB_THREAD
+				std::this_thread::yield();
+#endif
+			}
+		}
+
+		// sync with the thread that finished the last job
+		std::lock_guard<std::mutex> lock(counter->m_mutex);
+	}
+
+	void CJobSystem::parallelFor(int count, int grainSize, const JobRangeFunction& func)
+	{
+		if (count <= 0)
+			return;
+
+		if (grainSize < 1)
+			grainSize = 1;
+
+		int numRange = (count + grainSize - 1) / grainSize;
+
+#ifdef USE_OPENMP
+		if (m_backend == OpenMP)
+		{
+#pragma omp parallel for
+			for (int i = 0; i < numRange; i++)
+			{
+				int begin = i * grainSize;
+				int end = begin + grainSize < count ? begin + grainSize : count;
+				func(begin, end);
+			}
+			return;
+		}
+#endif
+
+		if (numRange == 1 || m_numWorkers == 0)
+		{
+			func(0, count);
+			return;
+		}
+
+		CJobCounter counter;
+
+		for (int i = 1; i < numRange; i++)
+		{
+			int begin = i * grainSize;
+			int end = begin + grainSize < count ? begin + grainSize : count;
+
+			run([&func, begin, end]() {
+				func(begin, end);
+				}, &counter);
+		}
+
+		// the caller thread runs the first range
+		func(0, grainSize);
+
+		wait(&counter);
+	}
+
+	void CJobSystem::workerLoop(int threadIndex)
+	{
+		s_threadIndex = threadIndex;
+
+#ifdef USE_JOB_THREAD
+		while (!m_quit.load())
+		{
+			SJob* job = popJob(threadIndex);
+			if (job != NULL)
+			{
+				execute(job);
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(m_wakeMutex);
+			m_wakeCondition.wait(lock, [this]() {
+				return m_quit.load() || m_pendingJobs.load() > 0;
+				});
+		}
+#endif
+	}
+}
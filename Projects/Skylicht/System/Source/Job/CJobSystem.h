@@ -0,0 +1,147 @@
+/*
+!@
+MIT License
+
+Copyright (c) 2023 Skylicht Technology CO., LTD
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files
+(the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify,
+merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+This file is part of the "Skylicht Engine".
+https://github.com/skylicht-lab/skylicht-engine
+!#
+*/
+
+#pragma once
+
+#include "SkylichtSystemConfig.h"
+#include "CJobCounter.h"
+
+#include <functional>
+
+#if defined(USE_PTHREAD) || defined(USE_STDTHREAD)
+#define USE_JOB_THREAD
+#include <thread>
+#include <condition_variable>
+#endif
+
+namespace SkylichtSystem
+{
+	typedef std::function<void()> JobFunction;
+
+	typedef std::function<void(int begin, int end)> JobRangeFunction;
+
+	struct SJobQueue;
+
+	struct SJob
+	{
+		JobFunction Function;
+		CJobCounter* Counter;
+	};
+
+	/// Work stealing job system.
+	/// Each worker has a job deque, it pops its own jobs at back and steals the others at front.
+	/// The caller thread (main thread) also executes the jobs while it waits a counter.
+	class CJobSystem
+	{
+	public:
+		enum EBackend
+		{
+			Worker = 0,
+			OpenMP
+		};
+
+	protected:
+		static CJobSystem* s_instance;
+
+		int m_numWorkers;
+
+		EBackend m_backend;
+
+		SJobQueue** m_queues;
+
+		std::atomic<int> m_pendingJobs;
+
+		std::atomic<bool> m_quit;
+
+		std::atomic<unsigned int> m_nextQueue;
+
+#ifdef USE_JOB_THREAD
+		std::vector<std::thread*> m_workers;
+
+		std::mutex m_wakeMutex;
+
+		std::condition_variable m_wakeCondition;
+#endif
+
+	public:
+		CJobSystem(int numWorkers);
+
+		virtual ~CJobSystem();
+
+		static CJobSystem* createGetInstance();
+
+		static CJobSystem* getInstance();
+
+		static void releaseInstance();
+
+		static int getDefaultNumWorkers();
+
+		// parallelFor on the shared job system, the ranges run on the caller thread if it is not created
+		static void runParallelFor(int count, int grainSize, const JobRangeFunction& func);
+
+		inline int getNumWorkers()
+		{
+			return m_numWorkers;
+		}
+
+		// number of threads run the jobs (workers and the caller thread)
+		inline int getNumThreads()
+		{
+			return m_numWorkers + 1;
+		}
+
+		inline void setBackend(EBackend backend)
+		{
+			m_backend = backend;
+		}
+
+		inline EBackend getBackend()
+		{
+			return m_backend;
+		}
+
+		// submit a job, the counter is increased and decreased when the job is done
+		// the job will be scheduled after the dependency counter is zero
+		void run(const JobFunction& func, CJobCounter* counter = NULL, CJobCounter* dependency = NULL);
+
+		// wait the counter, the caller thread also runs the jobs while waiting
+		void wait(CJobCounter* counter);
+
+		// split [0, count) to the ranges of grainSize and run them parallel, it returns when all ranges are done
+		void parallelFor(int count, int grainSize, const JobRangeFunction& func);
+
+		// run a pending job on the caller thread
+		bool runPendingJob();
+
+	protected:
+
+		void schedule(SJob* job);
+
+		SJob* popJob(int threadIndex);
+
+		void execute(SJob* job);
+
+		void workerLoop(int threadIndex);
+	};
+}
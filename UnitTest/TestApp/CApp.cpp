@@ -1,9 +1,29 @@
 #include "CApp.h"
 #include "TestCoreUtils.h"
 #include "TestSystemThread.h"
+#include "TestJobSystem.h"
 #include "TestScene.h"
 #include "TestMemoryStream.h"
 #include "TestSpreadsheet.h"
+#include "TestEntityStorage.h"
+#include "TestSystemScheduler.h"
+#include "TestEntityGroup.h"
+#include "TestCullingBVH.h"
+#include "TestCullingSystem.h"
+#include "TestShadowMap.h"
+#include "TestOcclusionBuffer.h"
+#include "TestRenderQueue.h"
+#include "TestRenderStateCache.h"
+#include "TestRenderCommandBuffer.h"
+#include "TestMaterialParams.h"
+#include "TestStaticMeshBatching.h"
+#include "TestMeshInstancing.h"
+#include "TestLightCluster.h"
+#include "TestFrameGraph.h"
+#include "TestAnimationCompression.h"
+#include "TestPoseSampler.h"
+#include "TestBlendTree.h"
+#include "TestAnimationLOD.h"
 
 #include "CApplication.h"
 #include "Material/Shader/CShaderManager.h"
@@ -54,9 +74,49 @@ void CApp::onInitApp()
 
 	testSystemThread();
 
+	testJobSystem();
+
 	testScene();
 
 	testSpreadsheet();
+
+	testEntityStorage();
+
+	testSystemScheduler();
+
+	testEntityGroup();
+
+	testCullingBVH();
+
+	testCullingSystem();
+
+	testShadowMap();
+
+	testOcclusionBuffer();
+
+	testRenderQueue();
+
+	testRenderStateCache();
+
+	testRenderCommandBuffer();
+
+	testMaterialParams();
+
+	testStaticMeshBatching();
+
+	testMeshInstancing();
+
+	testLightCluster();
+
+	testFrameGraph();
+
+	testAnimationCompression();
+
+	testPoseSampler();
+
+	testBlendTree();
+
+	testAnimationLOD();
 }
 
 void CApp::onUpdate()
@@ -0,0 +1,168 @@
+#include "pch.h"
+#include "Base.hh"
+#include "TestAnimationCompression.h"
+
+#include "Animation/CAnimationCompressor.h"
+
+using namespace Skylicht;
+
+static f32 getRotationAngle(core::quaternion a, core::quaternion b)
+{
+	a.normalize();
+	b.normalize();
+
+	// q & -q are the same rotation
+	f32 d1 = core::vector3df(a.X - b.X, a.Y - b.Y, a.Z - b.Z).getLengthSQ() + (a.W - b.W) * (a.W - b.W);
+	f32 d2 = core::vector3df(a.X + b.X, a.Y + b.Y, a.Z + b.Z).getLengthSQ() + (a.W + b.W) * (a.W + b.W);
+	f32 d = sqrtf(core::min_(d1, d2));
+
+	return 4.0f * asinf(core::min_(d * 0.5f, 1.0f));
+}
+
+static void testCompressionError()
+{
+	TEST_CASE("Animation compression quantization error");
+
+	CAnimationClip clip;
+
+	SEntityAnim* anim = new SEntityAnim();
+	anim->Name = "bone";
+
+	CAnimationData& data = anim->Data;
+
+	// the long track with the large range, the quantization step of values & frames is not small
+	const int numKey = 3000;
+	for (int i = 0; i <= numKey; i++)
+	{
+		f32 frame = (f32)i;
+
+		CPositionKey pos;
+		pos.Frame = frame;
+		pos.Value.set(100.0f + 100.0f * sinf(frame * 0.005f), 0.0f, 0.0f);
+		data.Positions.Data.push_back(pos);
+
+		CRotationKey rot;
+		rot.Frame = frame;
+		rot.Value.fromAngleAxis(1.5f * sinf(frame * 0.005f), core::vector3df(0.0f, 1.0f, 0.0f));
+		data.Rotations.Data.push_back(rot);
+	}
+
+	data.Scales.Default.set(1.0f, 1.0f, 1.0f);
+
+	clip.addAnim(anim);
+
+	CAnimationData source = data;
+
+	const f32 positionError = 0.05f;
+	const f32 rotationError = 0.02f;
+
+	CAnimationCompressor compressor;
+	compressor.setPositionError(positionError);
+	compressor.setRotationError(rotationError);
+	compressor.compressClip(&clip);
+
+	TEST_ASSERT_THROW(data.QuantizedPositions.size() < numKey / 10);
+	TEST_ASSERT_THROW(data.QuantizedRotations.size() < numKey / 10);
+
+	CAnimationTrack sourceTrack;
+	sourceTrack.setAnimationData(&source);
+
+	CAnimationTrack track;
+	track.setAnimationData(&data);
+
+	// the worst case of the decoded keys, on the source keys & between them
+	f32 maxPositionError = 0.0f;
+	f32 maxRotationError = 0.0f;
+
+	for (f32 frame = 0.0f; frame <= (f32)numKey; frame += 0.5f)
+	{
+		core::vector3df p1, s1, p2, s2;
+		core::quaternion r1, r2;
+
+		sourceTrack.getFrameData(frame, p1, s1, r1);
+		track.getFrameData(frame, p2, s2, r2);
+
+		maxPositionError = core::max_(maxPositionError, p1.getDistanceFrom(p2));
+		maxRotationError = core::max_(maxRotationError, getRotationAngle(r1, r2));
+	}
+
+	TEST_ASSERT_THROW(maxPositionError <= positionError);
+	TEST_ASSERT_THROW(maxRotationError <= rotationError);
+}
+
+void testAnimationCompression()
+{
+	TEST_CASE("Animation compression");
+
+	CAnimationClip clip;
+
+	SEntityAnim* anim = new SEntityAnim();
+	anim->Name = "bone";
+
+	CAnimationData& data = anim->Data;
+
+	for (int i = 0; i <= 30; i++)
+	{
+		f32 frame = (f32)i;
+
+		// linear move, the middle keys are removed
+		CPositionKey pos;
+		pos.Frame = frame;
+		pos.Value.set(frame * 0.1f, 1.0f, -2.0f);
+		data.Positions.Data.push_back(pos);
+
+		// rotate around Y
+		CRotationKey rot;
+		rot.Frame = frame;
+		rot.Value.fromAngleAxis(sinf(frame * 0.2f), core::vector3df(0.0f, 1.0f, 0.0f));
+		data.Rotations.Data.push_back(rot);
+
+		// constant
+		CScaleKey scale;
+		scale.Frame = frame;
+		scale.Value.set(1.0f, 1.0f, 1.0f);
+		data.Scales.Data.push_back(scale);
+	}
+
+	clip.addAnim(anim);
+
+	// the float track for compare
+	CAnimationData source = data;
+
+	u32 memory = CAnimationCompressor::getKeyMemory(&clip);
+
+	CAnimationCompressor compressor;
+	compressor.setRotationError(0.02f);
+	compressor.compressClip(&clip);
+
+	TEST_ASSERT_THROW(data.Compressed == true);
+	TEST_ASSERT_THROW(data.QuantizedPositions.size() == 2);
+	TEST_ASSERT_THROW(data.QuantizedScales.size() == 1);
+	TEST_ASSERT_THROW(data.QuantizedRotations.size() < 31);
+	TEST_ASSERT_THROW(CAnimationCompressor::getKeyMemory(&clip) * 4 < memory);
+	TEST_ASSERT_FLOAT_EQUAL(data.getLastFrame(), 30.0f);
+
+	CAnimationTrack sourceTrack;
+	sourceTrack.setAnimationData(&source);
+
+	CAnimationTrack track;
+	track.setAnimationData(&data);
+
+	for (f32 frame = 0.0f; frame <= 32.0f; frame += 0.75f)
+	{
+		core::vector3df p1, s1, p2, s2;
+		core::quaternion r1, r2;
+
+		sourceTrack.getFrameData(frame, p1, s1, r1);
+		track.getFrameData(frame, p2, s2, r2);
+
+		TEST_ASSERT_THROW(p1.getDistanceFrom(p2) < 0.002f);
+		TEST_ASSERT_THROW(s1.getDistanceFrom(s2) < 0.002f);
+
+		r1.normalize();
+		r2.normalize();
+		TEST_ASSERT_THROW(fabsf(r1.dotProduct(r2)) > cosf(0.015f));
+	}
+
+	testCompressionError();
+}
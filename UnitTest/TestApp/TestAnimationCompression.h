@@ -0,0 +1,3 @@
+#pragma once
+
+void testAnimationCompression();
\ No newline at end of file
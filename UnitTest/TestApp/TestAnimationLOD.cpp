@@ -0,0 +1,304 @@
+#include "pch.h"
+#include "Base.hh"
+#include "TestAnimationLOD.h"
+
+#include "Scene/CScene.h"
+#include "Animation/CAnimationController.h"
+#include "Entity/CEntityManager.h"
+#include "Transform/CWorldTransformData.h"
+#include "Transform/CWorldInverseTransformData.h"
+#include "RenderMesh/CJointData.h"
+#include "RenderMesh/CRenderMeshData.h"
+#include "RenderMesh/CSkinnedMesh.h"
+#include "RenderMesh/CRenderMesh.h"
+#include "Entity/CEntityPrefab.h"
+
+using namespace Skylicht;
+
+class CTestAnimationController : public CAnimationController
+{
+public:
+	void addCulling(CCullingData* culling)
+	{
+		m_cullings.push_back(culling);
+	}
+
+	void setFrameCount(u32 frame)
+	{
+		m_frameCount = frame;
+	}
+
+	core::array<CCullingData*>& getCullings()
+	{
+		return m_cullings;
+	}
+};
+
+static void setCullingDistance(CCullingData& culling, f32 distance)
+{
+	culling.BBox.MinEdge.set(-1.0f, -1.0f, distance - 1.0f);
+	culling.BBox.MaxEdge.set(1.0f, 1.0f, distance + 1.0f);
+}
+
+static CEntity* createTestBone(CEntityManager* entityMgr, CEntity* parent, const char* name, const core::vector3df& position)
+{
+	CEntity* entity = entityMgr->createEntity();
+
+	CWorldTransformData* transform = entity->addData<CWorldTransformData>();
+	transform->Name = name;
+	transform->Relative.setTranslation(position);
+
+	if (parent != NULL)
+	{
+		CWorldTransformData* parentTransform = GET_ENTITY_DATA(parent, CWorldTransformData);
+		transform->ParentIndex = parent->getIndex();
+		transform->Depth = parentTransform->Depth + 1;
+	}
+
+	return entity;
+}
+
+static f32 getBoneX(core::array<CEntity*>& bones, int i)
+{
+	return GET_ENTITY_DATA(bones[i], CWorldTransformData)->Relative.getTranslation().X;
+}
+
+static void testCullingRefresh(CZone* zone)
+{
+	TEST_CASE("Animation LOD reload render mesh");
+
+	CEntityPrefab prefab;
+	CEntity* entity = prefab.createEntity();
+	entity->addData<CWorldTransformData>();
+	entity->addData<CCullingData>();
+
+	CGameObject* object = zone->createEmptyObject();
+	CRenderMesh* renderMesh = object->addComponent<CRenderMesh>();
+	renderMesh->initFromPrefab(&prefab);
+
+	CTestAnimationController* controller = object->addComponent<CTestAnimationController>();
+	controller->createSkeleton();
+
+	TEST_ASSERT_THROW(controller->getCullings().size() == 1);
+	TEST_ASSERT_THROW(controller->getCullings()[0] == GET_ENTITY_DATA(renderMesh->getEntities()[0], CCullingData));
+
+	// the entities are released & spawned again
+	renderMesh->initFromPrefab(&prefab);
+	controller->updateComponent();
+
+	TEST_ASSERT_THROW(controller->getCullings().size() == 1);
+	TEST_ASSERT_THROW(controller->getCullings()[0] == GET_ENTITY_DATA(renderMesh->getEntities()[0], CCullingData));
+}
+
+static void testJointSkinning()
+{
+	// the joints skip the matrices that are not changed, with or without the animation LOD
+	TEST_CASE("Joint skinning matrix");
+	TEST_ASSERT_THROW(!CAnimationController::isEnableLOD());
+
+	CEntityManager* entityMgr = new CEntityManager();
+
+	// the joint RootIndex 0 is not a root
+	CEntity* dummy = entityMgr->createEntity();
+	dummy->addData<CWorldTransformData>();
+
+	CEntity* root = entityMgr->createEntity();
+	root->addData<CWorldTransformData>();
+	root->addData<CWorldInverseTransformData>();
+
+	CEntity* joints[2];
+	for (int i = 0; i < 2; i++)
+	{
+		joints[i] = entityMgr->createEntity();
+
+		CWorldTransformData* transform = joints[i]->addData<CWorldTransformData>();
+		transform->ParentIndex = root->getIndex();
+		transform->Depth = 1;
+		transform->Relative.setTranslation(core::vector3df((f32)i, 1.0f, 0.0f));
+
+		CJointData* joint = joints[i]->addData<CJointData>();
+		joint->RootIndex = root->getIndex();
+	}
+
+	CSkinnedMesh* skinnedMesh = new CSkinnedMesh();
+
+	CEntity* meshEntity = entityMgr->createEntity();
+	meshEntity->addData<CWorldTransformData>();
+
+	CRenderMeshData* renderMesh = meshEntity->addData<CRenderMeshData>();
+	renderMesh->setMesh(skinnedMesh);
+	renderMesh->setSkinnedMesh(true);
+	skinnedMesh->drop();
+
+	skinnedMesh = (CSkinnedMesh*)renderMesh->getMesh();
+	skinnedMesh->SkinningMatrix = new f32[16 * GPU_BONES_COUNT];
+	for (int i = 0; i < 2; i++)
+	{
+		CSkinnedMesh::SJoint joint;
+		joint.JointData = GET_ENTITY_DATA(joints[i], CJointData);
+		joint.EntityIndex = joints[i]->getIndex();
+		joint.SkinningMatrix = skinnedMesh->SkinningMatrix + i * 16;
+		skinnedMesh->Joints.push_back(joint);
+	}
+
+	entityMgr->update();
+
+	f32* m0 = skinnedMesh->Joints[0].SkinningMatrix;
+	f32* m1 = skinnedMesh->Joints[1].SkinningMatrix;
+	TEST_ASSERT_FLOAT_EQUAL(m0[12], 0.0f);
+	TEST_ASSERT_FLOAT_EQUAL(m1[12], 1.0f);
+
+	// just move the first joint, the skinning matrix of the other joint is not updated
+	m0[12] = 100.0f;
+	m1[12] = 100.0f;
+
+	CWorldTransformData* transform = GET_ENTITY_DATA(joints[0], CWorldTransformData);
+	transform->Relative.setTranslation(core::vector3df(0.0f, 2.0f, 0.0f));
+	transform->HasChanged = true;
+	entityMgr->update();
+
+	TEST_ASSERT_THROW(GET_ENTITY_DATA(joints[0], CJointData)->Changed);
+	TEST_ASSERT_THROW(!GET_ENTITY_DATA(joints[1], CJointData)->Changed);
+	TEST_ASSERT_FLOAT_EQUAL(m0[12], 0.0f);
+	TEST_ASSERT_FLOAT_EQUAL(m0[13], 2.0f);
+	TEST_ASSERT_FLOAT_EQUAL(m1[12], 100.0f);
+
+	delete entityMgr;
+}
+
+void testAnimationLOD()
+{
+	CAnimationController::enableLOD(true);
+
+	CScene* scene = new CScene();
+	CZone* zone = scene->createZone();
+
+	CCamera* camera = zone->createEmptyObject()->addComponent<CCamera>();
+	camera->lookAt(core::vector3df(0.0f, 0.0f, 0.0f), core::vector3df(0.0f, 0.0f, 1.0f), core::vector3df(0.0f, 1.0f, 0.0f));
+	zone->getEntityManager()->setCamera(camera);
+
+	CTestAnimationController* controller = zone->createEmptyObject()->addComponent<CTestAnimationController>();
+
+	CCullingData culling;
+	culling.Visible = true;
+	controller->addCulling(&culling);
+
+	TEST_CASE("Animation LOD band");
+	controller->addLOD(0.05f, 8, 0);
+	controller->addLOD(0.5f, 2);
+	controller->addLOD(0.2f, 4, 1);
+
+	// the screen size is 0.6, 0.3, 0.1, 0.03 (the radius of bbox is 1.73 & fov is 60)
+	const f32 distance[] = { 5.0f, 10.0f, 30.0f, 100.0f };
+	for (int i = 0; i < 4; i++)
+	{
+		setCullingDistance(culling, distance[i]);
+		controller->updateComponent();
+		TEST_ASSERT_THROW(controller->getLOD() == i - 1);
+		TEST_ASSERT_THROW(!controller->isCulled());
+	}
+
+	TEST_CASE("Animation LOD culled");
+	culling.Visible = false;
+	culling.ViewMask = 0;
+	controller->updateComponent();
+	TEST_ASSERT_THROW(controller->isCulled());
+
+	// visible on a shadow view
+	culling.ViewMask = 2;
+	controller->updateComponent();
+	TEST_ASSERT_THROW(!controller->isCulled());
+
+	// the skeleton: root > spine > hand, the clip moves the bone i by (i + 1) * frame on x
+	CEntityManager* boneMgr = new CEntityManager();
+	core::array<CEntity*> bones;
+
+	const char* boneNames[] = { "root", "spine", "hand" };
+	CEntity* parent = NULL;
+	for (int i = 0; i < 3; i++)
+	{
+		parent = createTestBone(boneMgr, parent, boneNames[i], core::vector3df(0.0f, i == 0 ? 0.0f : 1.0f, 0.0f));
+		bones.push_back(parent);
+	}
+
+	CAnimationClip clip;
+	for (int t = 0; t < 3; t++)
+	{
+		SEntityAnim* anim = new SEntityAnim();
+		anim->Name = boneNames[t];
+
+		for (int i = 0; i <= 10; i++)
+		{
+			CPositionKey pos;
+			pos.Frame = (f32)i;
+			pos.Value.set((f32)(i * (t + 1)), 1.0f, 0.0f);
+			anim->Data.Positions.Data.push_back(pos);
+		}
+
+		anim->Data.Scales.Default.set(1.0f, 1.0f, 1.0f);
+		clip.addAnim(anim);
+	}
+
+	CSkeleton* skeleton = controller->createSkeleton();
+	skeleton->initSkeleton(bones);
+	skeleton->setAnimation(&clip, true, true);
+
+	TEST_CASE("Animation LOD culled root update");
+	culling.ViewMask = 0;
+	skeleton->getTimeline().Frame = 5.0f;
+	controller->updateComponent();
+
+	TEST_ASSERT_FLOAT_EQUAL(getBoneX(bones, 0), 5.0f);
+	TEST_ASSERT_FLOAT_EQUAL(getBoneX(bones, 1), 0.0f);
+	TEST_ASSERT_FLOAT_EQUAL(getBoneX(bones, 2), 0.0f);
+
+	TEST_CASE("Animation LOD culled root motion bone");
+	// the bone & its parents are updated
+	skeleton->setRootMotionBone("spine");
+	skeleton->getTimeline().Frame = 6.0f;
+	controller->updateComponent();
+
+	TEST_ASSERT_FLOAT_EQUAL(getBoneX(bones, 0), 6.0f);
+	TEST_ASSERT_FLOAT_EQUAL(getBoneX(bones, 1), 12.0f);
+	TEST_ASSERT_FLOAT_EQUAL(getBoneX(bones, 2), 0.0f);
+
+	// the first animated bone
+	skeleton->setRootMotionBone(NULL);
+
+	TEST_CASE("Animation LOD interpolate");
+	culling.Visible = true;
+	setCullingDistance(culling, 10.0f);
+
+	controller->clearLOD();
+	controller->addLOD(1.0f, 4, -1, true);
+	controller->setFrameCount(0);
+
+	skeleton->getTimeline().Frame = 4.0f;
+	for (int i = 0; i < 4; i++)
+		controller->updateComponent();
+
+	TEST_ASSERT_THROW(controller->getLOD() == 0);
+	TEST_ASSERT_FLOAT_EQUAL(getBoneX(bones, 0), 4.0f);
+	TEST_ASSERT_FLOAT_EQUAL(getBoneX(bones, 2), 12.0f);
+
+	// evaluated once, the frames between are blended from the last pose by 1/4, 2/4, 3/4, 4/4
+	skeleton->getTimeline().Frame = 8.0f;
+	for (int i = 1; i <= 4; i++)
+	{
+		controller->updateComponent();
+
+		f32 rootX = 4.0f + (f32)i;
+		f32 handX = 12.0f + (f32)i * 3.0f;
+		TEST_ASSERT_FLOAT_EQUAL(getBoneX(bones, 0), rootX);
+		TEST_ASSERT_FLOAT_EQUAL(getBoneX(bones, 2), handX);
+	}
+
+	testCullingRefresh(zone);
+
+	delete scene;
+	delete boneMgr;
+
+	CAnimationController::enableLOD(false);
+
+	testJointSkinning();
+}
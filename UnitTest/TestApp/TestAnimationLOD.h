@@ -0,0 +1,3 @@
+#pragma once
+
+void testAnimationLOD();
\ No newline at end of file
@@ -0,0 +1,195 @@
+#include "pch.h"
+#include "Base.hh"
+#include "TestBlendTree.h"
+
+#include "Entity/CEntityPrefab.h"
+#include "Animation/Skeleton/CSkeleton.h"
+#include "Animation/BlendTree/CBlendTree.h"
+#include "Animation/BlendTree/CBlendClipNode.h"
+#include "Animation/BlendTree/CBlendSpaceNode.h"
+#include "Animation/BlendTree/CBlendLayerNode.h"
+#include "Animation/BlendTree/CBlendCrossfadeNode.h"
+#include "Skylicht.h"
+
+using namespace Skylicht;
+
+// hip moves on x from 0 to 10 * speed, spine rotates on y by angle
+static void addClipAnim(CAnimationClip& clip, f32 speed, f32 angle)
+{
+	SEntityAnim* hip = new SEntityAnim();
+	hip->Name = "hip";
+
+	for (int i = 0; i <= 10; i += 10)
+	{
+		CPositionKey pos;
+		pos.Frame = (f32)i;
+		pos.Value.set(i * speed, 0.0f, 0.0f);
+		hip->Data.Positions.Data.push_back(pos);
+	}
+	clip.addAnim(hip);
+
+	SEntityAnim* spine = new SEntityAnim();
+	spine->Name = "spine";
+
+	CRotationKey rot;
+	rot.Frame = 0.0f;
+	rot.Value.fromAngleAxis(angle, core::vector3df(0.0f, 1.0f, 0.0f));
+	spine->Data.Rotations.Data.push_back(rot);
+	clip.addAnim(spine);
+}
+
+static core::vector3df getPosition(CSkeleton& skeleton, int bone)
+{
+	return skeleton.getEntitiesData()[bone]->AnimPosition;
+}
+
+void testBlendTree()
+{
+	TEST_CASE("Blend tree");
+
+	CEntityPrefab prefab;
+
+	core::matrix4 armMatrix;
+	armMatrix.setTranslation(core::vector3df(0.0f, 1.0f, 0.0f));
+
+	CEntity* hip = prefab.createEntity();
+	prefab.addTransformData(hip, NULL, core::IdentityMatrix, "hip");
+	CEntity* spine = prefab.createEntity();
+	prefab.addTransformData(spine, hip, core::IdentityMatrix, "spine");
+	CEntity* arm = prefab.createEntity();
+	prefab.addTransformData(arm, spine, armMatrix, "arm");
+
+	core::array<CEntity*> entities;
+	entities.push_back(hip);
+	entities.push_back(spine);
+	entities.push_back(arm);
+
+	CSkeleton skeleton(0);
+	skeleton.initSkeleton(entities);
+
+	CAnimationClip walkClip, runClip;
+	addClipAnim(walkClip, 1.0f, 0.0f);
+	addClipAnim(runClip, 2.0f, core::HALF_PI);
+
+	// 1D blend space
+	CBlendTree* tree = skeleton.createBlendTree();
+	TEST_ASSERT_THROW(skeleton.getAnimationType() == CSkeleton::BlendTree);
+	TEST_ASSERT_THROW(tree->getNumBone() == 3);
+
+	CBlendClipNode* walk = tree->addNode(new CBlendClipNode(&walkClip));
+	CBlendClipNode* run = tree->addNode(new CBlendClipNode(&runClip));
+
+	CBlendSpaceNode* space = tree->addNode(new CBlendSpaceNode("speed"));
+	space->addChild(run, 1.0f);
+	space->addChild(walk, 0.0f);
+	space->setPhase(0.5f);
+
+	tree->setRoot(space);
+	tree->setParameter("speed", 0.5f);
+	tree->updateTime();
+
+	// the time is synced to the heaviest child
+	TEST_ASSERT_FLOAT_EQUAL(walk->getPhase(), run->getPhase());
+
+	space->setPhase(0.5f);
+	skeleton.update();
+
+	TEST_ASSERT_FLOAT_EQUAL(space->getWeight(0), 0.5f);
+	TEST_ASSERT_FLOAT_EQUAL(getPosition(skeleton, 0).X, 7.5f);
+
+	// the bone that has no animation keeps the default transform
+	TEST_ASSERT_FLOAT_EQUAL(getPosition(skeleton, 2).Y, 1.0f);
+
+	// the run layer is masked on the spine & its childs, the mask is set before the node is added to the tree
+	CBlendLayerNode* layer = new CBlendLayerNode(walk, run);
+	layer->setMask("spine");
+	tree->addNode(layer);
+	tree->setRoot(layer);
+	skeleton.update();
+
+	core::quaternion runRotation;
+	runRotation.fromAngleAxis(core::HALF_PI, core::vector3df(0.0f, 1.0f, 0.0f));
+
+	TEST_ASSERT_FLOAT_EQUAL(getPosition(skeleton, 0).X, 5.0f);
+	TEST_ASSERT_THROW(fabsf(skeleton.getEntitiesData()[1]->AnimRotation.dotProduct(runRotation)) > 0.9999f);
+
+	// the additive run layer from its first frame
+	CBlendLayerNode* additive = tree->addNode(new CBlendLayerNode(walk, run, CBlendLayerNode::Additive));
+	additive->setReference(run, 0.0f);
+	additive->setWeightParameter("additive");
+	tree->setParameter("additive", 0.5f);
+	tree->setRoot(additive);
+	skeleton.update();
+
+	TEST_ASSERT_FLOAT_EQUAL(getPosition(skeleton, 0).X, 10.0f);
+
+	// the spine of run is constant, no difference from the reference
+	core::quaternion identity;
+	TEST_ASSERT_THROW(fabsf(skeleton.getEntitiesData()[1]->AnimRotation.dotProduct(identity)) > 0.9999f);
+
+	TEST_CASE("Blend tree 2D blend space");
+	CBlendSpaceNode* space2D = tree->addNode(new CBlendSpaceNode("x", "y"));
+	space2D->addChild(walk, 0.0f, 0.0f);
+	space2D->addChild(run, 1.0f, 0.0f);
+	space2D->addChild(walk, 0.0f, 1.0f);
+	tree->setRoot(space2D);
+
+	// the inverse squared distances 4, 4, 0.8 are normalized
+	tree->setParameter("x", 0.5f);
+	tree->setParameter("y", 0.0f);
+	tree->updateTime();
+
+	f32 nearWeight = 4.0f / 8.8f;
+	f32 farWeight = 0.8f / 8.8f;
+	TEST_ASSERT_FLOAT_EQUAL(space2D->getWeight(0), nearWeight);
+	TEST_ASSERT_FLOAT_EQUAL(space2D->getWeight(1), nearWeight);
+	TEST_ASSERT_FLOAT_EQUAL(space2D->getWeight(2), farWeight);
+
+	// on the child position
+	tree->setParameter("x", 1.0f);
+	tree->updateTime();
+	TEST_ASSERT_FLOAT_EQUAL(space2D->getWeight(0), 0.0f);
+	TEST_ASSERT_FLOAT_EQUAL(space2D->getWeight(1), 1.0f);
+	TEST_ASSERT_FLOAT_EQUAL(space2D->getWeight(2), 0.0f);
+
+	TEST_CASE("Blend tree crossfade");
+	float timeStep = getTimeStep();
+	setTimeStep(100.0f);
+
+	// the clips are paused: walk is at the first frame, run is at the last frame
+	walk->getTimeline().Pause = true;
+	run->getTimeline().Pause = true;
+	walk->setPhase(0.0f);
+	run->setPhase(1.0f);
+
+	CBlendCrossfadeNode* crossfade = tree->addNode(new CBlendCrossfadeNode());
+	crossfade->addChild(walk);
+	int runID = crossfade->addChild(run);
+	tree->setRoot(crossfade);
+
+	crossfade->play(runID, 0.4f, false);
+	TEST_ASSERT_THROW(crossfade->getCurrent() == runID);
+
+	// the weight of run is 0.25, 0.5, 0.75 after the time steps of 0.1s
+	for (int i = 1; i <= 3; i++)
+	{
+		tree->updateTime();
+		skeleton.update();
+		TEST_ASSERT_THROW(crossfade->isFading());
+
+		f32 hipX = 20.0f * (f32)i * 0.25f;
+		TEST_ASSERT_THROW(fabsf(getPosition(skeleton, 0).X - hipX) < 0.001f);
+	}
+
+	// the fade is done
+	tree->updateTime();
+	tree->updateTime();
+	skeleton.update();
+	TEST_ASSERT_THROW(!crossfade->isFading());
+	TEST_ASSERT_FLOAT_EQUAL(getPosition(skeleton, 0).X, 20.0f);
+
+	setTimeStep(timeStep);
+
+	skeleton.releaseBlendTree();
+	TEST_ASSERT_THROW(skeleton.getAnimationType() == CSkeleton::KeyFrame);
+}
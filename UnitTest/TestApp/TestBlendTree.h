@@ -0,0 +1,3 @@
+#pragma once
+
+void testBlendTree();
\ No newline at end of file
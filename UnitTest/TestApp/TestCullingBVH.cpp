@@ -0,0 +1,101 @@
+#include "pch.h"
+#include "Base.hh"
+#include "TestCullingBVH.h"
+
+#include "Culling/CCullingBVH.h"
+
+using namespace Skylicht;
+
+static int countIntersect(const core::array<core::aabbox3df>& boxes, const core::array<int>& nodes, const core::aabbox3df& box)
+{
+	int count = 0;
+	for (u32 i = 0; i < boxes.size(); i++)
+	{
+		if (nodes[i] != -1 && boxes[i].intersectsWithBox(box))
+			count++;
+	}
+	return count;
+}
+
+void testCullingBVH()
+{
+	CCullingBVH* bvh = new CCullingBVH();
+
+	core::array<core::aabbox3df> boxes;
+	core::array<int> nodes;
+
+	TEST_CASE("Culling BVH insert");
+	for (int x = 0; x < 32; x++)
+	{
+		for (int z = 0; z < 32; z++)
+		{
+			core::vector3df p((f32)x * 4.0f, 0.0f, (f32)z * 4.0f);
+			core::aabbox3df box(p - core::vector3df(1.0f, 1.0f, 1.0f), p + core::vector3df(1.0f, 1.0f, 1.0f));
+
+			nodes.push_back(bvh->insert(box, (int)boxes.size()));
+			boxes.push_back(box);
+		}
+	}
+	TEST_ASSERT_THROW(bvh->validate());
+	TEST_ASSERT_THROW(bvh->getLeafCount() == 1024);
+
+	// balanced tree
+	TEST_ASSERT_THROW(bvh->getHeight() < 32);
+
+	TEST_CASE("Culling BVH query");
+	CFastArray<int> result;
+	core::aabbox3df queryBox(core::vector3df(10.0f, -1.0f, 10.0f), core::vector3df(30.0f, 1.0f, 50.0f));
+	bvh->query(queryBox, NULL, 0, result);
+
+	// the fat box could add the neighbours
+	int count = countIntersect(boxes, nodes, queryBox);
+	TEST_ASSERT_THROW(result.count() >= count);
+
+	int* r = result.pointer();
+	int exact = 0;
+	for (int i = 0; i < result.count(); i++)
+	{
+		if (boxes[r[i]].intersectsWithBox(queryBox))
+			exact++;
+	}
+	TEST_ASSERT_THROW(exact == count);
+
+	// the ortho frustum that looks on +x, the near plane is x = 64
+	core::matrix4 projection, view;
+	projection.buildProjectionMatrixOrthoLH(400.0f, 40.0f, 10.0f, 1000.0f);
+	view.buildCameraLookAtMatrixLH(core::vector3df(54.0f, 0.0f, 64.0f), core::vector3df(100.0f, 0.0f, 64.0f), core::vector3df(0.0f, 1.0f, 0.0f));
+
+	SViewFrustum frustum;
+	frustum.setFrom(projection * view);
+
+	core::aabbox3df allBox(core::vector3df(-10.0f, -10.0f, -10.0f), core::vector3df(200.0f, 10.0f, 200.0f));
+	bvh->query(allBox, frustum.planes, SViewFrustum::VF_PLANE_COUNT, result);
+	r = result.pointer();
+	for (int i = 0; i < result.count(); i++)
+		TEST_ASSERT_THROW(boxes[r[i]].MaxEdge.X >= 63.0f);
+	TEST_ASSERT_THROW(result.count() >= 512);
+
+	TEST_CASE("Culling BVH move & remove");
+	for (u32 i = 0; i < boxes.size(); i += 3)
+	{
+		boxes[i].MinEdge.Y += 20.0f;
+		boxes[i].MaxEdge.Y += 20.0f;
+		bvh->move(nodes[i], boxes[i]);
+	}
+
+	for (u32 i = 0; i < boxes.size(); i += 5)
+	{
+		bvh->remove(nodes[i]);
+		nodes[i] = -1;
+	}
+	TEST_ASSERT_THROW(bvh->validate());
+
+	bvh->query(allBox, NULL, 0, result);
+	TEST_ASSERT_THROW(result.count() == countIntersect(boxes, nodes, allBox));
+
+	core::aabbox3df upBox(core::vector3df(-10.0f, 15.0f, -10.0f), core::vector3df(200.0f, 25.0f, 200.0f));
+	bvh->query(upBox, NULL, 0, result);
+	TEST_ASSERT_THROW(result.count() == countIntersect(boxes, nodes, upBox));
+
+	delete bvh;
+}
@@ -0,0 +1,202 @@
+#include "pch.h"
+#include "Base.hh"
+#include "TestCullingSystem.h"
+
+#include "Entity/CEntityManager.h"
+#include "Transform/CWorldTransformData.h"
+#include "Culling/CCullingData.h"
+#include "Culling/CCullingBBoxData.h"
+#include "Culling/CCullingSystem.h"
+#include "Transform/CWorldInverseTransformData.h"
+#include "RenderMesh/CJointData.h"
+#include "RenderMesh/CRenderMeshData.h"
+#include "RenderMesh/CSkinnedMesh.h"
+
+using namespace Skylicht;
+
+static CEntity* createTestCullingEntity(CEntityManager* entityMgr, const core::vector3df& position)
+{
+	CEntity* entity = entityMgr->createEntity();
+
+	CWorldTransformData* transform = entity->addData<CWorldTransformData>();
+	transform->Relative.setTranslation(position);
+
+	CCullingData* culling = entity->addData<CCullingData>();
+	culling->Type = CCullingData::FrustumBox;
+
+	CCullingBBoxData* bbox = entity->addData<CCullingBBoxData>();
+	bbox->BBox.MinEdge.set(-1.0f, -1.0f, -1.0f);
+	bbox->BBox.MaxEdge.set(1.0f, 1.0f, 1.0f);
+
+	return entity;
+}
+
+static void buildTestFrustum(SViewFrustum& frustum, const core::vector3df& position, const core::vector3df& target)
+{
+	core::matrix4 projection, view;
+	projection.buildProjectionMatrixPerspectiveFovLH(core::HALF_PI, 1.0f, 0.1f, 100.0f);
+	view.buildCameraLookAtMatrixLH(position, target, core::vector3df(0.0f, 1.0f, 0.0f));
+
+	frustum.setFrom(projection * view);
+	frustum.cameraPosition = position;
+	frustum.recalculateBoundingBox();
+}
+
+static u32 getViewMask(CEntity* entity)
+{
+	return GET_ENTITY_DATA(entity, CCullingData)->ViewMask;
+}
+
+void testCullingSystem()
+{
+	CEntityManager* entityMgr = new CEntityManager();
+	CCullingSystem* cullingSystem = entityMgr->getSystem<CCullingSystem>();
+
+	// more than 4 entities of each kind, the test runs on both SIMD & scalar path
+	core::array<CEntity*> front, side, behind;
+	for (int i = 0; i < 5; i++)
+	{
+		f32 x = (f32)i * 3.0f - 6.0f;
+		front.push_back(createTestCullingEntity(entityMgr, core::vector3df(x, 0.0f, 50.0f)));
+
+		// inside the bbox of the frustum, but outside the left & right planes
+		side.push_back(createTestCullingEntity(entityMgr, core::vector3df(i % 2 ? 80.0f : -80.0f, 0.0f, 10.0f + x)));
+
+		behind.push_back(createTestCullingEntity(entityMgr, core::vector3df(x, 0.0f, -50.0f)));
+	}
+
+	entityMgr->update();
+
+	TEST_CASE("Culling system frustum");
+	SViewFrustum frontFrustum;
+	buildTestFrustum(frontFrustum, core::vector3df(0.0f, 0.0f, 0.0f), core::vector3df(0.0f, 0.0f, 1.0f));
+
+	cullingSystem->clearViews();
+	cullingSystem->addView(frontFrustum);
+	cullingSystem->queryViews(entityMgr);
+
+	for (u32 i = 0; i < front.size(); i++)
+	{
+		TEST_ASSERT_THROW(getViewMask(front[i]) == 1);
+		TEST_ASSERT_THROW(getViewMask(side[i]) == 0);
+		TEST_ASSERT_THROW(getViewMask(behind[i]) == 0);
+	}
+
+	TEST_CASE("Culling system view mask");
+	SViewFrustum backFrustum;
+	buildTestFrustum(backFrustum, core::vector3df(0.0f, 0.0f, 0.0f), core::vector3df(0.0f, 0.0f, -1.0f));
+
+	core::aabbox3df sideBox(core::vector3df(-100.0f, -10.0f, 0.0f), core::vector3df(100.0f, 10.0f, 20.0f));
+
+	cullingSystem->clearViews();
+	TEST_ASSERT_THROW(cullingSystem->addView(frontFrustum) == 0);
+	TEST_ASSERT_THROW(cullingSystem->addView(backFrustum) == 1);
+	TEST_ASSERT_THROW(cullingSystem->addView(sideBox) == 2);
+	cullingSystem->queryViews(entityMgr);
+
+	for (u32 i = 0; i < front.size(); i++)
+	{
+		TEST_ASSERT_THROW(getViewMask(front[i]) == 1);
+		TEST_ASSERT_THROW(getViewMask(behind[i]) == 2);
+		TEST_ASSERT_THROW(getViewMask(side[i]) == 4);
+	}
+
+	TEST_CASE("Culling system light view");
+	// the view is added after the query, it is culled on the same tree
+	core::aabbox3df lightBox(core::vector3df(-10.0f, -10.0f, -60.0f), core::vector3df(10.0f, 10.0f, -40.0f));
+	int lightView = cullingSystem->addView(lightBox);
+	TEST_ASSERT_THROW(lightView == 3);
+	cullingSystem->queryViews(entityMgr);
+
+	for (u32 i = 0; i < front.size(); i++)
+	{
+		TEST_ASSERT_THROW(getViewMask(front[i]) == 1);
+		TEST_ASSERT_THROW(getViewMask(behind[i]) == (2 | 8));
+	}
+
+	// the next light reuses the view
+	lightBox = core::aabbox3df(core::vector3df(-10.0f, -10.0f, 40.0f), core::vector3df(10.0f, 10.0f, 60.0f));
+	cullingSystem->setView(lightView, lightBox);
+	cullingSystem->queryViews(entityMgr);
+
+	for (u32 i = 0; i < front.size(); i++)
+	{
+		TEST_ASSERT_THROW(getViewMask(front[i]) == (1 | 8));
+		TEST_ASSERT_THROW(getViewMask(behind[i]) == 2);
+	}
+
+	cullingSystem->clearViews();
+
+	TEST_CASE("Culling system refit changed bbox");
+	// the mesh updates its bbox on the same pointer
+	CCullingBBoxData* bbox = GET_ENTITY_DATA(front[0], CCullingBBoxData);
+	bbox->BBox.MaxEdge.Y = 5.0f;
+	entityMgr->update();
+
+	CCullingData* culling = GET_ENTITY_DATA(front[0], CCullingData);
+	TEST_ASSERT_FLOAT_EQUAL(culling->BBox.MaxEdge.Y, 5.0f);
+	TEST_ASSERT_THROW(cullingSystem->isChanged(culling->BBox));
+
+	TEST_CASE("Culling system changed frustum");
+	entityMgr->update();
+	TEST_ASSERT_THROW(cullingSystem->isChanged(frontFrustum) == false);
+
+	// inside the bbox of the front frustum, but outside its planes
+	CWorldTransformData* transform = GET_ENTITY_DATA(side[1], CWorldTransformData);
+	transform->Relative.setTranslation(core::vector3df(80.0f, 0.0f, 20.0f));
+	transform->HasChanged = true;
+	entityMgr->update();
+	TEST_ASSERT_THROW(cullingSystem->isChanged(frontFrustum) == false);
+
+	transform = GET_ENTITY_DATA(front[1], CWorldTransformData);
+	transform->Relative.setTranslation(core::vector3df(0.0f, 5.0f, 60.0f));
+	transform->HasChanged = true;
+	entityMgr->update();
+	TEST_ASSERT_THROW(cullingSystem->isChanged(frontFrustum) == true);
+	TEST_ASSERT_THROW(cullingSystem->isChanged(backFrustum) == false);
+
+	TEST_CASE("Culling system skinned caster");
+	CEntity* root = entityMgr->createEntity();
+	root->addData<CWorldTransformData>();
+	root->addData<CWorldInverseTransformData>();
+
+	CEntity* joint = entityMgr->createEntity();
+	transform = joint->addData<CWorldTransformData>();
+	transform->ParentIndex = root->getIndex();
+	transform->Depth = 1;
+	joint->addData<CJointData>()->RootIndex = root->getIndex();
+
+	CSkinnedMesh* skinnedMesh = new CSkinnedMesh();
+
+	CEntity* skinned = entityMgr->createEntity();
+	skinned->addData<CWorldTransformData>()->Relative.setTranslation(core::vector3df(0.0f, 0.0f, 50.0f));
+	skinned->addData<CCullingData>();
+
+	CRenderMeshData* renderMesh = skinned->addData<CRenderMeshData>();
+	renderMesh->setMesh(skinnedMesh);
+	renderMesh->setSkinnedMesh(true);
+	skinnedMesh->drop();
+
+	skinnedMesh = (CSkinnedMesh*)renderMesh->getMesh();
+	skinnedMesh->SkinningMatrix = new f32[16 * GPU_BONES_COUNT];
+
+	CSkinnedMesh::SJoint skinJoint;
+	skinJoint.JointData = GET_ENTITY_DATA(joint, CJointData);
+	skinJoint.EntityIndex = joint->getIndex();
+	skinJoint.SkinningMatrix = skinnedMesh->SkinningMatrix;
+	skinnedMesh->Joints.push_back(skinJoint);
+
+	entityMgr->update();
+	TEST_ASSERT_THROW(cullingSystem->isChanged(frontFrustum) == true);
+
+	// the joints are not animated, the skinned caster does not change the shadow
+	entityMgr->update();
+	TEST_ASSERT_THROW(cullingSystem->isChanged(frontFrustum) == false);
+
+	transform->HasChanged = true;
+	entityMgr->update();
+	TEST_ASSERT_THROW(cullingSystem->isChanged(frontFrustum) == true);
+	TEST_ASSERT_THROW(cullingSystem->isChanged(backFrustum) == false);
+
+	delete entityMgr;
+}
@@ -0,0 +1,3 @@
+#pragma once
+
+void testCullingSystem();
\ No newline at end of file
@@ -0,0 +1,95 @@
+#include "pch.h"
+#include "Base.hh"
+#include "TestEntityGroup.h"
+
+#include "Entity/CEntityManager.h"
+#include "Transform/CWorldTransformData.h"
+#include "Culling/CCullingData.h"
+#include "Culling/CVisibleData.h"
+
+using namespace Skylicht;
+
+CEntity* createTestGroupEntity(CEntityManager* entityMgr, int parentIndex)
+{
+	CEntity* entity = entityMgr->createEntity();
+
+	CWorldTransformData* transform = entity->addData<CWorldTransformData>();
+	if (parentIndex >= 0)
+	{
+		transform->ParentIndex = parentIndex;
+		transform->Depth = 1;
+	}
+
+	entity->addData<CCullingData>();
+	return entity;
+}
+
+void testEntityGroup()
+{
+	CEntityManager* entityMgr = new CEntityManager();
+
+	const u32 cullingType[] = GET_LIST_ENTITY_DATA(CCullingData);
+	CEntityGroup* group = entityMgr->createGroup(cullingType, 1);
+
+	core::array<CEntity*> entities;
+	for (int i = 0; i < 40; i++)
+		entities.push_back(createTestGroupEntity(entityMgr, -1));
+
+	entityMgr->update();
+
+	// the visible group is created on the first update
+	const u32 visibleType[] = GET_LIST_ENTITY_DATA(CVisibleData);
+	CEntityGroup* visibleGroup = entityMgr->findGroup(visibleType, 1);
+
+	TEST_CASE("Entity group query");
+	TEST_ASSERT_THROW(group->getEntityCount() == 40);
+	TEST_ASSERT_THROW(visibleGroup->getEntityCount() == 40);
+
+	TEST_CASE("Entity group remove changed entity");
+	CEntity* removeEntity = entities[5];
+	entityMgr->removeEntity(removeEntity);
+	entityMgr->update();
+	TEST_ASSERT_THROW(group->getEntityCount() == 39);
+	TEST_ASSERT_THROW(group->haveEntity(removeEntity) == false);
+	TEST_ASSERT_THROW(group->haveEntity(entities[39]) == true);
+
+	TEST_CASE("Entity group add changed entity");
+	CEntity* newEntity = createTestGroupEntity(entityMgr, -1);
+	entityMgr->update();
+	TEST_ASSERT_THROW(group->getEntityCount() == 40);
+	TEST_ASSERT_THROW(group->haveEntity(newEntity) == true);
+
+	TEST_CASE("Entity group child visible");
+	CEntity* parent = entities[0];
+	parent->setVisible(false);
+	entityMgr->update();
+
+	CEntity* child = createTestGroupEntity(entityMgr, parent->getIndex());
+	entityMgr->update();
+	TEST_ASSERT_THROW(visibleGroup->haveEntity(parent) == false);
+	TEST_ASSERT_THROW(visibleGroup->haveEntity(child) == false);
+	TEST_ASSERT_THROW(group->haveEntity(child) == true);
+
+	TEST_CASE("Entity group release all entities");
+	entityMgr->releaseAllEntities();
+	TEST_ASSERT_THROW(group->getEntityCount() == 0);
+	TEST_ASSERT_THROW(visibleGroup->getEntityCount() == 0);
+	TEST_ASSERT_THROW(group->needQuery() == true);
+
+	// the new entities reuse the index of released entities
+	entities.set_used(0);
+	for (int i = 0; i < 10; i++)
+		entities.push_back(createTestGroupEntity(entityMgr, -1));
+
+	entityMgr->update();
+	TEST_ASSERT_THROW(group->getEntityCount() == 10);
+	TEST_ASSERT_THROW(visibleGroup->getEntityCount() == 10);
+
+	for (int i = 0; i < 10; i++)
+	{
+		TEST_ASSERT_THROW(group->haveEntity(entities[i]) == true);
+		TEST_ASSERT_THROW(group->getEntities()[i] == entities[i]);
+	}
+
+	delete entityMgr;
+}
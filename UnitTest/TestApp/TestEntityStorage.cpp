@@ -0,0 +1,75 @@
+#include "pch.h"
+#include "Base.hh"
+#include "TestEntityStorage.h"
+
+#include "Entity/CEntityManager.h"
+#include "Transform/CWorldTransformData.h"
+
+using namespace Skylicht;
+
+class CTestNotEntityData
+{
+public:
+	float Value[4];
+
+	virtual ~CTestNotEntityData()
+	{
+	}
+};
+
+void testEntityStorage()
+{
+	CEntityManager* entityMgr = new CEntityManager();
+
+	core::array<CEntity*> entities;
+	entityMgr->createEntity(100, entities);
+
+	TEST_CASE("Entity data storage");
+	for (u32 i = 0; i < entities.size(); i++)
+		entities[i]->addData<CWorldTransformData>();
+
+	CEntityDataStorage* storage = entityMgr->getDataStorage(CWorldTransformData::DataTypeIndex);
+	TEST_ASSERT_THROW(storage != NULL);
+	TEST_ASSERT_THROW(storage->getNumAlloc() == 100);
+
+	// the data is contiguous on the chunk
+	u32 stride = storage->getDataSize();
+	u8* first = (u8*)GET_ENTITY_DATA(entities[0], CWorldTransformData);
+	u8* second = (u8*)GET_ENTITY_DATA(entities[1], CWorldTransformData);
+	TEST_ASSERT_THROW(second - first == (int)stride);
+	TEST_ASSERT_THROW(((size_t)first & 15) == 0);
+
+	TEST_CASE("Entity data storage release");
+	CWorldTransformData* data = GET_ENTITY_DATA(entities[10], CWorldTransformData);
+	entities[10]->removeData<CWorldTransformData>();
+	TEST_ASSERT_THROW(GET_ENTITY_DATA(entities[10], CWorldTransformData) == NULL);
+	TEST_ASSERT_THROW(storage->getNumAlloc() == 99);
+
+	// reuse the released slot
+	CWorldTransformData* newData = entities[10]->addData<CWorldTransformData>();
+	TEST_ASSERT_THROW(newData == data);
+	TEST_ASSERT_THROW(newData->EntityIndex == entities[10]->getIndex());
+	TEST_ASSERT_THROW(newData->ParentIndex == -1);
+
+	TEST_CASE("Entity data storage invalid type");
+	TEST_ASSERT_THROW(entities[20]->addData<CTestNotEntityData>() == NULL);
+
+	u32 invalidIndex = CEntityDataTypeManager::getDataIndex(typeid(CTestNotEntityData));
+	CEntityDataStorage* invalidStorage = entityMgr->getDataStorage(invalidIndex);
+	TEST_ASSERT_THROW(invalidStorage != NULL);
+	TEST_ASSERT_THROW(invalidStorage->getNumAlloc() == 0);
+
+	// the slot is returned to the storage
+	TEST_ASSERT_THROW(entities[21]->addData<CTestNotEntityData>() == NULL);
+	TEST_ASSERT_THROW(invalidStorage->getNumAlloc() == 0);
+	TEST_ASSERT_THROW(invalidStorage->getNumChunk() == 1);
+
+	TEST_CASE("Entity data heap allocate");
+	entityMgr->setUseDataStorage(false);
+	CEntity* entity = entityMgr->createEntity();
+	entity->addData<CWorldTransformData>();
+	TEST_ASSERT_THROW(storage->getNumAlloc() == 100);
+	entityMgr->removeEntity(entity);
+
+	delete entityMgr;
+}
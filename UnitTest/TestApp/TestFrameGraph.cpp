@@ -0,0 +1,99 @@
+#include "pch.h"
+#include "Base.hh"
+#include "TestFrameGraph.h"
+
+#include "RenderPipeline/CFrameGraph.h"
+#include "RenderPipeline/CDeferredRP.h"
+#include "RenderPipeline/CPostProcessorRP.h"
+
+using namespace Skylicht;
+
+class CTestPostProcessorRP : public CPostProcessorRP
+{
+public:
+	CFrameGraph* getTestFrameGraph()
+	{
+		return m_frameGraph;
+	}
+
+	int getTestResource(int i)
+	{
+		return m_rttResource[i];
+	}
+};
+
+void testFrameGraph()
+{
+	TEST_CASE("Frame graph");
+
+	core::dimension2du size(256, 256);
+
+	CFrameGraph graph;
+
+	int gbuffer = graph.createTexture("gbuffer", size, ECF_A8R8G8B8);
+	int light = graph.createTexture("light", size, ECF_A16B16G16R16F);
+	int target = graph.createTexture("target", size, ECF_A16B16G16R16F);
+	int debug = graph.createTexture("debug", size, ECF_A16B16G16R16F);
+	int post = graph.createTexture("post", size, ECF_A16B16G16R16F);
+
+	int gbufferPass = graph.addPass("GBuffer");
+	graph.write(gbufferPass, gbuffer);
+
+	int lightPass = graph.addPass("Lighting");
+	graph.read(lightPass, gbuffer);
+	graph.write(lightPass, light);
+
+	int compositePass = graph.addPass("Composite");
+	graph.read(compositePass, gbuffer);
+	graph.read(compositePass, light);
+	graph.write(compositePass, target);
+
+	// nobody reads the debug target
+	int debugPass = graph.addPass("Debug");
+	graph.read(debugPass, light);
+	graph.write(debugPass, debug);
+
+	int postPass = graph.addPass("Post", true);
+	graph.read(postPass, target);
+	graph.write(postPass, post);
+
+	graph.compile();
+
+	TEST_ASSERT_THROW(graph.isPassCulled(debugPass) == true);
+	TEST_ASSERT_THROW(graph.isPassCulled(lightPass) == false);
+	TEST_ASSERT_THROW(graph.isPassCulled(postPass) == false);
+	TEST_ASSERT_THROW(graph.getPhysicalID(debug) == -1);
+
+	// the light target is dead after composite, the post target shares its texture
+	TEST_ASSERT_THROW(graph.getPhysicalID(post) == graph.getPhysicalID(light));
+	TEST_ASSERT_THROW(graph.getPhysicalID(target) != graph.getPhysicalID(light));
+	TEST_ASSERT_THROW(graph.getNumPhysical() == 3);
+	TEST_ASSERT_THROW(graph.getPhysicalMemory() < graph.getTransientMemory());
+
+	TEST_CASE("Frame graph post processor");
+	CTestPostProcessorRP* postProcessor = new CTestPostProcessorRP();
+
+	// the full size targets are aliased on the graph of deferred pipeline
+	CDeferredRP* deferred = new CDeferredRP();
+	deferred->setPostProcessor(postProcessor);
+	deferred->initRender(256, 256);
+
+	TEST_ASSERT_THROW(postProcessor->getTestFrameGraph() == deferred->getFrameGraph());
+	TEST_ASSERT_THROW(postProcessor->getTestResource(0) >= 0);
+
+	// detach, the post processor does not use the graph anymore
+	deferred->setPostProcessor(NULL);
+	TEST_ASSERT_THROW(postProcessor->getTestFrameGraph() == NULL);
+	TEST_ASSERT_THROW(postProcessor->getTestResource(0) == -1);
+
+	// attach again, the graph is rebuilt on resize
+	deferred->setPostProcessor(postProcessor);
+	deferred->resize(256, 256);
+	TEST_ASSERT_THROW(postProcessor->getTestFrameGraph() == deferred->getFrameGraph());
+
+	// the graph is released with the pipeline
+	delete deferred;
+	TEST_ASSERT_THROW(postProcessor->getTestFrameGraph() == NULL);
+
+	delete postProcessor;
+}
@@ -0,0 +1,3 @@
+#pragma once
+
+void testFrameGraph();
\ No newline at end of file
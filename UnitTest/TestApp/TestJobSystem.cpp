@@ -0,0 +1,55 @@
+#include "Base.hh"
+#include "TestJobSystem.h"
+
+using namespace SkylichtSystem;
+
+void testJobSystem()
+{
+	CJobSystem* jobSystem = new CJobSystem(3);
+
+	TEST_CASE("Job system counter");
+	std::atomic<int> count(0);
+	CJobCounter counter;
+	for (int i = 0; i < 100; i++)
+	{
+		jobSystem->run([&]() {
+			count++;
+			}, &counter);
+	}
+	jobSystem->wait(&counter);
+	TEST_ASSERT_THROW(counter.isDone());
+	TEST_ASSERT_THROW(count.load() == 100);
+
+	TEST_CASE("Job system dependency");
+	std::atomic<int> step(0);
+	bool order = true;
+	CJobCounter first, second;
+	jobSystem->run([&]() {
+		step = 1;
+		}, &first);
+	jobSystem->run([&]() {
+		if (step.load() != 1)
+			order = false;
+		step = 2;
+		}, &second, &first);
+	jobSystem->wait(&second);
+	TEST_ASSERT_THROW(order);
+	TEST_ASSERT_THROW(step.load() == 2);
+
+	TEST_CASE("Job system parallel for");
+	std::vector<int> values(1000, 0);
+	jobSystem->parallelFor((int)values.size(), 64, [&](int begin, int end) {
+		for (int i = begin; i < end; i++)
+			values[i] = i;
+		});
+
+	bool pass = true;
+	for (int i = 0, n = (int)values.size(); i < n; i++)
+	{
+		if (values[i] != i)
+			pass = false;
+	}
+	TEST_ASSERT_THROW(pass);
+
+	delete jobSystem;
+}
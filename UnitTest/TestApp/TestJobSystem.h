@@ -0,0 +1,6 @@
+#pragma once
+
+#include "Base.hh"
+#include "Job/CJobSystem.h"
+
+void testJobSystem();
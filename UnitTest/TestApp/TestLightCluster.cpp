@@ -0,0 +1,77 @@
+#include "pch.h"
+#include "Base.hh"
+#include "TestLightCluster.h"
+
+#include "Lighting/CLightCluster.h"
+
+using namespace Skylicht;
+
+void testLightCluster()
+{
+	TEST_CASE("Light cluster");
+
+	core::matrix4 projection;
+	projection.buildProjectionMatrixPerspectiveFovLH(core::PI * 0.5f, 1.0f, 1.0f, 100.0f);
+
+	// camera at the origin, look at +Z
+	core::matrix4 view;
+	view.buildCameraLookAtMatrixLH(core::vector3df(0.0f, 0.0f, 0.0f), core::vector3df(0.0f, 0.0f, 1.0f), core::vector3df(0.0f, 1.0f, 0.0f));
+
+	CLightCluster cluster;
+	cluster.setGridSize(4, 4, 8);
+	cluster.update(projection, 1.0f, 100.0f);
+
+	TEST_ASSERT_THROW(cluster.getNumCluster() == 128);
+	TEST_ASSERT_THROW(cluster.getSlice(0.5f) == 0);
+	TEST_ASSERT_THROW(cluster.getSlice(99.0f) == 7);
+
+	SClusterLight lights[4];
+
+	// a small light at the center of screen
+	lights[0].Position.set(0.0f, 0.0f, 10.0f);
+	lights[0].Radius = 1.0f;
+
+	// the light behind the camera
+	lights[1].Position.set(0.0f, 0.0f, -10.0f);
+	lights[1].Radius = 2.0f;
+
+	// the big light covers all the near clusters
+	lights[2].Position.set(0.0f, 0.0f, 1.0f);
+	lights[2].Radius = 50.0f;
+
+	// the spot light on the left side, that points to the left
+	lights[3].Position.set(-10.0f, 0.0f, 10.0f);
+	lights[3].Direction.set(-1.0f, 0.0f, 0.0f);
+	lights[3].Radius = 5.0f;
+	lights[3].Spot = true;
+	lights[3].CosAngle = cosf(core::PI / 8.0f);
+	lights[3].SinAngle = sinf(core::PI / 8.0f);
+
+	cluster.assignLights(view, lights, 4);
+
+	core::rectf rect;
+
+	// the light 0 is on the 4 center tiles
+	TEST_ASSERT_THROW(cluster.getLightScreenRect(0, 400.0f, 400.0f, rect) == true);
+	TEST_ASSERT_FLOAT_EQUAL(rect.UpperLeftCorner.X, 100.0f);
+	TEST_ASSERT_FLOAT_EQUAL(rect.LowerRightCorner.Y, 300.0f);
+
+	TEST_ASSERT_THROW(cluster.getLightScreenRect(1, 400.0f, 400.0f, rect) == false);
+
+	TEST_ASSERT_THROW(cluster.getLightScreenRect(2, 400.0f, 400.0f, rect) == true);
+	TEST_ASSERT_FLOAT_EQUAL(rect.getWidth(), 400.0f);
+
+	// the left spot light does not touch the right half of screen
+	TEST_ASSERT_THROW(cluster.getLightScreenRect(3, 400.0f, 400.0f, rect) == true);
+	TEST_ASSERT_THROW(rect.LowerRightCorner.X <= 200.0f);
+
+	// the near cluster at the center has the light 0 & 2, in order
+	u32 count = 0;
+	const u16* list = cluster.getClusterLights(cluster.getClusterID(1, 1, cluster.getSlice(10.0f)), count);
+	TEST_ASSERT_THROW(count == 2);
+	TEST_ASSERT_THROW(list[0] == 0 && list[1] == 2);
+
+	// the far cluster is empty
+	cluster.getClusterLights(cluster.getClusterID(0, 0, 7), count);
+	TEST_ASSERT_THROW(count == 0);
+}
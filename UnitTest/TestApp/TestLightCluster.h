@@ -0,0 +1,3 @@
+#pragma once
+
+void testLightCluster();
\ No newline at end of file
@@ -0,0 +1,141 @@
+#include "pch.h"
+#include "Base.hh"
+#include "TestMaterialParams.h"
+
+#include "Material/Shader/CShader.h"
+
+using namespace Skylicht;
+
+class CTestMaterialRenderer : public IMaterialRenderer
+{
+public:
+	core::array<s32> UploadID;
+	core::array<E_SHADER_TYPE> UploadType;
+
+public:
+	virtual void setShaderVariable(s32 id, const f32* value, int count, E_SHADER_TYPE shaderType)
+	{
+		UploadID.push_back(id);
+		UploadType.push_back(shaderType);
+	}
+
+	void reset()
+	{
+		UploadID.set_used(0);
+		UploadType.set_used(0);
+	}
+
+	bool isUploaded(s32 id)
+	{
+		return UploadID.linear_search(id) >= 0;
+	}
+};
+
+class CTestShader : public CShader
+{
+public:
+	void addUniform(const char* name, EUniformType type, int valueIndex, int shaderID, bool vertexShader)
+	{
+		SUniform uniform;
+		uniform.Name = name;
+		uniform.Type = type;
+		uniform.ValueIndex = valueIndex;
+		uniform.FloatSize = 4;
+		uniform.SizeOfUniform = 4;
+		uniform.UniformShaderID = shaderID;
+
+		if (vertexShader)
+			m_vsUniforms.push_back(uniform);
+		else
+			m_fsUniforms.push_back(uniform);
+	}
+
+	// the program is linked
+	void build()
+	{
+		m_listVSUniforms = m_vsUniforms.pointer();
+		m_listFSUniforms = m_fsUniforms.pointer();
+		m_numVSUniform = (int)m_vsUniforms.size();
+		m_numFSUniform = (int)m_fsUniforms.size();
+
+		buildMaterialParams();
+	}
+
+	void upload(CShaderParams& params, IMaterialRenderer* matRender)
+	{
+		setMaterialParams(params, matRender);
+	}
+};
+
+void testMaterialParams()
+{
+	TEST_CASE("Material params handle");
+
+	CTestShader* shader = new CTestShader();
+	shader->addUniform("uTexTiling", MATERIAL_PARAM, 0, 10, true);
+	shader->addUniform("uColor", MATERIAL_PARAM, 1, 11, false);
+	shader->addUniform("uSpecGloss", MATERIAL_PARAM, 2, 12, false);
+	shader->addUniform("uLightDirection", LIGHT_DIRECTION, 0, 13, false);
+	shader->build();
+
+	TEST_ASSERT_THROW(shader->getMaterialParamHandle("uTexTiling") == 0);
+	TEST_ASSERT_THROW(shader->getMaterialParamHandle("uColor") == 1);
+	TEST_ASSERT_THROW(shader->getMaterialParamHandle("uSpecGloss") == 2);
+	TEST_ASSERT_THROW(shader->getMaterialParamHandle("uLightDirection") == -1);
+	TEST_ASSERT_THROW(shader->getMaterialParamHandle("uNotFound") == -1);
+
+	TEST_CASE("Material params dirty upload");
+
+	CTestMaterialRenderer* renderer = new CTestMaterialRenderer();
+	CShaderParams params;
+
+	for (int i = 0; i < 3; i++)
+	{
+		SVec4 v(1.0f, 2.0f, 3.0f, (f32)i);
+		params.setValue(i, v);
+	}
+
+	// the program has no params, upload all
+	shader->upload(params, renderer);
+	TEST_ASSERT_THROW(renderer->UploadID.size() == 3);
+	TEST_ASSERT_THROW(renderer->isUploaded(10));
+	TEST_ASSERT_THROW(renderer->isUploaded(11));
+	TEST_ASSERT_THROW(renderer->isUploaded(12));
+	TEST_ASSERT_THROW(!renderer->isUploaded(13));
+
+	for (u32 i = 0; i < renderer->UploadID.size(); i++)
+	{
+		E_SHADER_TYPE type = renderer->UploadID[i] == 10 ? EST_VERTEX_SHADER : EST_PIXEL_SHADER;
+		TEST_ASSERT_THROW(renderer->UploadType[i] == type);
+	}
+
+	// same params, nothing to upload
+	renderer->reset();
+	shader->upload(params, renderer);
+	TEST_ASSERT_THROW(renderer->UploadID.size() == 0);
+
+	// only the changed param is uploaded
+	params.getParam(1).W = 5.0f;
+
+	renderer->reset();
+	shader->upload(params, renderer);
+	TEST_ASSERT_THROW(renderer->UploadID.size() == 1);
+	TEST_ASSERT_THROW(renderer->isUploaded(11));
+
+	// the param that is not used on shader is not uploaded
+	params.getParam(5).X = 1.0f;
+
+	renderer->reset();
+	shader->upload(params, renderer);
+	TEST_ASSERT_THROW(renderer->UploadID.size() == 0);
+
+	// the new program need upload all params
+	shader->build();
+
+	renderer->reset();
+	shader->upload(params, renderer);
+	TEST_ASSERT_THROW(renderer->UploadID.size() == 3);
+
+	delete renderer;
+	delete shader;
+}
@@ -0,0 +1,3 @@
+#pragma once
+
+void testMaterialParams();
\ No newline at end of file
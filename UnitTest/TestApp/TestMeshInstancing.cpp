@@ -0,0 +1,209 @@
+#include "pch.h"
+#include "Base.hh"
+#include "TestMeshInstancing.h"
+
+#include "Entity/CEntityManager.h"
+#include "RenderMesh/CMeshRendererInstancing.h"
+#include "Culling/CCullingData.h"
+
+using namespace Skylicht;
+
+class CTestRenderMeshData : public CRenderMeshData
+{
+public:
+	void setInstancingData(SMeshInstancingData* data)
+	{
+		InstancingData = data;
+	}
+};
+
+class CTestMeshRendererInstancing : public CMeshRendererInstancing
+{
+public:
+	core::array<int> BatchedSlots;
+
+public:
+	void setMeshs(core::array<CRenderMeshData*>& meshs)
+	{
+		m_meshs = meshs;
+	}
+
+	SMeshInstancingGroup* getTestGroup(SMeshInstancingData* data)
+	{
+		return getGroup(data);
+	}
+
+	SMeshInstancingSlot& getSlot(CEntity* entity)
+	{
+		return m_slots[entity->getIndex()];
+	}
+
+	bool isTestVisible(CCullingData* culling)
+	{
+		return isInstanceVisible(culling, 1);
+	}
+
+protected:
+
+	// record the dirty slots, the test data has no instancing buffer
+	virtual void batchGroup(SMeshInstancingGroup* group)
+	{
+		BatchedSlots.set_used(0);
+		for (u32 i = 0, n = group->DirtySlots.count(); i < n; i++)
+			BatchedSlots.push_back(group->DirtySlots.pointer()[i]);
+
+		group->DirtySlots.reset();
+		group->BatchedCount = group->Entities.size();
+	}
+};
+
+static bool isBatchedSlots(CTestMeshRendererInstancing* renderer, const int* slots, u32 count)
+{
+	if (renderer->BatchedSlots.size() != count)
+		return false;
+
+	for (u32 i = 0; i < count; i++)
+	{
+		if (renderer->BatchedSlots[i] != slots[i])
+			return false;
+	}
+	return true;
+}
+
+static void updateInstancing(CEntityManager* entityMgr, CTestMeshRendererInstancing* renderer, CEntity** entities, CTestRenderMeshData* meshData, int count, int skip)
+{
+	core::array<CRenderMeshData*> meshs;
+	for (int i = 0; i < count; i++)
+	{
+		if (i != skip)
+			meshs.push_back(&meshData[i]);
+	}
+
+	renderer->setMeshs(meshs);
+	renderer->update(entityMgr);
+
+	// the transforms is not changed on next frame
+	for (int i = 0; i < count; i++)
+		GET_ENTITY_DATA(entities[i], CWorldTransformData)->NeedValidate = false;
+}
+
+void testMeshInstancing()
+{
+	TEST_CASE("Mesh instancing persistent group");
+
+	CEntityManager* entityMgr = new CEntityManager();
+	CTestMeshRendererInstancing* renderer = new CTestMeshRendererInstancing();
+
+	SMeshInstancingData instancingData;
+
+	const int numEntity = 5;
+	CEntity* entities[numEntity];
+	CTestRenderMeshData meshData[numEntity];
+
+	for (int i = 0; i < numEntity; i++)
+	{
+		entities[i] = entityMgr->createEntity();
+		entities[i]->addData<CWorldTransformData>();
+		entities[i]->addData<CIndirectLightingData>();
+
+		meshData[i].EntityIndex = entities[i]->getIndex();
+		meshData[i].setInstancingData(&instancingData);
+	}
+
+	SMeshInstancingGroup* group = renderer->getTestGroup(&instancingData);
+
+	// the new instances is added to the group in order
+	updateInstancing(entityMgr, renderer, entities, meshData, numEntity, -1);
+
+	const int allSlots[] = { 0, 1, 2, 3, 4 };
+	TEST_ASSERT_THROW(group->Entities.size() == numEntity);
+	TEST_ASSERT_THROW(isBatchedSlots(renderer, allSlots, 5));
+
+	for (int i = 0; i < numEntity; i++)
+	{
+		TEST_ASSERT_THROW(renderer->getSlot(entities[i]).Group == group);
+		TEST_ASSERT_THROW(renderer->getSlot(entities[i]).Slot == i);
+	}
+
+	// nothing changed, nothing to batch
+	updateInstancing(entityMgr, renderer, entities, meshData, numEntity, -1);
+	TEST_ASSERT_THROW(renderer->BatchedSlots.size() == 0);
+
+	// the middle instance is culled, the last instance is moved to its slot
+	updateInstancing(entityMgr, renderer, entities, meshData, numEntity, 2);
+
+	const int movedSlots[] = { 2 };
+	TEST_ASSERT_THROW(group->Entities.size() == numEntity - 1);
+	TEST_ASSERT_THROW(isBatchedSlots(renderer, movedSlots, 1));
+
+	TEST_ASSERT_THROW(renderer->getSlot(entities[2]).Group == NULL);
+	TEST_ASSERT_THROW(renderer->getSlot(entities[4]).Group == group);
+	TEST_ASSERT_THROW(renderer->getSlot(entities[4]).Slot == 2);
+
+	const int remain[] = { 0, 1, 3 };
+	for (int i = 0; i < 3; i++)
+		TEST_ASSERT_THROW(renderer->getSlot(entities[remain[i]]).Slot == remain[i]);
+
+	for (u32 i = 0; i < group->Entities.size(); i++)
+	{
+		CEntity* entity = group->Entities[i];
+		TEST_ASSERT_THROW(group->EntityIndex[i] == (u32)entity->getIndex());
+		TEST_ASSERT_THROW(renderer->getSlot(entity).Slot == (int)i);
+	}
+
+	// the indirect lighting changed, only its slot is batched
+	GET_ENTITY_DATA(entities[1], CIndirectLightingData)->ChangedID++;
+	updateInstancing(entityMgr, renderer, entities, meshData, numEntity, 2);
+
+	const int lightingSlots[] = { 1 };
+	TEST_ASSERT_THROW(isBatchedSlots(renderer, lightingSlots, 1));
+	TEST_ASSERT_THROW(group->LightingID[1] == GET_ENTITY_DATA(entities[1], CIndirectLightingData)->ChangedID);
+
+	// the culled instance is visible again, it is added at the end
+	updateInstancing(entityMgr, renderer, entities, meshData, numEntity, -1);
+
+	const int addSlots[] = { 4 };
+	TEST_ASSERT_THROW(group->Entities.size() == numEntity);
+	TEST_ASSERT_THROW(isBatchedSlots(renderer, addSlots, 1));
+	TEST_ASSERT_THROW(renderer->getSlot(entities[2]).Slot == 4);
+	TEST_ASSERT_THROW(group->Entities[4] == entities[2]);
+
+	TEST_CASE("Mesh instancing culling views");
+	SMeshInstancingData viewInstancingData;
+	group = renderer->getTestGroup(&viewInstancingData);
+
+	CCullingData culling[numEntity];
+	for (int i = 0; i < numEntity; i++)
+	{
+		meshData[i].setInstancingData(&viewInstancingData);
+		culling[i].Visible = true;
+		culling[i].CullingLayer = 1;
+		culling[i].ViewMask = 1 | 2;
+	}
+
+	updateInstancing(entityMgr, renderer, entities, meshData, numEntity, -1);
+	TEST_ASSERT_THROW(group->Entities.size() == numEntity);
+
+	// the camera pass, the instance is outside the camera but inside a shadow cascade
+	culling[2].Visible = false;
+	culling[2].ViewMask = 2;
+	TEST_ASSERT_THROW(renderer->isTestVisible(&culling[2]) == true);
+
+	updateInstancing(entityMgr, renderer, entities, meshData, numEntity, renderer->isTestVisible(&culling[2]) ? -1 : 2);
+	TEST_ASSERT_THROW(group->Entities.size() == numEntity);
+	TEST_ASSERT_THROW(renderer->BatchedSlots.size() == 0);
+
+	// the instance is not on any view, or its layer is not rendered
+	culling[2].ViewMask = 0;
+	TEST_ASSERT_THROW(renderer->isTestVisible(&culling[2]) == false);
+
+	culling[2].ViewMask = 2;
+	culling[2].CullingLayer = 2;
+	TEST_ASSERT_THROW(renderer->isTestVisible(&culling[2]) == false);
+
+	updateInstancing(entityMgr, renderer, entities, meshData, numEntity, renderer->isTestVisible(&culling[2]) ? -1 : 2);
+	TEST_ASSERT_THROW(group->Entities.size() == numEntity - 1);
+
+	delete renderer;
+	delete entityMgr;
+}
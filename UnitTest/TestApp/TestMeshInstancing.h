@@ -0,0 +1,3 @@
+#pragma once
+
+void testMeshInstancing();
\ No newline at end of file
@@ -0,0 +1,57 @@
+#include "pch.h"
+#include "Base.hh"
+#include "TestOcclusionBuffer.h"
+
+#include "Culling/COcclusionBuffer.h"
+
+using namespace Skylicht;
+
+void testOcclusionBuffer()
+{
+	COcclusionBuffer* buffer = new COcclusionBuffer(60, 30);
+
+	TEST_CASE("Occlusion buffer size");
+	TEST_ASSERT_THROW(buffer->getWidth() == 64);
+	TEST_ASSERT_THROW(buffer->getHeight() == 32);
+
+	core::matrix4 proj, view;
+	proj.buildProjectionMatrixPerspectiveFovLH(core::PI / 3.0f, 2.0f, 0.1f, 1000.0f);
+	view.buildCameraLookAtMatrixLH(core::vector3df(0.0f, 0.0f, 0.0f), core::vector3df(0.0f, 0.0f, 1.0f), core::vector3df(0.0f, 1.0f, 0.0f));
+
+	buffer->clear(proj * view);
+
+	// the wall at z = 10
+	core::vector3df wall[] = {
+		core::vector3df(-5.0f, -5.0f, 10.0f),
+		core::vector3df(5.0f, -5.0f, 10.0f),
+		core::vector3df(5.0f, 5.0f, 10.0f),
+		core::vector3df(-5.0f, 5.0f, 10.0f)
+	};
+	u32 indices[] = { 0, 1, 2, 0, 2, 3 };
+
+	TEST_CASE("Occlusion buffer rasterize");
+	buffer->drawTriangles(core::IdentityMatrix, wall, 4, indices, 6);
+
+	// center pixel has depth 1/w = 1/10
+	f32 d = buffer->getDepth(buffer->getWidth() / 2, buffer->getHeight() / 2);
+	TEST_ASSERT_FLOAT_EQUAL(d, 0.1f);
+
+	// corner pixel is empty
+	TEST_ASSERT_THROW(buffer->getDepth(0, 0) == 0.0f);
+
+	TEST_CASE("Occlusion buffer test box");
+	core::aabbox3df behind(core::vector3df(-1.0f, -1.0f, 20.0f), core::vector3df(1.0f, 1.0f, 22.0f));
+	TEST_ASSERT_THROW(buffer->isVisible(behind) == false);
+
+	core::aabbox3df front(core::vector3df(-1.0f, -1.0f, 5.0f), core::vector3df(1.0f, 1.0f, 6.0f));
+	TEST_ASSERT_THROW(buffer->isVisible(front) == true);
+
+	core::aabbox3df side(core::vector3df(20.0f, -1.0f, 20.0f), core::vector3df(22.0f, 1.0f, 22.0f));
+	TEST_ASSERT_THROW(buffer->isVisible(side) == true);
+
+	// the box cross the near plane
+	core::aabbox3df cross(core::vector3df(-1.0f, -1.0f, -1.0f), core::vector3df(1.0f, 1.0f, 30.0f));
+	TEST_ASSERT_THROW(buffer->isVisible(cross) == true);
+
+	delete buffer;
+}
@@ -0,0 +1,118 @@
+#include "pch.h"
+#include "Base.hh"
+#include "TestPoseSampler.h"
+
+#include "Animation/CAnimationClip.h"
+
+using namespace Skylicht;
+
+void testPoseSampler()
+{
+	TEST_CASE("Pose sampler");
+
+	CAnimationClip clip;
+
+	// 5 tracks, the last stride is padded
+	for (int t = 0; t < 5; t++)
+	{
+		SEntityAnim* anim = new SEntityAnim();
+		anim->Name = std::string("bone") + (char)('0' + t);
+
+		for (int i = 0; i <= 20; i++)
+		{
+			f32 frame = (f32)i;
+
+			CPositionKey pos;
+			pos.Frame = frame;
+			pos.Value.set(frame * t, sinf(frame), 1.0f);
+			anim->Data.Positions.Data.push_back(pos);
+
+			CRotationKey rot;
+			rot.Frame = frame;
+			rot.Value.fromAngleAxis(frame * 0.1f * t, core::vector3df(0.0f, 1.0f, 0.0f));
+			anim->Data.Rotations.Data.push_back(rot);
+		}
+
+		anim->Data.Scales.Default.set(1.0f, 2.0f, 3.0f);
+
+		clip.addAnim(anim);
+	}
+
+	// the pose sampler is opt-in per clip
+	TEST_ASSERT_THROW(clip.getPoseSampler() == NULL);
+	clip.enablePoseSampler(true);
+
+	CPoseSampler* sampler = clip.getPoseSampler();
+	TEST_ASSERT_THROW(sampler != NULL);
+	TEST_ASSERT_THROW(sampler->getNumFrame() == 21);
+	TEST_ASSERT_THROW(sampler->getStride() == 8);
+
+	f32 pose[CPoseSampler::StreamCount * 8];
+	u32 stride = sampler->getStride();
+
+	CAnimationTrack track;
+
+	for (f32 frame = 0.0f; frame <= 22.0f; frame += 0.7f)
+	{
+		sampler->sample(frame, pose);
+
+		for (int t = 0; t < 5; t++)
+		{
+			core::vector3df position, scale;
+			core::quaternion rotation;
+
+			track.clearAllKeyFrame();
+			track.setAnimationData(&clip.AnimInfo[t]->Data);
+			track.getFrameData(frame, position, scale, rotation);
+
+			TEST_ASSERT_FLOAT_EQUAL(pose[CPoseSampler::PositionX * stride + t], position.X);
+			TEST_ASSERT_FLOAT_EQUAL(pose[CPoseSampler::PositionY * stride + t], position.Y);
+			TEST_ASSERT_FLOAT_EQUAL(pose[CPoseSampler::ScaleZ * stride + t], scale.Z);
+
+			core::quaternion r(
+				pose[CPoseSampler::RotationX * stride + t],
+				pose[CPoseSampler::RotationY * stride + t],
+				pose[CPoseSampler::RotationZ * stride + t],
+				pose[CPoseSampler::RotationW * stride + t]);
+
+			// the slerp of track does not normalize on the small angle
+			rotation.normalize();
+			TEST_ASSERT_THROW(fabsf(r.dotProduct(rotation)) > 0.9999f);
+		}
+	}
+
+	// the skeletons at the same quantized time share the cached pose
+	CPoseCache* cache = clip.getPoseCache();
+	TEST_ASSERT_THROW(cache != NULL);
+
+	f32 step = 1.0f / (f32)CPoseCache::getSubFrames();
+	const f32* cached = cache->getPose(3.0f + step);
+	TEST_ASSERT_THROW(cache->getPose(3.0f + step * 1.2f) == cached);
+	TEST_ASSERT_THROW(cache->getHit() == 1 && cache->getMiss() == 1);
+
+	sampler->sample(3.0f + step, pose);
+	for (u32 i = 0; i < CPoseSampler::StreamCount * stride; i++)
+		TEST_ASSERT_FLOAT_EQUAL(cached[i], pose[i]);
+
+	// the slow motion does not share the quantized pose
+	TEST_ASSERT_THROW(CPoseCache::canShare(step));
+	TEST_ASSERT_THROW(CPoseCache::canShare(step * 2.0f));
+	TEST_ASSERT_THROW(!CPoseCache::canShare(step * 0.5f));
+
+	// the key is not on the integer frame
+	CPositionKey key;
+	key.Frame = 20.5f;
+	clip.AnimInfo[0]->Data.Positions.Data.push_back(key);
+	clip.releasePoseSampler();
+
+	TEST_ASSERT_THROW(clip.getPoseSampler() == NULL);
+
+	// the compressed clip is not sampled
+	clip.AnimInfo[0]->Data.Positions.Data.erase(21);
+	clip.releasePoseSampler();
+	TEST_ASSERT_THROW(clip.getPoseSampler() != NULL);
+
+	clip.AnimInfo[0]->Data.Compressed = true;
+	clip.releasePoseSampler();
+	TEST_ASSERT_THROW(clip.getPoseSampler() == NULL);
+}
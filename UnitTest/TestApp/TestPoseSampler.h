@@ -0,0 +1,3 @@
+#pragma once
+
+void testPoseSampler();
\ No newline at end of file
@@ -0,0 +1,83 @@
+#include "pch.h"
+#include "Base.hh"
+#include "TestRenderCommandBuffer.h"
+
+#include "RenderPipeline/CBaseRP.h"
+#include "RenderPipeline/CRenderCommandBuffer.h"
+
+using namespace Skylicht;
+
+// the recording backend: log the draws in replay order
+class CTestRecordRP : public CBaseRP
+{
+public:
+	core::array<int> Draws;
+	core::array<f32> DrawWorldX;
+
+	virtual void initRender(int w, int h)
+	{
+	}
+
+	virtual void resize(int w, int h)
+	{
+	}
+
+	virtual void render(ITexture* target, CCamera* camera, CEntityManager* entityManager, const core::recti& viewport)
+	{
+	}
+
+	virtual void drawMeshBuffer(CMesh* mesh, int bufferID, CEntityManager* entity, int entityID, bool skinnedMesh)
+	{
+		Draws.push_back(entityID);
+		DrawWorldX.push_back(getVideoDriver()->getTransform(video::ETS_WORLD).getTranslation().X);
+	}
+
+	virtual void drawInstancingMeshBuffer(CMesh* mesh, int bufferID, int materialRenderID, CEntityManager* entityMgr, bool skinnedMesh)
+	{
+		Draws.push_back(-materialRenderID);
+		DrawWorldX.push_back(getVideoDriver()->getTransform(video::ETS_WORLD).getTranslation().X);
+	}
+};
+
+void testRenderCommandBuffer()
+{
+	TEST_CASE("Render command buffer");
+
+	core::matrix4 world1;
+	world1.setTranslation(core::vector3df(1.0f, 0.0f, 0.0f));
+
+	core::matrix4 world2;
+	world2.setTranslation(core::vector3df(2.0f, 0.0f, 0.0f));
+
+	CRenderCommandBuffer commands;
+	commands.setWorldTransform(&world1);
+	commands.drawMeshBuffer(NULL, 0, 10, false);
+	commands.drawMeshBuffer(NULL, 1, 10, false);
+	commands.setWorldTransform(&world2);
+	commands.drawMeshBuffer(NULL, 0, 20, false);
+	commands.setWorldTransform(&core::IdentityMatrix);
+	commands.drawInstancing(NULL, 0, 5, false);
+
+	TEST_ASSERT_THROW(commands.getCount() == 7);
+	TEST_ASSERT_THROW(commands.getNumDraw() == 4);
+	TEST_ASSERT_THROW(commands.getCommand(3)->Type == CRenderCommandBuffer::SetWorldTransform);
+	TEST_ASSERT_THROW(commands.getCommand(4)->Param == 20);
+
+	CTestRecordRP* rp = new CTestRecordRP();
+	CEntityManager* entityManager = new CEntityManager();
+	entityManager->setRenderPipeline(rp);
+
+	commands.replay(entityManager);
+
+	TEST_ASSERT_THROW(rp->Draws.size() == 4);
+	TEST_ASSERT_THROW(rp->Draws[0] == 10 && rp->Draws[2] == 20 && rp->Draws[3] == -5);
+	TEST_ASSERT_FLOAT_EQUAL(rp->DrawWorldX[1], 1.0f);
+	TEST_ASSERT_FLOAT_EQUAL(rp->DrawWorldX[2], 2.0f);
+	TEST_ASSERT_FLOAT_EQUAL(rp->DrawWorldX[3], 0.0f);
+
+	commands.reset();
+	TEST_ASSERT_THROW(commands.getCount() == 0);
+
+	delete entityManager;
+	delete rp;
+}
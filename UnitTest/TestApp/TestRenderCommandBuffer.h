@@ -0,0 +1,3 @@
+#pragma once
+
+void testRenderCommandBuffer();
\ No newline at end of file
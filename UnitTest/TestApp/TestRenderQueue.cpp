@@ -0,0 +1,54 @@
+#include "pch.h"
+#include "Base.hh"
+#include "TestRenderQueue.h"
+
+#include "RenderMesh/CRenderQueue.h"
+
+using namespace Skylicht;
+
+void testRenderQueue()
+{
+	TEST_CASE("Render queue key");
+	u64 nearOpaque = CRenderQueue::packKey(CRenderQueue::Opaque, 1, 2, 3, 4, 10);
+	u64 farOpaque = CRenderQueue::packKey(CRenderQueue::Opaque, 1, 2, 3, 4, 1000);
+	u64 otherShader = CRenderQueue::packKey(CRenderQueue::Opaque, 2, 0, 0, 0, 0);
+	u64 nearTransparent = CRenderQueue::packKey(CRenderQueue::Transparent, 1, 2, 3, 4, 10);
+	u64 farTransparent = CRenderQueue::packKey(CRenderQueue::Transparent, 1, 2, 3, 4, 1000);
+
+	// opaque: by state, then front to back
+	TEST_ASSERT_THROW(nearOpaque < farOpaque);
+	TEST_ASSERT_THROW(farOpaque < otherShader);
+
+	// transparent: after opaque, back to front
+	TEST_ASSERT_THROW(otherShader < farTransparent);
+	TEST_ASSERT_THROW(farTransparent < nearTransparent);
+
+	TEST_CASE("Render queue radix sort");
+	CRenderQueue queue;
+
+	u64 seed = 12345;
+	for (int i = 0; i < 1000; i++)
+	{
+		seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+		CRenderQueue::SRenderItem* item = queue.addItem(seed);
+		item->BufferID = (u32)i;
+	}
+
+	// same key keeps the add order
+	queue.addItem(5)->BufferID = 1000;
+	queue.addItem(5)->BufferID = 1001;
+
+	queue.sort();
+
+	TEST_ASSERT_THROW(queue.getCount() == 1002);
+	TEST_ASSERT_THROW(queue.getItem(0)->BufferID == 1000);
+	TEST_ASSERT_THROW(queue.getItem(1)->BufferID == 1001);
+
+	bool sorted = true;
+	for (int i = 1; i < queue.getCount(); i++)
+	{
+		if (queue.getItem(i - 1)->Key > queue.getItem(i)->Key)
+			sorted = false;
+	}
+	TEST_ASSERT_THROW(sorted);
+}
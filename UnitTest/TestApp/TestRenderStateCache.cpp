@@ -0,0 +1,122 @@
+#include "pch.h"
+#include "Base.hh"
+#include "TestRenderStateCache.h"
+
+#include "RenderPipeline/CRenderStateCache.h"
+#include "RenderPipeline/CForwardRP.h"
+#include "Scene/CScene.h"
+#include "Entity/CEntityManager.h"
+
+using namespace Skylicht;
+
+// the system sets the driver material directly, the cache does not know it
+class CTestMaterialSystem : public IRenderSystem
+{
+public:
+	SMaterial Material;
+
+public:
+	CTestMaterialSystem()
+	{
+		m_pipelineType = IRenderPipeline::Mix;
+		Material.MaterialType = video::EMT_SOLID;
+	}
+
+	virtual void beginQuery(CEntityManager* entityManager)
+	{
+	}
+
+	virtual void onQuery(CEntityManager* entityManager, CEntity** entities, int numEntity)
+	{
+	}
+
+	virtual void init(CEntityManager* entityManager)
+	{
+	}
+
+	virtual void update(CEntityManager* entityManager)
+	{
+	}
+
+	virtual void render(CEntityManager* entityManager)
+	{
+		CRenderStateCache::setMaterial(getVideoDriver(), Material);
+	}
+};
+
+// the entity manager keeps one system per type
+class CTestMaterialSystem2 : public CTestMaterialSystem
+{
+};
+
+void testRenderStateCache()
+{
+	TEST_CASE("Render state cache");
+	IVideoDriver* driver = getVideoDriver();
+
+	ITexture* texture = driver->addTexture(core::dimension2du(2, 2), "TestRenderStateCache");
+
+	SMaterial a;
+	a.MaterialType = video::EMT_SOLID;
+
+	SMaterial b = a;
+	b.setTexture(0, texture);
+
+	SMaterial c = b;
+	c.ZWriteEnable = false;
+
+	SMaterial d = c;
+	d.MaterialType = video::EMT_TRANSPARENT_ALPHA_CHANNEL;
+
+	CRenderStateCache::invalidate();
+	CRenderStateCache::resetStats();
+
+	CRenderStateCache::setMaterial(driver, a);
+	CRenderStateCache::setMaterial(driver, a);
+	CRenderStateCache::setMaterial(driver, b);
+	CRenderStateCache::setMaterial(driver, b);
+	CRenderStateCache::setMaterial(driver, c);
+	CRenderStateCache::setMaterial(driver, d);
+
+	SRenderStateStats& stats = CRenderStateCache::getStats();
+	TEST_ASSERT_THROW(stats.MaterialChanged == 4);
+	TEST_ASSERT_THROW(stats.RedundantSkipped == 2);
+	TEST_ASSERT_THROW(stats.TextureChanged == 1);
+	TEST_ASSERT_THROW(stats.StateChanged == 1);
+	TEST_ASSERT_THROW(stats.ShaderChanged == 1);
+
+	// the material must be sent again after invalidate
+	CRenderStateCache::invalidate();
+	CRenderStateCache::setMaterial(driver, d);
+	TEST_ASSERT_THROW(stats.MaterialChanged == 5);
+	TEST_ASSERT_THROW(stats.RedundantSkipped == 2);
+
+	CRenderStateCache::invalidate();
+	CRenderStateCache::resetStats();
+
+	driver->removeTexture(texture);
+
+	TEST_CASE("Render state cache invalidate per system");
+	CScene* scene = new CScene();
+	CZone* zone = scene->createZone();
+
+	CCamera* camera = zone->createEmptyObject()->addComponent<CCamera>();
+	CForwardRP* forwardRP = new CForwardRP();
+
+	CEntityManager* entityMgr = zone->getEntityManager();
+	entityMgr->setCamera(camera);
+	entityMgr->setRenderPipeline(forwardRP);
+
+	entityMgr->addRenderSystem<CTestMaterialSystem>();
+	entityMgr->addRenderSystem<CTestMaterialSystem2>();
+
+	// each system sends its material, even it is same as the previous system
+	entityMgr->cullingAndRender();
+	TEST_ASSERT_THROW(stats.MaterialChanged == 2);
+	TEST_ASSERT_THROW(stats.RedundantSkipped == 0);
+
+	CRenderStateCache::resetStats();
+
+	delete forwardRP;
+	delete scene;
+}
@@ -0,0 +1,3 @@
+#pragma once
+
+void testRenderStateCache();
\ No newline at end of file
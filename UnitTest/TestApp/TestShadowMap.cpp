@@ -0,0 +1,196 @@
+#include "pch.h"
+#include "Base.hh"
+#include "TestShadowMap.h"
+
+#include "Scene/CScene.h"
+#include "Shadow/CCascadedShadowMaps.h"
+#include "RenderPipeline/CShadowMapRP.h"
+#include "Entity/CEntityManager.h"
+#include "Transform/CWorldTransformData.h"
+#include "Culling/CCullingData.h"
+#include "Culling/CCullingBBoxData.h"
+#include "Culling/CCullingSystem.h"
+
+using namespace Skylicht;
+
+class CTestShadowMapRP : public CShadowMapRP
+{
+public:
+	CCascadedShadowMaps* getTestCSM()
+	{
+		return getCSM();
+	}
+
+	void renderCascade(int cascade)
+	{
+		updateCascadeCache(cascade, true);
+	}
+};
+
+static CWorldTransformData* createTestCaster(CEntityManager* entityMgr, const core::vector3df& position)
+{
+	CEntity* entity = entityMgr->createEntity();
+
+	CWorldTransformData* transform = entity->addData<CWorldTransformData>();
+	transform->Relative.setTranslation(position);
+
+	entity->addData<CCullingData>();
+
+	CCullingBBoxData* bbox = entity->addData<CCullingBBoxData>();
+	bbox->BBox.MinEdge.set(-1.0f, -1.0f, -1.0f);
+	bbox->BBox.MaxEdge.set(1.0f, 1.0f, 1.0f);
+
+	return transform;
+}
+
+static void moveTestCaster(CWorldTransformData* transform, const core::vector3df& position)
+{
+	transform->Relative.setTranslation(position);
+	transform->HasChanged = true;
+}
+
+static bool isInsideFrustum(const SViewFrustum& frustum, const core::vector3df& point)
+{
+	// the plane normals point out of the frustum
+	for (int i = 0; i < SViewFrustum::VF_PLANE_COUNT; i++)
+	{
+		if (frustum.planes[i].getDistanceTo(point) > 0.0f)
+			return false;
+	}
+	return true;
+}
+
+static bool isTexelStep(f32 ndc, int shadowMapSize)
+{
+	f32 texel = ndc * (f32)shadowMapSize * 0.5f;
+	return fabsf(texel - core::round_(texel)) < 0.05f;
+}
+
+void testShadowMap()
+{
+	CScene* scene = new CScene();
+	CZone* zone = scene->createZone();
+
+	CGameObject* obj = zone->createEmptyObject();
+	CCamera* camera = obj->addComponent<CCamera>();
+
+	core::vector3df cameraPosition(0.0f, 2.0f, 0.0f);
+	core::vector3df cameraForward(0.0f, 0.0f, 1.0f);
+	camera->lookAt(cameraPosition, cameraPosition + cameraForward, core::vector3df(0.0f, 1.0f, 0.0f));
+
+	const int shadowMapSize = 1024;
+	core::vector3df lightDir(-0.5f, -1.0f, 0.3f);
+
+	CCascadedShadowMaps* csm = new CCascadedShadowMaps();
+	csm->init(3, shadowMapSize, 100.0f, 512, 512);
+	csm->update(camera, lightDir);
+
+	TEST_CASE("Shadow cascade culling frustum");
+	lightDir.normalize();
+
+	core::vector3df right = cameraForward.crossProduct(core::vector3df(0.0f, 1.0f, 0.0f));
+	float* distance = csm->getShadowDistance();
+
+	for (int i = 0; i < csm->getSplitCount(); i++)
+	{
+		const SViewFrustum& frustum = csm->getCullingFrustum(i);
+
+		float nearDistance = i == 0 ? camera->getNearValue() : distance[i - 1];
+		core::vector3df receiver = cameraPosition + cameraForward * ((nearDistance + distance[i]) * 0.5f);
+
+		// the receiver and the caster between the light and the receiver
+		TEST_ASSERT_THROW(isInsideFrustum(frustum, receiver));
+		TEST_ASSERT_THROW(isInsideFrustum(frustum, receiver - lightDir * 50.0f));
+		TEST_ASSERT_THROW(csm->getFrustumBox(i).isPointInside(receiver));
+
+		// behind the receivers or beside the split
+		TEST_ASSERT_THROW(!isInsideFrustum(frustum, receiver + lightDir * 1000.0f));
+		TEST_ASSERT_THROW(!isInsideFrustum(frustum, receiver + right * 1000.0f));
+	}
+
+	TEST_CASE("Shadow cascade texel snap");
+	core::matrix4 lastViewProj[MAX_FRUSTUM_SPLITS];
+	for (int i = 0; i < csm->getSplitCount(); i++)
+		lastViewProj[i] = csm->getProjectionMatrices(i) * csm->getViewMatrices(i);
+
+	cameraPosition += core::vector3df(3.3f, 0.7f, 1.7f);
+	camera->lookAt(cameraPosition, cameraPosition + cameraForward, core::vector3df(0.0f, 1.0f, 0.0f));
+	csm->update(camera, lightDir);
+
+	for (int i = 0; i < csm->getSplitCount(); i++)
+	{
+		core::matrix4 viewProj = csm->getProjectionMatrices(i) * csm->getViewMatrices(i);
+
+		// a static point just moves by the whole texel on the shadow map
+		core::vector3df point(10.0f, 0.0f, 20.0f);
+		core::vector3df lastPos = point;
+		core::vector3df pos = point;
+		lastViewProj[i].transformVect(lastPos);
+		viewProj.transformVect(pos);
+
+		TEST_ASSERT_THROW(isTexelStep(pos.X - lastPos.X, shadowMapSize));
+		TEST_ASSERT_THROW(isTexelStep(pos.Y - lastPos.Y, shadowMapSize));
+	}
+
+	delete csm;
+
+	TEST_CASE("Shadow cascade cache");
+	CTestShadowMapRP* shadowMapRP = new CTestShadowMapRP();
+	shadowMapRP->initRender(512, 512);
+	shadowMapRP->setFarCascadeUpdateInterval(1);
+
+	csm = shadowMapRP->getTestCSM();
+	csm->update(camera, lightDir);
+
+	distance = csm->getShadowDistance();
+	core::vector3df receiver = cameraPosition + cameraForward * ((camera->getNearValue() + distance[0]) * 0.5f);
+	core::vector3df farAway(1000.0f, 0.0f, 1000.0f);
+
+	CEntityManager* entityMgr = new CEntityManager();
+	CCullingSystem* cullingSystem = entityMgr->getSystem<CCullingSystem>();
+
+	CWorldTransformData* nearCaster = createTestCaster(entityMgr, receiver);
+	CWorldTransformData* farCaster = createTestCaster(entityMgr, farAway);
+	entityMgr->update();
+
+	int numCascade = csm->getSplitCount();
+
+	// the first frame renders all cascades
+	for (int i = 0; i < numCascade; i++)
+	{
+		TEST_ASSERT_THROW(shadowMapRP->needRenderCascade(i, cullingSystem));
+		shadowMapRP->renderCascade(i);
+	}
+
+	// nothing is changed
+	entityMgr->update();
+	for (int i = 0; i < numCascade; i++)
+		TEST_ASSERT_THROW(!shadowMapRP->needRenderCascade(i, cullingSystem));
+
+	// a caster outside all cascades
+	moveTestCaster(farCaster, farAway + core::vector3df(5.0f, 0.0f, 0.0f));
+	entityMgr->update();
+	for (int i = 0; i < numCascade; i++)
+		TEST_ASSERT_THROW(!shadowMapRP->needRenderCascade(i, cullingSystem));
+
+	// a caster inside the first cascade
+	moveTestCaster(nearCaster, receiver + core::vector3df(0.5f, 0.0f, 0.0f));
+	entityMgr->update();
+	TEST_ASSERT_THROW(shadowMapRP->needRenderCascade(0, cullingSystem));
+	for (int i = 0; i < numCascade; i++)
+		shadowMapRP->renderCascade(i);
+
+	entityMgr->update();
+	TEST_ASSERT_THROW(!shadowMapRP->needRenderCascade(0, cullingSystem));
+
+	// the camera is moved, the cascade matrices are changed
+	cameraPosition += core::vector3df(0.0f, 0.0f, 20.0f);
+	camera->lookAt(cameraPosition, cameraPosition + cameraForward, core::vector3df(0.0f, 1.0f, 0.0f));
+	csm->update(camera, lightDir);
+	for (int i = 0; i < numCascade; i++)
+		TEST_ASSERT_THROW(shadowMapRP->needRenderCascade(i, cullingSystem));
+
+	delete entityMgr;
+	delete shadowMapRP;
+	delete scene;
+}
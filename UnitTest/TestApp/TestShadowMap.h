@@ -0,0 +1,3 @@
+#pragma once
+
+void testShadowMap();
\ No newline at end of file
@@ -0,0 +1,130 @@
+#include "pch.h"
+#include "Base.hh"
+#include "TestStaticMeshBatching.h"
+
+#include "MeshManager/CStaticMeshBatching.h"
+#include "RenderMesh/CRenderMeshData.h"
+#include "Transform/CWorldTransformData.h"
+#include "Culling/CCullingData.h"
+
+using namespace Skylicht;
+
+// a triangle mesh at local (0,0,0), (1,0,0), (0,1,0)
+static CMesh* createTriangleMesh(const char* materialName)
+{
+	IMeshBuffer* mb = new CMeshBuffer<S3DVertex>(getVideoDriver()->getVertexDescriptor(EVT_STANDARD), video::EIT_16BIT);
+
+	S3DVertex v;
+	v.Normal.set(0.0f, 0.0f, 1.0f);
+
+	v.Pos.set(0.0f, 0.0f, 0.0f);
+	mb->getVertexBuffer(0)->addVertex(&v);
+	v.Pos.set(1.0f, 0.0f, 0.0f);
+	mb->getVertexBuffer(0)->addVertex(&v);
+	v.Pos.set(0.0f, 1.0f, 0.0f);
+	mb->getVertexBuffer(0)->addVertex(&v);
+
+	mb->getIndexBuffer()->addIndex(0);
+	mb->getIndexBuffer()->addIndex(1);
+	mb->getIndexBuffer()->addIndex(2);
+	mb->recalculateBoundingBox();
+
+	CMesh* mesh = new CMesh();
+	mesh->addMeshBuffer(mb, materialName);
+	mesh->recalculateBoundingBox();
+	mb->drop();
+	return mesh;
+}
+
+static CEntity* addMeshEntity(CEntityPrefab* prefab, CEntity* parent, const core::matrix4& m, const char* materialName)
+{
+	CEntity* entity = prefab->createEntity();
+	prefab->addTransformData(entity, parent, m, "Mesh");
+
+	CMesh* mesh = createTriangleMesh(materialName);
+	entity->addData<CRenderMeshData>()->setMesh(mesh);
+	entity->addData<CCullingData>();
+	mesh->drop();
+	return entity;
+}
+
+static CEntity* addMeshEntity(CEntityPrefab* prefab, CEntity* parent, const core::vector3df& pos, const char* materialName)
+{
+	core::matrix4 m;
+	m.setTranslation(pos);
+	return addMeshEntity(prefab, parent, m, materialName);
+}
+
+void testStaticMeshBatching()
+{
+	TEST_CASE("Static mesh batching");
+
+	CEntityPrefab* prefab = new CEntityPrefab();
+
+	CEntity* root = prefab->createEntity();
+	prefab->addTransformData(root, NULL, core::IdentityMatrix, "Root");
+
+	CEntity* a = addMeshEntity(prefab, root, core::vector3df(10.0f, 0.0f, 0.0f), "wall");
+	CEntity* b = addMeshEntity(prefab, a, core::vector3df(0.0f, 5.0f, 0.0f), "wall");
+	CEntity* c = addMeshEntity(prefab, root, core::vector3df(0.0f, 0.0f, 2.0f), "floor");
+
+	core::matrix4 mirror;
+	mirror.setScale(core::vector3df(-1.0f, 1.0f, 1.0f));
+	addMeshEntity(prefab, root, mirror, "mirror");
+
+	CStaticMeshBatching batching;
+	TEST_ASSERT_THROW(batching.batchPrefab(prefab) == true);
+
+	// the source entities just keep the transform
+	TEST_ASSERT_THROW(a->getData<CRenderMeshData>() == NULL);
+	TEST_ASSERT_THROW(b->getData<CCullingData>() == NULL);
+	TEST_ASSERT_THROW(c->getData<CWorldTransformData>() != NULL);
+
+	CEntity* batchEntity = prefab->getEntity(prefab->getNumEntities() - 1);
+	CRenderMeshData* renderData = batchEntity->getData<CRenderMeshData>();
+	TEST_ASSERT_THROW(renderData != NULL);
+	TEST_ASSERT_THROW(batchEntity->getData<CCullingData>() != NULL);
+
+	// a buffer per material, sorted by the name
+	CMesh* mesh = renderData->getMesh();
+	TEST_ASSERT_THROW(mesh->getMeshBufferCount() == 3);
+	TEST_ASSERT_THROW(mesh->MaterialName[0] == "floor");
+	TEST_ASSERT_THROW(mesh->MaterialName[1] == "mirror");
+	TEST_ASSERT_THROW(mesh->MaterialName[2] == "wall");
+
+	// the ranges of 2 walls in the shared buffer
+	IMeshBuffer* wall = mesh->getMeshBuffer(2);
+	TEST_ASSERT_THROW(wall->getVertexBuffer(0)->getVertexCount() == 6);
+	TEST_ASSERT_THROW(wall->getIndexBuffer()->getIndexCount() == 6);
+	TEST_ASSERT_THROW(wall->getIndexBuffer()->getIndex(3) == 3);
+	TEST_ASSERT_THROW(wall->getIndexBuffer()->getIndex(5) == 5);
+
+	// the transform is baked by the parent chain
+	S3DVertex* vertices = (S3DVertex*)wall->getVertexBuffer(0)->getVertices();
+	TEST_ASSERT_FLOAT_EQUAL(vertices[1].Pos.X, 11.0f);
+	TEST_ASSERT_FLOAT_EQUAL(vertices[4].Pos.X, 11.0f);
+	TEST_ASSERT_FLOAT_EQUAL(vertices[4].Pos.Y, 5.0f);
+	TEST_ASSERT_FLOAT_EQUAL(vertices[5].Normal.Z, 1.0f);
+
+	S3DVertex* floor = (S3DVertex*)mesh->getMeshBuffer(0)->getVertexBuffer(0)->getVertices();
+	TEST_ASSERT_FLOAT_EQUAL(floor[2].Pos.Z, 2.0f);
+
+	TEST_CASE("Static mesh batching mirrored transform");
+	IMeshBuffer* mirrorBuffer = mesh->getMeshBuffer(1);
+	IIndexBuffer* mirrorIndices = mirrorBuffer->getIndexBuffer();
+	TEST_ASSERT_THROW(mirrorIndices->getIndex(0) == 0);
+	TEST_ASSERT_THROW(mirrorIndices->getIndex(1) == 2);
+	TEST_ASSERT_THROW(mirrorIndices->getIndex(2) == 1);
+
+	// the winding still faces the normal
+	S3DVertex* mirrorVertices = (S3DVertex*)mirrorBuffer->getVertexBuffer(0)->getVertices();
+	core::vector3df p0 = mirrorVertices[mirrorIndices->getIndex(0)].Pos;
+	core::vector3df p1 = mirrorVertices[mirrorIndices->getIndex(1)].Pos;
+	core::vector3df p2 = mirrorVertices[mirrorIndices->getIndex(2)].Pos;
+	core::vector3df faceNormal = (p1 - p0).crossProduct(p2 - p0);
+	TEST_ASSERT_FLOAT_EQUAL(mirrorVertices[0].Pos.X, 0.0f);
+	TEST_ASSERT_FLOAT_EQUAL(mirrorVertices[1].Pos.X, -1.0f);
+	TEST_ASSERT_THROW(faceNormal.dotProduct(mirrorVertices[0].Normal) > 0.0f);
+
+	delete prefab;
+}
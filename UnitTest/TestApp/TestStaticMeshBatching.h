@@ -0,0 +1,3 @@
+#pragma once
+
+void testStaticMeshBatching();
\ No newline at end of file
@@ -0,0 +1,75 @@
+#include "pch.h"
+#include "Base.hh"
+#include "TestSystemScheduler.h"
+
+#include "Entity/CEntityManager.h"
+#include "Transform/CWorldTransformData.h"
+#include "Transform/CWorldInverseTransformSystem.h"
+#include "IndirectLighting/CIndirectLightingSystem.h"
+#include "ReflectionProbe/CReflectionProbeSystem.h"
+#include "RenderMesh/CSkinnedMeshSystem.h"
+
+using namespace Skylicht;
+
+TestReadTransformSystem::TestReadTransformSystem() :
+	UpdateCount(0)
+{
+	readData(CWorldTransformData::DataTypeIndex);
+}
+
+void TestReadTransformSystem::update(CEntityManager* entityManager)
+{
+	UpdateCount++;
+}
+
+void testSystemScheduler()
+{
+	CEntityManager* entityMgr = new CEntityManager();
+	entityMgr->update();
+
+	TEST_CASE("System data access conflict");
+	TestReadTransformSystem* readA = entityMgr->addSystem<TestReadTransformSystem>();
+	TestReadTransformSystem* readB = entityMgr->addSystem<TestReadTransformSystem>();
+	CWorldInverseTransformSystem* inverse = entityMgr->getSystem<CWorldInverseTransformSystem>();
+
+	// both systems only read the transform data
+	TEST_ASSERT_THROW(readA->isConflict(readB) == false);
+	// inverse system read transform & write inverse data
+	TEST_ASSERT_THROW(readA->isConflict(inverse) == false);
+
+	TEST_CASE("System data access probes");
+	CIndirectLightingSystem* lighting = new CIndirectLightingSystem();
+	CReflectionProbeSystem* reflection = new CReflectionProbeSystem();
+	CSkinnedMeshSystem* skinned = new CSkinnedMeshSystem();
+
+	// the reflection probe writes its own data, it does not touch the SH of indirect lighting
+	TEST_ASSERT_THROW(lighting->isConflict(reflection) == false);
+	// the probes do not touch the joint & mesh data
+	TEST_ASSERT_THROW(lighting->isConflict(skinned) == false);
+	TEST_ASSERT_THROW(reflection->isConflict(skinned) == false);
+
+	delete lighting;
+	delete reflection;
+	delete skinned;
+
+	// the probe systems of entity manager run on the same stage
+	lighting = entityMgr->getSystem<CIndirectLightingSystem>();
+	reflection = entityMgr->getSystem<CReflectionProbeSystem>();
+	TEST_ASSERT_THROW(entityMgr->getUpdateStage(lighting) >= 0);
+	TEST_ASSERT_THROW(entityMgr->getUpdateStage(lighting) == entityMgr->getUpdateStage(reflection));
+
+	TEST_CASE("System update stages");
+	int numStage = entityMgr->getNumUpdateStage();
+	entityMgr->update();
+
+	// 2 read systems run on the same new stage
+	TEST_ASSERT_THROW(entityMgr->getNumUpdateStage() == numStage + 1);
+	TEST_ASSERT_THROW(readA->UpdateCount == 1);
+	TEST_ASSERT_THROW(readB->UpdateCount == 1);
+
+	entityMgr->setParallelUpdate(false);
+	entityMgr->update();
+	TEST_ASSERT_THROW(readA->UpdateCount == 2);
+
+	delete entityMgr;
+}
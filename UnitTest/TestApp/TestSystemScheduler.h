@@ -0,0 +1,22 @@
+#pragma once
+
+#include "Entity/IEntitySystem.h"
+
+class TestReadTransformSystem : public Skylicht::IEntitySystem
+{
+public:
+	int UpdateCount;
+
+public:
+	TestReadTransformSystem();
+
+	virtual void beginQuery(Skylicht::CEntityManager* entityManager) {}
+
+	virtual void onQuery(Skylicht::CEntityManager* entityManager, Skylicht::CEntity** entities, int count) {}
+
+	virtual void init(Skylicht::CEntityManager* entityManager) {}
+
+	virtual void update(Skylicht::CEntityManager* entityManager);
+};
+
+void testSystemScheduler();
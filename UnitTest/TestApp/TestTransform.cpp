@@ -1,5 +1,6 @@
 #include "Base.hh"
 #include "TestTransform.h"
+#include "Utils/CMatrixSIMD.h"
 
 void testTransform(CGameObject *obj)
 {
@@ -22,8 +23,6 @@ void testTransform(CGameObject *obj)
 	TEST_ASSERT_FLOAT_EQUAL(right.Y, CTransform::s_ox.Y);
 	TEST_ASSERT_FLOAT_EQUAL(right.Z, CTransform::s_ox.Z);
 
-
-
 	TEST_CASE("Test set transform matrix");
 	core::matrix4 m;
 	m.setRotationDegrees(core::vector3df(0.0f, 90.0f, 0.0f));
@@ -42,7 +41,6 @@ void testTransform(CGameObject *obj)
 	TEST_ASSERT_FLOAT_EQUAL(front.Y, CTransform::s_ox.Y);
 	TEST_ASSERT_FLOAT_EQUAL(front.Z, CTransform::s_ox.Z);
 
-
 	TEST_CASE("Test get transform matrix");
 	// rotate ox 90
 	core::quaternion q;
@@ -66,4 +64,49 @@ void testTransform(CGameObject *obj)
 	TEST_ASSERT_FLOAT_EQUAL(front.X, -CTransform::s_oy.X);
 	TEST_ASSERT_FLOAT_EQUAL(front.Y, -CTransform::s_oy.Y);
 	TEST_ASSERT_FLOAT_EQUAL(front.Z, -CTransform::s_oy.Z);
+
+	TEST_CASE("Test SIMD matrix multiply");
+	core::matrix4 a, b, r1, r2;
+	a.setRotationDegrees(core::vector3df(30.0f, 45.0f, 60.0f));
+	a.setTranslation(core::vector3df(1.0f, 2.0f, 3.0f));
+	b.setRotationDegrees(core::vector3df(10.0f, -20.0f, 90.0f));
+	b.setTranslation(core::vector3df(-5.0f, 0.5f, 8.0f));
+	b.setScale(core::vector3df(2.0f, 2.0f, 2.0f));
+
+	r1.setbyproduct_nocheck(a, b);
+	CMatrixSIMD::mul(r2, a, b);
+	for (int i = 0; i < 16; i++)
+		TEST_ASSERT_FLOAT_EQUAL(r1[i], r2[i]);
+
+	TEST_CASE("Test SIMD affine inverse");
+	core::matrix4 worlds[4];
+	core::matrix4 inverses[4];
+	const core::matrix4* in[4];
+	core::matrix4* out[4];
+	for (int i = 0; i < 4; i++)
+	{
+		worlds[i].setRotationDegrees(core::vector3df(i * 20.0f, 45.0f, i * -30.0f));
+		worlds[i].setTranslation(core::vector3df(i * 10.0f, -5.0f, 3.0f));
+		in[i] = &worlds[i];
+		out[i] = &inverses[i];
+	}
+	worlds[1].setScale(core::vector3df(2.0f, 0.5f, 3.0f));
+	worlds[2] = worlds[2] * a;
+
+	bool inverseAffine = CMatrixSIMD::inverseAffine4(out, in);
+#if defined(USE_SIMD)
+	TEST_ASSERT_THROW(inverseAffine == true);
+	for (int i = 0; i < 4; i++)
+	{
+		worlds[i].getInverse(r1);
+		for (int j = 0; j < 16; j++)
+			TEST_ASSERT_FLOAT_EQUAL(r1[j], inverses[i][j]);
+	}
+
+	// projection matrix is not affine
+	worlds[3].buildProjectionMatrixPerspectiveFovLH(core::PI * 0.5f, 1.0f, 0.1f, 100.0f);
+	TEST_ASSERT_THROW(CMatrixSIMD::inverseAffine4(out, in) == false);
+#else
+	TEST_ASSERT_THROW(inverseAffine == false);
+#endif
 }
\ No newline at end of file